@@ -0,0 +1,346 @@
+#include "BSPBuilder.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+#include "CounterRng.h"
+#include "Parallel.h"
+
+// Leaves and corridors are handed to workers in chunks of this many
+static const int BSP_CHUNK_SIZE = 256;
+
+// Routing costs: corridors are cheapest, rooms are crossed only when needed
+static const uint8_t ROUTE_CORRIDOR_COST = 1;
+static const uint8_t ROUTE_EMPTY_COST = 4;
+static const uint8_t ROUTE_ROOM_COST = 12;
+static const int ROUTE_SEARCH_MARGIN = 16;
+
+static int randiRange(CounterStream& stream, int from, int to) {
+    if (from > to)
+        std::swap(from, to);
+    return stream.range(from, to);
+}
+
+bool BSPBuilder::splitNode(int index) {
+    if (!nodes[index].isLeaf())
+        return false;
+
+    // Copy: emplace_back below may move the node array
+    BSPRect2i rect = nodes[index].rect;
+    int min_split_size = cfg.minRoomSize + 2;
+    bool can_split_h = rect.size.x >= min_split_size * 2;
+    bool can_split_v = rect.size.y >= min_split_size * 2;
+
+    if (!can_split_h && !can_split_v)
+        return false;
+
+    bool split_h = can_split_h && (!can_split_v || rng.coin());
+
+    int first = (int)nodes.size();
+    if (split_h) {
+        int split_x = rng.range(min_split_size, rect.size.x - min_split_size);
+        nodes.emplace_back(BSPRect2i{rect.position, {split_x, rect.size.y}});
+        nodes.emplace_back(BSPRect2i{{rect.position.x + split_x, rect.position.y}, {rect.size.x - split_x, rect.size.y}});
+    } else {
+        int split_y = rng.range(min_split_size, rect.size.y - min_split_size);
+        nodes.emplace_back(BSPRect2i{rect.position, {rect.size.x, split_y}});
+        nodes.emplace_back(BSPRect2i{{rect.position.x, rect.position.y + split_y}, {rect.size.x, rect.size.y - split_y}});
+    }
+    nodes[index].left = first;
+    nodes[index].right = first + 1;
+
+    return true;
+}
+
+void BSPBuilder::generate(const BSPSettings& settings) {
+    cfg = settings;
+    rng = CounterStream(cfg.seed);
+
+    nodes.clear();
+    leaves.clear();
+    rooms.clear();
+    corridors.clear();
+
+    // BSP partitioning
+    nodes.emplace_back(BSPRect2i{BSPVec2i{0, 0}, BSPVec2i{cfg.mapWidth, cfg.mapHeight}});
+    std::vector<int> queue = {0};
+    int split_count = 0;
+
+    while (split_count < cfg.maxSplits && !queue.empty()) {
+        std::vector<int> next;
+        bool did_split = false;
+        for (int index : queue) {
+            if (splitNode(index)) {
+                next.push_back(nodes[index].left);
+                next.push_back(nodes[index].right);
+                did_split = true;
+            } else {
+                leaves.push_back(index);
+            }
+        }
+        if (!did_split) {
+            leaves.insert(leaves.end(), next.begin(), next.end());
+            break;
+        }
+        queue = next;
+        split_count++;
+    }
+
+    if (split_count == cfg.maxSplits) {
+        leaves.insert(leaves.end(), queue.begin(), queue.end());
+    }
+
+    placeRooms();
+    cacheRepresentativePoints();
+    connectRooms();
+    buildTileLists();
+}
+
+void BSPBuilder::placeRooms() {
+    int leafCount = (int)leaves.size();
+    int chunks = (leafCount + BSP_CHUNK_SIZE - 1) / BSP_CHUNK_SIZE;
+    parallelFor(chunks, cfg.workerThreads, [&](int c) {
+        int end = std::min(leafCount, (c + 1) * BSP_CHUNK_SIZE);
+        for (int i = c * BSP_CHUNK_SIZE; i < end; ++i) {
+            BSPNode& leaf = nodes[leaves[i]];
+            int max_w = leaf.rect.size.x - 2 * cfg.roomPadding;
+            int max_h = leaf.rect.size.y - 2 * cfg.roomPadding;
+            if (max_w < cfg.minRoomSize || max_h < cfg.minRoomSize)
+                continue;
+
+            CounterStream stream = rng.substream(leaves[i]);
+            int w = randiRange(stream, cfg.minRoomSize, std::min(max_w, cfg.maxRoomSize));
+            int h = randiRange(stream, cfg.minRoomSize, std::min(max_h, cfg.maxRoomSize));
+            int x = randiRange(stream, leaf.rect.position.x + cfg.roomPadding,
+                               leaf.rect.position.x + leaf.rect.size.x - cfg.roomPadding - w);
+            int y = randiRange(stream, leaf.rect.position.y + cfg.roomPadding,
+                               leaf.rect.position.y + leaf.rect.size.y - cfg.roomPadding - h);
+
+            leaf.room = {{x, y}, {w, h}};
+            leaf.has_room = true;
+        }
+    });
+
+    for (int index : leaves) {
+        if (nodes[index].has_room) rooms.push_back(nodes[index].room);
+    }
+}
+
+void BSPBuilder::cacheRepresentativePoints() {
+    // Children come after parents, so one reverse pass fills the tree
+    for (int i = (int)nodes.size() - 1; i >= 0; --i) {
+        BSPNode& node = nodes[i];
+        if (node.has_room) {
+            node.point = node.room.center();
+            node.has_point = true;
+            node.point_leaf = i;
+        } else if (!node.isLeaf()) {
+            const BSPNode& source = nodes[node.left].has_point ? nodes[node.left] : nodes[node.right];
+            node.point = source.point;
+            node.has_point = source.has_point;
+            node.point_leaf = source.point_leaf;
+        }
+    }
+}
+
+void BSPBuilder::connectRooms() {
+    // Internal nodes whose halves both hold a room, in pre-order, with the
+    // offset of each one's corridor in the shared list
+    std::vector<int> joins;
+    std::vector<size_t> offsets;
+    size_t total = 0;
+    std::vector<int> stack = {0};
+    while (!stack.empty()) {
+        const BSPNode& node = nodes[stack.back()];
+        int index = stack.back();
+        stack.pop_back();
+        if (node.isLeaf())
+            continue;
+
+        const BSPNode& left = nodes[node.left];
+        const BSPNode& right = nodes[node.right];
+        if (left.has_point && right.has_point) {
+            joins.push_back(index);
+            offsets.push_back(total);
+            total += std::abs(left.point.x - right.point.x) + std::abs(left.point.y - right.point.y);
+        }
+        stack.push_back(node.right);
+        stack.push_back(node.left);
+    }
+
+    if (cfg.routeCorridors) {
+        routeCorridors(joins);
+        return;
+    }
+
+    // Every corridor's length is known, so each join writes its own slice
+    corridors.resize(total);
+    int joinCount = (int)joins.size();
+    int chunks = (joinCount + BSP_CHUNK_SIZE - 1) / BSP_CHUNK_SIZE;
+    parallelFor(chunks, cfg.workerThreads, [&](int c) {
+        int end = std::min(joinCount, (c + 1) * BSP_CHUNK_SIZE);
+        for (int j = c * BSP_CHUNK_SIZE; j < end; ++j) {
+            const BSPNode& node = nodes[joins[j]];
+            BSPVec2i pos = nodes[node.left].point;
+            BSPVec2i b = nodes[node.right].point;
+            BSPVec2i* out = corridors.data() + offsets[j];
+
+            CounterStream stream = rng.substream(joins[j]);
+            if (stream.coin()) {
+                while (pos.x != b.x) {
+                    pos.x += (b.x > pos.x ? 1 : -1);
+                    *out++ = pos;
+                }
+                while (pos.y != b.y) {
+                    pos.y += (b.y > pos.y ? 1 : -1);
+                    *out++ = pos;
+                }
+            } else {
+                while (pos.y != b.y) {
+                    pos.y += (b.y > pos.y ? 1 : -1);
+                    *out++ = pos;
+                }
+                while (pos.x != b.x) {
+                    pos.x += (b.x > pos.x ? 1 : -1);
+                    *out++ = pos;
+                }
+            }
+        }
+    });
+}
+
+void BSPBuilder::routeCorridors(const std::vector<int>& joins) {
+    router.reset(cfg.mapWidth, cfg.mapHeight, ROUTE_EMPTY_COST);
+    router.setSearchMargin(ROUTE_SEARCH_MARGIN);
+    router.setHeuristicCost(ROUTE_EMPTY_COST);
+    for (const auto& room : rooms) {
+        for (int y = room.position.y; y < room.position.y + room.size.y; ++y) {
+            for (int x = room.position.x; x < room.position.x + room.size.x; ++x) {
+                router.cost(x, y) = ROUTE_ROOM_COST;
+            }
+        }
+    }
+
+    // The two rooms being joined are walked out of at the empty-cell cost
+    auto setRoomCost = [&](const BSPRect2i& room, uint8_t from, uint8_t to) {
+        for (int y = room.position.y; y < room.position.y + room.size.y; ++y) {
+            for (int x = room.position.x; x < room.position.x + room.size.x; ++x) {
+                uint8_t& c = router.cost(x, y);
+                if (c == from) c = to;
+            }
+        }
+    };
+
+    // In order, so each corridor can follow the ones carved before it
+    std::vector<RoutePoint> path;
+    for (int index : joins) {
+        const BSPNode& node = nodes[index];
+        const BSPNode& left = nodes[node.left];
+        const BSPNode& right = nodes[node.right];
+        const BSPRect2i& roomA = nodes[left.point_leaf].room;
+        const BSPRect2i& roomB = nodes[right.point_leaf].room;
+        setRoomCost(roomA, ROUTE_ROOM_COST, ROUTE_EMPTY_COST);
+        setRoomCost(roomB, ROUTE_ROOM_COST, ROUTE_EMPTY_COST);
+
+        path.clear();
+        bool routed = router.route({left.point.x, left.point.y}, {right.point.x, right.point.y}, path);
+        setRoomCost(roomA, ROUTE_EMPTY_COST, ROUTE_ROOM_COST);
+        setRoomCost(roomB, ROUTE_EMPTY_COST, ROUTE_ROOM_COST);
+        if (routed) {
+            // Like the L-shaped carve: the start cell is left out
+            for (size_t i = 1; i < path.size(); ++i) {
+                corridors.push_back({path[i].x, path[i].y});
+                router.cost(path[i].x, path[i].y) = ROUTE_CORRIDOR_COST;
+            }
+        }
+    }
+}
+
+void BSPBuilder::buildTileLists() {
+    floors.clear();
+    corridorTiles.clear();
+    walls.clear();
+    if (rooms.empty() && corridors.empty())
+        return;
+
+    // Occupancy bitmap over the bounding box, padded by one cell for walls
+    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+    for (const auto& room : rooms) {
+        minX = std::min(minX, room.position.x);
+        minY = std::min(minY, room.position.y);
+        maxX = std::max(maxX, room.position.x + room.size.x - 1);
+        maxY = std::max(maxY, room.position.y + room.size.y - 1);
+    }
+    for (const auto& tile : corridors) {
+        minX = std::min(minX, tile.x);
+        minY = std::min(minY, tile.y);
+        maxX = std::max(maxX, tile.x);
+        maxY = std::max(maxY, tile.y);
+    }
+    int originX = minX - 1;
+    int originY = minY - 1;
+    int width = maxX - minX + 3;
+    int height = maxY - minY + 3;
+    int words = (width + 63) / 64;
+    std::vector<uint64_t> placed((size_t)words * height, 0);
+    auto testAndSet = [&](int x, int y) {
+        uint64_t& word = placed[(size_t)(y - originY) * words + ((x - originX) >> 6)];
+        uint64_t bit = uint64_t(1) << ((x - originX) & 63);
+        bool wasSet = (word & bit) != 0;
+        word |= bit;
+        return wasSet;
+    };
+
+    // Add room floors
+    for (const auto& room : rooms) {
+        for (int y = room.position.y; y < room.position.y + room.size.y; ++y) {
+            for (int x = room.position.x; x < room.position.x + room.size.x; ++x) {
+                testAndSet(x, y);
+                floors.push_back({x, y});
+            }
+        }
+    }
+
+    // Add corridors (also added to floors so corridors have floor tiles)
+    for (const auto& tile : corridors) {
+        if (!testAndSet(tile.x, tile.y)) {
+            corridorTiles.push_back(tile);
+            floors.push_back(tile);
+        }
+    }
+
+    // Walls: the 3x3 dilation of the occupancy minus the occupancy, a word
+    // at a time. Collected row by row, then bucketed by column so the list
+    // comes out sorted by (x, y).
+    std::vector<uint64_t> spread((size_t)words * height, 0);
+    for (int y = 0; y < height; ++y) {
+        const uint64_t* row = &placed[(size_t)y * words];
+        uint64_t* out = &spread[(size_t)y * words];
+        for (int k = 0; k < words; ++k) {
+            uint64_t v = row[k] | (row[k] << 1) | (row[k] >> 1);
+            if (k > 0) v |= row[k - 1] >> 63;
+            if (k + 1 < words) v |= row[k + 1] << 63;
+            out[k] = v;
+        }
+    }
+    std::vector<BSPVec2i> rowOrder;
+    std::vector<int> columnCounts(width + 1, 0);
+    for (int y = 0; y < height; ++y) {
+        for (int k = 0; k < words; ++k) {
+            uint64_t v = spread[(size_t)y * words + k];
+            if (y > 0) v |= spread[(size_t)(y - 1) * words + k];
+            if (y + 1 < height) v |= spread[(size_t)(y + 1) * words + k];
+            v &= ~placed[(size_t)y * words + k];
+            for (int x = k * 64; v; ++x, v >>= 1) {
+                if (!(v & 1)) continue;
+                rowOrder.push_back({x, y});
+                columnCounts[x + 1]++;
+            }
+        }
+    }
+    for (int x = 0; x < width; ++x) columnCounts[x + 1] += columnCounts[x];
+    walls.resize(rowOrder.size());
+    for (const auto& cell : rowOrder) {
+        walls[columnCounts[cell.x]++] = {cell.x + originX, cell.y + originY};
+    }
+}
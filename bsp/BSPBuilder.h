@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "CorridorRouter.h"
+#include "CounterRng.h"
+
+// --- Data Structures (Pure C++) ---
+
+struct BSPVec2i {
+    int x, y;
+    BSPVec2i() : x(0), y(0) {}
+    BSPVec2i(int x, int y) : x(x), y(y) {}
+    bool operator==(const BSPVec2i& other) const { return x == other.x && y == other.y; }
+    bool operator<(const BSPVec2i& other) const {
+        if (x != other.x) return x < other.x;
+        return y < other.y;
+    }
+};
+
+struct BSPRect2i {
+    BSPVec2i position;
+    BSPVec2i size;
+    BSPVec2i center() const {
+        return { position.x + size.x / 2, position.y + size.y / 2 };
+    }
+};
+
+// One node of the flat BSP tree. Children are indices into the builder's
+// node array (-1 for none) and always come after their parent, so a reverse
+// scan visits children before parents.
+struct BSPNode {
+    BSPRect2i rect;
+    BSPRect2i room;
+    int left = -1;
+    int right = -1;
+    bool has_room = false;
+
+    // Centre of the first room in this subtree, searching left children
+    // first. Cached bottom-up once rooms are placed.
+    BSPVec2i point;
+    bool has_point = false;
+    int point_leaf = -1; // leaf whose room gives `point`
+
+    explicit BSPNode(const BSPRect2i& rect) : rect(rect) {}
+    bool isLeaf() const { return left < 0; }
+};
+
+struct BSPSettings {
+    int mapWidth = 64;
+    int mapHeight = 64;
+    int minRoomSize = 5;
+    int maxRoomSize = 12;
+    int maxSplits = 6;
+    int roomPadding = 1;
+    uint64_t seed = 0;
+    // Workers for room placement and corridor carving (0 = all hardware
+    // threads). Leave at 1 when builders already run in parallel. Output
+    // does not depend on this value.
+    int workerThreads = 1;
+    // Route corridors around rooms and along earlier corridors (A* over a
+    // cost map) instead of carving straight L shapes. Routing is sequential.
+    bool routeCorridors = false;
+};
+
+// --- The API Class ---
+//
+// One builder owns all state for a single run, so independent builders can
+// generate concurrently.
+
+class BSPBuilder {
+public:
+    void generate(const BSPSettings& settings);
+
+    const std::vector<BSPRect2i>& getRooms() const { return rooms; }
+    // The partition tree of the last run; node 0 is the root.
+    const std::vector<BSPNode>& getNodes() const { return nodes; }
+
+    // Room tiles followed by corridor tiles not already covered by a room.
+    const std::vector<BSPVec2i>& getFloors() const { return floors; }
+    const std::vector<BSPVec2i>& getCorridors() const { return corridorTiles; }
+    // Sorted, 8-neighbour ring around every floor tile.
+    const std::vector<BSPVec2i>& getWalls() const { return walls; }
+
+private:
+    BSPSettings cfg;
+    CounterStream rng{0};
+
+    // The tree lives in one array. Splitting draws from `rng` in
+    // breadth-first order; rooms and corridors then draw from substream i
+    // of `rng` for node i, so subtrees can be processed in any order on any
+    // thread.
+    std::vector<BSPNode> nodes;
+    std::vector<int> leaves;
+
+    std::vector<BSPRect2i> rooms;
+    std::vector<BSPVec2i> corridors;
+    CorridorRouter router;
+
+    std::vector<BSPVec2i> floors;
+    std::vector<BSPVec2i> corridorTiles;
+    std::vector<BSPVec2i> walls;
+
+    bool splitNode(int index);
+    void placeRooms();
+    void cacheRepresentativePoints();
+    void connectRooms();
+    void routeCorridors(const std::vector<int>& joins);
+    void buildTileLists();
+};
@@ -0,0 +1,414 @@
+#include "MapJobs.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "BSPBuilder.h"
+#include "DungeonBuilder.h"
+#include "MultiLevel.h"
+#include "OverlappingSolver.h"
+#include "TilingSolver.h"
+#include "WalkerBuilder.h"
+
+static void setCells(MapRecord& record, const std::vector<int>& cells, int width, int height) {
+    record.width = width;
+    record.height = height;
+    record.cells.assign(cells.begin(), cells.end());
+}
+
+// ============================================================================
+// Walker / BSP / Hybrid
+// ============================================================================
+
+class WalkerJob : public MapJob {
+public:
+    explicit WalkerJob(const ParamFile& params) {
+        settings.allowOverlap = params.getBool("walker.allow_overlap", settings.allowOverlap);
+        settings.minHall = (int)params.getInt("walker.min_hall", settings.minHall);
+        settings.maxHall = (int)params.getInt("walker.max_hall", settings.maxHall);
+        settings.roomDim = (int)params.getInt("walker.room_dim", settings.roomDim);
+        settings.totalFloorCount = (int)params.getInt("walker.total_floor_count", settings.totalFloorCount);
+    }
+
+    MapRecord generate(uint64_t seed) const override {
+        WalkerSettings run = settings;
+        run.seed = seed;
+        WalkerBuilder builder;
+        builder.generate(run);
+
+        MapRecord record;
+        record.seed = seed;
+        record.algorithm = MapAlgorithm::Walker;
+        rasterizeMap(builder.getFloors(), builder.getWalls(), record);
+        return record;
+    }
+
+private:
+    WalkerSettings settings;
+};
+
+class BSPJob : public MapJob {
+public:
+    explicit BSPJob(const ParamFile& params) {
+        settings.mapWidth = (int)params.getInt("bsp.map_width", settings.mapWidth);
+        settings.mapHeight = (int)params.getInt("bsp.map_height", settings.mapHeight);
+        settings.minRoomSize = (int)params.getInt("bsp.min_room_size", settings.minRoomSize);
+        settings.maxRoomSize = (int)params.getInt("bsp.max_room_size", settings.maxRoomSize);
+        settings.maxSplits = (int)params.getInt("bsp.max_splits", settings.maxSplits);
+        settings.roomPadding = (int)params.getInt("bsp.room_padding", settings.roomPadding);
+        settings.routeCorridors = params.getBool("bsp.route_corridors", settings.routeCorridors);
+    }
+
+    MapRecord generate(uint64_t seed) const override {
+        BSPSettings run = settings;
+        run.seed = seed;
+        BSPBuilder builder;
+        builder.generate(run);
+
+        MapRecord record;
+        record.seed = seed;
+        record.algorithm = MapAlgorithm::BSP;
+        rasterizeMap(builder.getFloors(), builder.getWalls(), record);
+        return record;
+    }
+
+private:
+    BSPSettings settings;
+};
+
+class HybridJob : public MapJob {
+public:
+    explicit HybridJob(const ParamFile& params) {
+        settings.roomCount = (int)params.getInt("hybrid.room_count", settings.roomCount);
+        settings.spreadRadius = (float)params.getFloat("hybrid.spread_radius", settings.spreadRadius);
+        settings.walkerCount = (int)params.getInt("hybrid.walker_count", settings.walkerCount);
+        settings.gridWidth = (int)params.getInt("hybrid.grid_width", settings.gridWidth);
+        settings.gridHeight = (int)params.getInt("hybrid.grid_height", settings.gridHeight);
+        settings.tileW = (int)params.getInt("hybrid.tile_w", settings.tileW);
+        settings.tileH = (int)params.getInt("hybrid.tile_h", settings.tileH);
+        settings.routeCorridors = params.getBool("hybrid.route_corridors", settings.routeCorridors);
+    }
+
+    MapRecord generate(uint64_t seed) const override {
+        GenSettings run = settings;
+        run.seed = seed;  // 0 still means "random", as in Godot
+        DungeonBuilder builder;
+        builder.generate(run);
+
+        MapRecord record;
+        record.seed = seed;
+        record.algorithm = MapAlgorithm::Hybrid;
+        rasterizeMap(builder.getFloors(), builder.getWalls(), record);
+        return record;
+    }
+
+private:
+    GenSettings settings;
+};
+
+// ============================================================================
+// Tiling WFC
+// ============================================================================
+
+static bool parseSymmetry(const std::string& token, Symmetry& out) {
+    // Letters, or the WFCConfiguration.SymmetryType values used from GDScript
+    if (token == "X" || token == "0") out = Symmetry::X;
+    else if (token == "I" || token == "1") out = Symmetry::I;
+    else if (token == "\\" || token == "backslash" || token == "2") out = Symmetry::backslash;
+    else if (token == "T" || token == "3") out = Symmetry::T;
+    else if (token == "L" || token == "4") out = Symmetry::L;
+    else if (token == "P" || token == "5") out = Symmetry::P;
+    else return false;
+    return true;
+}
+
+class TilingJob : public MapJob {
+public:
+    bool configure(const ParamFile& params, std::string& error) {
+        width = (int)params.getInt("tiling.width", width);
+        height = (int)params.getInt("tiling.height", height);
+        periodic = params.getBool("tiling.periodic", periodic);
+
+        // tiling.tile = <id> <symmetry> <weight> <size> <values...>
+        for (const std::string& line : params.getAll("tiling.tile")) {
+            std::istringstream in(line);
+            int id = 0, size = 0;
+            std::string symmetryToken;
+            double weight = 1.0;
+            Symmetry symmetry;
+            if (!(in >> id >> symmetryToken >> weight >> size) || !parseSymmetry(symmetryToken, symmetry)) {
+                error = "tiling.tile expects '<id> <symmetry> <weight> <size> <values...>': " + line;
+                return false;
+            }
+            std::string rest;
+            std::getline(in, rest);
+            std::vector<int> data;
+            if (!parseIntList(rest, data)) {
+                error = "tiling.tile has a non-integer value: " + line;
+                return false;
+            }
+            if (data.empty()) {
+                data.push_back(id);
+            }
+            problem.addTile(id, data, size, symmetry, weight);
+        }
+
+        // tiling.neighbor = <id1> <orientation1> <id2> <orientation2>
+        for (const std::string& line : params.getAll("tiling.neighbor")) {
+            std::vector<int> v;
+            if (!parseIntList(line, v) || v.size() != 4) {
+                error = "tiling.neighbor expects '<id1> <orientation1> <id2> <orientation2>': " + line;
+                return false;
+            }
+            problem.addNeighbor(v[0], v[1], v[2], v[3]);
+        }
+
+        // tiling.stamp = <id> <width> <height> <values...>
+        for (const std::string& line : params.getAll("tiling.stamp")) {
+            std::vector<int> v;
+            if (!parseIntList(line, v) || v.size() < 3 || !problem.setStamp(v[0], std::vector<int>(v.begin() + 3, v.end()), v[1], v[2])) {
+                error = "tiling.stamp expects '<tile id> <width> <height> <values...>' for a defined tile: " + line;
+                return false;
+            }
+        }
+
+        if (problem.tiles.empty()) {
+            error = "No tiles defined (tiling.tile)";
+            return false;
+        }
+        if (problem.neighbors.empty()) {
+            error = "No neighbor rules defined (tiling.neighbor)";
+            return false;
+        }
+        if (!problem.enableStamps((int)params.getInt("tiling.stamp_size", 0))) {
+            error = "tiling.stamp_size set but not all tiles have stamps defined";
+            return false;
+        }
+        return true;
+    }
+
+    MapRecord generate(uint64_t seed) const override {
+        TilingOutput out = solveTiling(problem, width, height, periodic, seed);
+
+        MapRecord record;
+        record.seed = seed;
+        record.algorithm = MapAlgorithm::TilingWFC;
+        record.success = out.success;
+        record.message = out.failureReason;
+        if (!out.success) {
+            return record;
+        }
+        if (problem.stampSize > 0) {
+            setCells(record, out.expanded, out.expandedWidth, out.expandedHeight);
+        } else {
+            setCells(record, out.tiles, out.width, out.height);
+        }
+        return record;
+    }
+
+private:
+    TilingProblem problem;
+    int width = 10;
+    int height = 10;
+    bool periodic = false;
+};
+
+// ============================================================================
+// Overlapping WFC
+// ============================================================================
+
+// Binary (P6) or ASCII (P3) PPM, 8 bits per channel, as 0xRRGGBB values.
+static bool loadPPM(const std::string& path, Array2D<int>& out, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "Cannot open seed image " + path;
+        return false;
+    }
+
+    auto readToken = [&in]() {
+        std::string token;
+        char c;
+        while (in.get(c)) {
+            if (c == '#') {
+                std::string skip;
+                std::getline(in, skip);
+            } else if (!std::isspace((unsigned char)c)) {
+                token.push_back(c);
+                break;
+            }
+        }
+        while (in.get(c) && !std::isspace((unsigned char)c)) {
+            token.push_back(c);
+        }
+        return token;
+    };
+
+    std::string magic = readToken();
+    int w = std::atoi(readToken().c_str());
+    int h = std::atoi(readToken().c_str());
+    int maxValue = std::atoi(readToken().c_str());
+    if ((magic != "P6" && magic != "P3") || w <= 0 || h <= 0 || maxValue <= 0 || maxValue > 255) {
+        error = path + " is not an 8-bit P3/P6 PPM image";
+        return false;
+    }
+
+    out = Array2D<int>(h, w);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int rgb[3];
+            for (int c = 0; c < 3; c++) {
+                if (magic == "P6") {
+                    char byte;
+                    if (!in.get(byte)) {
+                        error = path + " is truncated";
+                        return false;
+                    }
+                    rgb[c] = (unsigned char)byte;
+                } else {
+                    std::string token = readToken();
+                    if (token.empty()) {
+                        error = path + " is truncated";
+                        return false;
+                    }
+                    rgb[c] = std::atoi(token.c_str());
+                }
+                rgb[c] = rgb[c] * 255 / maxValue;
+            }
+            out.get(y, x) = (rgb[0] << 16) | (rgb[1] << 8) | rgb[2];
+        }
+    }
+    return true;
+}
+
+class OverlappingJob : public MapJob {
+public:
+    bool configure(const ParamFile& params, std::string& error) {
+        // Seed pattern: a PPM image, or inline rows of integer values
+        std::string imagePath = params.getString("overlapping.input");
+        std::vector<std::string> rows = params.getAll("overlapping.row");
+        if (!imagePath.empty()) {
+            if (!loadPPM(imagePath, problem.input, error)) {
+                return false;
+            }
+        } else if (!rows.empty()) {
+            std::vector<std::vector<int>> values(rows.size());
+            for (size_t y = 0; y < rows.size(); y++) {
+                if (!parseIntList(rows[y], values[y]) || values[y].empty() || values[y].size() != values[0].size()) {
+                    error = "overlapping.row values must be integers and every row the same length";
+                    return false;
+                }
+            }
+            problem.input = Array2D<int>(values.size(), values[0].size());
+            for (size_t y = 0; y < values.size(); y++) {
+                for (size_t x = 0; x < values[y].size(); x++) {
+                    problem.input.get(y, x) = values[y][x];
+                }
+            }
+        } else {
+            error = "No seed pattern provided (overlapping.input or overlapping.row)";
+            return false;
+        }
+
+        problem.options.periodic_input = params.getBool("overlapping.periodic_input", false);
+        problem.options.periodic_output = params.getBool("overlapping.periodic_output", false);
+        problem.options.out_width = (unsigned)params.getInt("overlapping.width", 48);
+        problem.options.out_height = (unsigned)params.getInt("overlapping.height", 48);
+        problem.options.symmetry = (unsigned)params.getInt("overlapping.symmetry", 8);
+        problem.options.ground = params.getBool("overlapping.ground", false);
+        problem.options.pattern_size = (unsigned)params.getInt("overlapping.pattern_size", 3);
+
+        // overlapping.mapping = <pattern colour> <tile id>
+        for (const std::string& line : params.getAll("overlapping.mapping")) {
+            std::vector<int> v;
+            if (!parseIntList(line, v) || v.size() != 2) {
+                error = "overlapping.mapping expects '<colour> <tile id>': " + line;
+                return false;
+            }
+            problem.patternToTile[v[0]] = v[1];
+        }
+        problem.hasMapping = !problem.patternToTile.empty();
+
+        // overlapping.stamp = <tile id> <width> <height> <values...>
+        for (const std::string& line : params.getAll("overlapping.stamp")) {
+            std::vector<int> v;
+            if (!parseIntList(line, v) || v.size() < 3) {
+                error = "overlapping.stamp expects '<tile id> <width> <height> <values...>': " + line;
+                return false;
+            }
+            OverlappingStamp stamp;
+            stamp.width = v[1];
+            stamp.height = v[2];
+            stamp.pattern.assign(v.begin() + 3, v.end());
+            problem.stamps[v[0]] = stamp;
+        }
+        problem.stampSize = (int)params.getInt("overlapping.stamp_size", 3);
+        problem.expandStamps = params.getBool("overlapping.use_stamps", false) && !problem.stamps.empty();
+        return true;
+    }
+
+    MapRecord generate(uint64_t seed) const override {
+        OverlappingOutput out = solveOverlapping(problem, seed);
+
+        MapRecord record;
+        record.seed = seed;
+        record.algorithm = MapAlgorithm::OverlappingWFC;
+        record.success = out.success;
+        record.message = out.failureReason;
+        if (!out.success) {
+            return record;
+        }
+        int width = (int)problem.options.out_width;
+        int height = (int)problem.options.out_height;
+        if (problem.expandStamps) {
+            setCells(record, out.expanded, out.expandedWidth, out.expandedHeight);
+        } else if (problem.hasMapping) {
+            setCells(record, out.tiles, width, height);
+        } else {
+            setCells(record, out.patterns, width, height);
+        }
+        return record;
+    }
+
+private:
+    OverlappingProblem problem;
+};
+
+// ============================================================================
+// Factory
+// ============================================================================
+
+std::unique_ptr<MapJob> makeMapJob(const ParamFile& params, std::string& error) {
+    std::string algorithm = params.getString("algorithm");
+    if (algorithm == "walker") {
+        return std::unique_ptr<MapJob>(new WalkerJob(params));
+    }
+    if (algorithm == "bsp") {
+        return std::unique_ptr<MapJob>(new BSPJob(params));
+    }
+    if (algorithm == "hybrid") {
+        return std::unique_ptr<MapJob>(new HybridJob(params));
+    }
+    if (algorithm == "tiling") {
+        std::unique_ptr<TilingJob> job(new TilingJob());
+        if (!job->configure(params, error)) return nullptr;
+        return job;
+    }
+    if (algorithm == "overlapping") {
+        std::unique_ptr<OverlappingJob> job(new OverlappingJob());
+        if (!job->configure(params, error)) return nullptr;
+        return job;
+    }
+    error = algorithm.empty() ? "No algorithm set (walker, bsp, hybrid, tiling, overlapping)"
+                              : "Unknown algorithm '" + algorithm + "'";
+    return nullptr;
+}
+
+const std::vector<std::string>& knownParamPrefixes() {
+    static const std::vector<std::string> prefixes = {
+        "algorithm", "output", "seed_start", "seed_count", "threads",
+        "walker.", "bsp.", "hybrid.", "tiling.", "overlapping."
+    };
+    return prefixes;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MapContainer.h"
+#include "ParamFile.h"
+
+// --- Generator jobs (Pure C++) ---
+//
+// A job holds one generator's settings, parsed once from the parameter file.
+// generate() only reads that state, so a single job is shared by every worker
+// thread.
+
+class MapJob {
+public:
+    virtual ~MapJob() = default;
+    virtual MapRecord generate(uint64_t seed) const = 0;
+};
+
+// Builds the job named by `algorithm` (walker, bsp, hybrid, tiling,
+// overlapping). Returns nullptr and sets `error` on invalid parameters.
+std::unique_ptr<MapJob> makeMapJob(const ParamFile& params, std::string& error);
+
+// Parameter keys understood by makeMapJob() and the CLI driver.
+const std::vector<std::string>& knownParamPrefixes();
@@ -0,0 +1,135 @@
+#include "ParamFile.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+static std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return std::string();
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+bool ParamFile::load(const std::string& path, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "Cannot open parameter file " + path;
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    if (!parse(text.str(), error)) {
+        error = path + ":" + error;
+        return false;
+    }
+    return true;
+}
+
+bool ParamFile::parse(const std::string& text, std::string& error) {
+    std::istringstream in(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            error = std::to_string(lineNumber) + ": expected 'key = value'";
+            return false;
+        }
+        std::string key = trim(line.substr(0, eq));
+        if (key.empty()) {
+            error = std::to_string(lineNumber) + ": missing key";
+            return false;
+        }
+        entries.push_back({key, trim(line.substr(eq + 1))});
+    }
+    return true;
+}
+
+void ParamFile::set(const std::string& key, const std::string& value) {
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&](const std::pair<std::string, std::string>& e) { return e.first == key; }),
+                  entries.end());
+    entries.push_back({key, value});
+}
+
+bool ParamFile::has(const std::string& key) const {
+    for (const auto& e : entries) {
+        if (e.first == key) return true;
+    }
+    return false;
+}
+
+std::string ParamFile::getString(const std::string& key, const std::string& fallback) const {
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if (it->first == key) return it->second;
+    }
+    return fallback;
+}
+
+long long ParamFile::getInt(const std::string& key, long long fallback) const {
+    std::string value = getString(key);
+    if (value.empty()) return fallback;
+    char* end = nullptr;
+    long long v = std::strtoll(value.c_str(), &end, 0);
+    return (end && *end == '\0') ? v : fallback;
+}
+
+double ParamFile::getFloat(const std::string& key, double fallback) const {
+    std::string value = getString(key);
+    if (value.empty()) return fallback;
+    char* end = nullptr;
+    double v = std::strtod(value.c_str(), &end);
+    return (end && *end == '\0') ? v : fallback;
+}
+
+bool ParamFile::getBool(const std::string& key, bool fallback) const {
+    std::string value = getString(key);
+    if (value == "true" || value == "1" || value == "yes" || value == "on") return true;
+    if (value == "false" || value == "0" || value == "no" || value == "off") return false;
+    return fallback;
+}
+
+std::vector<std::string> ParamFile::getAll(const std::string& key) const {
+    std::vector<std::string> values;
+    for (const auto& e : entries) {
+        if (e.first == key) values.push_back(e.second);
+    }
+    return values;
+}
+
+std::vector<std::string> ParamFile::unknownKeys(const std::vector<std::string>& knownPrefixes) const {
+    std::vector<std::string> unknown;
+    for (const auto& e : entries) {
+        bool known = false;
+        for (const auto& prefix : knownPrefixes) {
+            if (e.first == prefix || e.first.compare(0, prefix.size(), prefix) == 0) {
+                known = true;
+                break;
+            }
+        }
+        if (!known && std::find(unknown.begin(), unknown.end(), e.first) == unknown.end()) {
+            unknown.push_back(e.first);
+        }
+    }
+    return unknown;
+}
+
+bool parseIntList(const std::string& value, std::vector<int>& out) {
+    std::istringstream in(value);
+    std::string token;
+    out.clear();
+    while (in >> token) {
+        char* end = nullptr;
+        long v = std::strtol(token.c_str(), &end, 0);
+        if (!end || *end != '\0') return false;
+        out.push_back(static_cast<int>(v));
+    }
+    return true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+
+// --- Parameter file (Pure C++) ---
+//
+// One `key = value` pair per line; `#` starts a comment. Keys may repeat
+// (e.g. one `tiling.tile` line per tile), in which case getAll() returns
+// every value in file order and the scalar getters use the last one.
+
+class ParamFile {
+public:
+    bool load(const std::string& path, std::string& error);
+    bool parse(const std::string& text, std::string& error);
+
+    // Command-line overrides replace every earlier value of `key`.
+    void set(const std::string& key, const std::string& value);
+
+    bool has(const std::string& key) const;
+    std::string getString(const std::string& key, const std::string& fallback = "") const;
+    long long getInt(const std::string& key, long long fallback) const;
+    double getFloat(const std::string& key, double fallback) const;
+    bool getBool(const std::string& key, bool fallback) const;
+    std::vector<std::string> getAll(const std::string& key) const;
+
+    // Keys that no generator consumed, for typo warnings.
+    std::vector<std::string> unknownKeys(const std::vector<std::string>& knownPrefixes) const;
+
+private:
+    std::vector<std::pair<std::string, std::string>> entries;
+};
+
+// Splits a value on whitespace and parses every token as an integer.
+bool parseIntList(const std::string& value, std::vector<int>& out);
@@ -0,0 +1,208 @@
+// dungeon_cli - headless batch generation without Godot.
+//
+//   dungeon_cli generate <params> [--output FILE] [--seed-start N]
+//                                 [--seed-count N] [--threads N] [--append]
+//   dungeon_cli info <container>
+//   dungeon_cli dump <container> <seed>
+//
+// Every map is written to the container as soon as its worker finishes, so
+// memory use is bounded by the number of threads, not the seed count.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "MapContainer.h"
+#include "MapJobs.h"
+#include "Parallel.h"
+#include "ParamFile.h"
+
+static const char* algorithmName(MapAlgorithm algorithm) {
+    switch (algorithm) {
+        case MapAlgorithm::Walker: return "walker";
+        case MapAlgorithm::BSP: return "bsp";
+        case MapAlgorithm::Hybrid: return "hybrid";
+        case MapAlgorithm::TilingWFC: return "tiling";
+        case MapAlgorithm::OverlappingWFC: return "overlapping";
+    }
+    return "unknown";
+}
+
+static int usage() {
+    std::fprintf(stderr,
+        "usage:\n"
+        "  dungeon_cli generate <params> [--output FILE] [--seed-start N] [--seed-count N]\n"
+        "                                [--threads N] [--append]\n"
+        "  dungeon_cli info <container>\n"
+        "  dungeon_cli dump <container> <seed>\n");
+    return 2;
+}
+
+static int runGenerate(int argc, char** argv) {
+    if (argc < 3) return usage();
+
+    ParamFile params;
+    std::string error;
+    if (!params.load(argv[2], error)) {
+        std::fprintf(stderr, "error: %s\n", error.c_str());
+        return 1;
+    }
+
+    // Command-line flags override the parameter file
+    bool append = false;
+    for (int i = 3; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--append") {
+            append = true;
+        } else if (i + 1 < argc && (arg == "--output" || arg == "--seed-start" ||
+                                    arg == "--seed-count" || arg == "--threads")) {
+            std::string key = arg.substr(2);
+            for (char& c : key) {
+                if (c == '-') c = '_';
+            }
+            params.set(key, argv[++i]);
+        } else {
+            std::fprintf(stderr, "error: unknown argument '%s'\n", arg.c_str());
+            return usage();
+        }
+    }
+
+    for (const std::string& key : params.unknownKeys(knownParamPrefixes())) {
+        std::fprintf(stderr, "warning: unknown parameter '%s'\n", key.c_str());
+    }
+
+    std::unique_ptr<MapJob> job = makeMapJob(params, error);
+    if (!job) {
+        std::fprintf(stderr, "error: %s\n", error.c_str());
+        return 1;
+    }
+
+    std::string output = params.getString("output", "maps.dgmc");
+    uint64_t seedStart = (uint64_t)params.getInt("seed_start", 1);
+    long long seedCount = params.getInt("seed_count", 1);
+    int threads = (int)params.getInt("threads", 0);
+    if (seedCount <= 0 || seedCount > 0x7fffffff) {
+        std::fprintf(stderr, "error: seed_count must be in [1, 2147483647]\n");
+        return 1;
+    }
+    if (params.getString("algorithm") == "hybrid" && seedStart == 0) {
+        std::fprintf(stderr, "warning: hybrid seed 0 means 'random'; that map is not reproducible\n");
+    }
+
+    MapContainerWriter writer;
+    if (!writer.open(output, append, error)) {
+        std::fprintf(stderr, "error: %s\n", error.c_str());
+        return 1;
+    }
+
+    std::atomic<long long> failures{0};
+    std::atomic<bool> writeFailed{false};
+    auto start = std::chrono::steady_clock::now();
+
+    parallelFor((int)seedCount, threads, [&](int i) {
+        if (writeFailed.load()) return;
+        MapRecord record = job->generate(seedStart + (uint64_t)i);
+        if (!record.success) failures++;
+        if (!writer.write(record)) writeFailed = true;
+    });
+
+    bool closed = writer.close();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (writeFailed || !closed) {
+        std::fprintf(stderr, "error: failed writing %s\n", output.c_str());
+        return 1;
+    }
+    std::printf("%lld maps (%lld failed) -> %s in %.2fs (%d threads)\n",
+                seedCount, failures.load(), output.c_str(), seconds,
+                resolveThreadCount(threads, (int)seedCount));
+    return failures.load() == seedCount ? 1 : 0;
+}
+
+static int runInfo(int argc, char** argv) {
+    if (argc < 3) return usage();
+
+    MapContainerReader reader;
+    std::string error;
+    if (!reader.open(argv[2], error)) {
+        std::fprintf(stderr, "error: %s\n", error.c_str());
+        return 1;
+    }
+
+    const std::vector<MapIndexEntry>& index = reader.getIndex();
+    std::printf("%s: %zu records%s\n", argv[2], index.size(),
+                reader.hasFooter() ? "" : " (no index footer, recovered by scanning)");
+
+    size_t failed = 0;
+    for (size_t i = 0; i < index.size(); i++) {
+        MapRecord record;
+        if (!reader.read(i, record)) {
+            std::fprintf(stderr, "error: record %zu is corrupt\n", i);
+            return 1;
+        }
+        if (!record.success) failed++;
+        if (i < 10) {
+            std::printf("  seed %llu  %-11s %dx%d%s%s\n", (unsigned long long)record.seed,
+                        algorithmName(record.algorithm), record.width, record.height,
+                        record.success ? "" : "  FAILED: ", record.message.c_str());
+        }
+    }
+    if (index.size() > 10) std::printf("  ...\n");
+    std::printf("%zu failed\n", failed);
+    return 0;
+}
+
+static int runDump(int argc, char** argv) {
+    if (argc < 4) return usage();
+
+    MapContainerReader reader;
+    std::string error;
+    if (!reader.open(argv[2], error)) {
+        std::fprintf(stderr, "error: %s\n", error.c_str());
+        return 1;
+    }
+
+    MapRecord record;
+    uint64_t seed = std::strtoull(argv[3], nullptr, 0);
+    if (!reader.find(seed, record)) {
+        std::fprintf(stderr, "error: seed %llu not found\n", (unsigned long long)seed);
+        return 1;
+    }
+
+    std::printf("seed %llu  %s  %dx%d  origin (%d, %d)\n", (unsigned long long)record.seed,
+                algorithmName(record.algorithm), record.width, record.height,
+                record.originX, record.originY);
+    if (!record.success) {
+        std::printf("FAILED: %s\n", record.message.c_str());
+        return 0;
+    }
+
+    // Floor/wall generators as a picture; WFC outputs as raw values
+    bool cellMap = record.algorithm == MapAlgorithm::Walker || record.algorithm == MapAlgorithm::BSP ||
+                   record.algorithm == MapAlgorithm::Hybrid;
+    for (int y = 0; y < record.height; y++) {
+        for (int x = 0; x < record.width; x++) {
+            int v = record.cells[(size_t)y * record.width + x];
+            if (cellMap) {
+                std::putchar(v == MAP_CELL_FLOOR ? '.' : v == MAP_CELL_WALL ? '#' : ' ');
+            } else {
+                std::printf(x ? " %d" : "%d", v);
+            }
+        }
+        std::putchar('\n');
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+
+    std::string command = argv[1];
+    if (command == "generate") return runGenerate(argc, argv);
+    if (command == "info") return runInfo(argc, argv);
+    if (command == "dump") return runDump(argc, argv);
+    return usage();
+}
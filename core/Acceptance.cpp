@@ -0,0 +1,39 @@
+#include "Acceptance.h"
+
+#include "GridAnalysis.h"
+
+void gridFloorMask(const int* cells, int width, int height, int value, FloorMask& mask) {
+    mask.width = width;
+    mask.height = height;
+    mask.cells.resize(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < mask.cells.size(); i++) {
+        mask.cells[i] = cells[i] == value;
+    }
+}
+
+bool acceptsMap(const AcceptanceCriteria& criteria, const FloorMask& mask, int roomCount) {
+    if (roomCount < criteria.minRoomCount) return false;
+    if (criteria.maxRoomCount > 0 && roomCount > criteria.maxRoomCount) return false;
+
+    if (criteria.minFloorRatio > 0.0 || criteria.maxFloorRatio < 1.0) {
+        int64_t floors = 0;
+        for (uint8_t cell : mask.cells) floors += cell;
+        double ratio = mask.cells.empty() ? 0.0 : static_cast<double>(floors) / mask.cells.size();
+        if (ratio < criteria.minFloorRatio || ratio > criteria.maxFloorRatio) return false;
+    }
+
+    if (criteria.maxRegions > 0 || criteria.minLargestRegion > 0) {
+        // Candidates already run one per worker
+        ComponentLabels regions = labelComponents(mask.cells.data(), mask.width, mask.height, 1);
+        if (criteria.maxRegions > 0 && regions.count() > criteria.maxRegions) return false;
+        int largest = regions.largest();
+        int64_t largestSize = largest >= 0 ? regions.sizes[largest] : 0;
+        if (largestSize < criteria.minLargestRegion) return false;
+    }
+
+    if (criteria.minCriticalPath > 0) {
+        CellPair pair = farthestPair(mask.cells.data(), mask.width, mask.height);
+        if (pair.distance < criteria.minCriticalPath) return false;
+    }
+    return true;
+}
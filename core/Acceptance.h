@@ -0,0 +1,94 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include "Parallel.h"
+
+// --- Acceptance checks and retry-until-valid (Pure C++) ---
+//
+// A declarative set of limits a generated map must meet, evaluated on its
+// floor mask right after generation. Rejected candidates never leave
+// native code. Checks run cheapest first: room counts, floor ratio, region
+// labelling, then a two-sweep BFS for the critical path.
+
+struct AcceptanceCriteria {
+    double minFloorRatio = 0.0;   // floor cells / mask area
+    double maxFloorRatio = 1.0;
+    int maxRegions = 0;           // 4-connected floor regions; 0 = no limit
+    int64_t minLargestRegion = 0; // cells in the largest region
+    int minRoomCount = 0;
+    int maxRoomCount = 0;         // 0 = no limit
+    int minCriticalPath = 0;      // steps between the farthest pair of cells
+};
+
+struct FloorMask {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> cells;
+};
+
+// Floor points (anything with integer x / y) over their bounding box.
+template <typename Point>
+void rasterizePoints(const std::vector<Point>& points, FloorMask& mask) {
+    mask = FloorMask();
+    if (points.empty()) return;
+    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+    for (const Point& p : points) {
+        minX = std::min(minX, static_cast<int>(p.x));
+        minY = std::min(minY, static_cast<int>(p.y));
+        maxX = std::max(maxX, static_cast<int>(p.x));
+        maxY = std::max(maxY, static_cast<int>(p.y));
+    }
+    mask.width = maxX - minX + 1;
+    mask.height = maxY - minY + 1;
+    mask.cells.assign(static_cast<size_t>(mask.width) * mask.height, 0);
+    for (const Point& p : points) {
+        mask.cells[static_cast<size_t>(p.y - minY) * mask.width + (p.x - minX)] = 1;
+    }
+}
+
+// Cells equal to `value` in a row-major grid.
+void gridFloorMask(const int* cells, int width, int height, int value, FloorMask& mask);
+
+bool acceptsMap(const AcceptanceCriteria& criteria, const FloorMask& mask, int roomCount);
+
+struct AcceptedCandidate {
+    int index = -1;    // first accepted candidate, -1 when none passed
+    int slot = -1;     // slot it was generated in
+    int attempts = 0;  // candidates up to and including it (or all tried)
+};
+
+// Slots firstAccepted() uses: one candidate per slot and wave.
+inline int acceptanceSlotCount(int maxAttempts, int threads) {
+    return resolveThreadCount(threads, std::max(1, maxAttempts));
+}
+
+// Calls attempt(candidate, slot) for candidates 0, 1, 2, ... until one
+// returns true or `maxAttempts` are used. Candidates run in waves of
+// `threads` (0 = all hardware threads); `slot` is the candidate's position
+// in its wave, so callers keep acceptanceSlotCount() builders and find the
+// winner's output in the winning slot. Every lower candidate is evaluated
+// before a higher one can win, so the winner does not depend on the
+// thread count.
+template <typename Attempt>
+AcceptedCandidate firstAccepted(int maxAttempts, int threads, Attempt&& attempt) {
+    AcceptedCandidate found;
+    int wave = acceptanceSlotCount(maxAttempts, threads);
+    std::vector<uint8_t> passed(wave);
+    for (int start = 0; start < maxAttempts; start += wave) {
+        int count = std::min(wave, maxAttempts - start);
+        parallelFor(count, wave, [&](int slot) { passed[slot] = attempt(start + slot, slot) ? 1 : 0; });
+        for (int slot = 0; slot < count; slot++) {
+            if (passed[slot]) {
+                found.index = start + slot;
+                found.slot = slot;
+                found.attempts = start + slot + 1;
+                return found;
+            }
+        }
+        found.attempts = start + count;
+    }
+    return found;
+}
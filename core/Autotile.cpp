@@ -0,0 +1,41 @@
+#include "Autotile.h"
+#include <algorithm>
+
+void computeBitmasks(const uint8_t* mask, int width, int height, int neighbours, std::vector<uint8_t>& out) {
+    out.assign((size_t)std::max(width, 0) * std::max(height, 0), 0);
+    if (width <= 0 || height <= 0) return;
+
+    // 0/1 cells with a clear border, so every neighbour read is in bounds
+    int stride = width + 2;
+    std::vector<uint8_t> cells((size_t)stride * (height + 2), 0);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* src = mask + (size_t)y * width;
+        uint8_t* dst = &cells[(size_t)(y + 1) * stride + 1];
+        for (int x = 0; x < width; ++x) dst[x] = src[x] != 0;
+    }
+
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* up = &cells[(size_t)y * stride + 1];
+        const uint8_t* row = up + stride;
+        const uint8_t* down = row + stride;
+        uint8_t* dst = &out[(size_t)y * width];
+
+        if (neighbours == 4) {
+            for (int x = 0; x < width; ++x) {
+                uint8_t bits = up[x] | (row[x + 1] << 1) | (down[x] << 2) | (row[x - 1] << 3);
+                dst[x] = bits & (uint8_t)-row[x];
+            }
+            continue;
+        }
+
+        for (int x = 0; x < width; ++x) {
+            uint8_t n = up[x], e = row[x + 1], s = down[x], w = row[x - 1];
+            uint8_t ne = up[x + 1] & n & e;
+            uint8_t se = down[x + 1] & s & e;
+            uint8_t sw = down[x - 1] & s & w;
+            uint8_t nw = up[x - 1] & n & w;
+            uint8_t bits = n | (ne << 1) | (e << 2) | (se << 3) | (s << 4) | (sw << 5) | (w << 6) | (nw << 7);
+            dst[x] = bits & (uint8_t)-row[x];
+        }
+    }
+}
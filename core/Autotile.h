@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// --- Autotile bitmasks for grid masks (Pure C++) ---
+//
+// Masks are row-major width * height byte arrays; non-zero cells are "set".
+// Cells outside the grid count as clear.
+//
+// 4-neighbour masks:  N = 1, E = 2, S = 4, W = 8 (16 values)
+// 8-neighbour masks:  N = 1, NE = 2, E = 4, SE = 8, S = 16, SW = 32, W = 64,
+//                     NW = 128, where a corner bit is only set when both of
+//                     its edge neighbours are too ("blob" tiles: 47 values)
+// Clear cells get 0.
+
+// One sweep over the grid: rows are padded once, then every row is built
+// from its neighbours with branch-free byte operations the compiler can
+// vectorise. `neighbours` is 4 or 8; `out` gets width * height entries.
+void computeBitmasks(const uint8_t* mask, int width, int height, int neighbours, std::vector<uint8_t>& out);
+
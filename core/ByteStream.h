@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// --- Little-endian byte buffers (Pure C++) ---
+//
+// Every multi-byte value is written least significant byte first, so the
+// encoded bytes are identical on every platform.
+
+class ByteWriter {
+public:
+    void putU8(uint8_t v) { bytes.push_back(v); }
+    void putU16(uint16_t v) { putLE(v, 2); }
+    void putU32(uint32_t v) { putLE(v, 4); }
+    void putU64(uint64_t v) { putLE(v, 8); }
+    void putI32(int32_t v) { putLE(static_cast<uint32_t>(v), 4); }
+    void putBytes(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        bytes.insert(bytes.end(), p, p + size);
+    }
+    void putString(const std::string& s) {
+        putU32(static_cast<uint32_t>(s.size()));
+        putBytes(s.data(), s.size());
+    }
+    void putF32(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, 4);
+        putU32(bits);
+    }
+
+    // LEB128: 7 bits per byte, high bit set on all but the last byte.
+    void putVarU(uint64_t v) {
+        while (v >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(v));
+    }
+    // Zigzag maps small negative numbers to small unsigned ones.
+    void putVarI(int64_t v) {
+        putVarU((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+    }
+
+    // Overwrites 4 bytes at `offset` (e.g. a size field reserved earlier).
+    void patchU32(size_t offset, uint32_t v) {
+        for (int i = 0; i < 4; ++i) bytes[offset + i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+
+    size_t size() const { return bytes.size(); }
+    const std::vector<uint8_t>& data() const { return bytes; }
+    std::vector<uint8_t>& data() { return bytes; }
+    void clear() { bytes.clear(); }
+
+private:
+    std::vector<uint8_t> bytes;
+
+    void putLE(uint64_t v, int count) {
+        for (int i = 0; i < count; ++i) bytes.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+};
+
+// Reading past the end returns zeros and clears ok(); callers check ok() once
+// after decoding instead of after every field.
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data(data), length(size) {}
+    explicit ByteReader(const std::vector<uint8_t>& bytes) : data(bytes.data()), length(bytes.size()) {}
+
+    uint8_t getU8() { return static_cast<uint8_t>(getLE(1)); }
+    uint16_t getU16() { return static_cast<uint16_t>(getLE(2)); }
+    uint32_t getU32() { return static_cast<uint32_t>(getLE(4)); }
+    uint64_t getU64() { return getLE(8); }
+    int32_t getI32() { return static_cast<int32_t>(static_cast<uint32_t>(getLE(4))); }
+    bool getBytes(void* out, size_t size) {
+        if (!require(size)) return false;
+        std::memcpy(out, data + pos, size);
+        pos += size;
+        return true;
+    }
+    float getF32() {
+        uint32_t bits = getU32();
+        float v;
+        std::memcpy(&v, &bits, 4);
+        return v;
+    }
+    uint64_t getVarU() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!require(1)) return 0;
+            uint8_t b = data[pos++];
+            v |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        good = false;
+        return 0;
+    }
+    int64_t getVarI() {
+        uint64_t v = getVarU();
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+    std::string getString() {
+        uint32_t size = getU32();
+        if (!require(size)) return std::string();
+        std::string s(reinterpret_cast<const char*>(data + pos), size);
+        pos += size;
+        return s;
+    }
+
+    bool ok() const { return good; }
+    size_t position() const { return pos; }
+    size_t remaining() const { return length - pos; }
+    const uint8_t* current() const { return data + pos; }
+    bool skip(size_t size) {
+        if (!require(size)) return false;
+        pos += size;
+        return true;
+    }
+
+private:
+    const uint8_t* data;
+    size_t length;
+    size_t pos = 0;
+    bool good = true;
+
+    bool require(size_t size) {
+        if (!good || size > length - pos) {
+            good = false;
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t getLE(int count) {
+        if (!require(count)) return 0;
+        uint64_t v = 0;
+        for (int i = 0; i < count; ++i) v |= static_cast<uint64_t>(data[pos + i]) << (8 * i);
+        pos += count;
+        return v;
+    }
+};
@@ -0,0 +1,259 @@
+#include "CompactCodec.h"
+#include <algorithm>
+
+static const uint8_t BLOB_MAGIC[3] = {'D', 'G', 'R'};
+static const uint8_t BLOB_VERSION = 1;
+static const uint8_t BLOB_FLAG_LZ = 1;
+
+static const uint8_t GRID_BITPACK = 0;
+static const uint8_t GRID_RLE = 1;
+
+// ============================================================================
+// Grids
+// ============================================================================
+
+static size_t varSize(uint64_t v) {
+    size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+void encodeGrid(const int32_t* cells, size_t count, ByteWriter& out) {
+    if (count == 0) {
+        out.putU8(GRID_RLE);
+        out.putVarI(0);
+        return;
+    }
+
+    int64_t minValue = *std::min_element(cells, cells + count);
+    int64_t maxValue = *std::max_element(cells, cells + count);
+    uint64_t range = static_cast<uint64_t>(maxValue - minValue);
+    int bits = 0;
+    while (bits < 32 && (range >> bits) != 0) bits++;
+
+    // Size both encodings before writing either
+    size_t packedSize = (count * bits + 7) / 8 + 1;
+    size_t rleSize = 0;
+    for (size_t i = 0; i < count;) {
+        size_t run = 1;
+        while (i + run < count && cells[i + run] == cells[i]) run++;
+        rleSize += varSize(static_cast<uint64_t>(cells[i] - minValue)) + varSize(run);
+        i += run;
+    }
+
+    if (rleSize < packedSize) {
+        out.putU8(GRID_RLE);
+        out.putVarI(minValue);
+        for (size_t i = 0; i < count;) {
+            size_t run = 1;
+            while (i + run < count && cells[i + run] == cells[i]) run++;
+            out.putVarU(static_cast<uint64_t>(cells[i] - minValue));
+            out.putVarU(run);
+            i += run;
+        }
+        return;
+    }
+
+    out.putU8(GRID_BITPACK);
+    out.putVarI(minValue);
+    out.putU8(static_cast<uint8_t>(bits));
+    uint64_t acc = 0;
+    int accBits = 0;
+    for (size_t i = 0; i < count; i++) {
+        acc |= static_cast<uint64_t>(cells[i] - minValue) << accBits;
+        accBits += bits;
+        while (accBits >= 8) {
+            out.putU8(static_cast<uint8_t>(acc));
+            acc >>= 8;
+            accBits -= 8;
+        }
+    }
+    if (accBits > 0) out.putU8(static_cast<uint8_t>(acc));
+}
+
+bool decodeGrid(ByteReader& in, int32_t* cells, size_t count) {
+    uint8_t mode = in.getU8();
+    int64_t minValue = in.getVarI();
+    if (!in.ok()) return false;
+
+    if (mode == GRID_RLE) {
+        size_t filled = 0;
+        while (filled < count) {
+            int64_t value = static_cast<int64_t>(in.getVarU()) + minValue;
+            uint64_t run = in.getVarU();
+            if (!in.ok() || run == 0 || run > count - filled) return false;
+            std::fill(cells + filled, cells + filled + run, static_cast<int32_t>(value));
+            filled += run;
+        }
+        return true;
+    }
+
+    if (mode != GRID_BITPACK) return false;
+    int bits = in.getU8();
+    if (!in.ok() || bits > 32) return false;
+    size_t byteCount = (count * bits + 7) / 8;
+    if (in.remaining() < byteCount) return false;
+
+    const uint8_t* src = in.current();
+    uint64_t mask = bits == 32 ? 0xffffffffull : ((1ull << bits) - 1);
+    uint64_t acc = 0;
+    int accBits = 0;
+    size_t next = 0;
+    for (size_t i = 0; i < count; i++) {
+        while (accBits < bits) {
+            acc |= static_cast<uint64_t>(src[next++]) << accBits;
+            accBits += 8;
+        }
+        cells[i] = static_cast<int32_t>(static_cast<int64_t>(acc & mask) + minValue);
+        acc >>= bits;
+        accBits -= bits;
+    }
+    in.skip(byteCount);
+    return true;
+}
+
+// ============================================================================
+// LZ
+// ============================================================================
+
+static const size_t LZ_MIN_MATCH = 4;
+static const int LZ_HASH_BITS = 14;
+
+static inline uint32_t lzHash(const uint8_t* p) {
+    uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+std::vector<uint8_t> lzCompress(const uint8_t* data, size_t size) {
+    ByteWriter out;
+    std::vector<int64_t> table(size_t(1) << LZ_HASH_BITS, -1);
+
+    size_t literalStart = 0;
+    size_t i = 0;
+    while (i + LZ_MIN_MATCH <= size) {
+        uint32_t h = lzHash(data + i);
+        int64_t candidate = table[h];
+        table[h] = static_cast<int64_t>(i);
+
+        if (candidate >= 0 && std::equal(data + candidate, data + candidate + LZ_MIN_MATCH, data + i)) {
+            size_t match = LZ_MIN_MATCH;
+            while (i + match < size && data[candidate + match] == data[i + match]) match++;
+
+            out.putVarU(i - literalStart);
+            out.putBytes(data + literalStart, i - literalStart);
+            out.putVarU(match - LZ_MIN_MATCH);
+            out.putVarU(i - static_cast<size_t>(candidate));
+
+            // Index a few positions inside the match so later repeats find it
+            size_t end = i + match;
+            for (size_t j = i + 1; j + LZ_MIN_MATCH <= size && j < end; j += 2) {
+                table[lzHash(data + j)] = static_cast<int64_t>(j);
+            }
+            i = end;
+            literalStart = i;
+        } else {
+            i++;
+        }
+    }
+
+    out.putVarU(size - literalStart);
+    out.putBytes(data + literalStart, size - literalStart);
+    return std::move(out.data());
+}
+
+bool lzDecompress(const uint8_t* data, size_t size, uint8_t* out, size_t outSize) {
+    ByteReader in(data, size);
+    size_t written = 0;
+    for (;;) {
+        uint64_t literals = in.getVarU();
+        if (!in.ok() || literals > outSize - written) return false;
+        if (!in.getBytes(out + written, literals)) return false;
+        written += literals;
+        if (written == outSize) return in.remaining() == 0;
+
+        uint64_t match = in.getVarU() + LZ_MIN_MATCH;
+        uint64_t offset = in.getVarU();
+        if (!in.ok() || offset == 0 || offset > written || match > outSize - written) return false;
+        // Byte by byte: the source may overlap the bytes being written
+        const uint8_t* src = out + written - offset;
+        for (uint64_t k = 0; k < match; k++) out[written + k] = src[k];
+        written += match;
+    }
+}
+
+// ============================================================================
+// Blob envelope
+// ============================================================================
+
+std::vector<uint8_t> writeBlob(uint8_t kind, const std::vector<uint8_t>& body, bool compress) {
+    std::vector<uint8_t> packed;
+    if (compress && !body.empty()) {
+        packed = lzCompress(body.data(), body.size());
+    }
+    bool useLz = !packed.empty() && packed.size() + varSize(packed.size()) < body.size();
+
+    ByteWriter out;
+    out.putBytes(BLOB_MAGIC, 3);
+    out.putU8(BLOB_VERSION);
+    out.putU8(kind);
+    out.putU8(useLz ? BLOB_FLAG_LZ : 0);
+    out.putVarU(body.size());
+    if (useLz) {
+        out.putVarU(packed.size());
+        out.putBytes(packed.data(), packed.size());
+    } else {
+        out.putBytes(body.data(), body.size());
+    }
+    return std::move(out.data());
+}
+
+bool openBlob(const uint8_t* data, size_t size, uint8_t kind, std::vector<uint8_t>& scratch,
+              const uint8_t*& body, size_t& bodySize, std::string& error) {
+    ByteReader in(data, size);
+    uint8_t magic[3] = {0, 0, 0};
+    in.getBytes(magic, 3);
+    uint8_t version = in.getU8();
+    uint8_t blobKind = in.getU8();
+    uint8_t flags = in.getU8();
+    uint64_t rawSize = in.getVarU();
+
+    if (!in.ok() || !std::equal(magic, magic + 3, BLOB_MAGIC)) {
+        error = "not a dungeon result blob";
+        return false;
+    }
+    if (version > BLOB_VERSION) {
+        error = "blob version " + std::to_string(version) + " is newer than this build supports";
+        return false;
+    }
+    if (blobKind != kind) {
+        error = "blob holds a different result type";
+        return false;
+    }
+
+    if (!(flags & BLOB_FLAG_LZ)) {
+        if (in.remaining() != rawSize) {
+            error = "blob is truncated";
+            return false;
+        }
+        body = in.current();
+        bodySize = rawSize;
+        return true;
+    }
+
+    uint64_t storedSize = in.getVarU();
+    if (!in.ok() || in.remaining() != storedSize || rawSize > (uint64_t(1) << 32)) {
+        error = "blob is truncated";
+        return false;
+    }
+    scratch.resize(rawSize);
+    if (!lzDecompress(in.current(), storedSize, scratch.data(), rawSize)) {
+        error = "blob is corrupt";
+        return false;
+    }
+    body = scratch.data();
+    bodySize = rawSize;
+    return true;
+}
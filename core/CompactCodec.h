@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ByteStream.h"
+
+// --- Compact encodings for generator output (Pure C++) ---
+
+// Grids: row-major int32 cells, written as whichever is smaller of
+//   bit-packed  u8 0, varint min, u8 bits, (value - min) packed LSB first
+//   run-length  u8 1, varint min, { varint (value - min), varint run }*
+// The cell count is not stored; the caller writes the dimensions.
+void encodeGrid(const int32_t* cells, size_t count, ByteWriter& out);
+// Decodes straight into `cells` (e.g. a PackedInt32Array's buffer).
+bool decodeGrid(ByteReader& in, int32_t* cells, size_t count);
+
+// Byte-oriented LZ77: { varint literals, bytes, varint matchLen - 4,
+// varint offset }*, ending after the last literal run. No dictionary or
+// entropy stage - small code, fast decode, and typically 2-4x on top of the
+// grid encodings above.
+std::vector<uint8_t> lzCompress(const uint8_t* data, size_t size);
+bool lzDecompress(const uint8_t* data, size_t size, uint8_t* out, size_t outSize);
+
+// Self-describing blob around an encoded body:
+//   "DGR" u8 version u8 kind u8 flags varint bodySize [varint storedSize] body
+// flags bit 0 = body is LZ compressed (storedSize bytes follow). Compression
+// is skipped when it does not make the body smaller.
+std::vector<uint8_t> writeBlob(uint8_t kind, const std::vector<uint8_t>& body, bool compress);
+
+// Points `body` into `data` when the blob is uncompressed (no copy);
+// otherwise decompresses into `scratch` and points there.
+bool openBlob(const uint8_t* data, size_t size, uint8_t kind, std::vector<uint8_t>& scratch,
+              const uint8_t*& body, size_t& bodySize, std::string& error);
@@ -0,0 +1,129 @@
+#include "CorridorRouter.h"
+#include <algorithm>
+#include <cstdlib>
+
+static const int DIR_X[4] = {1, -1, 0, 0};
+static const int DIR_Y[4] = {0, 0, 1, -1};
+
+// Min-heap order; ties go to the deeper node, then the lower cell index,
+// so routes never depend on heap internals.
+static bool openAfter(uint32_t fa, uint32_t ga, int32_t ca, uint32_t fb, uint32_t gb, int32_t cb) {
+    if (fa != fb) return fa > fb;
+    if (ga != gb) return ga < gb;
+    return ca > cb;
+}
+
+void CorridorRouter::reset(int width, int height, uint8_t fill) {
+    gridWidth = std::max(0, width);
+    gridHeight = std::max(0, height);
+    costs.assign((size_t)gridWidth * gridHeight, fill);
+}
+
+bool CorridorRouter::route(RoutePoint from, RoutePoint to, std::vector<RoutePoint>& path) {
+    auto inGrid = [&](RoutePoint p) { return p.x >= 0 && p.y >= 0 && p.x < gridWidth && p.y < gridHeight; };
+    if (!inGrid(from) || !inGrid(to) || cost(from.x, from.y) == BLOCKED || cost(to.x, to.y) == BLOCKED)
+        return false;
+
+    int x0 = 0, y0 = 0, x1 = gridWidth - 1, y1 = gridHeight - 1;
+    if (searchMargin >= 0) {
+        x0 = std::max(x0, std::min(from.x, to.x) - searchMargin);
+        y0 = std::max(y0, std::min(from.y, to.y) - searchMargin);
+        x1 = std::min(x1, std::max(from.x, to.x) + searchMargin);
+        y1 = std::min(y1, std::max(from.y, to.y) + searchMargin);
+    }
+    int w = x1 - x0 + 1;
+    size_t area = (size_t)w * (y1 - y0 + 1);
+    if (stamp.size() < area) {
+        stamp.assign(area, 0);
+        gScore.resize(area);
+        cameFrom.resize(area);
+        generation = 0;
+    }
+    if (generation >= 0x7FFFFFFEu) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        generation = 0;
+    }
+    generation++;
+    const uint32_t reached = generation * 2;
+    const uint32_t closed = reached + 1;
+
+    auto heuristic = [&](int x, int y) {
+        return (uint32_t)((std::abs(x - to.x) + std::abs(y - to.y)) * heuristicCost);
+    };
+    auto push = [&](uint32_t f, uint32_t g, int32_t cell) {
+        open.push_back({f, g, cell});
+        std::push_heap(open.begin(), open.end(), [](const OpenEntry& a, const OpenEntry& b) {
+            return openAfter(a.f, a.g, a.cell, b.f, b.g, b.cell);
+        });
+    };
+
+    open.clear();
+    int32_t start = (from.y - y0) * w + (from.x - x0);
+    int32_t goal = (to.y - y0) * w + (to.x - x0);
+    stamp[start] = reached;
+    gScore[start] = 0;
+    push(heuristic(from.x, from.y), 0, start);
+
+    bool found = false;
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), [](const OpenEntry& a, const OpenEntry& b) {
+            return openAfter(a.f, a.g, a.cell, b.f, b.g, b.cell);
+        });
+        OpenEntry top = open.back();
+        open.pop_back();
+        if (stamp[top.cell] == closed || top.g != gScore[top.cell])
+            continue;
+        stamp[top.cell] = closed;
+        if (top.cell == goal) {
+            found = true;
+            break;
+        }
+
+        int lx = top.cell % w;
+        int ly = top.cell / w;
+        for (int d = 0; d < 4; ++d) {
+            int nx = lx + DIR_X[d];
+            int ny = ly + DIR_Y[d];
+            if (nx < 0 || ny < 0 || nx >= w || ny > y1 - y0)
+                continue;
+            uint8_t c = cost(nx + x0, ny + y0);
+            if (c == BLOCKED)
+                continue;
+            int32_t next = ny * w + nx;
+            uint32_t g = top.g + c;
+            if (stamp[next] == closed || (stamp[next] == reached && gScore[next] <= g))
+                continue;
+            stamp[next] = reached;
+            gScore[next] = g;
+            cameFrom[next] = (uint8_t)d;
+            push(g + heuristic(nx + x0, ny + y0), g, next);
+        }
+    }
+    if (!found)
+        return false;
+
+    size_t first = path.size();
+    for (int32_t cell = goal;;) {
+        int lx = cell % w;
+        int ly = cell / w;
+        path.push_back({lx + x0, ly + y0});
+        if (cell == start) break;
+        int d = cameFrom[cell];
+        cell = (ly - DIR_Y[d]) * w + (lx - DIR_X[d]);
+    }
+    std::reverse(path.begin() + first, path.end());
+    return true;
+}
+
+int CorridorRouter::routeAll(const std::vector<RouteRequest>& requests, uint8_t carvedCost,
+                             std::vector<std::vector<RoutePoint>>& paths) {
+    paths.assign(requests.size(), {});
+    int routed = 0;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (!route(requests[i].from, requests[i].to, paths[i]))
+            continue;
+        for (const RoutePoint& p : paths[i]) cost(p.x, p.y) = carvedCost;
+        routed++;
+    }
+    return routed;
+}
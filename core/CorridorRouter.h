@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// --- Corridor routing over a cost grid (Pure C++) ---
+//
+// A* on a 4-connected grid where every cell has a cost of entering it
+// (1-254, or BLOCKED). Generators fill the costs so corridors prefer cells
+// that are already corridor and avoid room interiors, then route all their
+// connections through one router: search buffers are generation-stamped and
+// kept between calls, so a route only touches the cells it explores.
+
+struct RoutePoint {
+    int x, y;
+};
+
+struct RouteRequest {
+    RoutePoint from, to;
+};
+
+class CorridorRouter {
+public:
+    static const uint8_t BLOCKED = 255;
+
+    // Sizes the cost grid and sets every cell to `fill`.
+    void reset(int width, int height, uint8_t fill);
+
+    int width() const { return gridWidth; }
+    int height() const { return gridHeight; }
+    uint8_t& cost(int x, int y) { return costs[(size_t)y * gridWidth + x]; }
+    uint8_t cost(int x, int y) const { return costs[(size_t)y * gridWidth + x]; }
+
+    // Searches only the endpoints' bounding box grown by `margin` cells
+    // (< 0 = the whole grid). Bounds memory and time on very large grids.
+    void setSearchMargin(int margin) { searchMargin = margin; }
+
+    // Cost per step the heuristic assumes. The default 1 (the cheapest
+    // cell) gives least-cost paths; the cost of an empty cell searches far
+    // less of the grid and still strongly prefers cheap cells.
+    void setHeuristicCost(int costPerStep) { heuristicCost = costPerStep; }
+
+    // Appends the path from `from` to `to`, both included, to `path`.
+    // Returns false (and leaves `path` alone) when there is none.
+    bool route(RoutePoint from, RoutePoint to, std::vector<RoutePoint>& path);
+
+    // Routes the requests in order; after each one its cells cost
+    // `carvedCost`, so later corridors join earlier ones. paths[i] is empty
+    // for requests with no route. Returns the number routed.
+    int routeAll(const std::vector<RouteRequest>& requests, uint8_t carvedCost,
+                 std::vector<std::vector<RoutePoint>>& paths);
+
+private:
+    struct OpenEntry {
+        uint32_t f, g;
+        int32_t cell;
+    };
+
+    int gridWidth = 0;
+    int gridHeight = 0;
+    std::vector<uint8_t> costs;
+    int searchMargin = -1;
+    int heuristicCost = 1;
+
+    // Indexed by cell in the current search window. stamp = generation * 2
+    // once a cell has been reached, + 1 once it is closed; older stamps mean
+    // "unvisited", so nothing is cleared between searches.
+    std::vector<uint32_t> stamp;
+    std::vector<uint32_t> gScore;
+    std::vector<uint8_t> cameFrom; // direction of the step into the cell
+    std::vector<OpenEntry> open;
+    uint32_t generation = 0;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+
+// --- Counter-based random numbers (Pure C++) ---
+//
+// counterRandom(key, counter) is a pure function: a stream is just a key,
+// and its n-th value is computed directly from n. Streams therefore need no
+// shared state and give the same values in any evaluation order or thread.
+//
+// This is the one random source of the generators. Unlike std::mt19937 with
+// the std:: distributions, whose algorithms differ between standard
+// libraries, every value below is a fixed formula over 64-bit integers, so
+// a seed gives the same map with any compiler on any platform.
+
+// SplitMix64 finaliser (Steele, Lea & Flood). Bijective on 64-bit values.
+inline uint64_t splitMix64(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t counterRandom(uint64_t key, uint64_t counter) {
+    return splitMix64(splitMix64(key) ^ (counter * 0xD1B54A32D192ED03ull));
+}
+
+// Uniform integer in [0, bound) from the high bits (Lemire's multiply-shift).
+inline uint32_t counterRandomBelow(uint64_t key, uint64_t counter, uint32_t bound) {
+    return static_cast<uint32_t>(((counterRandom(key, counter) >> 32) * bound) >> 32);
+}
+
+// Reads one stream in order: values 0, 1, 2, ... of `key`.
+struct CounterStream {
+    uint64_t key;
+    uint64_t counter = 0;
+
+    explicit CounterStream(uint64_t key) : key(key) {}
+
+    uint64_t next() { return counterRandom(key, counter++); }
+    uint32_t below(uint32_t bound) { return counterRandomBelow(key, counter++, bound); }
+    // Inclusive on both ends, like std::uniform_int_distribution.
+    int range(int from, int to) {
+        return from + static_cast<int>(below(static_cast<uint32_t>(to - from) + 1));
+    }
+    bool coin() { return (next() >> 63) != 0; }
+
+    // [0, 1) from the top 53 (double) or 24 (float) bits.
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+    float unitFloat() { return static_cast<float>(next() >> 40) * 0x1.0p-24f; }
+    double uniform(double from, double to) { return from + (to - from) * unit(); }
+    float uniform(float from, float to) { return from + (to - from) * unitFloat(); }
+
+    // Approximately normal: the sum of 12 uniforms minus 6 (Irwin-Hall)
+    // has mean 0 and variance 1, needs no log or sqrt whose last bits vary
+    // between math libraries, and never strays past 6 standard deviations.
+    float normal(float mean, float stddev) {
+        double sum = 0.0;
+        for (int i = 0; i < 12; ++i) sum += unit();
+        return mean + stddev * static_cast<float>(sum - 6.0);
+    }
+
+    // Independent child stream `id`, e.g. one per work item. Deriving it
+    // does not advance this stream, and any thread can derive any child.
+    CounterStream substream(uint64_t id) const { return CounterStream(counterRandom(~key, id)); }
+};
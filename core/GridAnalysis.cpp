@@ -0,0 +1,329 @@
+#include "GridAnalysis.h"
+#include <algorithm>
+
+#include "Parallel.h"
+
+// ============================================================================
+// Connected components
+// ============================================================================
+
+namespace {
+
+// Union-find over cell indices. Roots are always the smallest index in their
+// set, i.e. the component's first cell in raster order.
+int32_t findRoot(std::vector<int32_t>& parent, int32_t i) {
+    int32_t root = i;
+    while (parent[root] != root) root = parent[root];
+    while (parent[i] != root) {
+        int32_t next = parent[i];
+        parent[i] = root;
+        i = next;
+    }
+    return root;
+}
+
+void unite(std::vector<int32_t>& parent, int32_t a, int32_t b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a == b) return;
+    if (a < b) parent[b] = a;
+    else parent[a] = b;
+}
+
+} // namespace
+
+int ComponentLabels::largest() const {
+    int best = -1;
+    for (int i = 0; i < count(); ++i) {
+        if (best < 0 || sizes[i] > sizes[best]) best = i;
+    }
+    return best;
+}
+
+ComponentLabels labelComponents(const uint8_t* mask, int width, int height, int threads) {
+    ComponentLabels out;
+    out.width = width;
+    out.height = height;
+    if (width <= 0 || height <= 0) return out;
+
+    size_t cellCount = static_cast<size_t>(width) * height;
+    std::vector<int32_t> parent(cellCount);
+
+    // Local pass: each strip only links cells inside itself, so strips share
+    // no parent entries and can run concurrently.
+    int strips = resolveThreadCount(threads, std::max(1, height / 16));
+    int rowsPerStrip = (height + strips - 1) / strips;
+    parallelFor(strips, strips, [&](int s) {
+        int y0 = s * rowsPerStrip;
+        int y1 = std::min(height, y0 + rowsPerStrip);
+        for (int y = y0; y < y1; ++y) {
+            for (int x = 0; x < width; ++x) {
+                int32_t i = y * width + x;
+                parent[i] = i;
+                if (!mask[i]) continue;
+                if (x > 0 && mask[i - 1]) unite(parent, i - 1, i);
+                if (y > y0 && mask[i - width]) unite(parent, i - width, i);
+            }
+        }
+    });
+
+    // Merge pass along the first row of every strip
+    for (int s = 1; s < strips; ++s) {
+        int y = s * rowsPerStrip;
+        if (y >= height) break;
+        for (int x = 0; x < width; ++x) {
+            int32_t i = y * width + x;
+            if (mask[i] && mask[i - width]) unite(parent, i - width, i);
+        }
+    }
+
+    // Roots come first in raster order, so labels can be handed out in one scan
+    out.labels.assign(cellCount, -1);
+    for (size_t c = 0; c < cellCount; ++c) {
+        if (!mask[c]) continue;
+        int32_t i = static_cast<int32_t>(c);
+        int32_t root = findRoot(parent, i);
+        if (root == i) {
+            out.labels[c] = out.count();
+            out.sizes.push_back(1);
+        } else {
+            out.labels[c] = out.labels[root];
+            out.sizes[out.labels[c]]++;
+        }
+    }
+    return out;
+}
+
+std::vector<std::pair<int64_t, int64_t>> componentSizeHistogram(const ComponentLabels& components) {
+    std::vector<int64_t> sizes = components.sizes;
+    std::sort(sizes.begin(), sizes.end());
+    std::vector<std::pair<int64_t, int64_t>> histogram;
+    for (int64_t size : sizes) {
+        if (histogram.empty() || histogram.back().first != size) histogram.push_back({size, 0});
+        histogram.back().second++;
+    }
+    return histogram;
+}
+
+// ============================================================================
+// Dead-end pruning
+// ============================================================================
+
+std::vector<int32_t> pruneDeadEnds(uint8_t* mask, int width, int height, int maxRounds, bool keepBorder) {
+    std::vector<int32_t> cleared;
+    if (width <= 0 || height <= 0) return cleared;
+
+    auto removable = [&](int32_t i) {
+        if (!mask[i]) return false;
+        int x = i % width;
+        int y = i / width;
+        if (keepBorder && (x == 0 || y == 0 || x == width - 1 || y == height - 1)) return false;
+        int n = 0;
+        if (x > 0 && mask[i - 1]) n++;
+        if (x < width - 1 && mask[i + 1]) n++;
+        if (y > 0 && mask[i - width]) n++;
+        if (y < height - 1 && mask[i + width]) n++;
+        return n <= 1;
+    };
+
+    // Round 1 scans everything; later rounds only the neighbours of cells
+    // cleared in the previous round, since nothing else changed.
+    std::vector<int32_t> candidates;
+    int32_t cellCount = width * height;
+    for (int32_t i = 0; i < cellCount; ++i) {
+        if (removable(i)) candidates.push_back(i);
+    }
+
+    std::vector<int32_t> queuedRound(cellCount, 0);
+    std::vector<int32_t> roundCleared;
+    for (int round = 1; !candidates.empty() && (maxRounds < 0 || round <= maxRounds); ++round) {
+        roundCleared.clear();
+        for (int32_t i : candidates) {
+            if (removable(i)) roundCleared.push_back(i);
+        }
+        // Clear together so every cell in the round saw the same grid
+        for (int32_t i : roundCleared) mask[i] = 0;
+        cleared.insert(cleared.end(), roundCleared.begin(), roundCleared.end());
+
+        candidates.clear();
+        for (int32_t i : roundCleared) {
+            int x = i % width;
+            int y = i / width;
+            int32_t around[4] = {x > 0 ? i - 1 : -1, x < width - 1 ? i + 1 : -1,
+                                 y > 0 ? i - width : -1, y < height - 1 ? i + width : -1};
+            for (int32_t n : around) {
+                if (n >= 0 && mask[n] && queuedRound[n] != round) {
+                    queuedRound[n] = round;
+                    candidates.push_back(n);
+                }
+            }
+        }
+    }
+    return cleared;
+}
+
+// ============================================================================
+// Distances and key locations
+// ============================================================================
+
+namespace {
+
+struct CellBits {
+    std::vector<uint64_t> words;
+
+    explicit CellBits(size_t count) : words((count + 63) / 64, 0) {}
+    bool test(int32_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    void set(int32_t i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+};
+
+// Level-order BFS over set cells through a flat queue. Calls visit(cell,
+// level) once per reached cell and returns the last cell reached (one of
+// the farthest from the sources), or -1.
+template <typename Visit>
+int32_t sweep(const uint8_t* mask, int width, int height, const int32_t* sources, size_t sourceCount,
+              std::vector<int32_t>& queue, Visit&& visit) {
+    CellBits seen((size_t)width * height);
+    queue.clear();
+    for (size_t i = 0; i < sourceCount; ++i) {
+        int32_t s = sources[i];
+        if (s < 0 || s >= width * height || !mask[s] || seen.test(s)) continue;
+        seen.set(s);
+        queue.push_back(s);
+    }
+
+    int32_t last = -1;
+    int32_t level = 0;
+    size_t head = 0;
+    while (head < queue.size()) {
+        size_t levelEnd = queue.size();
+        for (; head < levelEnd; ++head) {
+            int32_t cell = queue[head];
+            visit(cell, level);
+            last = cell;
+            int x = cell % width;
+            int32_t neighbours[4] = {cell - width, x > 0 ? cell - 1 : -1, x + 1 < width ? cell + 1 : -1, cell + width};
+            for (int32_t n : neighbours) {
+                if (n < 0 || n >= width * height || !mask[n] || seen.test(n)) continue;
+                seen.set(n);
+                queue.push_back(n);
+            }
+        }
+        level++;
+    }
+    return last;
+}
+
+} // namespace
+
+std::vector<int32_t> distanceField(const uint8_t* mask, int width, int height, const std::vector<int32_t>& sources) {
+    std::vector<int32_t> distance((size_t)std::max(0, width) * std::max(0, height), -1);
+    if (distance.empty()) return distance;
+    std::vector<int32_t> queue;
+    queue.reserve(distance.size());
+    sweep(mask, width, height, sources.data(), sources.size(), queue,
+          [&](int32_t cell, int32_t level) { distance[cell] = level; });
+    return distance;
+}
+
+CellPair farthestPair(const uint8_t* mask, int width, int height) {
+    CellPair pair;
+    if (width <= 0 || height <= 0) return pair;
+    ComponentLabels components = labelComponents(mask, width, height);
+    int largest = components.largest();
+    if (largest < 0) return pair;
+    int32_t start = (int32_t)(std::find(components.labels.begin(), components.labels.end(), largest) -
+                              components.labels.begin());
+
+    std::vector<int32_t> queue;
+    queue.reserve(components.sizes[largest]);
+    auto ignore = [](int32_t, int32_t) {};
+    pair.first = sweep(mask, width, height, &start, 1, queue, ignore);
+    pair.second = sweep(mask, width, height, &pair.first, 1, queue,
+                        [&](int32_t, int32_t level) { pair.distance = level; });
+    return pair;
+}
+
+std::vector<int32_t> shortestPath(const uint8_t* mask, int width, int height, int32_t from, int32_t to) {
+    std::vector<int32_t> path;
+    int32_t count = width * height;
+    if (width <= 0 || height <= 0 || from < 0 || to < 0 || from >= count || to >= count) return path;
+
+    // Distances from `to`, then walk downhill from `from`
+    std::vector<int32_t> distance = distanceField(mask, width, height, {to});
+    if (distance[from] < 0) return path;
+    path.reserve(distance[from] + 1);
+    int32_t cell = from;
+    path.push_back(cell);
+    while (cell != to) {
+        int x = cell % width;
+        int32_t neighbours[4] = {cell - width, x > 0 ? cell - 1 : -1, x + 1 < width ? cell + 1 : -1, cell + width};
+        for (int32_t n : neighbours) {
+            if (n >= 0 && n < count && distance[n] == distance[cell] - 1) {
+                cell = n;
+                break;
+            }
+        }
+        path.push_back(cell);
+    }
+    return path;
+}
+
+std::vector<int32_t> articulationPoints(const uint8_t* mask, int width, int height) {
+    std::vector<int32_t> result;
+    if (width <= 0 || height <= 0) return result;
+    int32_t count = width * height;
+
+    // Iterative Tarjan: discovery order and low-link per cell, with an
+    // explicit stack of (cell, next direction) frames
+    struct Frame {
+        int32_t cell;
+        int32_t parent;
+        int dir;
+    };
+    std::vector<int32_t> discovered(count, -1);
+    std::vector<int32_t> low(count, 0);
+    std::vector<Frame> stack;
+    CellBits cut(count);
+    int32_t clock = 0;
+
+    for (int32_t root = 0; root < count; ++root) {
+        if (!mask[root] || discovered[root] >= 0) continue;
+        int rootChildren = 0;
+        discovered[root] = low[root] = clock++;
+        stack.push_back({root, -1, 0});
+
+        while (!stack.empty()) {
+            size_t top = stack.size() - 1;
+            int32_t cell = stack[top].cell;
+            if (stack[top].dir < 4) {
+                int dir = stack[top].dir++;
+                int x = cell % width;
+                int32_t n = dir == 0 ? cell - width
+                          : dir == 1 ? (x > 0 ? cell - 1 : -1)
+                          : dir == 2 ? (x + 1 < width ? cell + 1 : -1)
+                          : cell + width;
+                if (n < 0 || n >= count || !mask[n]) continue;
+                if (discovered[n] < 0) {
+                    discovered[n] = low[n] = clock++;
+                    if (cell == root) rootChildren++;
+                    stack.push_back({n, cell, 0});
+                } else if (n != stack[top].parent) {
+                    low[cell] = std::min(low[cell], discovered[n]);
+                }
+                continue;
+            }
+
+            int32_t parent = stack[top].parent;
+            stack.pop_back();
+            if (parent < 0) continue;
+            low[parent] = std::min(low[parent], low[cell]);
+            if (parent != root && low[cell] >= discovered[parent]) cut.set(parent);
+        }
+        if (rootChildren > 1) cut.set(root);
+    }
+
+    for (int32_t i = 0; i < count; ++i) {
+        if (cut.test(i)) result.push_back(i);
+    }
+    return result;
+}
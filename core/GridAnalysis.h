@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// --- Grid analysis passes (Pure C++) ---
+//
+// Masks are row-major width * height byte arrays; non-zero cells are "set".
+// Connectivity is 4-neighbour throughout.
+
+struct ComponentLabels {
+    int width = 0;
+    int height = 0;
+    // -1 for unset cells, otherwise 0..count()-1. Labels are numbered in
+    // raster order of each component's first cell.
+    std::vector<int32_t> labels;
+    std::vector<int64_t> sizes; // cells per label
+
+    int count() const { return static_cast<int>(sizes.size()); }
+    // Lowest label among the largest components, or -1 when empty.
+    int largest() const;
+};
+
+// Scanline union-find labelling. Horizontal strips are labelled on up to
+// `threads` workers (0 = all hardware threads) and joined along the strip
+// boundaries afterwards; the result does not depend on the thread count.
+ComponentLabels labelComponents(const uint8_t* mask, int width, int height, int threads = 1);
+
+// (component size, number of components of that size), ascending by size.
+std::vector<std::pair<int64_t, int64_t>> componentSizeHistogram(const ComponentLabels& components);
+
+// Clears set cells with at most one set neighbour, in rounds: each round
+// clears every qualifying cell at once, and only the neighbours of cells
+// cleared in one round are examined in the next. Stops when nothing
+// qualifies or after `maxRounds` rounds (< 0 = no limit). With keepBorder,
+// cells on the outermost ring are never cleared.
+// Returns the cleared cell indices, round by round.
+std::vector<int32_t> pruneDeadEnds(uint8_t* mask, int width, int height, int maxRounds = -1, bool keepBorder = false);
+
+// --- Distances and key locations ---
+
+// Multi-source BFS: steps from the nearest source to every set cell, -1 for
+// unset or unreachable cells. Sources on unset cells are ignored.
+std::vector<int32_t> distanceField(const uint8_t* mask, int width, int height, const std::vector<int32_t>& sources);
+
+struct CellPair {
+    int32_t first = -1; // -1 when no cell is set
+    int32_t second = -1;
+    int32_t distance = -1;
+};
+
+// Two cells of the largest component that are far apart, found with two BFS
+// sweeps. Exact on tree-like layouts (mazes, pruned corridors); on maps
+// with loops it is a lower bound that is usually the true diameter.
+CellPair farthestPair(const uint8_t* mask, int width, int height);
+
+// A shortest 4-connected path from `from` to `to`, both included. Empty
+// when either cell is unset or there is no path.
+std::vector<int32_t> shortestPath(const uint8_t* mask, int width, int height, int32_t from, int32_t to);
+
+// Chokepoints: set cells whose removal splits their component (articulation
+// points of the 4-neighbour cell graph), in ascending cell order.
+std::vector<int32_t> articulationPoints(const uint8_t* mask, int width, int height);
@@ -0,0 +1,242 @@
+#include "GridGeometry.h"
+#include <algorithm>
+#include <cmath>
+
+#include "Parallel.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+int lowestBit(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(v);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return (int)index;
+#else
+    int n = 0;
+    while (!(v & 1)) {
+        v >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// Bits [from, to) of word `k`, as a mask
+uint64_t wordRange(int k, int from, int to) {
+    int lo = std::max(from - k * 64, 0);
+    int hi = std::min(to - k * 64, 64);
+    if (lo >= hi) return 0;
+    uint64_t upper = hi == 64 ? ~uint64_t(0) : ((uint64_t(1) << hi) - 1);
+    return upper & ~((uint64_t(1) << lo) - 1);
+}
+
+} // namespace
+
+std::vector<GridRect> mergeRectangles(const uint8_t* mask, int width, int height) {
+    std::vector<GridRect> rects;
+    if (width <= 0 || height <= 0) return rects;
+
+    // Uncovered set cells, one bit per cell
+    int words = (width + 63) / 64;
+    std::vector<uint64_t> open((size_t)words * height, 0);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = mask + (size_t)y * width;
+        uint64_t* bits = &open[(size_t)y * words];
+        for (int x = 0; x < width; ++x) {
+            if (row[x]) bits[x >> 6] |= uint64_t(1) << (x & 63);
+        }
+    }
+
+    auto rowHolds = [&](int y, int x0, int x1) {
+        const uint64_t* bits = &open[(size_t)y * words];
+        for (int k = x0 >> 6; k <= (x1 - 1) >> 6; ++k) {
+            uint64_t need = wordRange(k, x0, x1);
+            if ((bits[k] & need) != need) return false;
+        }
+        return true;
+    };
+
+    for (int y = 0; y < height; ++y) {
+        uint64_t* bits = &open[(size_t)y * words];
+        for (int k = 0; k < words; ++k) {
+            while (bits[k]) {
+                // Run start, then its end: the first clear bit after it
+                int x0 = k * 64 + lowestBit(bits[k]);
+                int kk = k;
+                uint64_t rest = ~bits[kk] & ~wordRange(k, k * 64, x0);
+                while (!rest && ++kk < words) rest = ~bits[kk];
+                int x1 = kk < words ? std::min(width, kk * 64 + lowestBit(rest)) : width;
+
+                int y1 = y + 1;
+                while (y1 < height && rowHolds(y1, x0, x1)) y1++;
+
+                for (int yy = y; yy < y1; ++yy) {
+                    uint64_t* clear = &open[(size_t)yy * words];
+                    for (int c = x0 >> 6; c <= (x1 - 1) >> 6; ++c) clear[c] &= ~wordRange(c, x0, x1);
+                }
+                rects.push_back({x0, y, x1 - x0, y1 - y});
+            }
+        }
+    }
+    return rects;
+}
+
+// ============================================================================
+// Contours
+// ============================================================================
+
+namespace {
+
+// Corner directions, clockwise in y-down coordinates
+const int DIR_X[4] = {1, 0, -1, 0};  // east, south, west, north
+const int DIR_Y[4] = {0, 1, 0, -1};
+
+double segmentDistance(const GridPoint& p, const GridPoint& a, const GridPoint& b) {
+    double dx = b.x - a.x, dy = b.y - a.y;
+    double px = p.x - a.x, py = p.y - a.y;
+    double len = dx * dx + dy * dy;
+    double t = len > 0 ? std::max(0.0, std::min(1.0, (px * dx + py * dy) / len)) : 0.0;
+    double ex = px - t * dx, ey = py - t * dy;
+    return std::sqrt(ex * ex + ey * ey);
+}
+
+// Douglas-Peucker over a closed ring: split at the corner farthest from the
+// first one and simplify both halves with an explicit stack
+Contour simplifyRing(const Contour& ring, double epsilon) {
+    size_t n = ring.size();
+    size_t far = 0;
+    long long best = -1;
+    for (size_t i = 1; i < n; ++i) {
+        long long dx = ring[i].x - ring[0].x, dy = ring[i].y - ring[0].y;
+        if (dx * dx + dy * dy > best) {
+            best = dx * dx + dy * dy;
+            far = i;
+        }
+    }
+
+    std::vector<uint8_t> keep(n, 0);
+    keep[0] = keep[far] = 1;
+    std::vector<std::pair<size_t, size_t>> stack = {{0, far}, {far, n}};
+    while (!stack.empty()) {
+        size_t a = stack.back().first, b = stack.back().second;
+        stack.pop_back();
+        const GridPoint& pa = ring[a];
+        const GridPoint& pb = ring[b % n];
+        size_t split = 0;
+        double worst = epsilon;
+        for (size_t i = a + 1; i < b; ++i) {
+            double d = segmentDistance(ring[i], pa, pb);
+            if (d > worst) {
+                worst = d;
+                split = i;
+            }
+        }
+        if (split) {
+            keep[split] = 1;
+            stack.push_back({a, split});
+            stack.push_back({split, b});
+        }
+    }
+
+    Contour out;
+    for (size_t i = 0; i < n; ++i) {
+        if (keep[i]) out.push_back(ring[i]);
+    }
+    return out.size() >= 3 ? out : ring;
+}
+
+} // namespace
+
+std::vector<Contour> traceContours(const uint8_t* mask, int width, int height, const GridRect& area, double epsilon) {
+    std::vector<Contour> contours;
+    int ax = std::max(area.x, 0), ay = std::max(area.y, 0);
+    int cw = std::min(area.x + area.w, width) - ax;
+    int ch = std::min(area.y + area.h, height) - ay;
+    if (cw <= 0 || ch <= 0) return contours;
+
+    auto cell = [&](int x, int y) {
+        return x >= 0 && y >= 0 && x < cw && y < ch && mask[(size_t)(ay + y) * width + (ax + x)] != 0;
+    };
+
+    // Outgoing boundary edges per corner, bit d = direction d. A corner with
+    // two (a diagonal pair of cells) is a saddle and is left by turning right.
+    int stride = cw + 1;
+    std::vector<uint8_t> edges((size_t)stride * (ch + 1), 0);
+    bool any = false;
+    for (int vy = 0; vy <= ch; ++vy) {
+        for (int vx = 0; vx <= cw; ++vx) {
+            bool tl = cell(vx - 1, vy - 1), tr = cell(vx, vy - 1);
+            bool bl = cell(vx - 1, vy), br = cell(vx, vy);
+            uint8_t bits = (br && !tr ? 1 : 0) | (bl && !br ? 2 : 0) | (tl && !bl ? 4 : 0) | (tr && !tl ? 8 : 0);
+            edges[(size_t)vy * stride + vx] = bits;
+            any |= bits != 0;
+        }
+    }
+    if (!any) return contours;
+
+    // Edges not yet walked
+    std::vector<uint8_t> out = edges;
+
+    for (int sy = 0; sy <= ch; ++sy) {
+        for (int sx = 0; sx <= cw; ++sx) {
+            size_t start = (size_t)sy * stride + sx;
+            while (out[start]) {
+                int startDir = lowestBit(out[start]);
+                out[start] &= ~(1 << startDir);
+                Contour ring;
+                int x = sx + DIR_X[startDir], y = sy + DIR_Y[startDir];
+                int dir = startDir;
+                for (;;) {
+                    size_t v = (size_t)y * stride + x;
+                    bool saddle = edges[v] == 5 || edges[v] == 10;
+                    int next = saddle ? (dir + 1) & 3 : lowestBit(edges[v]);
+                    if (next != dir) ring.push_back({ax + x, ay + y});
+                    if (v == start && next == startDir) break;
+                    out[v] &= ~(1 << next);
+                    dir = next;
+                    x += DIR_X[dir];
+                    y += DIR_Y[dir];
+                }
+                contours.push_back(epsilon > 0 && ring.size() > 4 ? simplifyRing(ring, epsilon) : std::move(ring));
+            }
+        }
+    }
+    return contours;
+}
+
+std::vector<Contour> traceContours(const uint8_t* mask, int width, int height, double epsilon) {
+    return traceContours(mask, width, height, GridRect{0, 0, width, height}, epsilon);
+}
+
+std::vector<ContourChunk> traceContourChunks(const uint8_t* mask, int width, int height, int originX, int originY,
+                                             int chunkSize, double epsilon, int threads) {
+    std::vector<ContourChunk> chunks;
+    if (width <= 0 || height <= 0 || chunkSize <= 0) return chunks;
+
+    auto floorDiv = [](long long a, long long b) { return a >= 0 ? a / b : -((-a + b - 1) / b); };
+    long long cx0 = floorDiv(originX, chunkSize), cx1 = floorDiv((long long)originX + width - 1, chunkSize);
+    long long cy0 = floorDiv(originY, chunkSize), cy1 = floorDiv((long long)originY + height - 1, chunkSize);
+    int columns = (int)(cx1 - cx0 + 1);
+    int count = columns * (int)(cy1 - cy0 + 1);
+
+    std::vector<ContourChunk> all(count);
+    parallelFor(count, threads, [&](int i) {
+        long long wx = (cx0 + i % columns) * chunkSize, wy = (cy0 + i / columns) * chunkSize;
+        int x0 = (int)std::max<long long>(wx - originX, 0), y0 = (int)std::max<long long>(wy - originY, 0);
+        int x1 = (int)std::min<long long>(wx + chunkSize - originX, width);
+        int y1 = (int)std::min<long long>(wy + chunkSize - originY, height);
+        all[i].area = GridRect{x0, y0, x1 - x0, y1 - y0};
+        all[i].contours = traceContours(mask, width, height, all[i].area, epsilon);
+    });
+
+    for (ContourChunk& chunk : all) {
+        if (!chunk.contours.empty()) chunks.push_back(std::move(chunk));
+    }
+    return chunks;
+}
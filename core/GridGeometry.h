@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// --- Geometry from grid masks (Pure C++) ---
+//
+// Masks are row-major width * height byte arrays; non-zero cells are "set".
+// Coordinates are in cells, with cell (x, y) covering [x, x+1) x [y, y+1).
+
+struct GridRect {
+    int x, y, w, h;
+};
+
+// Covers every set cell with non-overlapping axis-aligned rectangles using
+// greedy meshing: rows are scanned as bitmasks, each uncovered run is taken
+// as wide as it goes and then extended down while the rows below hold the
+// whole run. Rectangles come out in raster order of their top-left cell.
+std::vector<GridRect> mergeRectangles(const uint8_t* mask, int width, int height);
+
+// Closed outline of a set region, as lattice corners (x, y) in cells.
+struct GridPoint {
+    int x, y;
+};
+using Contour = std::vector<GridPoint>;
+
+// Marching squares over the cell corners: each corner looks at its four
+// surrounding cells and knows which way the boundary leaves it. Outlines
+// run along cell edges with the set cells on their right, so outer
+// boundaries are clockwise in y-down coordinates and holes counter-
+// clockwise. Diagonally touching cells get separate outlines (4-connected).
+// Collinear corners are always merged; with epsilon > 0 each outline is
+// then simplified by Douglas-Peucker (outlines that would collapse below
+// three points are kept as traced). Only cells inside `area` are traced, as
+// if the rest of the mask were clear. Outlines come out in raster order of
+// their first corner.
+std::vector<Contour> traceContours(const uint8_t* mask, int width, int height, const GridRect& area, double epsilon);
+std::vector<Contour> traceContours(const uint8_t* mask, int width, int height, double epsilon);
+
+struct ContourChunk {
+    GridRect area;                  // in mask cells
+    std::vector<Contour> contours;  // closed within the chunk
+};
+
+// Traces the mask in square chunks on up to `threads` workers (<= 0 = all
+// cores). Chunks are aligned to multiples of chunkSize in world cells, where
+// mask cell (0, 0) is world cell (originX, originY), so a renderer can key
+// them by world chunk. Empty chunks are skipped; the rest come in row-major
+// chunk order regardless of the thread count.
+std::vector<ContourChunk> traceContourChunks(const uint8_t* mask, int width, int height, int originX, int originY,
+                                             int chunkSize, double epsilon, int threads);
@@ -0,0 +1,276 @@
+#include "MapContainer.h"
+#include "ByteStream.h"
+#include <algorithm>
+#include <filesystem>
+
+static const char HEADER_MAGIC[4] = {'D', 'G', 'M', 'C'};
+static const char RECORD_MAGIC[4] = {'D', 'G', 'M', 'R'};
+static const char FOOTER_MAGIC[4] = {'D', 'G', 'I', 'X'};
+static const uint16_t CONTAINER_VERSION = 1;
+static const uint64_t HEADER_SIZE = 16;
+static const uint64_t FOOTER_SIZE = 16;
+static const uint64_t RECORD_HEADER_SIZE = 8;
+
+static void encodeRecord(const MapRecord& record, ByteWriter& out) {
+    bool small = std::all_of(record.cells.begin(), record.cells.end(),
+                             [](int32_t v) { return v >= 0 && v <= 255; });
+    MapCellEncoding encoding = small ? MapCellEncoding::U8 : MapCellEncoding::I32;
+
+    out.putBytes(RECORD_MAGIC, 4);
+    out.putU32(0); // payload size, patched below
+
+    out.putU64(record.seed);
+    out.putU8(static_cast<uint8_t>(record.algorithm));
+    out.putU8(record.success ? 1 : 0);
+    out.putU8(static_cast<uint8_t>(encoding));
+    out.putU8(0);
+    out.putString(record.message);
+    out.putI32(record.originX);
+    out.putI32(record.originY);
+    out.putU32(static_cast<uint32_t>(record.width));
+    out.putU32(static_cast<uint32_t>(record.height));
+    if (encoding == MapCellEncoding::U8) {
+        for (int32_t v : record.cells) out.putU8(static_cast<uint8_t>(v));
+    } else {
+        for (int32_t v : record.cells) out.putI32(v);
+    }
+
+    out.patchU32(4, static_cast<uint32_t>(out.size() - RECORD_HEADER_SIZE));
+}
+
+static bool decodeRecord(ByteReader& in, MapRecord& record) {
+    record.seed = in.getU64();
+    record.algorithm = static_cast<MapAlgorithm>(in.getU8());
+    record.success = in.getU8() != 0;
+    MapCellEncoding encoding = static_cast<MapCellEncoding>(in.getU8());
+    in.getU8();
+    record.message = in.getString();
+    record.originX = in.getI32();
+    record.originY = in.getI32();
+    record.width = static_cast<int32_t>(in.getU32());
+    record.height = static_cast<int32_t>(in.getU32());
+    if (!in.ok() || record.width < 0 || record.height < 0) return false;
+
+    size_t count = static_cast<size_t>(record.width) * static_cast<size_t>(record.height);
+    size_t cellBytes = encoding == MapCellEncoding::U8 ? 1 : 4;
+    if (encoding != MapCellEncoding::U8 && encoding != MapCellEncoding::I32) return false;
+    if (count > in.remaining() / cellBytes) return false;
+
+    record.cells.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        record.cells[i] = encoding == MapCellEncoding::U8 ? in.getU8() : in.getI32();
+    }
+    return in.ok();
+}
+
+// --- Writer ---
+
+bool MapContainerWriter::open(const std::string& path, bool append, std::string& error) {
+    close();
+    std::lock_guard<std::mutex> lock(mutex);
+    index.clear();
+    failed = false;
+
+    std::error_code ec;
+    if (append && std::filesystem::exists(path, ec)) {
+        {
+            // Scoped so the reader's handle is closed before the file is
+            // resized; Windows refuses to truncate a file that is still open
+            MapContainerReader reader;
+            if (!reader.open(path, error)) {
+                return false;
+            }
+            index = reader.getIndex();
+            offset = reader.getDataEnd();
+        }
+
+        // Drop the old index/footer (or a partial trailing record); they are
+        // rewritten by close().
+        std::filesystem::resize_file(path, offset, ec);
+        if (ec) {
+            error = "Cannot truncate " + path + ": " + ec.message();
+            return false;
+        }
+        file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(offset));
+    } else {
+        file.open(path, std::ios::binary | std::ios::trunc);
+        ByteWriter header;
+        header.putBytes(HEADER_MAGIC, 4);
+        header.putU16(CONTAINER_VERSION);
+        header.putU16(0);
+        header.putU64(0);
+        file.write(reinterpret_cast<const char*>(header.data().data()), header.size());
+        offset = HEADER_SIZE;
+    }
+
+    if (!file) {
+        error = "Cannot open " + path + " for writing";
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+bool MapContainerWriter::write(const MapRecord& record) {
+    ByteWriter buffer;
+    encodeRecord(record, buffer);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.is_open() || failed) return false;
+
+    file.write(reinterpret_cast<const char*>(buffer.data().data()), buffer.size());
+    if (!file) {
+        failed = true;
+        return false;
+    }
+    index.push_back({record.seed, offset});
+    offset += buffer.size();
+    return true;
+}
+
+bool MapContainerWriter::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file.is_open()) return !failed;
+
+    ByteWriter tail;
+    tail.putU64(index.size());
+    for (const auto& entry : index) {
+        tail.putU64(entry.seed);
+        tail.putU64(entry.offset);
+    }
+    tail.putU64(offset);
+    tail.putBytes(FOOTER_MAGIC, 4);
+    tail.putU32(0);
+
+    file.write(reinterpret_cast<const char*>(tail.data().data()), tail.size());
+    file.close();
+    if (file.fail()) failed = true;
+    return !failed;
+}
+
+size_t MapContainerWriter::getRecordCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return index.size();
+}
+
+// --- Reader ---
+
+bool MapContainerReader::open(const std::string& path, std::string& error) {
+    index.clear();
+    footer = false;
+    dataEnd = HEADER_SIZE;
+
+    file.close();
+    file.clear();
+    file.open(path, std::ios::binary);
+    if (!file) {
+        error = "Cannot open " + path;
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+
+    uint8_t header[HEADER_SIZE];
+    if (fileSize < HEADER_SIZE || !file.read(reinterpret_cast<char*>(header), HEADER_SIZE) ||
+        std::memcmp(header, HEADER_MAGIC, 4) != 0) {
+        error = path + " is not a map container";
+        return false;
+    }
+    ByteReader headerReader(header, HEADER_SIZE);
+    headerReader.skip(4);
+    if (headerReader.getU16() > CONTAINER_VERSION) {
+        error = path + " was written by a newer container version";
+        return false;
+    }
+
+    // Fast path: trust the footer index
+    if (fileSize >= HEADER_SIZE + FOOTER_SIZE) {
+        uint8_t tail[FOOTER_SIZE];
+        file.seekg(static_cast<std::streamoff>(fileSize - FOOTER_SIZE));
+        if (file.read(reinterpret_cast<char*>(tail), FOOTER_SIZE) &&
+            std::memcmp(tail + 8, FOOTER_MAGIC, 4) == 0) {
+            ByteReader tailReader(tail, FOOTER_SIZE);
+            uint64_t indexOffset = tailReader.getU64();
+            uint64_t indexSize = fileSize - FOOTER_SIZE - indexOffset;
+
+            if (indexOffset >= HEADER_SIZE && indexOffset < fileSize - FOOTER_SIZE && indexSize >= 8) {
+                std::vector<uint8_t> bytes(indexSize);
+                file.seekg(static_cast<std::streamoff>(indexOffset));
+                if (file.read(reinterpret_cast<char*>(bytes.data()), indexSize)) {
+                    ByteReader in(bytes);
+                    uint64_t count = in.getU64();
+                    if (count == (indexSize - 8) / 16) {
+                        index.resize(count);
+                        for (auto& entry : index) {
+                            entry.seed = in.getU64();
+                            entry.offset = in.getU64();
+                        }
+                        footer = true;
+                        dataEnd = indexOffset;
+                        return true;
+                    }
+                }
+            }
+        }
+        file.clear();
+    }
+
+    // Recovery path: walk the records until the first incomplete one
+    uint64_t pos = HEADER_SIZE;
+    while (pos + RECORD_HEADER_SIZE + 8 <= fileSize) {
+        uint8_t head[RECORD_HEADER_SIZE + 8];
+        file.seekg(static_cast<std::streamoff>(pos));
+        if (!file.read(reinterpret_cast<char*>(head), sizeof(head)) ||
+            std::memcmp(head, RECORD_MAGIC, 4) != 0) {
+            break;
+        }
+        ByteReader in(head, sizeof(head));
+        in.skip(4);
+        uint64_t payloadSize = in.getU32();
+        if (pos + RECORD_HEADER_SIZE + payloadSize > fileSize) {
+            break;
+        }
+        index.push_back({in.getU64(), pos});
+        pos += RECORD_HEADER_SIZE + payloadSize;
+    }
+    file.clear();
+    dataEnd = pos;
+    return true;
+}
+
+bool MapContainerReader::readAt(uint64_t offset, MapRecord& out) {
+    uint8_t head[RECORD_HEADER_SIZE];
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(offset));
+    if (!file.read(reinterpret_cast<char*>(head), RECORD_HEADER_SIZE) ||
+        std::memcmp(head, RECORD_MAGIC, 4) != 0) {
+        return false;
+    }
+    ByteReader headReader(head, RECORD_HEADER_SIZE);
+    headReader.skip(4);
+    uint32_t payloadSize = headReader.getU32();
+
+    std::vector<uint8_t> payload(payloadSize);
+    if (!file.read(reinterpret_cast<char*>(payload.data()), payloadSize)) {
+        return false;
+    }
+    ByteReader in(payload);
+    return decodeRecord(in, out);
+}
+
+bool MapContainerReader::read(size_t entry, MapRecord& out) {
+    if (entry >= index.size()) return false;
+    return readAt(index[entry].offset, out);
+}
+
+bool MapContainerReader::find(uint64_t seed, MapRecord& out) {
+    for (const auto& entry : index) {
+        if (entry.seed == seed) {
+            return readAt(entry.offset, out);
+        }
+    }
+    return false;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// --- Append-only map container (Pure C++) ---
+//
+// File layout (all integers little-endian):
+//
+//   header   "DGMC" u16 version u16 flags u64 reserved          (16 bytes)
+//   record*  "DGMR" u32 payloadSize payload                     (appended as maps finish)
+//   index    u64 count, count x { u64 seed, u64 recordOffset }  (written on close)
+//   footer   u64 indexOffset "DGIX" u32 reserved                (16 bytes)
+//
+// Record payload:
+//   u64 seed, u8 algorithm, u8 success, u8 cellEncoding, u8 reserved,
+//   string message (u32 length + bytes), i32 originX, i32 originY,
+//   u32 width, u32 height, cells (row-major, width * height values).
+//
+// Records are written in completion order, not seed order; the index maps
+// seeds to offsets. A file without a footer (writer killed mid-run) is still
+// readable: the reader rebuilds the index by scanning the records, and
+// opening it for append drops any trailing partial record.
+
+enum class MapAlgorithm : uint8_t {
+    Walker = 0,
+    BSP = 1,
+    Hybrid = 2,
+    TilingWFC = 3,
+    OverlappingWFC = 4
+};
+
+enum class MapCellEncoding : uint8_t {
+    U8 = 0,     // one byte per cell, used when every value fits in [0, 255]
+    I32 = 1     // four bytes per cell
+};
+
+// Cell values written for the floor/wall based generators. Matches the
+// DungeonBuilder::Tile ordering.
+enum MapCell : int32_t {
+    MAP_CELL_EMPTY = 0,
+    MAP_CELL_FLOOR = 1,
+    MAP_CELL_WALL = 2
+};
+
+struct MapRecord {
+    uint64_t seed = 0;
+    MapAlgorithm algorithm = MapAlgorithm::Walker;
+    bool success = true;
+    std::string message;    // failure reason when !success
+    int32_t originX = 0;    // world position of cell (0, 0)
+    int32_t originY = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    std::vector<int32_t> cells;
+};
+
+struct MapIndexEntry {
+    uint64_t seed;
+    uint64_t offset;
+};
+
+class MapContainerWriter {
+public:
+    ~MapContainerWriter() { close(); }
+
+    // Creates (or truncates) `path`. With `append`, an existing container is
+    // reopened and new records follow the existing ones.
+    bool open(const std::string& path, bool append, std::string& error);
+
+    // Thread-safe. The record is encoded before taking the file lock, so
+    // concurrent writers only serialise on the actual write.
+    bool write(const MapRecord& record);
+
+    // Writes the index and footer. Called by the destructor if needed.
+    bool close();
+
+    size_t getRecordCount() const;
+
+private:
+    mutable std::mutex mutex;
+    std::ofstream file;
+    uint64_t offset = 0;
+    std::vector<MapIndexEntry> index;
+    bool failed = false;
+};
+
+class MapContainerReader {
+public:
+    bool open(const std::string& path, std::string& error);
+
+    const std::vector<MapIndexEntry>& getIndex() const { return index; }
+    // False if the footer was missing and the index was rebuilt by scanning.
+    bool hasFooter() const { return footer; }
+    // Offset just past the last complete record.
+    uint64_t getDataEnd() const { return dataEnd; }
+
+    bool read(size_t entry, MapRecord& out);
+    // First record written for `seed`.
+    bool find(uint64_t seed, MapRecord& out);
+
+private:
+    std::ifstream file;
+    std::vector<MapIndexEntry> index;
+    uint64_t dataEnd = 0;
+    bool footer = false;
+
+    bool readAt(uint64_t offset, MapRecord& out);
+};
@@ -0,0 +1,155 @@
+#include "MultiLevel.h"
+#include <cstdlib>
+
+#include "GridAnalysis.h"
+#include "Parallel.h"
+
+static bool isWfc(MapAlgorithm algorithm) {
+    return algorithm == MapAlgorithm::TilingWFC || algorithm == MapAlgorithm::OverlappingWFC;
+}
+
+// Digs an L-shaped corridor (horizontal first) from `from` to `to` on one
+// level, walling in any empty cells around it.
+static void carveCorridor(int32_t* level, int width, int height, int32_t from, int32_t to) {
+    int x = from % width, y = from / width;
+    int tx = to % width, ty = to / width;
+    auto dig = [&](int cx, int cy) {
+        level[(size_t)cy * width + cx] = MAP_CELL_FLOOR;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = cx + dx, ny = cy + dy;
+                if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+                int32_t& cell = level[(size_t)ny * width + nx];
+                if (cell == MAP_CELL_EMPTY) cell = MAP_CELL_WALL;
+            }
+        }
+    };
+    dig(x, y);
+    while (x != tx) {
+        x += x < tx ? 1 : -1;
+        dig(x, y);
+    }
+    while (y != ty) {
+        y += y < ty ? 1 : -1;
+        dig(x, y);
+    }
+}
+
+MultiLevelOutput generateLevels(const std::vector<LevelJob>& jobs, const MultiLevelSettings& settings) {
+    MultiLevelOutput output;
+    int levels = (int)jobs.size();
+    if (levels == 0) {
+        output.message = "No levels";
+        return output;
+    }
+
+    std::vector<MapRecord> records(levels);
+    parallelFor(levels, settings.threads, [&](int i) {
+        records[i] = jobs[i](settings.seed + (uint64_t)i);
+    });
+
+    // Shared layout: the union of every level's bounds
+    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+    for (int i = 0; i < levels; i++) {
+        const MapRecord& record = records[i];
+        if (!record.success) {
+            output.message = "Level " + std::to_string(i) + ": " + record.message;
+            return output;
+        }
+        if (record.width <= 0 || record.height <= 0) {
+            output.message = "Level " + std::to_string(i) + " has no floor";
+            return output;
+        }
+        minX = std::min(minX, record.originX);
+        minY = std::min(minY, record.originY);
+        maxX = std::max(maxX, record.originX + record.width - 1);
+        maxY = std::max(maxY, record.originY + record.height - 1);
+    }
+    int width = maxX - minX + 1;
+    int height = maxY - minY + 1;
+    size_t area = (size_t)width * height;
+
+    output.originX = minX;
+    output.originY = minY;
+    output.width = width;
+    output.height = height;
+    output.cells.assign(area * levels, MAP_CELL_EMPTY);
+    for (int i = 0; i < levels; i++) {
+        const MapRecord& record = records[i];
+        bool wfc = isWfc(record.algorithm);
+        int32_t* level = output.cells.data() + area * i;
+        for (int y = 0; y < record.height; y++) {
+            int32_t* row = level + (size_t)(record.originY - minY + y) * width + (record.originX - minX);
+            const int32_t* src = record.cells.data() + (size_t)y * record.width;
+            for (int x = 0; x < record.width; x++) {
+                int32_t v = src[x];
+                if (wfc) {
+                    v = v == settings.wfcFloorValue ? MAP_CELL_FLOOR : (v < 0 ? MAP_CELL_EMPTY : MAP_CELL_WALL);
+                }
+                row[x] = v;
+            }
+        }
+        output.algorithms.push_back(record.algorithm);
+        output.seeds.push_back(settings.seed + (uint64_t)i);
+    }
+
+    // Stairs, top down: each level is entered where the previous one's
+    // stairs arrive, so the chain is sequential
+    std::vector<uint8_t> mask(area);
+    auto buildMask = [&](int level) {
+        const int32_t* cells = output.cells.data() + area * level;
+        for (size_t c = 0; c < area; c++) mask[c] = cells[c] == MAP_CELL_FLOOR;
+    };
+
+    buildMask(0);
+    int32_t entry = farthestPair(mask.data(), width, height).first;
+    if (entry < 0) {
+        output.message = "Level 0 has no floor";
+        return output;
+    }
+    for (int level = 0; level + 1 < levels; level++) {
+        if (level > 0) buildMask(level);
+        std::vector<int32_t> distance = distanceField(mask.data(), width, height, {entry});
+
+        const int32_t* below = output.cells.data() + area * (level + 1);
+        int32_t shared = -1, farthest = -1;
+        for (size_t c = 0; c < area; c++) {
+            if (distance[c] < 0) continue;
+            if (farthest < 0 || distance[c] > distance[farthest]) farthest = (int32_t)c;
+            if (below[c] == MAP_CELL_FLOOR && (shared < 0 || distance[c] > distance[shared])) shared = (int32_t)c;
+        }
+
+        StairLink link;
+        link.upper = level;
+        int32_t stair = shared;
+        if (stair < 0) {
+            // Nothing reachable lines up with the level below: dig from
+            // its nearest floor to the stairs
+            stair = farthest;
+            int sx = stair % width, sy = stair / width;
+            int32_t nearest = -1;
+            int best = INT_MAX;
+            for (size_t c = 0; c < area; c++) {
+                if (below[c] != MAP_CELL_FLOOR) continue;
+                int d = std::abs((int)(c % width) - sx) + std::abs((int)(c / width) - sy);
+                if (d < best) {
+                    best = d;
+                    nearest = (int32_t)c;
+                }
+            }
+            if (nearest < 0) {
+                output.message = "Level " + std::to_string(level + 1) + " has no floor";
+                return output;
+            }
+            carveCorridor(output.cells.data() + area * (level + 1), width, height, stair, nearest);
+            link.carved = true;
+        }
+        link.x = minX + stair % width;
+        link.y = minY + stair / width;
+        output.stairs.push_back(link);
+        entry = stair;
+    }
+
+    output.success = true;
+    return output;
+}
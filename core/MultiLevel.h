@@ -0,0 +1,91 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "MapContainer.h"
+
+// --- Multi-level dungeons (Pure C++) ---
+//
+// Generates one map per level concurrently, lays every level out on one
+// shared grid (so a cell index means the same world position on every
+// level) and links adjacent levels with stairs on cells that are floor on
+// both.
+
+// Floor/wall position lists -> Empty/Floor/Wall grid over their bounding box.
+// Walls are written last, matching how the Godot examples paint them.
+template <typename FloorVec, typename WallVec>
+void rasterizeMap(const FloorVec& floors, const WallVec& walls, MapRecord& record) {
+    int minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+    auto grow = [&](int x, int y) {
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    };
+    for (const auto& p : floors) grow(p.x, p.y);
+    for (const auto& p : walls) grow(p.x, p.y);
+
+    if (minX > maxX) {
+        record.width = 0;
+        record.height = 0;
+        record.cells.clear();
+        return;
+    }
+
+    record.originX = minX;
+    record.originY = minY;
+    record.width = maxX - minX + 1;
+    record.height = maxY - minY + 1;
+    record.cells.assign((size_t)record.width * record.height, MAP_CELL_EMPTY);
+    for (const auto& p : floors) {
+        record.cells[(size_t)(p.y - minY) * record.width + (p.x - minX)] = MAP_CELL_FLOOR;
+    }
+    for (const auto& p : walls) {
+        record.cells[(size_t)(p.y - minY) * record.width + (p.x - minX)] = MAP_CELL_WALL;
+    }
+}
+
+// One level's generator, called with that level's seed. Jobs run on worker
+// threads, so they may only read state captured when they were built.
+// Walker, BSP and Hybrid jobs return MapCell grids; WFC jobs return their
+// raw tile values (see MultiLevelSettings::wfcFloorValue).
+using LevelJob = std::function<MapRecord(uint64_t seed)>;
+
+struct MultiLevelSettings {
+    uint64_t seed = 0;       // level i uses seed + i
+    int wfcFloorValue = 0;   // WFC cells with this value are floor, -1 empty, the rest wall
+    int threads = 0;         // 0 = all hardware threads
+};
+
+struct StairLink {
+    int upper = 0;           // joins level `upper` and `upper + 1`
+    int32_t x = 0;           // world cell
+    int32_t y = 0;
+    bool carved = false;     // no shared floor was reachable; a corridor was dug on the lower level
+};
+
+struct MultiLevelOutput {
+    bool success = false;
+    std::string message;               // failure reason when !success
+    int32_t originX = 0;               // world position of cell (0, 0)
+    int32_t originY = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    std::vector<MapAlgorithm> algorithms;
+    std::vector<uint64_t> seeds;
+    std::vector<int32_t> cells;        // MapCell values, level * width * height + y * width + x
+    std::vector<StairLink> stairs;     // stairs[i] joins levels i and i + 1
+};
+
+// Runs every job on up to `settings.threads` workers, then places stairs
+// level by level: each descends from the cell farthest (by walking) from
+// where the level was entered, among cells that are also floor below. The
+// first level is entered at one end of its longest path. A level with no
+// such cell gets the farthest reachable cell as its stair and a corridor
+// from there to the nearest floor on the level below. Fails if a job fails
+// or a level has no floor.
+MultiLevelOutput generateLevels(const std::vector<LevelJob>& jobs, const MultiLevelSettings& settings);
@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// --- Minimal fork/join helpers (Pure C++) ---
+//
+// Work items are handed out through a shared atomic counter, so the order in
+// which items *finish* is unspecified. Callers write results into a slot per
+// item index, which keeps the output order independent of scheduling.
+
+// Resolve a requested worker count: <= 0 means "all hardware threads".
+inline int resolveThreadCount(int requested, int workItems) {
+    int n = requested;
+    if (n <= 0) {
+        n = static_cast<int>(std::thread::hardware_concurrency());
+        if (n <= 0) n = 1;
+    }
+    return std::max(1, std::min(n, workItems));
+}
+
+// Calls fn(i) for every i in [0, count). Runs inline when only one worker is
+// needed. The first exception thrown by any item is rethrown on the caller.
+template <typename Fn>
+void parallelFor(int count, int threads, Fn&& fn) {
+    if (count <= 0) return;
+    int workers = resolveThreadCount(threads, count);
+    if (workers == 1) {
+        for (int i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    std::atomic<int> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        for (;;) {
+            int i = next.fetch_add(1);
+            if (i >= count) return;
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+                next.store(count);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (int t = 1; t < workers; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+
+    if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,152 @@
+#include "PoissonDisk.h"
+#include <algorithm>
+#include <cmath>
+
+#include "CounterRng.h"
+
+namespace {
+
+int gcd(int a, int b) {
+    while (b) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Quadrant of an offset, counter-clockwise from +x
+int quadrant(const GridPoint& p) {
+    if (p.y == 0) return p.x > 0 ? 0 : 2;
+    if (p.x == 0) return p.y > 0 ? 1 : 3;
+    if (p.y > 0) return p.x > 0 ? 0 : 1;
+    return p.x < 0 ? 2 : 3;
+}
+
+// Integer offsets with r <= |d| < 2r, sorted by angle with exact integer
+// comparisons (no atan2, so the order is the same on every platform)
+std::vector<GridPoint> annulusOffsets(double r) {
+    std::vector<GridPoint> ring;
+    int reach = (int)std::ceil(2 * r);
+    for (int dy = -reach; dy <= reach; ++dy) {
+        for (int dx = -reach; dx <= reach; ++dx) {
+            double d2 = (double)dx * dx + (double)dy * dy;
+            if (d2 >= r * r && d2 < 4 * r * r) ring.push_back({dx, dy});
+        }
+    }
+    std::sort(ring.begin(), ring.end(), [](const GridPoint& a, const GridPoint& b) {
+        int qa = quadrant(a), qb = quadrant(b);
+        if (qa != qb) return qa < qb;
+        long long cross = (long long)a.x * b.y - (long long)a.y * b.x;
+        if (cross != 0) return cross > 0;
+        return (long long)a.x * a.x + (long long)a.y * a.y < (long long)b.x * b.x + (long long)b.y * b.y;
+    });
+    return ring;
+}
+
+// Integer offsets with |d| < r: the cells a sample keeps others out of
+std::vector<GridPoint> discOffsets(double r) {
+    std::vector<GridPoint> disc;
+    int reach = (int)std::ceil(r);
+    for (int dy = -reach; dy <= reach; ++dy) {
+        for (int dx = -reach; dx <= reach; ++dx) {
+            if ((double)dx * dx + (double)dy * dy < r * r) disc.push_back({dx, dy});
+        }
+    }
+    return disc;
+}
+
+} // namespace
+
+std::vector<std::vector<GridPoint>> samplePoissonDisk(const uint8_t* mask, int width, int height,
+                                                      const std::vector<PoissonLayer>& layers, uint64_t seed,
+                                                      int attempts) {
+    std::vector<std::vector<GridPoint>> result(layers.size());
+    if (width <= 0 || height <= 0) return result;
+
+    // Free cells: in the mask and not taken by an earlier layer
+    std::vector<uint8_t> free((size_t)width * height);
+    std::vector<uint32_t> seeds;
+    for (size_t i = 0; i < free.size(); ++i) {
+        free[i] = mask[i] != 0;
+        if (free[i]) seeds.push_back((uint32_t)i);
+    }
+
+    // No two cells are a diagonal apart, so any larger radius leaves one
+    // sample per layer just the same; capping it bounds the offset tables
+    // below, which grow with r^2
+    double diagonal = std::max(1.0, std::sqrt((double)width * width + (double)height * height));
+    for (size_t l = 0; l < layers.size(); ++l) {
+        CounterStream rng(counterRandom(seed, l));
+        double r = std::min(std::max(1.0, layers[l].radius), diagonal);
+        std::vector<GridPoint> ring = annulusOffsets(r);
+        int n = (int)ring.size();
+        // Stepping through the angle-sorted ring by about n / phi spreads
+        // the tries of one sample evenly around it
+        int step = std::max(1, (int)(n * 0.6180339887498949));
+        while (gcd(step, n) != 1) step++;
+        int tries = std::min(attempts, n);
+
+        // Background grid at tile resolution: cells within r of a sample of
+        // this layer are closed, so a spacing test is a single read. Stamping
+        // a disc per sample costs about as much as the area it covers.
+        std::vector<GridPoint> disc = discOffsets(r);
+        std::vector<uint8_t> open = free;
+        std::vector<GridPoint>& points = result[l];
+
+        auto accept = [&](int x, int y) {
+            if (x < 0 || y < 0 || x >= width || y >= height || !open[(size_t)y * width + x]) return false;
+            for (const GridPoint& d : disc) {
+                int cx = x + d.x, cy = y + d.y;
+                if (cx >= 0 && cy >= 0 && cx < width && cy < height) open[(size_t)cy * width + cx] = 0;
+            }
+            points.push_back({x, y});
+            return true;
+        };
+
+        // Fisher-Yates over the free cells; taken cells are skipped below
+        std::vector<uint32_t> order;
+        order.reserve(seeds.size());
+        for (uint32_t s : seeds) {
+            if (free[s]) order.push_back(s);
+        }
+        for (size_t i = order.size(); i > 1; --i) {
+            std::swap(order[i - 1], order[rng.below((uint32_t)i)]);
+        }
+
+        std::vector<int32_t> active;
+        for (uint32_t s : order) {
+            if (!accept((int)(s % width), (int)(s / width))) continue;
+            active.push_back((int32_t)points.size() - 1);
+            while (!active.empty()) {
+                size_t pick = rng.below((uint32_t)active.size());
+                GridPoint from = points[active[pick]];
+                bool placed = false;
+                int at = (int)rng.below((uint32_t)n);
+                for (int k = 0; k < tries && !placed; ++k) {
+                    const GridPoint& d = ring[at];
+                    if (accept(from.x + d.x, from.y + d.y)) {
+                        active.push_back((int32_t)points.size() - 1);
+                        placed = true;
+                    }
+                    at = (at + step) % n;
+                }
+                if (!placed) {
+                    active[pick] = active.back();
+                    active.pop_back();
+                }
+            }
+        }
+
+        // A random subset keeps the blue-noise spacing (only sparser)
+        int keep = layers[l].maxCount;
+        if (keep > 0 && (size_t)keep < points.size()) {
+            for (int i = 0; i < keep; ++i) {
+                std::swap(points[i], points[i + rng.below((uint32_t)(points.size() - i))]);
+            }
+            points.resize(keep);
+        }
+        for (const GridPoint& p : points) free[(size_t)p.y * width + p.x] = 0;
+    }
+    return result;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "GridGeometry.h"
+
+// --- Poisson-disk placement over grid masks (Pure C++) ---
+//
+// Bridson's algorithm on cells: samples are cells of the mask, and each new
+// sample is drawn from the annulus [r, 2r) around an active one. Candidates
+// are integer offsets (no trigonometry), so a seed gives the same points on
+// every platform. A background grid at tile resolution closes the cells
+// within r of each sample as it is placed, so a spacing test is one read.
+//
+// Bridson only grows outwards from where it starts; once a front dies out,
+// sampling restarts from the next free cell of a shuffled seed list, which
+// covers disconnected floor areas and leaves no free cell farther than r
+// from a sample.
+
+struct PoissonLayer {
+    double radius = 1.0; // minimum spacing within the layer, in cells (>= 1, capped at the mask diagonal)
+    int maxCount = 0;    // keep a random subset of this many; 0 = all
+};
+
+// One point list per layer. Layers are sampled in order and never reuse a
+// cell taken by an earlier layer; spacing only applies within a layer.
+// `attempts` is the number of annulus candidates tried per active sample.
+std::vector<std::vector<GridPoint>> samplePoissonDisk(const uint8_t* mask, int width, int height,
+                                                      const std::vector<PoissonLayer>& layers, uint64_t seed,
+                                                      int attempts = 30);
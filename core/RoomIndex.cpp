@@ -0,0 +1,241 @@
+#include "RoomIndex.h"
+#include <algorithm>
+
+namespace {
+
+const int LEAF_SIZE = 4;
+
+bool intersects(const GridRect& a, const GridRect& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+bool contains(const GridRect& outer, const GridRect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.w <= outer.x + outer.w &&
+           inner.y + inner.h <= outer.y + outer.h;
+}
+
+GridRect merge(const GridRect& a, const GridRect& b) {
+    if (a.w == 0) return b;
+    int x0 = std::min(a.x, b.x), y0 = std::min(a.y, b.y);
+    int x1 = std::max(a.x + a.w, b.x + b.w), y1 = std::max(a.y + a.h, b.y + b.h);
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+} // namespace
+
+void RoomIndex::reset(const GridRect& p_area, const uint8_t* p_floor) {
+    area = p_area;
+    size_t count = (size_t)std::max(area.w, 0) * std::max(area.h, 0);
+    floor.assign(p_floor, p_floor + count);
+    grid.assign(count, NONE);
+    bounds.clear();
+    cells.clear();
+    nodes.clear();
+    order.clear();
+    adjacencyStart.clear();
+    adjacency.clear();
+}
+
+int RoomIndex::addRoom() {
+    bounds.push_back({0, 0, 0, 0});
+    cells.push_back(0);
+    return (int)bounds.size() - 1;
+}
+
+void RoomIndex::claimCell(int room, int x, int y) {
+    int lx = x - area.x, ly = y - area.y;
+    if (lx < 0 || ly < 0 || lx >= area.w || ly >= area.h) return;
+    size_t i = (size_t)ly * area.w + lx;
+    if (!floor[i] || grid[i] != NONE) return;
+    grid[i] = room;
+    bounds[room] = merge(bounds[room], {x, y, 1, 1});
+    cells[room]++;
+}
+
+void RoomIndex::claimRect(int room, const GridRect& rect) {
+    int x0 = std::max(rect.x, area.x), x1 = std::min(rect.x + rect.w, area.x + area.w);
+    int y0 = std::max(rect.y, area.y), y1 = std::min(rect.y + rect.h, area.y + area.h);
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) claimCell(room, x, y);
+    }
+}
+
+void RoomIndex::finish() {
+    buildHierarchy();
+    buildAdjacency();
+}
+
+int RoomIndex::roomAt(int x, int y) const {
+    int lx = x - area.x, ly = y - area.y;
+    if (lx < 0 || ly < 0 || lx >= area.w || ly >= area.h) return NONE;
+    return grid[(size_t)ly * area.w + lx];
+}
+
+// ============================================================================
+// Hierarchy
+// ============================================================================
+
+void RoomIndex::buildHierarchy() {
+    order.clear();
+    for (int r = 0; r < roomCount(); ++r) {
+        if (cells[r] > 0) order.push_back(r);
+    }
+    nodes.clear();
+    if (order.empty()) return;
+
+    // Top-down median splits on the longer axis of the centre bounds;
+    // children are pushed after their parent, so nodes[0] is the root
+    struct Pending {
+        int node, first, count;
+    };
+    nodes.push_back(Node());
+    std::vector<Pending> pending = {{0, 0, (int)order.size()}};
+    while (!pending.empty()) {
+        Pending p = pending.back();
+        pending.pop_back();
+
+        GridRect box{0, 0, 0, 0};
+        int cx0 = INT32_MAX, cy0 = INT32_MAX, cx1 = INT32_MIN, cy1 = INT32_MIN;
+        for (int i = p.first; i < p.first + p.count; ++i) {
+            const GridRect& b = bounds[order[i]];
+            box = merge(box, b);
+            cx0 = std::min(cx0, 2 * b.x + b.w);
+            cx1 = std::max(cx1, 2 * b.x + b.w);
+            cy0 = std::min(cy0, 2 * b.y + b.h);
+            cy1 = std::max(cy1, 2 * b.y + b.h);
+        }
+        nodes[p.node].box = box;
+        if (p.count <= LEAF_SIZE) {
+            nodes[p.node].first = p.first;
+            nodes[p.node].count = p.count;
+            continue;
+        }
+
+        bool splitX = cx1 - cx0 >= cy1 - cy0;
+        auto centre = [&](int r) {
+            const GridRect& b = bounds[r];
+            return splitX ? 2 * b.x + b.w : 2 * b.y + b.h;
+        };
+        int half = p.count / 2;
+        std::nth_element(order.begin() + p.first, order.begin() + p.first + half, order.begin() + p.first + p.count,
+                         [&](int a, int b) { return centre(a) != centre(b) ? centre(a) < centre(b) : a < b; });
+
+        int left = (int)nodes.size();
+        nodes.push_back(Node());
+        nodes.push_back(Node());
+        nodes[p.node].left = left;
+        nodes[p.node].right = left + 1;
+        pending.push_back({left, p.first, half});
+        pending.push_back({left + 1, p.first + half, p.count - half});
+    }
+}
+
+bool RoomIndex::overlaps(int room, const GridRect& rect) const {
+    const GridRect& b = bounds[room];
+    if (contains(rect, b)) return true;
+    int x0 = std::max(b.x, rect.x), x1 = std::min(b.x + b.w, rect.x + rect.w);
+    int y0 = std::max(b.y, rect.y), y1 = std::min(b.y + b.h, rect.y + rect.h);
+    for (int y = y0; y < y1; ++y) {
+        const int32_t* row = &grid[(size_t)(y - area.y) * area.w];
+        for (int x = x0; x < x1; ++x) {
+            if (row[x - area.x] == room) return true;
+        }
+    }
+    return false;
+}
+
+void RoomIndex::roomsInRect(const GridRect& rect, std::vector<int>& out) const {
+    out.clear();
+    if (nodes.empty() || rect.w <= 0 || rect.h <= 0) return;
+
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        if (!intersects(node.box, rect)) continue;
+        if (node.left < 0) {
+            for (int i = node.first; i < node.first + node.count; ++i) {
+                int room = order[i];
+                if (intersects(bounds[room], rect) && overlaps(room, rect)) out.push_back(room);
+            }
+        } else {
+            stack[top++] = node.left;
+            stack[top++] = node.right;
+        }
+    }
+    std::sort(out.begin(), out.end());
+}
+
+// ============================================================================
+// Adjacency
+// ============================================================================
+
+const int* RoomIndex::neighbours(int room, int& count) const {
+    if (adjacencyStart.empty()) {
+        count = 0;
+        return nullptr;
+    }
+    count = adjacencyStart[room + 1] - adjacencyStart[room];
+    return adjacency.data() + adjacencyStart[room];
+}
+
+void RoomIndex::buildAdjacency() {
+    int rooms = roomCount();
+    adjacencyStart.assign(rooms + 1, 0);
+    adjacency.clear();
+    if (rooms == 0) return;
+
+    // Nearest-room labels over the floor, seeded with every claimed cell in
+    // raster order so ties resolve the same way on every run
+    std::vector<int32_t> label = grid;
+    std::vector<uint32_t> queue;
+    for (size_t i = 0; i < label.size(); ++i) {
+        if (label[i] != NONE) queue.push_back((uint32_t)i);
+    }
+    int w = area.w, h = area.h;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t i = queue[head];
+        int x = (int)(i % w), y = (int)(i / w);
+        uint32_t next[4] = {i - 1, i + 1, i - w, i + w};
+        bool valid[4] = {x > 0, x < w - 1, y > 0, y < h - 1};
+        for (int k = 0; k < 4; ++k) {
+            if (valid[k] && floor[next[k]] && label[next[k]] == NONE) {
+                label[next[k]] = label[i];
+                queue.push_back(next[k]);
+            }
+        }
+    }
+
+    // Rooms whose areas meet across a cell edge
+    std::vector<uint64_t> pairs;
+    auto meet = [&](int32_t a, int32_t b) {
+        if (a == NONE || b == NONE || a == b) return;
+        pairs.push_back((uint64_t)std::min(a, b) << 32 | (uint32_t)std::max(a, b));
+    };
+    for (int y = 0; y < h; ++y) {
+        const int32_t* row = &label[(size_t)y * w];
+        for (int x = 0; x < w; ++x) {
+            if (x + 1 < w) meet(row[x], row[x + 1]);
+            if (y + 1 < h) meet(row[x], row[x + w]);
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+    for (uint64_t p : pairs) {
+        adjacencyStart[(p >> 32) + 1]++;
+        adjacencyStart[(uint32_t)p + 1]++;
+    }
+    for (int r = 0; r < rooms; ++r) adjacencyStart[r + 1] += adjacencyStart[r];
+    adjacency.resize(adjacencyStart[rooms]);
+    std::vector<int> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+    for (uint64_t p : pairs) {
+        int a = (int)(p >> 32), b = (int)(uint32_t)p;
+        adjacency[fill[a]++] = b;
+        adjacency[fill[b]++] = a;
+    }
+    for (int r = 0; r < rooms; ++r) {
+        std::sort(adjacency.begin() + adjacencyStart[r], adjacency.begin() + adjacencyStart[r + 1]);
+    }
+}
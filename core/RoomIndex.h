@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "GridGeometry.h"
+
+// --- Room lookup for generated maps (Pure C++) ---
+//
+// Rooms are registered with their bounds and then claim floor cells, which
+// fills a per-cell room-id grid over the indexed area: roomAt() is one
+// array read. finish() builds a bounding-volume hierarchy over the claimed
+// footprints for rectangle queries, and the room adjacency graph.
+//
+// Two rooms are adjacent when they touch, or when a corridor leads from
+// one to the other without passing through a third room: corridor cells
+// are handed to the nearest room by a breadth-first search from every
+// room at once, and rooms whose areas meet are adjacent.
+
+class RoomIndex {
+public:
+    static constexpr int NONE = -1;
+
+    // Starts a new index over `area` (world cells). `floor` is a row-major
+    // area.w * area.h mask of walkable cells; it is copied.
+    void reset(const GridRect& area, const uint8_t* floor);
+
+    // Registers a room and returns its id (0, 1, ... in call order). Rooms
+    // that claim no cells stay registered but are never found.
+    int addRoom();
+    // Claims a floor cell for `room`. Cells outside the area, non-floor
+    // cells and cells already claimed by another room are ignored.
+    void claimCell(int room, int x, int y);
+    void claimRect(int room, const GridRect& rect);
+
+    // Builds the hierarchy and the adjacency graph; call once after claiming.
+    void finish();
+
+    int roomCount() const { return (int)bounds.size(); }
+    // Tight bounds of the cells a room claimed (w = h = 0 when it has none).
+    const GridRect& roomBounds(int room) const { return bounds[room]; }
+    int roomCells(int room) const { return cells[room]; }
+
+    // Room holding cell (x, y), or NONE.
+    int roomAt(int x, int y) const;
+    // Rooms with at least one cell inside `rect`, in ascending id order.
+    void roomsInRect(const GridRect& rect, std::vector<int>& out) const;
+    // Adjacent rooms in ascending id order.
+    const int* neighbours(int room, int& count) const;
+
+private:
+    struct Node {
+        GridRect box;
+        int left = -1, right = -1; // children; leaves have left == -1
+        int first = 0, count = 0;  // leaf range in `order`
+    };
+
+    GridRect area{0, 0, 0, 0};
+    std::vector<uint8_t> floor;
+    std::vector<int32_t> grid; // room id per cell, NONE when unclaimed
+    std::vector<GridRect> bounds;
+    std::vector<int> cells;
+
+    std::vector<Node> nodes;
+    std::vector<int> order; // room ids, grouped by leaf
+
+    std::vector<int> adjacencyStart; // CSR: neighbours of r are
+    std::vector<int> adjacency;      // adjacency[start[r] .. start[r + 1])
+
+    void buildHierarchy();
+    void buildAdjacency();
+    bool overlaps(int room, const GridRect& rect) const;
+};
@@ -0,0 +1,147 @@
+#include "Visibility.h"
+#include <algorithm>
+
+#include "Parallel.h"
+
+namespace {
+
+int64_t floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+int64_t ceilDiv(int64_t a, int64_t b) {
+    return -floorDiv(-a, b);
+}
+
+// Quadrant axes: world = origin + col * colAxis + depth * depthAxis
+const int COL_X[4] = {1, 1, 0, 0};
+const int COL_Y[4] = {0, 0, 1, 1};
+const int DEPTH_X[4] = {0, 0, 1, -1};
+const int DEPTH_Y[4] = {-1, 1, 0, 0};
+
+} // namespace
+
+void VisibilityMap::reset(const GridRect& p_area, const uint8_t* p_opaque) {
+    area = p_area;
+    size_t count = (size_t)std::max(area.w, 0) * std::max(area.h, 0);
+    opaque.assign(p_opaque, p_opaque + count);
+    stamp.assign(count, 0);
+    epoch = 0;
+    roomTotal = -1;
+    roomWords = 0;
+    roomBits.clear();
+}
+
+bool VisibilityMap::isOpaque(int x, int y) const {
+    int lx = x - area.x, ly = y - area.y;
+    if (lx < 0 || ly < 0 || lx >= area.w || ly >= area.h) return true;
+    return opaque[(size_t)ly * area.w + lx] != 0;
+}
+
+template <typename Visit>
+void VisibilityMap::shadowcast(int ox, int oy, int radius, std::vector<Row>& stack, Visit&& visit) const {
+    visit(ox, oy);
+    int64_t radius2 = (int64_t)radius * radius;
+    for (int q = 0; q < 4; ++q) {
+        stack.clear();
+        stack.push_back({1, -1, 1, 1, 1});
+        while (!stack.empty()) {
+            Row row = stack.back();
+            stack.pop_back();
+            if (radius > 0 && row.depth > radius) continue;
+
+            int64_t d = row.depth;
+            // Round the start up and the end down, ties towards the centre
+            int64_t minCol = floorDiv(2 * d * row.startNum + row.startDen, 2 * row.startDen);
+            int64_t maxCol = ceilDiv(2 * d * row.endNum - row.endDen, 2 * row.endDen);
+            int prev = -1; // -1 none yet, 0 floor, 1 wall
+            for (int64_t col = minCol; col <= maxCol; ++col) {
+                int x = ox + (int)(col * COL_X[q] + d * DEPTH_X[q]);
+                int y = oy + (int)(col * COL_Y[q] + d * DEPTH_Y[q]);
+                int lx = x - area.x, ly = y - area.y;
+                bool inside = lx >= 0 && ly >= 0 && lx < area.w && ly < area.h;
+                bool wall = !inside || opaque[(size_t)ly * area.w + lx];
+
+                // Floors need their centre inside the light (symmetry)
+                bool lit = wall || (col * row.startDen >= d * row.startNum && col * row.endDen <= d * row.endNum);
+                if (lit && inside && (radius <= 0 || col * col + d * d <= radius2)) visit(x, y);
+
+                if (prev == 1 && !wall) {
+                    row.startNum = 2 * col - 1;
+                    row.startDen = 2 * d;
+                }
+                if (prev == 0 && wall) {
+                    Row next = row;
+                    next.depth++;
+                    next.endNum = 2 * col - 1;
+                    next.endDen = 2 * d;
+                    stack.push_back(next);
+                }
+                prev = wall ? 1 : 0;
+            }
+            if (prev == 0) {
+                row.depth++;
+                stack.push_back(row);
+            }
+        }
+    }
+}
+
+void VisibilityMap::computeFov(int x, int y, int radius, std::vector<GridPoint>& out) {
+    out.clear();
+    int lx = x - area.x, ly = y - area.y;
+    if (lx < 0 || ly < 0 || lx >= area.w || ly >= area.h) return;
+
+    // Axes and diagonals are reached from two quadrants; stamps dedupe them
+    if (++epoch == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+    shadowcast(x, y, radius, rows, [&](int vx, int vy) {
+        uint32_t& s = stamp[(size_t)(vy - area.y) * area.w + (vx - area.x)];
+        if (s != epoch) {
+            s = epoch;
+            out.push_back({vx, vy});
+        }
+    });
+}
+
+void VisibilityMap::buildRoomVisibility(const RoomIndex& rooms, int threads) {
+    roomTotal = rooms.roomCount();
+    roomWords = (roomTotal + 63) / 64;
+    roomBits.assign((size_t)roomTotal * roomWords, 0);
+
+    parallelFor(roomTotal, threads, [&](int room) {
+        uint64_t* bits = roomBits.data() + (size_t)room * roomWords;
+        std::vector<Row> stack;
+        const GridRect& b = rooms.roomBounds(room);
+        for (int y = b.y; y < b.y + b.h; ++y) {
+            for (int x = b.x; x < b.x + b.w; ++x) {
+                if (rooms.roomAt(x, y) != room) continue;
+                shadowcast(x, y, 0, stack, [&](int vx, int vy) {
+                    int seen = rooms.roomAt(vx, vy);
+                    if (seen != RoomIndex::NONE) bits[seen >> 6] |= uint64_t(1) << (seen & 63);
+                });
+            }
+        }
+    });
+}
+
+bool VisibilityMap::roomSees(int from, int to) const {
+    if (from < 0 || to < 0 || from >= roomTotal || to >= roomTotal) return false;
+    return (roomBits[(size_t)from * roomWords + (to >> 6)] >> (to & 63)) & 1;
+}
+
+void VisibilityMap::visibleRooms(int room, std::vector<int>& out) const {
+    out.clear();
+    if (room < 0 || room >= roomTotal) return;
+    const uint64_t* bits = roomBits.data() + (size_t)room * roomWords;
+    for (int w = 0; w < roomWords; ++w) {
+        for (uint64_t word = bits[w]; word; word &= word - 1) {
+            int bit = 0;
+            while (!((word >> bit) & 1)) bit++;
+            out.push_back(w * 64 + bit);
+        }
+    }
+}
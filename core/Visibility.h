@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "GridGeometry.h"
+#include "RoomIndex.h"
+
+// --- Field of view and room visibility (Pure C++) ---
+//
+// An opacity bitmap over an area of world cells; everything outside the
+// area blocks sight. Field of view uses symmetric shadowcasting (Albert
+// Ford's variant): slopes are exact integer fractions, a floor cell is lit
+// only when its centre lies inside the light, and so A sees B exactly when
+// B sees A. Walls bordering a lit area are lit as well.
+//
+// computeFov() keeps its row stack and a per-cell stamp between calls, so
+// a query allocates nothing once the buffers have grown.
+//
+// The optional room table is a potentially-visible set: room a sees room b
+// when any cell of b is in the field of view of any cell of a. It is built
+// once, one bit per room pair.
+
+class VisibilityMap {
+public:
+    // Starts over with `opaque`, a row-major area.w * area.h mask (non-zero
+    // = blocks sight); it is copied. Drops the room table.
+    void reset(const GridRect& area, const uint8_t* opaque);
+
+    const GridRect& bounds() const { return area; }
+    bool isOpaque(int x, int y) const;
+
+    // Cells visible from (x, y), the origin included, each once. Cells
+    // farther than `radius` (Euclidean, in cells) are left out; radius <= 0
+    // means unlimited. Replaces the contents of `out`; empty when the
+    // origin lies outside the area.
+    void computeFov(int x, int y, int radius, std::vector<GridPoint>& out);
+
+    // Unlimited-radius field of view from every cell of every room, on up
+    // to `threads` workers (<= 0 = all cores).
+    void buildRoomVisibility(const RoomIndex& rooms, int threads);
+    bool hasRoomVisibility() const { return roomTotal >= 0; }
+    int roomCount() const { return roomTotal; }
+    bool roomSees(int from, int to) const;
+    // Rooms seen from `room` (itself included), in ascending id order.
+    void visibleRooms(int room, std::vector<int>& out) const;
+
+private:
+    struct Row {
+        int depth;
+        int64_t startNum, startDen; // slopes as exact fractions
+        int64_t endNum, endDen;
+    };
+
+    GridRect area{0, 0, 0, 0};
+    std::vector<uint8_t> opaque;
+
+    std::vector<Row> rows;
+    std::vector<uint32_t> stamp;
+    uint32_t epoch = 0;
+
+    int roomTotal = -1;
+    int roomWords = 0;
+    std::vector<uint64_t> roomBits; // row per room, roomWords words each
+
+    template <typename Visit>
+    void shadowcast(int ox, int oy, int radius, std::vector<Row>& stack, Visit&& visit) const;
+};
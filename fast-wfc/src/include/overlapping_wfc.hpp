@@ -68,13 +68,14 @@ private:
    */
   OverlappingWFC(
       const Array2D<T> &input, const OverlappingWFCOptions &options,
-      const int &seed,
+      uint64_t seed,
       const std::pair<std::vector<Array2D<T>>, std::vector<double>> &patterns,
       const std::vector<std::array<std::vector<unsigned>, 4>>
           &propagator) noexcept
       : input(input), options(options), patterns(patterns.first),
-        wfc(options.periodic_output, seed, patterns.second, propagator,
-            options.get_wave_height(), options.get_wave_width()) {
+        wfc(SquareTopology{options.get_wave_width(), options.get_wave_height(),
+                           options.periodic_output},
+            seed, patterns.second, propagator) {
     // If necessary, the ground is set.
     if (options.ground) {
       init_ground(wfc, input, patterns.first, options);
@@ -86,7 +87,7 @@ private:
    * parameters.
    */
   OverlappingWFC(const Array2D<T> &input, const OverlappingWFCOptions &options,
-                 const int &seed,
+                 uint64_t seed,
                  const std::pair<std::vector<Array2D<T>>, std::vector<double>>
                      &patterns) noexcept
       : OverlappingWFC(input, options, seed, patterns,
@@ -121,8 +122,11 @@ private:
     wfc.propagate();
   }
 
+public:
   /**
    * Return the id of the lowest middle pattern.
+   * This and the pattern helpers below are public so that callers solving
+   * part of an output can build the generic WFC input themselves.
    */
   static unsigned
   get_ground_pattern_id(const Array2D<T> &input,
@@ -251,6 +255,7 @@ private:
     return compatible;
   }
 
+private:
   /**
    * Transform a 2D array containing the patterns id to a 2D array containing
    * the pixels.
@@ -325,7 +330,7 @@ public:
    * The constructor used by the user.
    */
   OverlappingWFC(const Array2D<T> &input, const OverlappingWFCOptions &options,
-                 int seed) noexcept
+                 uint64_t seed) noexcept
       : OverlappingWFC(input, options, seed, get_patterns(input, options)) {}
 
   /**
@@ -354,6 +359,24 @@ public:
     }
     return std::nullopt;
   }
+
+  /**
+   * Record the decisions of run() into log (see WFC::set_decision_log).
+   */
+  void record_decisions(std::vector<WFCDecision> *log) noexcept {
+    wfc.set_decision_log(log);
+  }
+
+  /**
+   * Rebuild the result of a recorded run (see WFC::replay).
+   */
+  std::optional<Array2D<T>> replay(const std::vector<WFCDecision> &log) noexcept {
+    std::optional<Array2D<unsigned>> result = wfc.replay(log);
+    if (result.has_value()) {
+      return to_image(*result);
+    }
+    return std::nullopt;
+  }
 };
 
 #endif // FAST_WFC_WFC_HPP_
@@ -1,56 +1,46 @@
 #include "propagator.hpp"
 #include "wave.hpp"
 
-void Propagator::init_compatible() noexcept {
-  std::array<int, 4> value;
-  // We compute the number of pattern compatible in all directions.
-  for (unsigned y = 0; y < wave_height; y++) {
-    for (unsigned x = 0; x < wave_width; x++) {
-      for (unsigned pattern = 0; pattern < patterns_size; pattern++) {
-        for (int direction = 0; direction < 4; direction++) {
-          value[direction] =
-            static_cast<unsigned>(propagator_state[pattern][get_opposite_direction(direction)]
-                                  .size());
-        }
-        compatible.get(y, x, pattern) = value;
-      }
+template <typename Topology>
+void BasicPropagator<Topology>::init_compatible() noexcept {
+  // We compute the number of pattern compatible in all directions. It only
+  // depends on the pattern, so it is computed once and copied to every cell.
+  std::vector<std::array<int, nb_directions>> values(patterns_size);
+  for (unsigned pattern = 0; pattern < patterns_size; pattern++) {
+    for (unsigned direction = 0; direction < nb_directions; direction++) {
+      values[pattern][direction] = static_cast<int>(
+          propagator_state[pattern][nb_directions - 1 - direction].size());
+    }
+  }
+  for (std::size_t cell = 0; cell < compatible.height; cell++) {
+    for (unsigned pattern = 0; pattern < patterns_size; pattern++) {
+      compatible.get(cell, pattern) = values[pattern];
     }
   }
 }
 
-void Propagator::propagate(Wave &wave) noexcept {
+template <typename Topology>
+void BasicPropagator<Topology>::propagate(Wave &wave) noexcept {
 
   // We propagate every element while there is element to propagate.
   while (propagating.size() != 0) {
 
     // The cell and pattern that has been set to false.
-    unsigned y1, x1, pattern;
-    std::tie(y1, x1, pattern) = propagating.back();
+    unsigned i1, pattern;
+    std::tie(i1, pattern) = propagating.back();
     propagating.pop_back();
 
-    // We propagate the information in all 4 directions.
-    for (unsigned direction = 0; direction < 4; direction++) {
+    // We propagate the information in all directions.
+    const int *next = neighbours.data() + (std::size_t)i1 * nb_directions;
+    for (unsigned direction = 0; direction < nb_directions; direction++) {
 
       // We get the next cell in the direction direction.
-      int dx = directions_x[direction];
-      int dy = directions_y[direction];
-      int x2, y2;
-      if (periodic_output) {
-        x2 = ((int)x1 + dx + (int)wave.width) % wave.width;
-        y2 = ((int)y1 + dy + (int)wave.height) % wave.height;
-      } else {
-        x2 = x1 + dx;
-        y2 = y1 + dy;
-        if (x2 < 0 || x2 >= (int)wave.width) {
-          continue;
-        }
-        if (y2 < 0 || y2 >= (int)wave.height) {
-          continue;
-        }
+      if (next[direction] < 0) {
+        continue;
       }
 
       // The index of the second cell, and the patterns compatible
-      unsigned i2 = x2 + y2 * wave.width;
+      unsigned i2 = (unsigned)next[direction];
       const std::vector<unsigned> &patterns =
         propagator_state[pattern][direction];
 
@@ -62,16 +52,20 @@ void Propagator::propagate(Wave &wave) noexcept {
         // We decrease the number of compatible patterns in the opposite
         // direction If the pattern was discarded from the wave, the element
         // is still negative, which is not a problem
-        std::array<int, 4> &value = compatible.get(y2, x2, *it);
+        std::array<int, nb_directions> &value = compatible.get(i2, *it);
         value[direction]--;
 
         // If the element was set to 0 with this operation, we need to remove
         // the pattern from the wave, and propagate the information
         if (value[direction] == 0) {
-          add_to_propagator(y2, x2, *it);
+          add_to_propagator(i2, *it);
           wave.set(i2, *it, false);
         }
       }
     }
   }
 }
+
+template class BasicPropagator<SquareTopology>;
+template class BasicPropagator<CubeTopology>;
+template class BasicPropagator<HexTopology>;
@@ -1,57 +1,90 @@
 #include "wave.hpp"
 
+#include <cmath>
 #include <limits>
 
 namespace {
 
 /**
- * Return distribution * log(distribution).
+ * Number of fraction bits of the fixed-point frequencies and logarithms.
  */
-std::vector<double>
-get_plogp(const std::vector<double> &distribution) noexcept {
-  std::vector<double> plogp;
+constexpr unsigned fixed_bits = 20;
+
+/**
+ * Return log2(x) with fixed_bits fraction bits, for x >= 1.
+ * Only integer operations are used, so every platform gets the same bits.
+ */
+uint64_t fixed_log2(uint64_t x) noexcept {
+  unsigned integer = 0;
+  while (integer < 63 && (x >> (integer + 1)) != 0) {
+    integer++;
+  }
+  // Mantissa in [2^31, 2^32), squared once per fraction bit.
+  uint64_t mantissa = integer >= 31 ? x >> (integer - 31) : x << (31 - integer);
+  uint64_t result = (uint64_t)integer << fixed_bits;
+  for (unsigned bit = fixed_bits; bit-- > 0;) {
+    mantissa = (mantissa * mantissa) >> 31;
+    if (mantissa >= (uint64_t(1) << 32)) {
+      mantissa >>= 1;
+      result |= uint64_t(1) << bit;
+    }
+  }
+  return result;
+}
+
+/**
+ * Return the frequencies in fixed point. llround is exact, so this is too.
+ */
+std::vector<uint64_t>
+get_fixed(const std::vector<double> &distribution) noexcept {
+  std::vector<uint64_t> fixed;
   for (unsigned i = 0; i < distribution.size(); i++) {
-    plogp.push_back(distribution[i] * log(distribution[i]));
+    long long value = std::llround(std::ldexp(distribution[i], fixed_bits));
+    fixed.push_back(value < 1 ? 1 : (uint64_t)value);
   }
-  return plogp;
+  return fixed;
 }
 
 /**
- * Return min(v) / 2.
+ * Return distribution * log2(distribution).
  */
-double get_min_abs_half(const std::vector<double> &v) noexcept {
-  double min_abs_half = std::numeric_limits<double>::infinity();
-  for (unsigned i = 0; i < v.size(); i++) {
-    min_abs_half = std::min(min_abs_half, std::abs(v[i] / 2.0));
+std::vector<uint64_t>
+get_plogp(const std::vector<uint64_t> &distribution) noexcept {
+  std::vector<uint64_t> plogp;
+  for (unsigned i = 0; i < distribution.size(); i++) {
+    plogp.push_back(distribution[i] * fixed_log2(distribution[i]));
   }
-  return min_abs_half;
+  return plogp;
+}
+
+/**
+ * Return the entropy log2(sum) - plogp_sum / sum, in fixed point.
+ */
+int64_t get_entropy(uint64_t plogp_sum, uint64_t sum) noexcept {
+  return (int64_t)fixed_log2(sum) - (int64_t)(plogp_sum / sum);
 }
 
 } // namespace
 
-Wave::Wave(unsigned height, unsigned width,
+Wave::Wave(unsigned size,
      const std::vector<double> &patterns_frequencies) noexcept
-  : patterns_frequencies(patterns_frequencies),
-    plogp_patterns_frequencies(get_plogp(patterns_frequencies)),
-    min_abs_half_plogp(get_min_abs_half(plogp_patterns_frequencies)),
+  : patterns_frequencies(get_fixed(patterns_frequencies)),
+    plogp_patterns_frequencies(get_plogp(this->patterns_frequencies)),
     is_impossible(false), nb_patterns(patterns_frequencies.size()),
-    data(width * height, nb_patterns, 1), width(width), height(height),
-    size(height * width) {
+    data(size, nb_patterns, 1), size(size) {
   // Initialize the memoisation of entropy.
-  double base_entropy = 0;
-  double base_s = 0;
+  uint64_t base_entropy = 0;
+  uint64_t base_s = 0;
   for (unsigned i = 0; i < nb_patterns; i++) {
     base_entropy += plogp_patterns_frequencies[i];
-    base_s += patterns_frequencies[i];
+    base_s += this->patterns_frequencies[i];
   }
-  double log_base_s = log(base_s);
-  double entropy_base = log_base_s - base_entropy / base_s;
-  memoisation.plogp_sum = std::vector<double>(width * height, base_entropy);
-  memoisation.sum = std::vector<double>(width * height, base_s);
-  memoisation.log_sum = std::vector<double>(width * height, log_base_s);
+  memoisation.plogp_sum = std::vector<uint64_t>(size, base_entropy);
+  memoisation.sum = std::vector<uint64_t>(size, base_s);
   memoisation.nb_patterns =
-    std::vector<unsigned>(width * height, static_cast<unsigned>(nb_patterns));
-  memoisation.entropy = std::vector<double>(width * height, entropy_base);
+    std::vector<unsigned>(size, static_cast<unsigned>(nb_patterns));
+  memoisation.entropy =
+    std::vector<int64_t>(size, nb_patterns ? get_entropy(base_entropy, base_s) : 0);
 }
 
 
@@ -65,53 +98,50 @@ void Wave::set(unsigned index, unsigned pattern, bool value) noexcept {
   data.get(index, pattern) = value;
   memoisation.plogp_sum[index] -= plogp_patterns_frequencies[pattern];
   memoisation.sum[index] -= patterns_frequencies[pattern];
-  memoisation.log_sum[index] = log(memoisation.sum[index]);
   memoisation.nb_patterns[index]--;
-  memoisation.entropy[index] =
-    memoisation.log_sum[index] -
-    memoisation.plogp_sum[index] / memoisation.sum[index];
   // If there is no patterns possible in the cell, then there is a
   // contradiction.
   if (memoisation.nb_patterns[index] == 0) {
     is_impossible = true;
+    return;
   }
+  memoisation.entropy[index] =
+    get_entropy(memoisation.plogp_sum[index], memoisation.sum[index]);
 }
 
 
-int Wave::get_min_entropy(std::minstd_rand &gen) const noexcept {
+int Wave::get_min_entropy(CounterStream &gen) const noexcept {
   if (is_impossible) {
     return -2;
   }
 
-  std::uniform_real_distribution<> dis(0, min_abs_half_plogp);
-
-  // The minimum entropy (plus a small noise)
-  double min = std::numeric_limits<double>::infinity();
+  // The minimum entropy, ties broken by a random key.
+  int64_t min = std::numeric_limits<int64_t>::max();
+  uint64_t min_noise = 0;
   int argmin = -1;
 
   for (unsigned i = 0; i < size; i++) {
 
     // If the cell is decided, we do not compute the entropy (which is equal
     // to 0).
-    double nb_patterns_local = memoisation.nb_patterns[i];
-    if (nb_patterns_local == 1) {
+    if (memoisation.nb_patterns[i] == 1) {
       continue;
     }
 
     // Otherwise, we take the memoised entropy.
-    double entropy = memoisation.entropy[i];
+    int64_t entropy = memoisation.entropy[i];
 
-    // We first check if the entropy is less than the minimum.
+    // We first check if the entropy is at most the minimum.
     // This is important to reduce noise computation (which is not
     // negligible).
     if (entropy <= min) {
 
-      // Then, we add noise to decide randomly which will be chosen.
-      // noise is smaller than the smallest p * log(p), so the minimum entropy
-      // will always be chosen.
-      double noise = dis(gen);
-      if (entropy + noise < min) {
-        min = entropy + noise;
+      // Then, we draw a key to decide randomly which of the cells with the
+      // same entropy will be chosen: the smallest key is a uniform pick.
+      uint64_t noise = gen.next();
+      if (entropy < min || noise < min_noise) {
+        min = entropy;
+        min_noise = noise;
         argmin = i;
       }
     }
@@ -21,8 +21,10 @@ namespace {
 }
 
 
-Array2D<unsigned> WFC::wave_to_output() const noexcept {
-  Array2D<unsigned> output_patterns(wave.height, wave.width);
+template <typename Topology>
+typename BasicWFC<Topology>::Output
+BasicWFC<Topology>::wave_to_output() const noexcept {
+  Output output_patterns = topology.make_output();
   for (unsigned i = 0; i < wave.size; i++) {
     for (unsigned k = 0; k < nb_patterns; k++) {
       if (wave.get(i, k)) {
@@ -33,17 +35,19 @@ Array2D<unsigned> WFC::wave_to_output() const noexcept {
   return output_patterns;
 }
 
-WFC::WFC(bool periodic_output, int seed,
-         std::vector<double> patterns_frequencies,
-         Propagator::PropagatorState propagator, unsigned wave_height,
-         unsigned wave_width)
-  noexcept
-  : gen(seed), patterns_frequencies(normalize(patterns_frequencies)),
-    wave(wave_height, wave_width, patterns_frequencies),
+template <typename Topology>
+BasicWFC<Topology>::BasicWFC(const Topology &topology, uint64_t seed,
+                             std::vector<double> patterns_frequencies,
+                             PropagatorState propagator) noexcept
+  : topology(topology), gen(seed),
+    patterns_frequencies(normalize(patterns_frequencies)),
+    wave(topology.size(), patterns_frequencies),
     nb_patterns(propagator.size()),
-    propagator(wave.height, wave.width, periodic_output, propagator) {}
+    propagator(topology, propagator) {}
 
-std::optional<Array2D<unsigned>> WFC::run() noexcept {
+template <typename Topology>
+std::optional<typename BasicWFC<Topology>::Output>
+BasicWFC<Topology>::run() noexcept {
   while (true) {
 
     // Define the value of an undefined cell.
@@ -62,7 +66,48 @@ std::optional<Array2D<unsigned>> WFC::run() noexcept {
 }
 
 
-WFC::ObserveStatus WFC::observe() noexcept {
+template <typename Topology>
+std::optional<typename BasicWFC<Topology>::Output>
+BasicWFC<Topology>::replay(const std::vector<WFCDecision> &log) noexcept {
+  for (const WFCDecision &decision : log) {
+    if (decision.cell >= wave.size) {
+      return std::nullopt;
+    }
+    unsigned pattern = 0;
+    unsigned option = decision.option + 1;
+    for (; pattern < nb_patterns; pattern++) {
+      if (wave.get(decision.cell, pattern) && --option == 0) {
+        break;
+      }
+    }
+    if (pattern == nb_patterns) {
+      return std::nullopt;
+    }
+    collapse(decision.cell, pattern);
+    propagator.propagate(wave);
+  }
+
+  for (unsigned i = 0; i < wave.size; i++) {
+    if (wave.get_nb_patterns(i) != 1) {
+      return std::nullopt;
+    }
+  }
+  return wave_to_output();
+}
+
+template <typename Topology>
+void BasicWFC<Topology>::collapse(unsigned cell, unsigned pattern) noexcept {
+  for (unsigned k = 0; k < nb_patterns; k++) {
+    if (wave.get(cell, k) != (k == pattern)) {
+      propagator.add_to_propagator(cell, k);
+      wave.set(cell, k, false);
+    }
+  }
+}
+
+template <typename Topology>
+typename BasicWFC<Topology>::ObserveStatus
+BasicWFC<Topology>::observe() noexcept {
     // Get the cell with lowest entropy.
     int argmin = wave.get_min_entropy(gen);
 
@@ -84,8 +129,7 @@ WFC::ObserveStatus WFC::observe() noexcept {
       s += wave.get(argmin, k) ? patterns_frequencies[k] : 0;
     }
 
-    std::uniform_real_distribution<> dis(0, s);
-    double random_value = dis(gen);
+    double random_value = gen.unit() * s;
     size_t chosen_value = nb_patterns - 1;
 
     for (unsigned k = 0; k < nb_patterns; k++) {
@@ -96,14 +140,20 @@ WFC::ObserveStatus WFC::observe() noexcept {
       }
     }
 
-    // And define the cell with the pattern.
-    for (unsigned k = 0; k < nb_patterns; k++) {
-      if (wave.get(argmin, k) != (k == chosen_value)) {
-        propagator.add_to_propagator(argmin / wave.width, argmin % wave.width,
-                                     k);
-        wave.set(argmin, k, false);
+    if (decision_log) {
+      unsigned option = 0;
+      for (unsigned k = 0; k < chosen_value; k++) {
+        option += wave.get(argmin, k);
       }
+      decision_log->push_back({(unsigned)argmin, option});
     }
 
+    // And define the cell with the pattern.
+    collapse(argmin, chosen_value);
+
     return to_continue;
   }
+
+template class BasicWFC<SquareTopology>;
+template class BasicWFC<CubeTopology>;
+template class BasicWFC<HexTopology>;
@@ -1,8 +1,14 @@
 #include "DungeonBuilder.h"
 #include <algorithm>
+#include <numeric>
 #include <map>
 #include <set>
 #include <iostream>
+#include <random>
+
+#include "CounterRng.h"
+#include "GridAnalysis.h"
+#include "Parallel.h"
 
 // --- Helper Math (Global) ---
 static float distSq(float x1, float y1, float x2, float y2) {
@@ -29,51 +35,61 @@ struct DSU {
 
 // --- Implementation ---
 
-DungeonBuilder::DungeonBuilder() : rng(std::random_device{}()) {}
+DungeonBuilder::DungeonBuilder() {}
 
 void DungeonBuilder::init(const GenSettings& settings) {
     cfg = settings;
     
     if (cfg.seed == 0) {
-        rng.seed(std::random_device{}());
+        std::random_device device;
+        rng = CounterStream(((uint64_t)device() << 32) | device());
     } else {
-        rng.seed(cfg.seed);
+        rng = CounterStream(cfg.seed);
     }
 
     phase = Phase::Physics;
+    automataSteps = 0;
     rooms.clear();
     links.clear();
     walkers.clear();
+    sanctuary.clear();
     grid.clear();
     floors.clear();
     walls.clear();
     
     // Resize grid immediately
     grid.assign(cfg.gridWidth * cfg.gridHeight, Tile::Empty);
+    rowFloors.assign(cfg.gridHeight, {});
+    rowWalls.assign(cfg.gridHeight, {});
+    rowDirty.assign(cfg.gridHeight, 0);
+    dirtyRows.clear();
+    floorStart.assign(cfg.gridHeight + 1, 0);
+    wallStart.assign(cfg.gridHeight + 1, 0);
     
     // Spawn Rooms centered in the grid world
     float worldCX = (cfg.gridWidth * cfg.tileW) / 2.0f;
     float worldCY = (cfg.gridHeight * cfg.tileH) / 2.0f;
     
-    std::normal_distribution<float> sizeDist(12.0f, 6.0f);
-    std::uniform_real_distribution<float> angleDist(0, 6.2831f);
-    std::uniform_real_distribution<float> radDist(0, 1.0f);
-    
     for(int i=0; i<cfg.roomCount; ++i) {
         RoomObj r;
         r.id = i;
-        float angle = angleDist(rng);
-        float rad = std::sqrt(radDist(rng)) * cfg.spreadRadius; 
-        r.x = worldCX + std::cos(angle)*rad;
-        r.y = worldCY + std::sin(angle)*rad;
+        // Uniform in the spread disc by rejection: no sin/cos, whose last
+        // bits differ between math libraries
+        float dx, dy;
+        do {
+            dx = rng.uniform(-1.0f, 1.0f);
+            dy = rng.uniform(-1.0f, 1.0f);
+        } while (dx*dx + dy*dy > 1.0f);
+        r.x = worldCX + dx*cfg.spreadRadius;
+        r.y = worldCY + dy*cfg.spreadRadius;
         
-        float dim = std::max(8.0f, sizeDist(rng));
-        bool big = std::uniform_int_distribution<int>(0,10)(rng) > 8;
+        float dim = std::max(8.0f, rng.normal(12.0f, 6.0f));
+        bool big = rng.range(0,10) > 8;
         if(big) dim *= 3.0f;
         
         r.w = dim;
-        r.h = dim * std::uniform_real_distribution<float>(0.8f, 1.2f)(rng);
-        r.shape = (std::uniform_int_distribution<int>(0,1)(rng)==0) ? Shape::Rect : Shape::Circle;
+        r.h = dim * rng.uniform(0.8f, 1.2f);
+        r.shape = (rng.range(0,1)==0) ? Shape::Rect : Shape::Circle;
         if(r.shape == Shape::Circle) r.h = r.w; 
         
         r.vx = 0; r.vy = 0;
@@ -82,6 +98,14 @@ void DungeonBuilder::init(const GenSettings& settings) {
     }
 }
 
+void DungeonBuilder::generate(const GenSettings& settings, int maxSteps) {
+    init(settings);
+    while (!isComplete() && maxSteps > 0) {
+        step();
+        maxSteps--;
+    }
+}
+
 void DungeonBuilder::step() {
     if (phase == Phase::Physics) {
         updatePhysics();
@@ -92,39 +116,39 @@ void DungeonBuilder::step() {
     }
     else if (phase == Phase::Raster) {
         rasterizeBase();
-        rebuildTileLists();
+        buildSanctuaryMask();
         phase = Phase::Walkers;
         
         // Init Walkers
-        std::vector<Point> spawnPoints = floors;
+        const std::vector<Point>& spawnPoints = getFloors();
         if (!spawnPoints.empty()) {
+            // Walker i moves with substream i, so moves can run on any thread
             for(int i=0; i<cfg.walkerCount; ++i) {
-                Point p = spawnPoints[std::uniform_int_distribution<int>(0, spawnPoints.size()-1)(rng)];
-                walkers.push_back({p.x, p.y, std::uniform_int_distribution<int>(30, 100)(rng)});
+                Point p = spawnPoints[rng.range(0, (int)spawnPoints.size()-1)];
+                walkers.push(p.x, p.y, rng.range(30, 100), rng.substream(i).key);
             }
         }
     }
     else if (phase == Phase::Walkers) {
         updateWalkers();
-        rebuildTileLists(); // Sync for rendering
         if (walkers.empty()) {
             phase = Phase::Automata;
         }
     }
     else if (phase == Phase::Automata) {
-        static int caSteps = 0;
         runAutomataPass();
-        rebuildTileLists();
-        caSteps++;
-        if (caSteps >= 4) {
-            caSteps = 0;
+        automataSteps++;
+        if (automataSteps >= 4) {
             despeckleWalls(); // New cleaning pass
             pruneDeadEnds();
             floodFillPrune(); // Then ensure connectivity
-            rebuildTileLists();
             phase = Phase::Complete;
         }
     }
+
+    if (!cfg.deferTileLists) {
+        syncTileLists(); // Keep lists current for step-by-step rendering
+    }
 }
 
 void DungeonBuilder::updatePhysics() {
@@ -256,23 +280,35 @@ void DungeonBuilder::computeGraph() {
             dsu.unite(u, v);
             links.push_back({u, v, true}); 
         } else {
-            if(std::uniform_int_distribution<int>(0,10)(rng) > 8) {
+            if(rng.range(0,10) > 8) {
                 links.push_back({u, v, false}); 
             }
         }
     }
 }
 
+// Corridor routing costs: corridors are cheapest, main rooms other than the
+// two being linked are crossed only when needed
+static const uint8_t ROUTE_CORRIDOR_COST = 1;
+static const uint8_t ROUTE_EMPTY_COST = 4;
+static const uint8_t ROUTE_ROOM_COST = 12;
+
 void DungeonBuilder::rasterizeBase() {
     std::fill(grid.begin(), grid.end(), Tile::Empty);
+    markAllDirty();
     
+    // Grid bounds of each painted room (x0, y0, x1, y1), for routing
+    std::vector<int> roomBounds(rooms.size() * 4, 0);
     for(int idx : mainRoomIndices) {
         RoomObj& r = rooms[idx];
+        int* bounds = &roomBounds[idx * 4];
         if(r.shape == Shape::Rect) {
             int sx = toGridX(r.x - r.w/2); int sy = toGridY(r.y - r.h/2);
             int w = toGridX(r.w); int h = toGridY(r.h);
-            if(w < 1) w=1; if(h < 1) h=1;
+            if(w < 1) w=1;
+            if(h < 1) h=1;
             for(int y=sy; y<sy+h; ++y) for(int x=sx; x<sx+w; ++x) setTile(x,y,Tile::Floor);
+            bounds[0] = sx; bounds[1] = sy; bounds[2] = sx+w-1; bounds[3] = sy+h-1;
         } else {
             int cx = toGridX(r.x); int cy = toGridY(r.y);
             int radX = toGridX(r.w/2); int radY = toGridY(r.w/2);
@@ -280,6 +316,18 @@ void DungeonBuilder::rasterizeBase() {
                 float dx = (float)(x-cx); float dy = (float)(y-cy);
                 if((dx*dx)/(radX*radX) + (dy*dy)/(radY*radY) <= 1.0f) setTile(x,y,Tile::Floor);
             }
+            bounds[0] = cx-radX; bounds[1] = cy-radY; bounds[2] = cx+radX; bounds[3] = cy+radY;
+        }
+    }
+
+    if(cfg.routeCorridors) {
+        // Floors may not touch the two outermost rings (see setTile)
+        int W = cfg.gridWidth, H = cfg.gridHeight;
+        router.reset(W, H, ROUTE_EMPTY_COST);
+        router.setHeuristicCost(ROUTE_EMPTY_COST);
+        for(int y=0; y<H; ++y) for(int x=0; x<W; ++x) {
+            if(x<2 || x>W-3 || y<2 || y>H-3) router.cost(x,y) = CorridorRouter::BLOCKED;
+            else if(grid[y*W+x] == Tile::Floor) router.cost(x,y) = ROUTE_ROOM_COST;
         }
     }
     
@@ -296,7 +344,11 @@ void DungeonBuilder::rasterizeBase() {
             for(int y=ya; y!=yb+s; y+=s) { setTile(x,y,Tile::Floor); setTile(x+1,y,Tile::Floor); }
         };
         
-        if(std::uniform_int_distribution<int>(0,1)(rng)) {
+        // Drawn even when routing so later phases see the same RNG sequence
+        bool horizontalFirst = rng.range(0,1);
+        if(cfg.routeCorridors && routeLink(l, roomBounds)) continue;
+
+        if(horizontalFirst) {
             int mx = (x1+x2)/2; hline(x1,mx,y1); vline(y1,y2,mx); hline(mx,x2,y2);
         } else {
             int my = (y1+y2)/2; vline(y1,my,x1); hline(x1,x2,my); vline(my,y2,x2);
@@ -304,31 +356,137 @@ void DungeonBuilder::rasterizeBase() {
     }
 }
 
-void DungeonBuilder::updateWalkers() {
-    for(auto& w : walkers) {
-        if(w.life <= 0) continue;
-        int d = std::uniform_int_distribution<int>(0,3)(rng);
-        if(d==0) w.x--; else if(d==1) w.x++; else if(d==2) w.y--; else w.y++;
-        w.life--;
-        
-        if(w.x<1||w.x>=cfg.gridWidth-1||w.y<1||w.y>=cfg.gridHeight-1) { w.life=0; continue; }
-        
-        bool sanctuary = false;
-        float wx = w.x * cfg.tileW; float wy = w.y * cfg.tileH;
-        
-        for(int idx : mainRoomIndices) {
-            RoomObj& r = rooms[idx];
+bool DungeonBuilder::routeLink(const Link& link, const std::vector<int>& roomBounds) {
+    int W = cfg.gridWidth, H = cfg.gridHeight;
+    if(W < 5 || H < 5) return false;
+    auto clampPoint = [&](int x, int y) {
+        return RoutePoint{std::clamp(x, 2, W-3), std::clamp(y, 2, H-3)};
+    };
+    RoutePoint from = clampPoint(toGridX(rooms[link.u].x), toGridY(rooms[link.u].y));
+    RoutePoint to = clampPoint(toGridX(rooms[link.v].x), toGridY(rooms[link.v].y));
+
+    // The two linked rooms are walked out of at the empty-cell cost. Only
+    // the room cells are lowered and put back: the bounds of a circle room
+    // also cover empty corners, which must keep the empty-cell cost.
+    routeLowered.clear();
+    auto lowerRoomCost = [&](int idx) {
+        const int* b = &roomBounds[idx * 4];
+        for(int y=std::max(b[1], 0); y<=std::min(b[3], H-1); ++y) {
+            for(int x=std::max(b[0], 0); x<=std::min(b[2], W-1); ++x) {
+                uint8_t& c = router.cost(x,y);
+                if(c == ROUTE_ROOM_COST) {
+                    c = ROUTE_EMPTY_COST;
+                    routeLowered.push_back(y*W+x);
+                }
+            }
+        }
+    };
+    lowerRoomCost(link.u);
+    lowerRoomCost(link.v);
+    std::vector<RoutePoint> path;
+    bool routed = router.route(from, to, path);
+    for(int i : routeLowered) router.cost(i % W, i / W) = ROUTE_ROOM_COST;
+    if(!routed) return false;
+
+    // Two tiles wide like the L-shaped corridors: the second tile sits
+    // below horizontal steps and right of vertical ones
+    for(size_t i=0; i<path.size(); ++i) {
+        const RoutePoint& p = path[i];
+        const RoutePoint& q = (i > 0) ? path[i-1] : path[std::min(i+1, path.size()-1)];
+        bool horizontal = q.y == p.y;
+        int ex = horizontal ? p.x : p.x+1;
+        int ey = horizontal ? p.y+1 : p.y;
+        setTile(p.x, p.y, Tile::Floor);
+        setTile(ex, ey, Tile::Floor);
+        router.cost(p.x, p.y) = ROUTE_CORRIDOR_COST;
+        if(router.cost(ex, ey) != CorridorRouter::BLOCKED) router.cost(ex, ey) = ROUTE_CORRIDOR_COST;
+    }
+    return true;
+}
+
+void WalkerStore::clear() {
+    x.clear(); y.clear(); life.clear(); key.clear(); moves.clear();
+}
+
+void WalkerStore::push(int px, int py, int plife, uint64_t pkey) {
+    x.push_back(px); y.push_back(py); life.push_back(plife); key.push_back(pkey); moves.push_back(0);
+}
+
+void WalkerStore::compact() {
+    size_t out = 0;
+    for(size_t i=0; i<size(); ++i) {
+        if(life[i] <= 0) continue;
+        x[out] = x[i]; y[out] = y[i]; life[out] = life[i]; key[out] = key[i]; moves[out] = moves[i];
+        out++;
+    }
+    x.resize(out); y.resize(out); life.resize(out); key.resize(out); moves.resize(out);
+}
+
+const std::vector<WalkerAgent>& DungeonBuilder::getWalkers() const {
+    walkerView.resize(walkers.size());
+    for(size_t i=0; i<walkers.size(); ++i) walkerView[i] = {walkers.x[i], walkers.y[i], walkers.life[i]};
+    return walkerView;
+}
+
+void DungeonBuilder::buildSanctuaryMask() {
+    sanctuary.assign(((size_t)cfg.gridWidth * cfg.gridHeight + 63) / 64, 0);
+
+    for(int idx : mainRoomIndices) {
+        const RoomObj& r = rooms[idx];
+        // Cells whose world position can fall inside the room, padded by one
+        int x0 = std::max(0, (int)std::floor((r.x - r.w/2) / cfg.tileW) - 1);
+        int x1 = std::min(cfg.gridWidth - 1, (int)std::ceil((r.x + r.w/2) / cfg.tileW) + 1);
+        float halfH = (r.shape==Shape::Rect) ? r.h/2 : r.w/2;
+        int y0 = std::max(0, (int)std::floor((r.y - halfH) / cfg.tileH) - 1);
+        int y1 = std::min(cfg.gridHeight - 1, (int)std::ceil((r.y + halfH) / cfg.tileH) + 1);
+
+        for(int y=y0; y<=y1; ++y) for(int x=x0; x<=x1; ++x) {
+            // Same tests the walkers used to run per move
+            float wx = x * cfg.tileW; float wy = y * cfg.tileH;
+            bool inside;
             if(r.shape==Shape::Rect) {
-                if(wx > r.x-r.w/2+4 && wx < r.x+r.w/2-4 && wy > r.y-r.h/2+4 && wy < r.y+r.h/2-4) { sanctuary=true; break; }
+                inside = wx > r.x-r.w/2+4 && wx < r.x+r.w/2-4 && wy > r.y-r.h/2+4 && wy < r.y+r.h/2-4;
             } else {
-                if(distSq(wx,wy,r.x,r.y) < (r.w/2-2)*(r.w/2-2)) { sanctuary=true; break; }
+                inside = distSq(wx,wy,r.x,r.y) < (r.w/2-2)*(r.w/2-2);
+            }
+            if(inside) {
+                size_t i = (size_t)y * cfg.gridWidth + x;
+                sanctuary[i >> 6] |= uint64_t(1) << (i & 63);
             }
         }
-        
-        if(!sanctuary) setTile(w.x, w.y, Tile::Floor);
-        else w.life = 0; 
     }
-    walkers.erase(std::remove_if(walkers.begin(), walkers.end(), [](auto& w){return w.life<=0;}), walkers.end());
+}
+
+void DungeonBuilder::updateWalkers() {
+    // Moves only read the sanctuary mask, so they run in chunks on any
+    // thread; painting afterwards is cheap and stays on this thread.
+    const int chunkSize = 1024;
+    int count = (int)walkers.size();
+    int chunks = (count + chunkSize - 1) / chunkSize;
+    int* xs = walkers.x.data();
+    int* ys = walkers.y.data();
+    int* lives = walkers.life.data();
+    const uint64_t* keys = walkers.key.data();
+    uint32_t* moves = walkers.moves.data();
+
+    parallelFor(chunks, cfg.workerThreads, [&](int c) {
+        int end = std::min(count, (c + 1) * chunkSize);
+        for(int i=c*chunkSize; i<end; ++i) {
+            uint32_t d = counterRandomBelow(keys[i], moves[i]++, 4);
+            int x = xs[i] + (d==0 ? -1 : d==1 ? 1 : 0);
+            int y = ys[i] + (d==2 ? -1 : d==3 ? 1 : 0);
+            xs[i] = x; ys[i] = y;
+            lives[i]--;
+            // Out of bounds or inside a room: stop (negative life = stop without painting)
+            if(x<1||x>=cfg.gridWidth-1||y<1||y>=cfg.gridHeight-1) { lives[i] = -1; continue; }
+            if(isSanctuary(x, y)) lives[i] = -1;
+        }
+    });
+
+    for(int i=0; i<count; ++i) {
+        if(lives[i] >= 0) setTile(xs[i], ys[i], Tile::Floor);
+    }
+    walkers.compact();
 }
 
 void DungeonBuilder::runAutomataPass() {
@@ -345,132 +503,51 @@ void DungeonBuilder::runAutomataPass() {
         }
     }
     grid = next;
+    markAllDirty();
+}
+
+// Builds a byte mask of the cells holding `t`, for the GridAnalysis passes.
+std::vector<uint8_t> DungeonBuilder::tileMask(Tile t) const {
+    std::vector<uint8_t> mask(grid.size());
+    for (size_t i = 0; i < grid.size(); ++i) mask[i] = grid[i] == t;
+    return mask;
 }
 
 void DungeonBuilder::despeckleWalls() {
-    std::vector<int> wallRegions(grid.size(), 0);
-    int currentRegion = 0;
-    std::vector<std::vector<int>> regions;
+    std::vector<uint8_t> wallMask = tileMask(Tile::Wall);
+    ComponentLabels regions = labelComponents(wallMask.data(), cfg.gridWidth, cfg.gridHeight, cfg.workerThreads);
 
     for (int i = 0; i < (int)grid.size(); ++i) {
-        if (grid[i] == Tile::Wall && wallRegions[i] == 0) {
-            currentRegion++;
-            std::vector<int> q;
-            q.reserve(64); 
-            q.push_back(i);
-            wallRegions[i] = currentRegion;
-            
-            int head = 0;
-            while(head < (int)q.size()) {
-                int curr = q[head++];
-                int cx = curr % cfg.gridWidth;
-                int cy = curr / cfg.gridWidth;
-                
-                std::vector<int> candidates;
-                if(cx > 0) candidates.push_back(curr-1);
-                if(cx < cfg.gridWidth-1) candidates.push_back(curr+1);
-                if(cy > 0) candidates.push_back(curr-cfg.gridWidth);
-                if(cy < cfg.gridHeight-1) candidates.push_back(curr+cfg.gridWidth);
-
-                for(int n : candidates) {
-                    if(grid[n] == Tile::Wall && wallRegions[n] == 0) {
-                        wallRegions[n] = currentRegion;
-                        q.push_back(n);
-                    }
-                }
-            }
-            regions.push_back(q);
-        }
-    }
-
-    for (const auto& tiles : regions) {
-        if (tiles.size() < 10) { // Increased threshold to remove small blobs
-            for (int idx : tiles) {
-                int cx = idx % cfg.gridWidth; 
-                int cy = idx / cfg.gridWidth;
-                if (cx > 0 && cx < cfg.gridWidth-1 && cy > 0 && cy < cfg.gridHeight-1) {
-                    grid[idx] = Tile::Floor;
-                } else {
-                    grid[idx] = Tile::Empty;
-                }
-            }
+        int label = regions.labels[i];
+        if (label < 0 || regions.sizes[label] >= 10) continue; // Remove small blobs only
+        int cx = i % cfg.gridWidth; 
+        int cy = i / cfg.gridWidth;
+        if (cx > 0 && cx < cfg.gridWidth-1 && cy > 0 && cy < cfg.gridHeight-1) {
+            grid[i] = Tile::Floor;
+        } else {
+            grid[i] = Tile::Empty;
         }
     }
+    markAllDirty();
 }
 
 void DungeonBuilder::pruneDeadEnds() {
-    // Iteratively remove floor tiles that have 0 or 1 floor neighbors
-    bool changed = true;
-    int k = 0;
-    while(changed && k < 100) { // Safety limit
-        changed = false;
-        std::vector<int> toRemove;
-        
-        for(int y=1; y<cfg.gridHeight-1; ++y) {
-            for(int x=1; x<cfg.gridWidth-1; ++x) {
-                if(getTile(x,y) != Tile::Floor) continue;
-                
-                int n = 0;
-                if(getTile(x+1, y) == Tile::Floor) n++;
-                if(getTile(x-1, y) == Tile::Floor) n++;
-                if(getTile(x, y+1) == Tile::Floor) n++;
-                if(getTile(x, y-1) == Tile::Floor) n++;
-                
-                if(n <= 1) {
-                    toRemove.push_back(y*cfg.gridWidth + x);
-                }
-            }
-        }
-        
-        if(!toRemove.empty()){
-            changed = true;
-            for(int idx : toRemove) grid[idx] = Tile::Empty; // or Wall? Empty helps cleanup
-        }
-        k++;
-    }
+    // Iteratively remove floor tiles that have 0 or 1 floor neighbors.
+    // The outer ring is left alone, and 100 rounds is a safety limit.
+    std::vector<uint8_t> floorMask = tileMask(Tile::Floor);
+    std::vector<int32_t> removed = ::pruneDeadEnds(floorMask.data(), cfg.gridWidth, cfg.gridHeight, 100, true);
+    for (int32_t idx : removed) grid[idx] = Tile::Empty; // or Wall? Empty helps cleanup
+    markAllDirty();
 }
 
 void DungeonBuilder::floodFillPrune() {
-    std::vector<int> regions(grid.size(), 0);
-    int rID = 0;
-    std::map<int,int> sizes;
+    // Keep only the largest floor region (the first one found on ties)
+    std::vector<uint8_t> floorMask = tileMask(Tile::Floor);
+    ComponentLabels regions = labelComponents(floorMask.data(), cfg.gridWidth, cfg.gridHeight, cfg.workerThreads);
+    int bestR = regions.largest();
     
     for(int i=0; i<(int)grid.size(); ++i) {
-        if(grid[i]==Tile::Floor && regions[i]==0) {
-            rID++;
-            int size=0;
-            std::vector<int> q; q.reserve(cfg.gridWidth * cfg.gridHeight / 4);
-            q.push_back(i);
-            regions[i]=rID;
-            size++;
-            int head=0;
-            while(head<(int)q.size()){
-                int curr = q[head++];
-                int cx = curr%cfg.gridWidth; int cy = curr/cfg.gridWidth;
-                
-                int candidates[4];
-                int cCount = 0;
-                if(cx > 0) candidates[cCount++] = curr-1;
-                if(cx < cfg.gridWidth-1) candidates[cCount++] = curr+1;
-                if(cy > 0) candidates[cCount++] = curr-cfg.gridWidth;
-                if(cy < cfg.gridHeight-1) candidates[cCount++] = curr+cfg.gridWidth;
-
-                for(int k=0; k<cCount; ++k) {
-                    int n = candidates[k];
-                    if(grid[n]==Tile::Floor && regions[n]==0) {
-                        regions[n]=rID; q.push_back(n); size++;
-                    }
-                }
-            }
-            sizes[rID]=size;
-        }
-    }
-    
-    int bestR = -1, maxS = 0;
-    for(auto [r,s] : sizes) if(s>maxS) { maxS=s; bestR=r; }
-    
-    for(int i=0; i<(int)grid.size(); ++i) {
-        if(grid[i]==Tile::Floor && regions[i]!=bestR) grid[i]=Tile::Empty;
+        if(grid[i]==Tile::Floor && regions.labels[i]!=bestR) grid[i]=Tile::Empty;
     }
     
     // Wall Gen
@@ -484,18 +561,84 @@ void DungeonBuilder::floodFillPrune() {
             grid[i] = touch ? Tile::Wall : Tile::Empty;
         }
     }
+    markAllDirty();
 }
 
-void DungeonBuilder::rebuildTileLists() {
-    floors.clear();
-    walls.clear();
-    for(int y=0; y<cfg.gridHeight; ++y) {
+void DungeonBuilder::markRowDirty(int y) {
+    if (!rowDirty[y]) {
+        rowDirty[y] = 1;
+        dirtyRows.push_back(y);
+    }
+}
+
+void DungeonBuilder::markAllDirty() {
+    for(int y=0; y<cfg.gridHeight; ++y) markRowDirty(y);
+}
+
+// Replaces the spans of the `dirty` rows (ascending) of a row-major tile
+// list with `rows`, and updates the row offsets. Each run of clean rows
+// between two dirty ones is moved once; clean rows are never rescanned.
+static void spliceRows(std::vector<Point>& flat, std::vector<size_t>& start,
+                       const std::vector<std::vector<int>>& rows, const std::vector<int>& dirty) {
+    size_t count = dirty.size();
+    size_t oldSize = flat.size();
+    // shift[k]: how far the rows after dirty[k] move
+    std::vector<ptrdiff_t> shift(count);
+    ptrdiff_t total = 0;
+    for(size_t k=0; k<count; ++k) {
+        int y = dirty[k];
+        total += (ptrdiff_t)rows[y].size() - (ptrdiff_t)(start[y+1] - start[y]);
+        shift[k] = total;
+    }
+    if(total > 0) flat.resize(oldSize + total);
+
+    // Runs moving right go back to front and runs moving left front to back,
+    // so no run is overwritten before it has moved
+    auto run = [&](size_t k, size_t& from, size_t& to) {
+        from = start[dirty[k] + 1];
+        to = k + 1 < count ? start[dirty[k + 1]] : oldSize;
+    };
+    for(size_t k=count; k-- > 0;) {
+        size_t from, to;
+        run(k, from, to);
+        if(shift[k] > 0) std::move_backward(flat.begin() + from, flat.begin() + to, flat.begin() + (ptrdiff_t)to + shift[k]);
+    }
+    for(size_t k=0; k<count; ++k) {
+        size_t from, to;
+        run(k, from, to);
+        if(shift[k] < 0) std::move(flat.begin() + from, flat.begin() + to, flat.begin() + (ptrdiff_t)from + shift[k]);
+    }
+
+    // Write each dirty row (its own offset already moved with the run
+    // before it), then move the offsets up to the next dirty row
+    for(size_t k=0; k<count; ++k) {
+        int y = dirty[k];
+        Point* out = flat.data() + start[y];
+        for(int x : rows[y]) *out++ = {x, y};
+        int next = k + 1 < count ? dirty[k + 1] : (int)start.size() - 1;
+        for(int row=y+1; row<=next; ++row) start[row] += shift[k];
+    }
+    if(total < 0) flat.resize(oldSize + total);
+}
+
+void DungeonBuilder::syncTileLists() const {
+    if (dirtyRows.empty()) return;
+    std::sort(dirtyRows.begin(), dirtyRows.end());
+    for (int y : dirtyRows) {
+        rowDirty[y] = 0;
+        std::vector<int>& rowF = rowFloors[y];
+        std::vector<int>& rowW = rowWalls[y];
+        rowF.clear();
+        rowW.clear();
+        const Tile* row = grid.data() + (size_t)y * cfg.gridWidth;
         for(int x=0; x<cfg.gridWidth; ++x) {
-            Tile t = getTile(x,y);
-            if(t == Tile::Floor) floors.push_back({x,y});
-            else if(t == Tile::Wall) walls.push_back({x,y});
+            if(row[x] == Tile::Floor) rowF.push_back(x);
+            else if(row[x] == Tile::Wall) rowW.push_back(x);
         }
     }
+    spliceRows(floors, floorStart, rowFloors, dirtyRows);
+    spliceRows(walls, wallStart, rowWalls, dirtyRows);
+    dirtyRows.clear();
 }
 
 void DungeonBuilder::setTile(int x, int y, Tile t) {
@@ -503,7 +646,11 @@ void DungeonBuilder::setTile(int x, int y, Tile t) {
         // Prevent floors on the very edge to avoid leaks/renderer issues
         // Increased margin to 2 to ensure a solid wall seal + void boundary
         if (t == Tile::Floor && (x<=1 || x>=cfg.gridWidth-2 || y<=1 || y>=cfg.gridHeight-2)) return;
-        grid[y*cfg.gridWidth+x] = t;
+        Tile& cell = grid[y*cfg.gridWidth+x];
+        if (cell != t) {
+            cell = t;
+            markRowDirty(y);
+        }
     }
 }
 
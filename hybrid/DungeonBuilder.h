@@ -1,8 +1,11 @@
 #pragma once
+#include <cstdint>
 #include <vector>
-#include <random>
 #include <cmath>
 
+#include "CorridorRouter.h"
+#include "CounterRng.h"
+
 // --- Data Structures (Pure C++) ---
 
 enum class Shape { Rect, Circle };
@@ -31,6 +34,23 @@ struct WalkerAgent {
     int life;
 };
 
+// Structure-of-arrays walker state. Every walker draws its moves from its
+// own counter-based stream (key, move number), so walkers can be stepped in
+// any order or split across threads with identical results.
+struct WalkerStore {
+    std::vector<int> x, y;
+    std::vector<int> life;
+    std::vector<uint64_t> key;   // RNG stream of each walker
+    std::vector<uint32_t> moves; // moves taken, the stream counter
+
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+    void clear();
+    void push(int px, int py, int plife, uint64_t pkey);
+    // Drops walkers with life <= 0, keeping the others in order.
+    void compact();
+};
+
 struct GenSettings {
     int roomCount = 150;
     float spreadRadius = 50.0f;
@@ -39,7 +59,17 @@ struct GenSettings {
     int gridHeight = 150; 
     int tileW = 4;
     int tileH = 4;
-    unsigned int seed = 0; // 0 = Random
+    uint64_t seed = 0; // 0 = Random
+    // true: floor/wall lists are only rebuilt when getFloors()/getWalls()
+    // is called. false: they are brought up to date after every step().
+    bool deferTileLists = true;
+    // Workers for the parallel passes - walker moves and region labelling
+    // (0 = all hardware threads). Leave at 1 when builders already run in
+    // parallel. Output does not depend on this value.
+    int workerThreads = 1;
+    // Route links around main rooms and along earlier corridors (A* over a
+    // cost map) instead of carving straight L shapes.
+    bool routeCorridors = false;
 };
 
 // --- The API Class ---
@@ -61,16 +91,22 @@ public:
     
     void init(const GenSettings& settings);
     void step(); 
+    // init() followed by step() until complete (or maxSteps runs out).
+    void generate(const GenSettings& settings, int maxSteps = 100000);
     bool isComplete() const { return phase == Phase::Complete; }
     Phase getPhase() const { return phase; }
 
     const std::vector<RoomObj>& getRooms() const { return rooms; }
     const std::vector<Link>& getLinks() const { return links; }
-    const std::vector<WalkerAgent>& getWalkers() const { return walkers; }
+    const WalkerStore& getWalkerStore() const { return walkers; }
+    // Array-of-structs copy of getWalkerStore(), rebuilt when read.
+    const std::vector<WalkerAgent>& getWalkers() const;
     
-    const std::vector<Point>& getFloors() const { return floors; }
-    const std::vector<Point>& getWalls() const { return walls; }
-    int getTotalTiles() const { return static_cast<int>(floors.size() + walls.size()); }
+    // Row-major. Brings the lists up to date first, so the references are
+    // only valid until the next step().
+    const std::vector<Point>& getFloors() const { syncTileLists(); return floors; }
+    const std::vector<Point>& getWalls() const { syncTileLists(); return walls; }
+    int getTotalTiles() const { syncTileLists(); return static_cast<int>(floors.size() + walls.size()); }
 
     int getGridWidth() const { return cfg.gridWidth; }
     int getGridHeight() const { return cfg.gridHeight; }
@@ -79,29 +115,56 @@ public:
 
 private:
     GenSettings cfg;
-    std::mt19937 rng;
+    CounterStream rng{0};
     Phase phase;
+    int automataSteps = 0;
     
     std::vector<RoomObj> rooms;
     std::vector<int> mainRoomIndices;
     std::vector<Link> links;
-    std::vector<WalkerAgent> walkers;
+    WalkerStore walkers;
+    mutable std::vector<WalkerAgent> walkerView;
+
+    // One bit per cell: walkers stop on reaching a main room's interior.
+    // Built once after rasterizeBase so each move is a single bit test.
+    std::vector<uint64_t> sanctuary;
+    CorridorRouter router;
+    std::vector<int> routeLowered; // cells routeLink() opened up, to restore
     
     std::vector<Tile> grid;
-    
-    std::vector<Point> floors;
-    std::vector<Point> walls;
-    
+
+    // Tile lists are maintained per row: setTile() marks the rows it changes
+    // and only those rows are rescanned. The flat lists are row-major, and
+    // the *Start offsets (one per row, plus the end) locate each row's span,
+    // so a sync splices in just the dirty rows' spans.
+    mutable std::vector<std::vector<int>> rowFloors; // x of each floor, per row
+    mutable std::vector<std::vector<int>> rowWalls;
+    mutable std::vector<unsigned char> rowDirty;
+    mutable std::vector<int> dirtyRows;
+    mutable std::vector<Point> floors;
+    mutable std::vector<Point> walls;
+    mutable std::vector<size_t> floorStart;
+    mutable std::vector<size_t> wallStart;
+
     void updatePhysics();
     void computeGraph(); 
     void rasterizeBase(); 
+    bool routeLink(const Link& link, const std::vector<int>& roomBounds);
+    void buildSanctuaryMask();
+    bool isSanctuary(int x, int y) const {
+        size_t i = (size_t)y * cfg.gridWidth + x;
+        return (sanctuary[i >> 6] >> (i & 63)) & 1;
+    }
     void updateWalkers();
     void runAutomataPass();
     void despeckleWalls();
     void pruneDeadEnds();
     void floodFillPrune();
-    void rebuildTileLists(); 
-    
+    std::vector<uint8_t> tileMask(Tile t) const;
+    void markRowDirty(int y);
+    void markAllDirty(); // after passes that write grid[] directly
+    void syncTileLists() const;
+
     void setTile(int x, int y, Tile t);
     Tile getTile(int x, int y) const;
     int toGridX(float v) const { return static_cast<int>(v / cfg.tileW); }
@@ -0,0 +1,49 @@
+#include "acceptance.h"
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+
+bool read_acceptance(const Dictionary& dict, const char* class_name, AcceptanceCriteria& criteria,
+                     int* floor_value) {
+    criteria = AcceptanceCriteria();
+    Array keys = dict.keys();
+    for (int64_t i = 0; i < keys.size(); i++) {
+        String key = keys[i];
+        Variant value = dict[keys[i]];
+        if (value.get_type() != Variant::INT && value.get_type() != Variant::FLOAT) {
+            UtilityFunctions::push_error(class_name, ": acceptance '", key, "' must be a number");
+            return false;
+        }
+
+        if (key == "min_floor_ratio") {
+            criteria.minFloorRatio = (double)value;
+        } else if (key == "max_floor_ratio") {
+            criteria.maxFloorRatio = (double)value;
+        } else if (key == "max_regions") {
+            criteria.maxRegions = (int)value;
+        } else if (key == "min_largest_region") {
+            criteria.minLargestRegion = (int64_t)value;
+        } else if (key == "min_room_count") {
+            criteria.minRoomCount = (int)value;
+        } else if (key == "max_room_count") {
+            criteria.maxRoomCount = (int)value;
+        } else if (key == "min_critical_path") {
+            criteria.minCriticalPath = (int)value;
+        } else if (key == "floor_value" && floor_value) {
+            *floor_value = (int)value;
+        } else {
+            UtilityFunctions::push_error(class_name, ": unknown acceptance key '", key, "'");
+            return false;
+        }
+    }
+    return true;
+}
+
+Dictionary make_acceptance_report(const Variant& result, const AcceptedCandidate& found, int64_t base_seed) {
+    Dictionary report;
+    report["result"] = result;
+    if (found.index >= 0) {
+        report["seed"] = base_seed + found.index;
+    }
+    report["attempts"] = found.attempts;
+    return report;
+}
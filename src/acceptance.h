@@ -0,0 +1,32 @@
+#ifndef ACCEPTANCE_H
+#define ACCEPTANCE_H
+
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/variant.hpp>
+#include <cstdint>
+
+#include "Acceptance.h"
+
+using namespace godot;
+
+// ============================================================================
+// Shared helpers for the generators' generate_accepted() (see Acceptance.h)
+// ============================================================================
+
+// Reads an acceptance Dictionary; missing keys do not constrain:
+//   min_floor_ratio, max_floor_ratio  floor cells / area (0..1)
+//   max_regions, min_largest_region   4-connected floor regions, cells
+//   min_room_count, max_room_count    rooms in the result
+//   min_critical_path                 steps between the farthest floor pair
+//   floor_value                       WFC only: the tile value that is floor
+// floor_value is only read when `floor_value` is given. Unknown keys and
+// non-numeric values are reported with push_error, prefixed by
+// `class_name`, and make it return false.
+bool read_acceptance(const Dictionary& dict, const char* class_name, AcceptanceCriteria& criteria,
+                     int* floor_value = nullptr);
+
+// { "result": accepted result or null, "seed": its seed (only when one
+// passed), "attempts": candidates used }
+Dictionary make_acceptance_report(const Variant& result, const AcceptedCandidate& found, int64_t base_seed);
+
+#endif // ACCEPTANCE_H
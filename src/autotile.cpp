@@ -0,0 +1,101 @@
+#include "autotile.h"
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+#include <vector>
+
+#include "Autotile.h"
+#include "region_analysis.h"
+
+namespace {
+
+bool check_neighbours(int neighbours) {
+    if (neighbours != 4 && neighbours != 8) {
+        UtilityFunctions::push_error("Autotile neighbours must be 4 or 8, got ", neighbours);
+        return false;
+    }
+    return true;
+}
+
+// Dense 256-entry table, so the per-cell lookup is a single index
+std::vector<Vector2> dense_lut(const Dictionary& lut) {
+    std::vector<Vector2> table(256, Vector2(-1, -1));
+    Array keys = lut.keys();
+    for (int64_t i = 0; i < keys.size(); i++) {
+        int64_t mask = keys[i];
+        if (mask < 0 || mask > 255) continue;
+        Vector2i coords = lut[keys[i]];
+        table[mask] = Vector2((real_t)coords.x, (real_t)coords.y);
+    }
+    return table;
+}
+
+} // namespace
+
+PackedInt32Array position_bitmasks(const PackedVector2Array& positions, int neighbours) {
+    if (!check_neighbours(neighbours)) return PackedInt32Array();
+    PositionMask m = rasterize_positions(positions);
+    std::vector<uint8_t> bits;
+    computeBitmasks(m.cells.data(), m.width, m.height, neighbours, bits);
+
+    PackedInt32Array result;
+    result.resize(m.index.size());
+    int32_t* out = result.ptrw();
+    for (size_t i = 0; i < m.index.size(); i++) {
+        out[i] = bits[m.index[i]];
+    }
+    return result;
+}
+
+PackedInt32Array grid_bitmasks(const PackedInt32Array& tiles, int width, int height, int value, int neighbours) {
+    std::vector<uint8_t> mask;
+    if (!check_neighbours(neighbours) || !make_grid_mask(tiles, width, height, value, mask)) {
+        return PackedInt32Array();
+    }
+    std::vector<uint8_t> bits;
+    computeBitmasks(mask.data(), width, height, neighbours, bits);
+
+    PackedInt32Array result;
+    result.resize(bits.size());
+    int32_t* out = result.ptrw();
+    for (size_t i = 0; i < bits.size(); i++) {
+        out[i] = mask[i] ? bits[i] : -1;
+    }
+    return result;
+}
+
+PackedVector2Array position_autotile(const PackedVector2Array& positions, const Dictionary& lut, int neighbours) {
+    if (!check_neighbours(neighbours)) return PackedVector2Array();
+    PositionMask m = rasterize_positions(positions);
+    std::vector<uint8_t> bits;
+    computeBitmasks(m.cells.data(), m.width, m.height, neighbours, bits);
+    std::vector<Vector2> table = dense_lut(lut);
+
+    PackedVector2Array result;
+    result.resize(m.index.size());
+    Vector2* out = result.ptrw();
+    for (size_t i = 0; i < m.index.size(); i++) {
+        out[i] = table[bits[m.index[i]]];
+    }
+    return result;
+}
+
+PackedVector2Array grid_autotile(const PackedInt32Array& tiles, int width, int height, int value,
+                                 const Dictionary& lut, int neighbours) {
+    std::vector<uint8_t> mask;
+    if (!check_neighbours(neighbours) || !make_grid_mask(tiles, width, height, value, mask)) {
+        return PackedVector2Array();
+    }
+    std::vector<uint8_t> bits;
+    computeBitmasks(mask.data(), width, height, neighbours, bits);
+    std::vector<Vector2> table = dense_lut(lut);
+
+    PackedVector2Array result;
+    result.resize(bits.size());
+    Vector2* out = result.ptrw();
+    const Vector2 none(-1, -1);
+    for (size_t i = 0; i < bits.size(); i++) {
+        out[i] = mask[i] ? table[bits[i]] : none;
+    }
+    return result;
+}
@@ -0,0 +1,27 @@
+#ifndef AUTOTILE_H
+#define AUTOTILE_H
+
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+
+using namespace godot;
+
+// ============================================================================
+// Shared helpers for the result classes' autotile queries (see Autotile.h)
+// ============================================================================
+
+// Neighbour bitmask of every position (4 or 8 neighbours, in input order),
+// or of every grid cell holding `value` (-1 for other cells). Push an error
+// and return an empty array when `neighbours` is not 4 or 8.
+PackedInt32Array position_bitmasks(const PackedVector2Array& positions, int neighbours);
+PackedInt32Array grid_bitmasks(const PackedInt32Array& tiles, int width, int height, int value, int neighbours);
+
+// The same bitmasks mapped through `lut` ({ bitmask: Vector2i atlas coords })
+// in one pass. Cells of other values and bitmasks missing from the table
+// get (-1, -1).
+PackedVector2Array position_autotile(const PackedVector2Array& positions, const Dictionary& lut, int neighbours);
+PackedVector2Array grid_autotile(const PackedInt32Array& tiles, int width, int height, int value,
+                                 const Dictionary& lut, int neighbours);
+
+#endif // AUTOTILE_H
@@ -1,34 +1,16 @@
 #include "bsp_godot.h"
 #include <godot_cpp/variant/utility_functions.hpp>
-#include <set>
-#include <algorithm>
-
-// BSPLeaf implementation
-bool BSPLeaf::split(int min_room_size, std::mt19937& rng) {
-    if (left || right)
-        return false;
-
-    int min_split_size = min_room_size + 2;
-    bool can_split_h = rect.size.x >= min_split_size * 2;
-    bool can_split_v = rect.size.y >= min_split_size * 2;
-
-    if (!can_split_h && !can_split_v)
-        return false;
-
-    bool split_h = can_split_h && (!can_split_v || std::uniform_real_distribution<>(0, 1)(rng) < 0.5);
-
-    if (split_h) {
-        int split_x = std::uniform_int_distribution<>(min_split_size, rect.size.x - min_split_size)(rng);
-        left = new BSPLeaf({rect.position, {split_x, rect.size.y}});
-        right = new BSPLeaf({{rect.position.x + split_x, rect.position.y}, {rect.size.x - split_x, rect.size.y}});
-    } else {
-        int split_y = std::uniform_int_distribution<>(min_split_size, rect.size.y - min_split_size)(rng);
-        left = new BSPLeaf({rect.position, {rect.size.x, split_y}});
-        right = new BSPLeaf({{rect.position.x, rect.position.y + split_y}, {rect.size.x, rect.size.y - split_y}});
-    }
-
-    return true;
-}
+#include <random>
+
+#include "Parallel.h"
+#include "acceptance.h"
+#include "autotile.h"
+#include "grid_geometry.h"
+#include "placement.h"
+#include "region_analysis.h"
+#include "result_codec.h"
+#include "room_index.h"
+#include "visibility.h"
 
 // BSPResult implementation
 BSPResult::BSPResult() {
@@ -42,10 +24,44 @@ void BSPResult::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_wall_positions"), &BSPResult::get_wall_positions);
     ClassDB::bind_method(D_METHOD("get_corridor_positions"), &BSPResult::get_corridor_positions);
     ClassDB::bind_method(D_METHOD("get_floor_count"), &BSPResult::get_floor_count);
+    ClassDB::bind_method(D_METHOD("get_room_rects"), &BSPResult::get_room_rects);
+    ClassDB::bind_method(D_METHOD("get_room_count"), &BSPResult::get_room_count);
+    ClassDB::bind_method(D_METHOD("room_at", "cell"), &BSPResult::room_at);
+    ClassDB::bind_method(D_METHOD("rooms_in_rect", "rect"), &BSPResult::rooms_in_rect);
+    ClassDB::bind_method(D_METHOD("get_room_neighbours", "room"), &BSPResult::get_room_neighbours);
+    ClassDB::bind_method(D_METHOD("get_room_bounds", "room"), &BSPResult::get_room_bounds);
+    ClassDB::bind_method(D_METHOD("get_fov", "origin", "radius"), &BSPResult::get_fov, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_visible_rooms", "room", "threads"), &BSPResult::get_visible_rooms, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("can_room_see", "from", "to"), &BSPResult::can_room_see);
+    ClassDB::bind_method(D_METHOD("get_floor_regions", "threads"), &BSPResult::get_floor_regions, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_dead_end_positions"), &BSPResult::get_dead_end_positions);
+    ClassDB::bind_method(D_METHOD("get_distance_field", "sources"), &BSPResult::get_distance_field);
+    ClassDB::bind_method(D_METHOD("get_farthest_pair"), &BSPResult::get_farthest_pair);
+    ClassDB::bind_method(D_METHOD("get_critical_path"), &BSPResult::get_critical_path);
+    ClassDB::bind_method(D_METHOD("get_chokepoints"), &BSPResult::get_chokepoints);
+    ClassDB::bind_method(D_METHOD("get_wall_rects"), &BSPResult::get_wall_rects);
+    ClassDB::bind_method(D_METHOD("get_floor_rects"), &BSPResult::get_floor_rects);
+    ClassDB::bind_method(D_METHOD("get_wall_contours", "epsilon"), &BSPResult::get_wall_contours, DEFVAL(0.0));
+    ClassDB::bind_method(D_METHOD("get_floor_contours", "epsilon"), &BSPResult::get_floor_contours, DEFVAL(0.0));
+    ClassDB::bind_method(D_METHOD("get_wall_contour_chunks", "chunk_size", "epsilon", "threads"),
+                         &BSPResult::get_wall_contour_chunks, DEFVAL(0.0), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_floor_contour_chunks", "chunk_size", "epsilon", "threads"),
+                         &BSPResult::get_floor_contour_chunks, DEFVAL(0.0), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_wall_bitmasks", "neighbours"), &BSPResult::get_wall_bitmasks, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_floor_bitmasks", "neighbours"), &BSPResult::get_floor_bitmasks, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_wall_autotile", "lut", "neighbours"), &BSPResult::get_wall_autotile, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_floor_autotile", "lut", "neighbours"), &BSPResult::get_floor_autotile, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_floor_placements", "radii", "seed", "counts", "exclude", "keep_out"),
+                         &BSPResult::get_floor_placements, DEFVAL(PackedInt32Array()), DEFVAL(PackedVector2Array()),
+                         DEFVAL(PackedVector3Array()));
+    ClassDB::bind_method(D_METHOD("to_bytes", "compress"), &BSPResult::to_bytes, DEFVAL(true));
+    ClassDB::bind_static_method("BSPResult", D_METHOD("from_bytes", "bytes"), &BSPResult::from_bytes);
 }
 
 void BSPResult::set_floor_positions(const PackedVector2Array& positions) {
     floor_positions = positions;
+    room_index_built = false;
+    visibility_built = false;
 }
 
 void BSPResult::set_wall_positions(const PackedVector2Array& positions) {
@@ -56,6 +72,12 @@ void BSPResult::set_corridor_positions(const PackedVector2Array& positions) {
     corridor_positions = positions;
 }
 
+void BSPResult::set_room_rects(const PackedInt32Array& rects) {
+    room_rects = rects;
+    room_index_built = false;
+    visibility_built = false;
+}
+
 PackedVector2Array BSPResult::get_floor_positions() const {
     return floor_positions;
 }
@@ -72,11 +94,160 @@ int BSPResult::get_floor_count() const {
     return floor_positions.size();
 }
 
+PackedInt32Array BSPResult::get_room_rects() const {
+    return room_rects;
+}
+
+int BSPResult::get_room_count() const {
+    return room_rects.size() / 4;
+}
+
+const RoomIndex& BSPResult::room_lookup() const {
+    if (!room_index_built) {
+        build_rect_room_index(room_index, floor_positions, room_rects);
+        room_index_built = true;
+    }
+    return room_index;
+}
+
+int BSPResult::room_at(const Vector2i& cell) const {
+    return index_room_at(room_lookup(), cell);
+}
+
+PackedInt32Array BSPResult::rooms_in_rect(const Rect2i& rect) const {
+    return index_rooms_in_rect(room_lookup(), rect);
+}
+
+PackedInt32Array BSPResult::get_room_neighbours(int room) const {
+    return index_room_neighbours(room_lookup(), room);
+}
+
+Rect2i BSPResult::get_room_bounds(int room) const {
+    return index_room_bounds(room_lookup(), room);
+}
+
+VisibilityMap& BSPResult::visibility_map() const {
+    if (!visibility_built) {
+        build_position_visibility(visibility, floor_positions);
+        visibility_built = true;
+    }
+    return visibility;
+}
+
+PackedVector2Array BSPResult::get_fov(const Vector2i& origin, int radius) const {
+    return visibility_fov(visibility_map(), origin, radius);
+}
+
+PackedInt32Array BSPResult::get_visible_rooms(int room, int threads) const {
+    return visibility_rooms(visibility_map(), room_lookup(), room, threads);
+}
+
+bool BSPResult::can_room_see(int from, int to) const {
+    return visibility_room_sees(visibility_map(), room_lookup(), from, to);
+}
+
+Dictionary BSPResult::get_floor_regions(int threads) const {
+    return analyze_position_regions(floor_positions, threads);
+}
+
+PackedVector2Array BSPResult::get_dead_end_positions() const {
+    return find_position_dead_ends(floor_positions);
+}
+
+PackedInt32Array BSPResult::get_distance_field(const PackedVector2Array& sources) const {
+    return position_distance_field(floor_positions, sources);
+}
+
+PackedVector2Array BSPResult::get_farthest_pair() const {
+    return position_farthest_pair(floor_positions);
+}
+
+PackedVector2Array BSPResult::get_critical_path() const {
+    return position_critical_path(floor_positions);
+}
+
+PackedVector2Array BSPResult::get_chokepoints() const {
+    return position_chokepoints(floor_positions);
+}
+
+PackedInt32Array BSPResult::get_wall_rects() const {
+    return merge_position_rects(wall_positions);
+}
+
+PackedInt32Array BSPResult::get_floor_rects() const {
+    return merge_position_rects(floor_positions);
+}
+
+Array BSPResult::get_wall_contours(double epsilon) const {
+    return position_contours(wall_positions, epsilon);
+}
+
+Array BSPResult::get_floor_contours(double epsilon) const {
+    return position_contours(floor_positions, epsilon);
+}
+
+Array BSPResult::get_wall_contour_chunks(int chunk_size, double epsilon, int threads) const {
+    return position_contour_chunks(wall_positions, chunk_size, epsilon, threads);
+}
+
+Array BSPResult::get_floor_contour_chunks(int chunk_size, double epsilon, int threads) const {
+    return position_contour_chunks(floor_positions, chunk_size, epsilon, threads);
+}
+
+PackedInt32Array BSPResult::get_wall_bitmasks(int neighbours) const {
+    return position_bitmasks(wall_positions, neighbours);
+}
+
+PackedInt32Array BSPResult::get_floor_bitmasks(int neighbours) const {
+    return position_bitmasks(floor_positions, neighbours);
+}
+
+PackedVector2Array BSPResult::get_wall_autotile(const Dictionary& lut, int neighbours) const {
+    return position_autotile(wall_positions, lut, neighbours);
+}
+
+PackedVector2Array BSPResult::get_floor_autotile(const Dictionary& lut, int neighbours) const {
+    return position_autotile(floor_positions, lut, neighbours);
+}
+
+Array BSPResult::get_floor_placements(const PackedFloat32Array& radii, int64_t seed, const PackedInt32Array& counts,
+                                      const PackedVector2Array& exclude, const PackedVector3Array& keep_out) const {
+    return position_poisson(floor_positions, radii, seed, counts, exclude, keep_out);
+}
+
+PackedByteArray BSPResult::to_bytes(bool compress) const {
+    // Corridors are a subset of floors, so the layered grid stores them for free
+    ByteWriter body;
+    const PackedVector2Array* layers[] = {&floor_positions, &wall_positions, &corridor_positions};
+    write_position_layers(body, layers, 3);
+    write_rect_list(body, room_rects);
+    return make_result_blob(MapAlgorithm::BSP, body, compress);
+}
+
+Ref<BSPResult> BSPResult::from_bytes(const PackedByteArray& bytes) {
+    std::vector<uint8_t> scratch;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (!open_result_blob(bytes, MapAlgorithm::BSP, "BSPResult", scratch, data, size)) {
+        return Ref<BSPResult>();
+    }
+
+    ByteReader in(data, size);
+    Ref<BSPResult> result;
+    result.instantiate();
+    PackedVector2Array* layers[] = {&result->floor_positions, &result->wall_positions, &result->corridor_positions};
+    // Blobs written before rooms were stored end after the positions
+    if (!read_position_layers(in, layers, 3) || (in.remaining() > 0 && !read_rect_list(in, result->room_rects))) {
+        UtilityFunctions::push_error("BSPResult.from_bytes: blob is corrupt");
+        return Ref<BSPResult>();
+    }
+    return result;
+}
+
 // BSPDungeonGenerator implementation
 BSPDungeonGenerator::BSPDungeonGenerator()
     : map_width(64), map_height(64), min_room_size(5), max_room_size(12),
-      max_splits(6), room_padding(1), use_seed(false), seed(12345),
-      rng(std::random_device{}()) {
+      max_splits(6), room_padding(1), route_corridors(false), use_seed(false), seed(12345) {
 }
 
 BSPDungeonGenerator::~BSPDungeonGenerator() {
@@ -87,9 +258,14 @@ void BSPDungeonGenerator::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_room_size_range", "min_size", "max_size"), &BSPDungeonGenerator::set_room_size_range);
     ClassDB::bind_method(D_METHOD("set_max_splits", "splits"), &BSPDungeonGenerator::set_max_splits);
     ClassDB::bind_method(D_METHOD("set_room_padding", "padding"), &BSPDungeonGenerator::set_room_padding);
+    ClassDB::bind_method(D_METHOD("set_route_corridors", "enabled"), &BSPDungeonGenerator::set_route_corridors);
     ClassDB::bind_method(D_METHOD("set_use_seed", "enabled"), &BSPDungeonGenerator::set_use_seed);
     ClassDB::bind_method(D_METHOD("set_seed", "seed_value"), &BSPDungeonGenerator::set_seed);
     ClassDB::bind_method(D_METHOD("generate"), &BSPDungeonGenerator::generate);
+    ClassDB::bind_method(D_METHOD("generate_batch", "seeds", "threads"), &BSPDungeonGenerator::generate_batch, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("generate_accepted", "max_attempts", "threads"),
+                         &BSPDungeonGenerator::generate_accepted, DEFVAL(32), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("set_acceptance", "acceptance"), &BSPDungeonGenerator::set_acceptance);
 
     ClassDB::bind_method(D_METHOD("get_map_width"), &BSPDungeonGenerator::get_map_width);
     ClassDB::bind_method(D_METHOD("get_map_height"), &BSPDungeonGenerator::get_map_height);
@@ -97,8 +273,10 @@ void BSPDungeonGenerator::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_max_room_size"), &BSPDungeonGenerator::get_max_room_size);
     ClassDB::bind_method(D_METHOD("get_max_splits"), &BSPDungeonGenerator::get_max_splits);
     ClassDB::bind_method(D_METHOD("get_room_padding"), &BSPDungeonGenerator::get_room_padding);
+    ClassDB::bind_method(D_METHOD("get_route_corridors"), &BSPDungeonGenerator::get_route_corridors);
     ClassDB::bind_method(D_METHOD("get_use_seed"), &BSPDungeonGenerator::get_use_seed);
     ClassDB::bind_method(D_METHOD("get_seed"), &BSPDungeonGenerator::get_seed);
+    ClassDB::bind_method(D_METHOD("get_acceptance"), &BSPDungeonGenerator::get_acceptance);
 }
 
 void BSPDungeonGenerator::set_map_size(int width, int height) {
@@ -119,183 +297,131 @@ void BSPDungeonGenerator::set_room_padding(int padding) {
     room_padding = padding;
 }
 
+void BSPDungeonGenerator::set_route_corridors(bool enabled) {
+    route_corridors = enabled;
+}
+
 void BSPDungeonGenerator::set_use_seed(bool enabled) {
     use_seed = enabled;
 }
 
-void BSPDungeonGenerator::set_seed(int seed_value) {
+void BSPDungeonGenerator::set_seed(int64_t seed_value) {
     seed = seed_value;
 }
 
-int BSPDungeonGenerator::randi_range(int from, int to) {
-    if (from > to)
-        std::swap(from, to);
-    return std::uniform_int_distribution<>(from, to)(rng);
-}
-
-void BSPDungeonGenerator::connect_rooms(BSPLeaf* node) {
-    if (!node || (!node->left && !node->right))
-        return;
-
-    if (node->left && node->right) {
-        BSPVec2i a = get_representative_point(node->left);
-        BSPVec2i b = get_representative_point(node->right);
-        if (!(a == BSPVec2i{0, 0}) && !(b == BSPVec2i{0, 0})) {
-            create_corridor(a, b);
-        }
-    }
-
-    connect_rooms(node->left);
-    connect_rooms(node->right);
+void BSPDungeonGenerator::set_acceptance(const Dictionary& p_acceptance) {
+    acceptance = p_acceptance;
 }
 
-BSPVec2i BSPDungeonGenerator::get_representative_point(BSPLeaf* leaf) {
-    if (!leaf)
-        return {0, 0};
-    if (leaf->has_room)
-        return leaf->room.center();
-    BSPVec2i left = get_representative_point(leaf->left);
-    if (!(left == BSPVec2i{0, 0}))
-        return left;
-    return get_representative_point(leaf->right);
+BSPSettings BSPDungeonGenerator::make_settings(uint64_t p_seed) const {
+    BSPSettings settings;
+    settings.mapWidth = map_width;
+    settings.mapHeight = map_height;
+    settings.minRoomSize = min_room_size;
+    settings.maxRoomSize = max_room_size;
+    settings.maxSplits = max_splits;
+    settings.roomPadding = room_padding;
+    settings.routeCorridors = route_corridors;
+    settings.seed = p_seed;
+    return settings;
 }
 
-void BSPDungeonGenerator::create_corridor(BSPVec2i a, BSPVec2i b) {
-    BSPVec2i pos = a;
-    if (std::uniform_real_distribution<>(0, 1)(rng) < 0.5) {
-        while (pos.x != b.x) {
-            pos.x += (b.x > pos.x ? 1 : -1);
-            corridors.push_back(pos);
-        }
-        while (pos.y != b.y) {
-            pos.y += (b.y > pos.y ? 1 : -1);
-            corridors.push_back(pos);
-        }
-    } else {
-        while (pos.y != b.y) {
-            pos.y += (b.y > pos.y ? 1 : -1);
-            corridors.push_back(pos);
-        }
-        while (pos.x != b.x) {
-            pos.x += (b.x > pos.x ? 1 : -1);
-            corridors.push_back(pos);
+Ref<BSPResult> BSPDungeonGenerator::make_result(const BSPBuilder& builder) {
+    auto to_packed = [](const std::vector<BSPVec2i>& tiles) {
+        PackedVector2Array out;
+        out.resize(tiles.size());
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            out[i] = Vector2(tiles[i].x, tiles[i].y);
         }
+        return out;
+    };
+
+    Ref<BSPResult> result;
+    result.instantiate();
+    result->set_floor_positions(to_packed(builder.getFloors()));
+    result->set_corridor_positions(to_packed(builder.getCorridors()));
+    result->set_wall_positions(to_packed(builder.getWalls()));
+
+    const std::vector<BSPRect2i>& rooms = builder.getRooms();
+    PackedInt32Array rects;
+    rects.resize(rooms.size() * 4);
+    int32_t* r = rects.ptrw();
+    for (const BSPRect2i& room : rooms) {
+        *r++ = room.position.x;
+        *r++ = room.position.y;
+        *r++ = room.size.x;
+        *r++ = room.size.y;
     }
+    result->set_room_rects(rects);
+    return result;
 }
 
 Ref<BSPResult> BSPDungeonGenerator::generate() {
-    // Initialize RNG
-    if (use_seed) {
-        rng.seed(seed);
-    } else {
-        rng.seed(std::random_device{}());
-    }
-
-    leaves.clear();
-    rooms.clear();
-    corridors.clear();
-
-    // BSP partitioning
-    BSPLeaf* root = new BSPLeaf({BSPVec2i{0, 0}, BSPVec2i{map_width, map_height}});
-    std::vector<BSPLeaf*> queue = {root};
-    int split_count = 0;
-
-    while (split_count < max_splits && !queue.empty()) {
-        std::vector<BSPLeaf*> next;
-        bool did_split = false;
-        for (auto* leaf : queue) {
-            if (leaf->split(min_room_size, rng)) {
-                next.push_back(leaf->left);
-                next.push_back(leaf->right);
-                did_split = true;
-            } else {
-                leaves.push_back(leaf);
-            }
-        }
-        if (!did_split) {
-            leaves.insert(leaves.end(), next.begin(), next.end());
-            break;
-        }
-        queue = next;
-        split_count++;
-    }
-
-    if (split_count == max_splits) {
-        leaves.insert(leaves.end(), queue.begin(), queue.end());
-    }
-
-    // Create rooms in leaves
-    for (auto* leaf : leaves) {
-        int max_w = leaf->rect.size.x - 2 * room_padding;
-        int max_h = leaf->rect.size.y - 2 * room_padding;
-        if (max_w < min_room_size || max_h < min_room_size)
-            continue;
-
-        int w = randi_range(min_room_size, std::min(max_w, max_room_size));
-        int h = randi_range(min_room_size, std::min(max_h, max_room_size));
-        int x = randi_range(leaf->rect.position.x + room_padding,
-                            leaf->rect.position.x + leaf->rect.size.x - room_padding - w);
-        int y = randi_range(leaf->rect.position.y + room_padding,
-                            leaf->rect.position.y + leaf->rect.size.y - room_padding - h);
-
-        leaf->room = {{x, y}, {w, h}};
-        leaf->has_room = true;
-        rooms.push_back(leaf->room);
-    }
-
-    // Connect rooms with corridors
-    connect_rooms(root);
-
-    // Build result
-    Ref<BSPResult> result;
-    result.instantiate();
+    std::random_device rd;
+    uint64_t run_seed = use_seed ? (uint64_t)seed : ((uint64_t)rd() << 32) | rd();
+
+    // A single run may use every core for rooms and corridors; batches
+    // already run one builder per worker
+    BSPSettings run_settings = make_settings(run_seed);
+    run_settings.workerThreads = 0;
+    BSPBuilder builder;
+    builder.generate(run_settings);
+    return make_result(builder);
+}
 
-    std::set<BSPVec2i> placed;
-    PackedVector2Array floor_positions;
-    PackedVector2Array corridor_positions;
-
-    // Add room floors
-    for (const auto& room : rooms) {
-        for (int y = room.position.y; y < room.position.y + room.size.y; ++y) {
-            for (int x = room.position.x; x < room.position.x + room.size.x; ++x) {
-                BSPVec2i pos = {x, y};
-                placed.insert(pos);
-                floor_positions.push_back(Vector2(x, y));
-            }
-        }
+Array BSPDungeonGenerator::generate_batch(const PackedInt64Array& seeds, int threads) {
+    int count = seeds.size();
+    std::vector<BSPSettings> settings(count);
+    for (int i = 0; i < count; ++i) {
+        settings[i] = make_settings((uint64_t)seeds[i]);
     }
 
-    // Add corridors
-    for (const auto& tile : corridors) {
-        if (placed.insert(tile).second) {
-            corridor_positions.push_back(Vector2(tile.x, tile.y));
-            floor_positions.push_back(Vector2(tile.x, tile.y));  // Also add to floors so corridors have floor tiles
-        }
-    }
+    std::vector<BSPBuilder> builders(count);
+    parallelFor(count, threads, [&](int i) {
+        builders[i].generate(settings[i]);
+    });
 
-    // Generate walls around all placed tiles
-    const std::vector<BSPVec2i> offsets = {{-1, -1}, {0, -1}, {1, -1}, {-1, 0},
-                                        {1, 0},   {-1, 1}, {0, 1},  {1, 1}};
-    std::set<BSPVec2i> wall_positions_set;
-    for (const auto& pos : placed) {
-        for (const auto& offset : offsets) {
-            BSPVec2i neighbor = {pos.x + offset.x, pos.y + offset.y};
-            if (!placed.count(neighbor) && !wall_positions_set.count(neighbor)) {
-                wall_positions_set.insert(neighbor);
-            }
-        }
+    Array results;
+    results.resize(count);
+    for (int i = 0; i < count; ++i) {
+        results[i] = make_result(builders[i]);
     }
+    return results;
+}
 
-    PackedVector2Array wall_positions;
-    for (const auto& pos : wall_positions_set) {
-        wall_positions.push_back(Vector2(pos.x, pos.y));
+Dictionary BSPDungeonGenerator::generate_accepted(int max_attempts, int threads) {
+    AcceptanceCriteria criteria;
+    if (!read_acceptance(acceptance, "BSPDungeonGenerator", criteria)) {
+        return Dictionary();
     }
+    std::random_device rd;
+    uint64_t base_seed = use_seed ? (uint64_t)seed : ((uint64_t)rd() << 32) | rd();
+
+    std::vector<BSPBuilder> builders(acceptanceSlotCount(max_attempts, threads));
+    AcceptedCandidate found = firstAccepted(max_attempts, threads, [&](int candidate, int slot) {
+        BSPBuilder& builder = builders[slot];
+        builder.generate(make_settings(base_seed + candidate));
+        FloorMask mask;
+        rasterizePoints(builder.getFloors(), mask);
+        return acceptsMap(criteria, mask, (int)builder.getRooms().size());
+    });
+
+    Variant result = found.index >= 0 ? Variant(make_result(builders[found.slot])) : Variant();
+    return make_acceptance_report(result, found, (int64_t)base_seed);
+}
 
-    result->set_floor_positions(floor_positions);
-    result->set_corridor_positions(corridor_positions);
-    result->set_wall_positions(wall_positions);
-
-    delete root;
-
-    return result;
+LevelJob BSPDungeonGenerator::make_level_job() const {
+    BSPSettings base = make_settings(0);
+    return [base](uint64_t level_seed) {
+        BSPSettings settings = base;
+        settings.seed = level_seed;
+        BSPBuilder builder;
+        builder.generate(settings);
+
+        MapRecord record;
+        record.seed = level_seed;
+        record.algorithm = MapAlgorithm::BSP;
+        rasterizeMap(builder.getFloors(), builder.getWalls(), record);
+        return record;
+    };
 }
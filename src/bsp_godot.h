@@ -3,47 +3,23 @@
 
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
 #include <godot_cpp/core/class_db.hpp>
-#include <vector>
-#include <random>
 
-using namespace godot;
-
-struct BSPVec2i {
-    int x, y;
-    BSPVec2i() : x(0), y(0) {}
-    BSPVec2i(int x, int y) : x(x), y(y) {}
-    bool operator==(const BSPVec2i& other) const { return x == other.x && y == other.y; }
-    bool operator<(const BSPVec2i& other) const {
-        if (x != other.x) return x < other.x;
-        return y < other.y;
-    }
-};
-
-struct BSPRect2i {
-    BSPVec2i position;
-    BSPVec2i size;
-    BSPVec2i center() const {
-        return { position.x + size.x / 2, position.y + size.y / 2 };
-    }
-};
+#include "BSPBuilder.h"
+#include "MultiLevel.h"
+#include "RoomIndex.h"
+#include "Visibility.h"
 
-class BSPLeaf {
-public:
-    BSPRect2i rect;
-    BSPRect2i room;
-    bool has_room = false;
-    BSPLeaf* left = nullptr;
-    BSPLeaf* right = nullptr;
-
-    explicit BSPLeaf(const BSPRect2i& rect) : rect(rect) {}
-    ~BSPLeaf() {
-        delete left;
-        delete right;
-    }
-
-    bool split(int min_room_size, std::mt19937& rng);
-};
+using namespace godot;
 
 class BSPResult : public RefCounted {
     GDCLASS(BSPResult, RefCounted)
@@ -52,6 +28,16 @@ private:
     PackedVector2Array floor_positions;
     PackedVector2Array wall_positions;
     PackedVector2Array corridor_positions;
+    PackedInt32Array room_rects; // x, y, w, h per room
+
+    // Built on the first room query
+    mutable RoomIndex room_index;
+    mutable bool room_index_built = false;
+    const RoomIndex& room_lookup() const;
+
+    mutable VisibilityMap visibility;
+    mutable bool visibility_built = false;
+    VisibilityMap& visibility_map() const;
 
 protected:
     static void _bind_methods();
@@ -63,11 +49,55 @@ public:
     void set_floor_positions(const PackedVector2Array& positions);
     void set_wall_positions(const PackedVector2Array& positions);
     void set_corridor_positions(const PackedVector2Array& positions);
+    void set_room_rects(const PackedInt32Array& rects);
 
     PackedVector2Array get_floor_positions() const;
     PackedVector2Array get_wall_positions() const;
     PackedVector2Array get_corridor_positions() const;
     int get_floor_count() const;
+    PackedInt32Array get_room_rects() const;
+    int get_room_count() const;
+
+    // Room lookup (see room_index.h)
+    int room_at(const Vector2i& cell) const;
+    PackedInt32Array rooms_in_rect(const Rect2i& rect) const;
+    PackedInt32Array get_room_neighbours(int room) const;
+    Rect2i get_room_bounds(int room) const;
+
+    // Visibility (see visibility.h)
+    PackedVector2Array get_fov(const Vector2i& origin, int radius) const;
+    PackedInt32Array get_visible_rooms(int room, int threads) const;
+    bool can_room_see(int from, int to) const;
+
+    // Region analysis (see region_analysis.h)
+    Dictionary get_floor_regions(int threads = 0) const;
+    PackedVector2Array get_dead_end_positions() const;
+    PackedInt32Array get_distance_field(const PackedVector2Array& sources) const;
+    PackedVector2Array get_farthest_pair() const;
+    PackedVector2Array get_critical_path() const;
+    PackedVector2Array get_chokepoints() const;
+
+    // Shapes (see grid_geometry.h)
+    PackedInt32Array get_wall_rects() const;
+    PackedInt32Array get_floor_rects() const;
+    Array get_wall_contours(double epsilon) const;
+    Array get_floor_contours(double epsilon) const;
+    Array get_wall_contour_chunks(int chunk_size, double epsilon, int threads) const;
+    Array get_floor_contour_chunks(int chunk_size, double epsilon, int threads) const;
+
+    // Autotiling (see autotile.h)
+    PackedInt32Array get_wall_bitmasks(int neighbours) const;
+    PackedInt32Array get_floor_bitmasks(int neighbours) const;
+    PackedVector2Array get_wall_autotile(const Dictionary& lut, int neighbours) const;
+    PackedVector2Array get_floor_autotile(const Dictionary& lut, int neighbours) const;
+
+    // Placement (see placement.h)
+    Array get_floor_placements(const PackedFloat32Array& radii, int64_t seed, const PackedInt32Array& counts,
+                               const PackedVector2Array& exclude, const PackedVector3Array& keep_out) const;
+
+    // Compact serialization (see result_codec.h)
+    PackedByteArray to_bytes(bool compress = true) const;
+    static Ref<BSPResult> from_bytes(const PackedByteArray& bytes);
 };
 
 class BSPDungeonGenerator : public RefCounted {
@@ -80,18 +110,13 @@ private:
     int max_room_size;
     int max_splits;
     int room_padding;
+    bool route_corridors;
     bool use_seed;
-    int seed;
-    std::mt19937 rng;
+    int64_t seed;
+    Dictionary acceptance;
 
-    std::vector<BSPLeaf*> leaves;
-    std::vector<BSPRect2i> rooms;
-    std::vector<BSPVec2i> corridors;
-
-    void connect_rooms(BSPLeaf* node);
-    BSPVec2i get_representative_point(BSPLeaf* leaf);
-    void create_corridor(BSPVec2i a, BSPVec2i b);
-    int randi_range(int from, int to);
+    BSPSettings make_settings(uint64_t p_seed) const;
+    static Ref<BSPResult> make_result(const BSPBuilder& builder);
 
 protected:
     static void _bind_methods();
@@ -104,8 +129,9 @@ public:
     void set_room_size_range(int min_size, int max_size);
     void set_max_splits(int splits);
     void set_room_padding(int padding);
+    void set_route_corridors(bool enabled);
     void set_use_seed(bool enabled);
-    void set_seed(int seed_value);
+    void set_seed(int64_t seed_value);
 
     int get_map_width() const { return map_width; }
     int get_map_height() const { return map_height; }
@@ -113,10 +139,29 @@ public:
     int get_max_room_size() const { return max_room_size; }
     int get_max_splits() const { return max_splits; }
     int get_room_padding() const { return room_padding; }
+    bool get_route_corridors() const { return route_corridors; }
     bool get_use_seed() const { return use_seed; }
-    int get_seed() const { return seed; }
+    int64_t get_seed() const { return seed; }
+
+    // Limits for generate_accepted() (see acceptance.h for the keys)
+    void set_acceptance(const Dictionary& p_acceptance);
+    Dictionary get_acceptance() const { return acceptance; }
 
     Ref<BSPResult> generate();
+
+    // Generates one result per seed (as if use_seed were set) on up to
+    // `threads` workers (0 = all cores). Results are returned in seed order.
+    Array generate_batch(const PackedInt64Array& seeds, int threads = 0);
+
+    // Generates seeds seed, seed + 1, ... (from a random base unless
+    // use_seed is set) on up to `threads` workers and returns
+    // { result, seed, attempts } for the first that meets the acceptance
+    // limits; result is null if none of `max_attempts` did.
+    Dictionary generate_accepted(int max_attempts = 32, int threads = 0);
+
+    // Snapshot of the current settings as a native job for
+    // MultiLevelDungeonGenerator; the level's seed replaces `seed`.
+    LevelJob make_level_job() const;
 };
 
 #endif // BSP_GODOT_H
@@ -1,10 +1,18 @@
 #include "gdwfc_v2.h"
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
+#include <memory>
 #include <tuple>
 
-#include "../tiling-wfc/include/tiling_wfc.hpp"
-#include "../tiling-wfc/include/utils/array2D.hpp"
+#include "Parallel.h"
+#include "TilingSolver.h"
+#include "acceptance.h"
+#include "autotile.h"
+#include "grid_geometry.h"
+#include "packed_arrays.h"
+#include "placement.h"
+#include "region_analysis.h"
+#include "result_codec.h"
 
 // ============================================================================
 // WFCResult Implementation
@@ -41,16 +49,43 @@ void WFCResult::_bind_methods() {
     // Helper methods
     ClassDB::bind_method(D_METHOD("get_floor_positions", "floor_value"), &WFCResult::get_floor_positions, DEFVAL(0));
     ClassDB::bind_method(D_METHOD("get_wall_positions", "wall_value"), &WFCResult::get_wall_positions, DEFVAL(1));
+    ClassDB::bind_method(D_METHOD("get_positions_of", "tile_value"), &WFCResult::get_positions_of);
     ClassDB::bind_method(D_METHOD("get_tile_distribution"), &WFCResult::get_tile_distribution);
 
+    // Bulk region queries
+    ClassDB::bind_method(D_METHOD("get_region", "rect"), &WFCResult::get_region);
+    ClassDB::bind_method(D_METHOD("count_in_rect", "tile_value", "rect"), &WFCResult::count_in_rect);
+    ClassDB::bind_method(D_METHOD("find_all", "tile_value", "rect"), &WFCResult::find_all);
+
+    // Region analysis
+    ClassDB::bind_method(D_METHOD("get_regions", "tile_value", "threads"), &WFCResult::get_regions, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_dead_end_positions", "tile_value"), &WFCResult::get_dead_end_positions);
+    ClassDB::bind_method(D_METHOD("get_distance_field", "tile_value", "sources"), &WFCResult::get_distance_field);
+    ClassDB::bind_method(D_METHOD("get_farthest_pair", "tile_value"), &WFCResult::get_farthest_pair);
+    ClassDB::bind_method(D_METHOD("get_critical_path", "tile_value"), &WFCResult::get_critical_path);
+    ClassDB::bind_method(D_METHOD("get_chokepoints", "tile_value"), &WFCResult::get_chokepoints);
+    ClassDB::bind_method(D_METHOD("get_rects", "tile_value"), &WFCResult::get_rects);
+    ClassDB::bind_method(D_METHOD("get_contours", "tile_value", "epsilon"), &WFCResult::get_contours, DEFVAL(0.0));
+    ClassDB::bind_method(D_METHOD("get_contour_chunks", "tile_value", "chunk_size", "epsilon", "threads"),
+                         &WFCResult::get_contour_chunks, DEFVAL(0.0), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_bitmasks", "tile_value", "neighbours"), &WFCResult::get_bitmasks, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_autotile", "tile_value", "lut", "neighbours"), &WFCResult::get_autotile, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_placements", "tile_value", "radii", "seed", "counts", "exclude", "keep_out"),
+                         &WFCResult::get_placements, DEFVAL(PackedInt32Array()), DEFVAL(PackedVector2Array()),
+                         DEFVAL(PackedVector3Array()));
+    ClassDB::bind_method(D_METHOD("to_bytes", "compress"), &WFCResult::to_bytes, DEFVAL(true));
+    ClassDB::bind_static_method("WFCResult", D_METHOD("from_bytes", "bytes"), &WFCResult::from_bytes);
+    ClassDB::bind_method(D_METHOD("get_decision_log"), &WFCResult::get_decision_log);
+
     // Internal
     ClassDB::bind_method(D_METHOD("_set_wfc_data", "tiles", "width", "height"), &WFCResult::_set_wfc_data);
     ClassDB::bind_method(D_METHOD("_set_expanded_data", "tiles", "width", "height", "stamp_size"), &WFCResult::_set_expanded_data);
     ClassDB::bind_method(D_METHOD("_set_failure", "reason", "position"), &WFCResult::_set_failure);
+    ClassDB::bind_method(D_METHOD("_set_decision_log", "log"), &WFCResult::_set_decision_log);
 }
 
 int WFCResult::get_wfc_tile_at(int x, int y) const {
-    if (x < 0 || x >= wfc_width || y < 0 || y >= wfc_height) {
+    if (x < 0 || x >= wfc_width || y < 0 || y >= wfc_height || wfc_tiles.is_empty()) {
         return -1;
     }
     return wfc_tiles[y * wfc_width + x];
@@ -67,52 +102,82 @@ int WFCResult::get_expanded_tile_at(int x, int y) const {
 }
 
 PackedVector2Array WFCResult::get_floor_positions(int floor_tile_value) const {
-    PackedVector2Array positions;
-    const PackedInt32Array& tiles = has_stamps ? expanded_tiles : wfc_tiles;
-    int w = has_stamps ? expanded_width : wfc_width;
-    int h = has_stamps ? expanded_height : wfc_height;
-
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            int tile = tiles[y * w + x];
-            if (tile == floor_tile_value) {
-                positions.append(Vector2(x, y));
-            }
-        }
-    }
-    return positions;
+    return get_positions_of(floor_tile_value);
 }
 
 PackedVector2Array WFCResult::get_wall_positions(int wall_tile_value) const {
-    PackedVector2Array positions;
-    const PackedInt32Array& tiles = has_stamps ? expanded_tiles : wfc_tiles;
-    int w = has_stamps ? expanded_width : wfc_width;
-    int h = has_stamps ? expanded_height : wfc_height;
-
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            int tile = tiles[y * w + x];
-            if (tile == wall_tile_value) {
-                positions.append(Vector2(x, y));
-            }
-        }
-    }
-    return positions;
+    return get_positions_of(wall_tile_value);
+}
+
+PackedVector2Array WFCResult::get_positions_of(int tile_value) const {
+    return grid_cache.get_positions(active_tiles(), active_width(), tile_value);
 }
 
 Dictionary WFCResult::get_tile_distribution() const {
-    Dictionary dist;
-    const PackedInt32Array& tiles = has_stamps ? expanded_tiles : wfc_tiles;
+    return grid_cache.get_distribution(active_tiles());
+}
 
-    for (int i = 0; i < tiles.size(); i++) {
-        int tile_id = tiles[i];
-        if (dist.has(tile_id)) {
-            dist[tile_id] = (int)dist[tile_id] + 1;
-        } else {
-            dist[tile_id] = 1;
-        }
-    }
-    return dist;
+PackedInt32Array WFCResult::get_region(const Rect2i& rect) const {
+    return TileGridCache::get_region(active_tiles(), active_width(), active_height(), rect);
+}
+
+int64_t WFCResult::count_in_rect(int tile_value, const Rect2i& rect) const {
+    return grid_cache.count_in_rect(active_tiles(), active_width(), active_height(), tile_value, rect);
+}
+
+PackedVector2Array WFCResult::find_all(int tile_value, const Rect2i& rect) const {
+    return TileGridCache::find_all(active_tiles(), active_width(), active_height(), tile_value, rect);
+}
+
+Dictionary WFCResult::get_regions(int tile_value, int threads) const {
+    return analyze_grid_regions(active_tiles(), active_width(), active_height(), tile_value, threads);
+}
+
+PackedVector2Array WFCResult::get_dead_end_positions(int tile_value) const {
+    return find_grid_dead_ends(active_tiles(), active_width(), active_height(), tile_value);
+}
+
+PackedInt32Array WFCResult::get_distance_field(int tile_value, const PackedVector2Array& sources) const {
+    return grid_distance_field(active_tiles(), active_width(), active_height(), tile_value, sources);
+}
+
+PackedVector2Array WFCResult::get_farthest_pair(int tile_value) const {
+    return grid_farthest_pair(active_tiles(), active_width(), active_height(), tile_value);
+}
+
+PackedVector2Array WFCResult::get_critical_path(int tile_value) const {
+    return grid_critical_path(active_tiles(), active_width(), active_height(), tile_value);
+}
+
+PackedVector2Array WFCResult::get_chokepoints(int tile_value) const {
+    return grid_chokepoints(active_tiles(), active_width(), active_height(), tile_value);
+}
+
+PackedInt32Array WFCResult::get_rects(int tile_value) const {
+    return merge_grid_rects(active_tiles(), active_width(), active_height(), tile_value);
+}
+
+Array WFCResult::get_contours(int tile_value, double epsilon) const {
+    return grid_contours(active_tiles(), active_width(), active_height(), tile_value, epsilon);
+}
+
+Array WFCResult::get_contour_chunks(int tile_value, int chunk_size, double epsilon, int threads) const {
+    return grid_contour_chunks(active_tiles(), active_width(), active_height(), tile_value, chunk_size, epsilon, threads);
+}
+
+PackedInt32Array WFCResult::get_bitmasks(int tile_value, int neighbours) const {
+    return grid_bitmasks(active_tiles(), active_width(), active_height(), tile_value, neighbours);
+}
+
+PackedVector2Array WFCResult::get_autotile(int tile_value, const Dictionary& lut, int neighbours) const {
+    return grid_autotile(active_tiles(), active_width(), active_height(), tile_value, lut, neighbours);
+}
+
+Array WFCResult::get_placements(int tile_value, const PackedFloat32Array& radii, int64_t seed,
+                                const PackedInt32Array& counts, const PackedVector2Array& exclude,
+                                const PackedVector3Array& keep_out) const {
+    return grid_poisson(active_tiles(), active_width(), active_height(), tile_value, radii, seed, counts, exclude,
+                        keep_out);
 }
 
 void WFCResult::_set_wfc_data(PackedInt32Array tiles, int width, int height) {
@@ -120,6 +185,7 @@ void WFCResult::_set_wfc_data(PackedInt32Array tiles, int width, int height) {
     wfc_width = width;
     wfc_height = height;
     success = true;
+    grid_cache.reset();
 }
 
 void WFCResult::_set_expanded_data(PackedInt32Array tiles, int width, int height, int p_stamp_size) {
@@ -128,6 +194,7 @@ void WFCResult::_set_expanded_data(PackedInt32Array tiles, int width, int height
     expanded_height = height;
     has_stamps = true;
     stamp_size = p_stamp_size;
+    grid_cache.reset();
 }
 
 void WFCResult::_set_failure(String reason, Vector2i position) {
@@ -136,6 +203,78 @@ void WFCResult::_set_failure(String reason, Vector2i position) {
     failure_position = position;
 }
 
+void WFCResult::_set_decision_log(PackedByteArray log) {
+    decision_log = log;
+}
+
+static const uint8_t WFC_FLAG_SUCCESS = 1;
+static const uint8_t WFC_FLAG_STAMPS = 2;
+// Set when a decision log follows the grids; older blobs have none
+static const uint8_t WFC_FLAG_DECISIONS = 4;
+
+PackedByteArray WFCResult::to_bytes(bool compress) const {
+    ByteWriter body;
+    body.putU8((success ? WFC_FLAG_SUCCESS : 0) | (has_stamps ? WFC_FLAG_STAMPS : 0) |
+               (decision_log.is_empty() ? 0 : WFC_FLAG_DECISIONS));
+    CharString reason = failure_reason.utf8();
+    body.putString(std::string(reason.get_data(), reason.length()));
+    body.putVarI(failure_position.x);
+    body.putVarI(failure_position.y);
+
+    body.putVarU(wfc_width);
+    body.putVarU(wfc_height);
+    write_int_grid(body, wfc_tiles);
+
+    body.putVarU(expanded_width);
+    body.putVarU(expanded_height);
+    body.putVarU(stamp_size);
+    write_int_grid(body, expanded_tiles);
+    if (!decision_log.is_empty()) {
+        write_byte_array(body, decision_log);
+    }
+    return make_result_blob(MapAlgorithm::TilingWFC, body, compress);
+}
+
+Ref<WFCResult> WFCResult::from_bytes(const PackedByteArray& bytes) {
+    std::vector<uint8_t> scratch;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (!open_result_blob(bytes, MapAlgorithm::TilingWFC, "WFCResult", scratch, data, size)) {
+        return Ref<WFCResult>();
+    }
+
+    ByteReader in(data, size);
+    Ref<WFCResult> result;
+    result.instantiate();
+    uint8_t flags = in.getU8();
+    result->success = (flags & WFC_FLAG_SUCCESS) != 0;
+    result->has_stamps = (flags & WFC_FLAG_STAMPS) != 0;
+    std::string reason = in.getString();
+    result->failure_reason = String::utf8(reason.data(), (int)reason.size());
+    result->failure_position.x = (int32_t)in.getVarI();
+    result->failure_position.y = (int32_t)in.getVarI();
+
+    result->wfc_width = (int)in.getVarU();
+    result->wfc_height = (int)in.getVarU();
+    bool ok = in.ok() && read_int_grid(in, result->wfc_tiles) &&
+              int_grid_fits(result->wfc_tiles, result->wfc_width, result->wfc_height);
+
+    result->expanded_width = (int)in.getVarU();
+    result->expanded_height = (int)in.getVarU();
+    result->stamp_size = (int)in.getVarU();
+    ok = ok && in.ok() && read_int_grid(in, result->expanded_tiles) &&
+         int_grid_fits(result->expanded_tiles, result->expanded_width, result->expanded_height);
+    if (flags & WFC_FLAG_DECISIONS) {
+        ok = ok && read_byte_array(in, result->decision_log);
+    }
+
+    if (!ok) {
+        UtilityFunctions::push_error("WFCResult.from_bytes: blob is corrupt");
+        return Ref<WFCResult>();
+    }
+    return result;
+}
+
 // ============================================================================
 // WFCConfiguration Implementation
 // ============================================================================
@@ -161,6 +300,8 @@ void WFCConfiguration::_bind_methods() {
                         &WFCConfiguration::add_connected_tile, DEFVAL(1.0), DEFVAL(SYMMETRY_X));
     ClassDB::bind_method(D_METHOD("set_tile_stamp", "tile_id", "stamp_pattern", "stamp_width", "stamp_height"),
                         &WFCConfiguration::set_tile_stamp);
+    ClassDB::bind_method(D_METHOD("set_tile_interior", "tile_id", "fine_tile_ids"),
+                        &WFCConfiguration::set_tile_interior);
 
     // Neighbor rules
     ClassDB::bind_method(D_METHOD("add_neighbor_rule", "tile1_id", "orientation1", "tile2_id", "orientation2"),
@@ -206,6 +347,7 @@ void WFCConfiguration::add_tile(int tile_id, PackedInt32Array tile_data, int til
     tile.has_connections = false;
     tile.borders_all = false;
     tile.has_stamp = false;
+    tile.has_interior = false;
     tiles.push_back(tile);
 }
 
@@ -229,6 +371,7 @@ void WFCConfiguration::add_connected_tile(int tile_id, Dictionary connections, f
     tile.tile_data.append(tile_id);
 
     tile.has_stamp = false;
+    tile.has_interior = false;
     tiles.push_back(tile);
 }
 
@@ -247,6 +390,17 @@ void WFCConfiguration::set_tile_stamp(int tile_id, PackedInt32Array stamp_patter
     UtilityFunctions::push_error("Tile ", tile_id, " not found when setting stamp");
 }
 
+void WFCConfiguration::set_tile_interior(int tile_id, PackedInt32Array fine_tile_ids) {
+    for (size_t i = 0; i < tiles.size(); i++) {
+        if (tiles[i].tile_id == tile_id) {
+            tiles[i].has_interior = true;
+            tiles[i].interior_tiles = fine_tile_ids;
+            return;
+        }
+    }
+    UtilityFunctions::push_error("Tile ", tile_id, " not found when setting interior");
+}
+
 void WFCConfiguration::add_neighbor_rule(int tile1_id, int orientation1,
                                          int tile2_id, int orientation2) {
     NeighborRule rule;
@@ -337,6 +491,9 @@ Dictionary WFCConfiguration::get_tile_info(int tile_id) const {
                 info["borders_all"] = tile.borders_all;
             }
             info["has_stamp"] = tile.has_stamp;
+            if (tile.has_interior) {
+                info["interior"] = tile.interior_tiles;
+            }
             return info;
         }
     }
@@ -359,12 +516,14 @@ void WFCConfiguration::clear_rules_only() {
 // ============================================================================
 
 GDTilingWFCv2::GDTilingWFCv2() :
-    width(10), height(10), seed(0), periodic(false), debug_mode(false) {
+    width(10), height(10), seed(0), periodic(false), macro_block_size(16), debug_mode(false),
+    keep_intermediate_outputs(true), record_decisions(false) {
     config.instantiate();
 }
 
 GDTilingWFCv2::GDTilingWFCv2(Ref<WFCConfiguration> p_config) :
-    width(10), height(10), seed(0), periodic(false), debug_mode(false) {
+    width(10), height(10), seed(0), periodic(false), macro_block_size(16), debug_mode(false),
+    keep_intermediate_outputs(true), record_decisions(false) {
     config = p_config;
 }
 
@@ -378,6 +537,16 @@ void GDTilingWFCv2::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_periodic", "periodic"), &GDTilingWFCv2::set_periodic);
     ClassDB::bind_method(D_METHOD("set_configuration", "config"), &GDTilingWFCv2::set_configuration);
     ClassDB::bind_method(D_METHOD("enable_debug", "enabled"), &GDTilingWFCv2::enable_debug);
+    ClassDB::bind_method(D_METHOD("set_keep_intermediate_outputs", "keep"), &GDTilingWFCv2::set_keep_intermediate_outputs);
+    ClassDB::bind_method(D_METHOD("get_keep_intermediate_outputs"), &GDTilingWFCv2::get_keep_intermediate_outputs);
+    ClassDB::bind_method(D_METHOD("set_record_decisions", "enabled"), &GDTilingWFCv2::set_record_decisions);
+    ClassDB::bind_method(D_METHOD("get_record_decisions"), &GDTilingWFCv2::get_record_decisions);
+    ClassDB::bind_method(D_METHOD("set_acceptance", "acceptance"), &GDTilingWFCv2::set_acceptance);
+    ClassDB::bind_method(D_METHOD("get_acceptance"), &GDTilingWFCv2::get_acceptance);
+    ClassDB::bind_method(D_METHOD("set_macro_configuration", "config"), &GDTilingWFCv2::set_macro_configuration);
+    ClassDB::bind_method(D_METHOD("get_macro_configuration"), &GDTilingWFCv2::get_macro_configuration);
+    ClassDB::bind_method(D_METHOD("set_macro_block_size", "size"), &GDTilingWFCv2::set_macro_block_size);
+    ClassDB::bind_method(D_METHOD("get_macro_block_size"), &GDTilingWFCv2::get_macro_block_size);
 
     // Quick setup
     ClassDB::bind_method(D_METHOD("use_connection_system"), &GDTilingWFCv2::use_connection_system);
@@ -395,6 +564,13 @@ void GDTilingWFCv2::_bind_methods() {
 
     // Run
     ClassDB::bind_method(D_METHOD("run"), &GDTilingWFCv2::run);
+    ClassDB::bind_method(D_METHOD("generate_batch", "seeds", "threads"), &GDTilingWFCv2::generate_batch, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("generate_accepted", "max_attempts", "threads"),
+                         &GDTilingWFCv2::generate_accepted, DEFVAL(32), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("run_hierarchical", "threads"), &GDTilingWFCv2::run_hierarchical, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("replay", "log"), &GDTilingWFCv2::replay);
+    ClassDB::bind_method(D_METHOD("regenerate_region", "result", "rect", "seed"),
+                        &GDTilingWFCv2::regenerate_region);
     ClassDB::bind_method(D_METHOD("clear"), &GDTilingWFCv2::clear);
     ClassDB::bind_method(D_METHOD("get_configuration"), &GDTilingWFCv2::get_configuration);
 }
@@ -404,7 +580,7 @@ void GDTilingWFCv2::set_size(int p_width, int p_height) {
     height = p_height;
 }
 
-void GDTilingWFCv2::set_seed(int p_seed) {
+void GDTilingWFCv2::set_seed(int64_t p_seed) {
     seed = p_seed;
 }
 
@@ -420,6 +596,26 @@ void GDTilingWFCv2::enable_debug(bool enabled) {
     debug_mode = enabled;
 }
 
+void GDTilingWFCv2::set_keep_intermediate_outputs(bool keep) {
+    keep_intermediate_outputs = keep;
+}
+
+void GDTilingWFCv2::set_record_decisions(bool enabled) {
+    record_decisions = enabled;
+}
+
+void GDTilingWFCv2::set_acceptance(const Dictionary& p_acceptance) {
+    acceptance = p_acceptance;
+}
+
+void GDTilingWFCv2::set_macro_configuration(Ref<WFCConfiguration> p_config) {
+    macro_config = p_config;
+}
+
+void GDTilingWFCv2::set_macro_block_size(int size) {
+    macro_block_size = size;
+}
+
 void GDTilingWFCv2::use_connection_system() {
     if (config.is_valid()) {
         config->enable_connection_system(true);
@@ -459,209 +655,324 @@ void GDTilingWFCv2::add_neighbor_rule(int tile1_id, int orientation1,
     }
 }
 
-Ref<WFCResult> GDTilingWFCv2::run() {
-    Ref<WFCResult> result;
-    result.instantiate();
+// ============================================================================
+// Native problem/output conversion (solving lives in wfc/TilingSolver)
+// ============================================================================
+
+namespace {
+
+std::vector<int> to_int_vector(const PackedInt32Array& values) {
+    return std::vector<int>(values.ptr(), values.ptr() + values.size());
+}
 
+// Returns an empty string on success, otherwise the failure reason.
+String build_tiling_problem(const Ref<WFCConfiguration>& config, TilingProblem& problem) {
     if (!config.is_valid()) {
-        result->_set_failure("No configuration set", Vector2i(0, 0));
-        return result;
+        return "No configuration set";
     }
 
     const std::vector<WFCConfiguration::TileDefinition>& tiles = config->get_tiles();
     const std::vector<WFCConfiguration::NeighborRule>& rules = config->get_rules();
 
     if (tiles.empty()) {
-        result->_set_failure("No tiles defined", Vector2i(0, 0));
-        return result;
+        return "No tiles defined";
     }
 
     if (rules.empty()) {
-        result->_set_failure("No neighbor rules defined", Vector2i(0, 0));
+        return "No neighbor rules defined";
+    }
+
+    // ====================================================================
+    // STEP 1: Convert tiles to WFC format
+    // ====================================================================
+    for (const auto& tile_def : tiles) {
+        // Convert symmetry
+        Symmetry sym;
+        switch (tile_def.symmetry) {
+            case WFCConfiguration::SYMMETRY_X: sym = Symmetry::X; break;
+            case WFCConfiguration::SYMMETRY_I: sym = Symmetry::I; break;
+            case WFCConfiguration::SYMMETRY_BACKSLASH: sym = Symmetry::backslash; break;
+            case WFCConfiguration::SYMMETRY_T: sym = Symmetry::T; break;
+            case WFCConfiguration::SYMMETRY_L: sym = Symmetry::L; break;
+            case WFCConfiguration::SYMMETRY_P: sym = Symmetry::P; break;
+            default: sym = Symmetry::X; break;
+        }
+
+        problem.addTile(tile_def.tile_id, to_int_vector(tile_def.tile_data), tile_def.tile_size, sym, tile_def.weight);
+        if (tile_def.has_stamp) {
+            problem.setStamp(tile_def.tile_id, to_int_vector(tile_def.stamp_pattern),
+                             tile_def.stamp_width, tile_def.stamp_height);
+        }
+    }
+
+    // ====================================================================
+    // STEP 2: Convert neighbor rules
+    // ====================================================================
+    for (const auto& rule : rules) {
+        problem.addNeighbor(rule.tile1_id, rule.orientation1, rule.tile2_id, rule.orientation2);
+    }
+
+    // Stamps are only expanded when every tile has one
+    if (!problem.enableStamps(config->get_stamp_size())) {
+        UtilityFunctions::push_warning("WFCv2: Stamp size set but not all tiles have stamps defined");
+    }
+
+    return String();
+}
+
+Ref<WFCResult> make_tiling_result(const TilingOutput& out, int stamp_size, bool keep_intermediate) {
+    Ref<WFCResult> result;
+    result.instantiate();
+
+    if (!out.success) {
+        result->_set_failure(String(out.failureReason.c_str()), Vector2i(out.failureX, out.failureY));
         return result;
     }
 
-    try {
-        // ====================================================================
-        // STEP 1: Convert tiles to WFC format
-        // ====================================================================
-        std::vector<Tile<int>> wfc_tiles;
-        std::map<int, int> tile_id_to_index;  // Map tile_id -> index in wfc_tiles
+    // The raw grid is only an intermediate when stamps expand it
+    bool keep_raw = keep_intermediate || stamp_size <= 0;
+    result->_set_wfc_data(keep_raw ? to_packed_int32(out.tiles) : PackedInt32Array(), out.width, out.height);
+    if (stamp_size > 0) {
+        result->_set_expanded_data(to_packed_int32(out.expanded), out.expandedWidth, out.expandedHeight, stamp_size);
+    }
+    if (!out.decisions.empty()) {
+        result->_set_decision_log(to_packed_bytes(out.decisions));
+    }
+    return result;
+}
 
-        for (size_t i = 0; i < tiles.size(); i++) {
-            const auto& tile_def = tiles[i];
+} // namespace
 
-            // Create Array2D from tile_data
-            int size = tile_def.tile_size;
-            Array2D<int> tile_array(size, size);
+Ref<WFCResult> GDTilingWFCv2::run() {
+    TilingProblem problem;
+    String error = build_tiling_problem(config, problem);
+    if (!error.is_empty()) {
+        Ref<WFCResult> result;
+        result.instantiate();
+        result->_set_failure(error, Vector2i(0, 0));
+        return result;
+    }
 
-            for (int y = 0; y < size; y++) {
-                for (int x = 0; x < size; x++) {
-                    int index = y * size + x;
-                    if (index < tile_def.tile_data.size()) {
-                        tile_array.get(y, x) = tile_def.tile_data[index];
-                    }
-                }
-            }
+    if (debug_mode) {
+        UtilityFunctions::print("WFCv2: Running with ", (int)problem.tiles.size(), " tiles and ", (int)problem.neighbors.size(), " rules");
+    }
 
-            // Convert symmetry
-            Symmetry sym;
-            switch (tile_def.symmetry) {
-                case WFCConfiguration::SYMMETRY_X: sym = Symmetry::X; break;
-                case WFCConfiguration::SYMMETRY_I: sym = Symmetry::I; break;
-                case WFCConfiguration::SYMMETRY_BACKSLASH: sym = Symmetry::backslash; break;
-                case WFCConfiguration::SYMMETRY_T: sym = Symmetry::T; break;
-                case WFCConfiguration::SYMMETRY_L: sym = Symmetry::L; break;
-                case WFCConfiguration::SYMMETRY_P: sym = Symmetry::P; break;
-                default: sym = Symmetry::X; break;
-            }
+    TilingOutput out = solveTiling(problem, width, height, periodic, seed, record_decisions);
 
-            wfc_tiles.push_back(Tile<int>(tile_array, sym, tile_def.weight));
-            tile_id_to_index[tile_def.tile_id] = i;
+    if (debug_mode && out.success) {
+        if (problem.stampSize > 0) {
+            UtilityFunctions::print("WFCv2: Expanded from ", out.width, "x", out.height,
+                                  " to ", out.expandedWidth, "x", out.expandedHeight,
+                                  " (", problem.stampSize, "x", problem.stampSize, " stamps)");
         }
+        UtilityFunctions::print("WFCv2: Success! Generated ", out.width, "x", out.height, " dungeon");
+    }
 
-        // ====================================================================
-        // STEP 2: Convert neighbor rules
-        // ====================================================================
-        std::vector<std::tuple<unsigned, unsigned, unsigned, unsigned>> wfc_neighbors;
-
-        for (const auto& rule : rules) {
-            // Map tile IDs to indices
-            auto it1 = tile_id_to_index.find(rule.tile1_id);
-            auto it2 = tile_id_to_index.find(rule.tile2_id);
-
-            if (it1 != tile_id_to_index.end() && it2 != tile_id_to_index.end()) {
-                wfc_neighbors.push_back(std::make_tuple(
-                    it1->second,  // tile1 index
-                    rule.orientation1,
-                    it2->second,  // tile2 index
-                    rule.orientation2
-                ));
-            }
-        }
+    return make_tiling_result(out, problem.stampSize, keep_intermediate_outputs);
+}
+
+Array GDTilingWFCv2::generate_batch(const PackedInt64Array& seeds, int threads) {
+    int count = seeds.size();
+    Array results;
+    results.resize(count);
 
-        if (debug_mode) {
-            UtilityFunctions::print("WFCv2: Running with ", (int)wfc_tiles.size(), " tiles and ", (int)wfc_neighbors.size(), " rules");
+    // The configuration is converted once and shared read-only by every solve
+    TilingProblem problem;
+    String error = build_tiling_problem(config, problem);
+    if (!error.is_empty()) {
+        for (int i = 0; i < count; i++) {
+            Ref<WFCResult> result;
+            result.instantiate();
+            result->_set_failure(error, Vector2i(0, 0));
+            results[i] = result;
         }
+        return results;
+    }
 
-        // ====================================================================
-        // STEP 3: Run WFC algorithm
-        // ====================================================================
-        TilingWFCOptions options;
-        options.periodic_output = periodic;
+    std::vector<TilingOutput> outputs(count);
+    parallelFor(count, threads, [&](int i) {
+        outputs[i] = solveTiling(problem, width, height, periodic, (uint64_t)seeds[i], record_decisions);
+    });
 
-        TilingWFC<int> wfc(wfc_tiles, wfc_neighbors, height, width, options, seed);
-        std::optional<Array2D<int>> output = wfc.run();
+    for (int i = 0; i < count; i++) {
+        results[i] = make_tiling_result(outputs[i], problem.stampSize, keep_intermediate_outputs);
+    }
+    return results;
+}
 
-        if (!output.has_value()) {
-            result->_set_failure("WFC contradiction - no valid solution", Vector2i(-1, -1));
-            return result;
+Dictionary GDTilingWFCv2::generate_accepted(int max_attempts, int threads) {
+    AcceptanceCriteria criteria;
+    int floor_value = 0;
+    if (!read_acceptance(acceptance, "GDTilingWFCv2", criteria, &floor_value)) {
+        return Dictionary();
+    }
+    TilingProblem problem;
+    String error = build_tiling_problem(config, problem);
+    if (!error.is_empty()) {
+        UtilityFunctions::push_error("GDTilingWFCv2.generate_accepted: ", error);
+        return Dictionary();
+    }
+
+    std::vector<TilingOutput> outputs(acceptanceSlotCount(max_attempts, threads));
+    AcceptedCandidate found = firstAccepted(max_attempts, threads, [&](int candidate, int slot) {
+        TilingOutput& out = outputs[slot];
+        out = solveTiling(problem, width, height, periodic, (uint64_t)seed + candidate, record_decisions);
+        if (!out.success) {
+            return false;
         }
+        FloorMask mask;
+        if (problem.stampSize > 0) {
+            gridFloorMask(out.expanded.data(), out.expandedWidth, out.expandedHeight, floor_value, mask);
+        } else {
+            gridFloorMask(out.tiles.data(), out.width, out.height, floor_value, mask);
+        }
+        return acceptsMap(criteria, mask, 0);
+    });
 
-        // ====================================================================
-        // STEP 4: Convert WFC output to PackedInt32Array
-        // ====================================================================
-        Array2D<int>& output_array = output.value();
-        int output_height = output_array.height;
-        int output_width = output_array.width;
-
-        PackedInt32Array wfc_result;
-        wfc_result.resize(output_height * output_width);
-
-        for (int y = 0; y < output_height; y++) {
-            for (int x = 0; x < output_width; x++) {
-                int tile_index = output_array.get(y, x);
-                // Convert back to tile_id
-                int tile_id = tiles[tile_index].tile_id;
-                wfc_result[y * output_width + x] = tile_id;
-            }
+    Variant result;
+    if (found.index >= 0) {
+        result = make_tiling_result(outputs[found.slot], problem.stampSize, keep_intermediate_outputs);
+    }
+    return make_acceptance_report(result, found, seed);
+}
+
+LevelJob GDTilingWFCv2::make_level_job() const {
+    auto problem = std::make_shared<TilingProblem>();
+    String error = build_tiling_problem(config, *problem);
+    std::string message = error.utf8().get_data();
+    int level_width = width;
+    int level_height = height;
+    bool level_periodic = periodic;
+    return [problem, message, level_width, level_height, level_periodic](uint64_t level_seed) {
+        MapRecord record;
+        record.seed = level_seed;
+        record.algorithm = MapAlgorithm::TilingWFC;
+        if (!message.empty()) {
+            record.success = false;
+            record.message = message;
+            return record;
         }
 
-        result->_set_wfc_data(wfc_result, output_width, output_height);
-
-        // ====================================================================
-        // STEP 5: Expand stamps if configured
-        // ====================================================================
-        int stamp_size = config->get_stamp_size();
-
-        if (stamp_size > 0) {
-            // Check if all tiles have stamps
-            bool all_have_stamps = true;
-            for (const auto& tile : tiles) {
-                if (!tile.has_stamp) {
-                    all_have_stamps = false;
-                    break;
-                }
-            }
+        TilingOutput out = solveTiling(*problem, level_width, level_height, level_periodic, level_seed);
+        record.success = out.success;
+        record.message = out.failureReason;
+        if (!out.success) {
+            return record;
+        }
+        bool stamped = problem->stampSize > 0;
+        record.width = stamped ? out.expandedWidth : out.width;
+        record.height = stamped ? out.expandedHeight : out.height;
+        record.cells = stamped ? std::move(out.expanded) : std::move(out.tiles);
+        return record;
+    };
+}
 
-            if (all_have_stamps) {
-                int expanded_width = output_width * stamp_size;
-                int expanded_height = output_height * stamp_size;
-
-                PackedInt32Array expanded_tiles;
-                expanded_tiles.resize(expanded_width * expanded_height);
-                // Initialize to -1 to distinguish unset tiles from actual floor tiles (0)
-                expanded_tiles.fill(-1);
-
-                // Expand each WFC tile to its stamp
-                for (int wfc_y = 0; wfc_y < output_height; wfc_y++) {
-                    for (int wfc_x = 0; wfc_x < output_width; wfc_x++) {
-                        int tile_id = wfc_result[wfc_y * output_width + wfc_x];
-
-                        // Find tile definition
-                        const WFCConfiguration::TileDefinition* tile_def = nullptr;
-                        for (const auto& t : tiles) {
-                            if (t.tile_id == tile_id) {
-                                tile_def = &t;
-                                break;
-                            }
-                        }
-
-                        if (!tile_def || !tile_def->has_stamp) {
-                            continue;
-                        }
-
-                        // Place stamp
-                        int base_x = wfc_x * stamp_size;
-                        int base_y = wfc_y * stamp_size;
-
-                        for (int local_y = 0; local_y < tile_def->stamp_height; local_y++) {
-                            for (int local_x = 0; local_x < tile_def->stamp_width; local_x++) {
-                                int stamp_index = local_y * tile_def->stamp_width + local_x;
-                                if (stamp_index < tile_def->stamp_pattern.size()) {
-                                    int world_x = base_x + local_x;
-                                    int world_y = base_y + local_y;
-
-                                    if (world_x < expanded_width && world_y < expanded_height) {
-                                        int tile_value = tile_def->stamp_pattern[stamp_index];
-                                        expanded_tiles[world_y * expanded_width + world_x] = tile_value;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-
-                result->_set_expanded_data(expanded_tiles, expanded_width, expanded_height, stamp_size);
-
-                if (debug_mode) {
-                    UtilityFunctions::print("WFCv2: Expanded from ", output_width, "x", output_height,
-                                          " to ", expanded_width, "x", expanded_height,
-                                          " (", stamp_size, "x", stamp_size, " stamps)");
-                }
-            } else {
-                UtilityFunctions::push_warning("WFCv2: Stamp size set but not all tiles have stamps defined");
-            }
+Ref<WFCResult> GDTilingWFCv2::run_hierarchical(int threads) {
+    Ref<WFCResult> result;
+    TilingProblem problem;
+    String error = build_tiling_problem(config, problem);
+    HierarchicalTiling hierarchy;
+    if (error.is_empty()) {
+        String macro_error = build_tiling_problem(macro_config, hierarchy.macro);
+        if (!macro_error.is_empty()) {
+            error = "Macro configuration: " + macro_error;
         }
+    }
+    if (!error.is_empty()) {
+        result.instantiate();
+        result->_set_failure(error, Vector2i(0, 0));
+        return result;
+    }
 
-        if (debug_mode) {
-            UtilityFunctions::print("WFCv2: Success! Generated ", output_width, "x", output_height, " dungeon");
+    for (const auto& tile_def : macro_config->get_tiles()) {
+        if (tile_def.has_interior) {
+            hierarchy.interiors[tile_def.tile_id] = to_int_vector(tile_def.interior_tiles);
         }
+    }
+    hierarchy.blockSize = macro_block_size;
+    hierarchy.threads = threads;
+
+    TilingOutput out = solveTilingHierarchical(problem, hierarchy, width, height, seed);
+    if (debug_mode && out.success) {
+        int blocks_x = (width + macro_block_size - 1) / macro_block_size;
+        int blocks_y = (height + macro_block_size - 1) / macro_block_size;
+        UtilityFunctions::print("WFCv2: Hierarchical ", out.width, "x", out.height, " from ", blocks_x, "x",
+                                blocks_y, " macro cells");
+    }
+    return make_tiling_result(out, problem.stampSize, keep_intermediate_outputs);
+}
 
-    } catch (const std::exception& e) {
-        result->_set_failure(String("WFC error: ") + e.what(), Vector2i(0, 0));
+Ref<WFCResult> GDTilingWFCv2::replay(const PackedByteArray& log) {
+    TilingProblem problem;
+    String error = build_tiling_problem(config, problem);
+    if (!error.is_empty()) {
+        Ref<WFCResult> result;
+        result.instantiate();
+        result->_set_failure(error, Vector2i(0, 0));
+        return result;
     }
 
+    TilingOutput out = replayTiling(problem, width, height, periodic, log.ptr(), log.size());
+    if (out.success) {
+        out.decisions.assign(log.ptr(), log.ptr() + log.size());
+    }
+    return make_tiling_result(out, problem.stampSize, keep_intermediate_outputs);
+}
+
+Ref<WFCResult> GDTilingWFCv2::regenerate_region(const Ref<WFCResult>& p_result, const Rect2i& rect,
+                                                 int64_t region_seed) {
+    Ref<WFCResult> result;
+    result.instantiate();
+    TilingProblem problem;
+    String error = build_tiling_problem(config, problem);
+    if (error.is_empty()) {
+        if (p_result.is_null() || !p_result->is_success()) {
+            error = "regenerate_region needs a successful result";
+        } else if (p_result->get_wfc_width() != width || p_result->get_wfc_height() != height) {
+            error = "Result size does not match this generator's size";
+        } else if (p_result->get_wfc_tiles().is_empty()) {
+            error = "Result has no WFC tiles; enable keep_intermediate_outputs";
+        } else if (p_result->get_wfc_tiles().size() != (int64_t)width * height) {
+            error = "Result WFC tiles do not match its size";
+        } else if (problem.stampSize > 0 && (p_result->get_expanded_width() != width * problem.stampSize ||
+                                             p_result->get_expanded_height() != height * problem.stampSize)) {
+            error = "Result stamps do not match this configuration";
+        } else if (problem.stampSize > 0 && p_result->get_expanded_tiles().size() !=
+                                                (int64_t)width * problem.stampSize * height * problem.stampSize) {
+            error = "Result expanded tiles do not match its size";
+        }
+    }
+    if (!error.is_empty()) {
+        result->_set_failure(error, Vector2i(0, 0));
+        return result;
+    }
+
+    Rect2i region = rect.intersection(Rect2i(0, 0, width, height));
+    PackedInt32Array tiles = p_result->get_wfc_tiles();
+    TilingOutput out = regenerateTilingRegion(problem, tiles.ptr(), width, height, periodic,
+                                              region.position.x, region.position.y,
+                                              region.size.x, region.size.y, (uint64_t)region_seed);
+    if (!out.success) {
+        result->_set_failure(String(out.failureReason.c_str()), Vector2i(out.failureX, out.failureY));
+        return result;
+    }
+
+    // The old grids with the region written over them
+    if (!copy_block(tiles, width, out.tiles, out.width, region.position.x, region.position.y)) {
+        result->_set_failure("Region does not fit the result", Vector2i(0, 0));
+        return result;
+    }
+    result->_set_wfc_data(tiles, width, height);
+    if (problem.stampSize > 0) {
+        int stamp = problem.stampSize;
+        PackedInt32Array expanded = p_result->get_expanded_tiles();
+        if (!copy_block(expanded, width * stamp, out.expanded, out.expandedWidth, region.position.x * stamp,
+                        region.position.y * stamp)) {
+            result->_set_failure("Region does not fit the result", Vector2i(0, 0));
+            return result;
+        }
+        result->_set_expanded_data(expanded, width * stamp, height * stamp, stamp);
+    }
     return result;
 }
 
@@ -6,10 +6,18 @@
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/variant/typed_array.hpp>
 #include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
 #include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/array.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/core/class_db.hpp>
 
+#include "MultiLevel.h"
+#include "tile_grid_cache.h"
+
 using namespace godot;
 
 // Forward declarations
@@ -34,6 +42,14 @@ private:
     bool success;
     String failure_reason;
     Vector2i failure_position;
+    PackedByteArray decision_log;
+
+    // Lazily built views of the active grid (expanded if stamped, else raw)
+    mutable TileGridCache grid_cache;
+
+    const PackedInt32Array& active_tiles() const { return has_stamps ? expanded_tiles : wfc_tiles; }
+    int active_width() const { return has_stamps ? expanded_width : wfc_width; }
+    int active_height() const { return has_stamps ? expanded_height : wfc_height; }
 
 protected:
     static void _bind_methods();
@@ -59,15 +75,54 @@ public:
     PackedInt32Array get_wfc_tiles() const { return wfc_tiles; }
     PackedInt32Array get_expanded_tiles() const { return expanded_tiles; }
 
-    // Helper methods for dungeon generation
+    // Helper methods for dungeon generation. The first call buckets every
+    // tile value in one pass; later calls for any value reuse the buckets.
     PackedVector2Array get_floor_positions(int floor_tile_value = 0) const;
     PackedVector2Array get_wall_positions(int wall_tile_value = 1) const;
+    PackedVector2Array get_positions_of(int tile_value) const;
     Dictionary get_tile_distribution() const;
 
+    // Bulk queries on the same grid as get_expanded_tile_at(). get_region()
+    // returns rect.size.x * rect.size.y tiles (row-major, -1 outside the grid);
+    // count_in_rect() is O(1) after a per-value summed-area table is built.
+    PackedInt32Array get_region(const Rect2i& rect) const;
+    int64_t count_in_rect(int tile_value, const Rect2i& rect) const;
+    PackedVector2Array find_all(int tile_value, const Rect2i& rect) const;
+
+    // Region analysis on the same grid (see region_analysis.h)
+    Dictionary get_regions(int tile_value, int threads = 0) const;
+    PackedVector2Array get_dead_end_positions(int tile_value) const;
+    PackedInt32Array get_distance_field(int tile_value, const PackedVector2Array& sources) const;
+    PackedVector2Array get_farthest_pair(int tile_value) const;
+    PackedVector2Array get_critical_path(int tile_value) const;
+    PackedVector2Array get_chokepoints(int tile_value) const;
+
+    // Shapes (see grid_geometry.h)
+    PackedInt32Array get_rects(int tile_value) const;
+    Array get_contours(int tile_value, double epsilon) const;
+    Array get_contour_chunks(int tile_value, int chunk_size, double epsilon, int threads) const;
+
+    // Autotiling (see autotile.h)
+    PackedInt32Array get_bitmasks(int tile_value, int neighbours) const;
+    PackedVector2Array get_autotile(int tile_value, const Dictionary& lut, int neighbours) const;
+
+    // Placement (see placement.h)
+    Array get_placements(int tile_value, const PackedFloat32Array& radii, int64_t seed, const PackedInt32Array& counts,
+                         const PackedVector2Array& exclude, const PackedVector3Array& keep_out) const;
+
+    // Compact serialization (see result_codec.h)
+    PackedByteArray to_bytes(bool compress = true) const;
+    static Ref<WFCResult> from_bytes(const PackedByteArray& bytes);
+
+    // The solve's decisions (see wfc/DecisionLog.h), for
+    // GDTilingWFCv2.replay(). Empty unless record_decisions was on.
+    PackedByteArray get_decision_log() const { return decision_log; }
+
     // Internal setters (used by WFC generator)
     void _set_wfc_data(PackedInt32Array tiles, int width, int height);
     void _set_expanded_data(PackedInt32Array tiles, int width, int height, int p_stamp_size);
     void _set_failure(String reason, Vector2i position);
+    void _set_decision_log(PackedByteArray log);
 };
 
 // ============================================================================
@@ -106,6 +161,10 @@ public:
         PackedInt32Array stamp_pattern;  // Flat array: [row0_col0, row0_col1, ..., row2_col2]
         int stamp_width;
         int stamp_height;
+
+        // Hierarchical mode: fine tiles allowed inside this macro tile
+        bool has_interior;
+        PackedInt32Array interior_tiles;
     };
 
     struct NeighborRule {
@@ -153,6 +212,13 @@ public:
     // ========================================================================
     void set_tile_stamp(int tile_id, PackedInt32Array stamp_pattern, int stamp_width, int stamp_height);
 
+    // ========================================================================
+    // Macro tiles (GDTilingWFCv2.run_hierarchical)
+    // ========================================================================
+    // Restricts the blocks under this macro tile to the given fine tile ids.
+    // Macro tiles without an interior allow every fine tile.
+    void set_tile_interior(int tile_id, PackedInt32Array fine_tile_ids);
+
     // ========================================================================
     // Neighbor rules
     // ========================================================================
@@ -190,11 +256,16 @@ public:
 private:
     int width;
     int height;
-    int seed;
+    int64_t seed;
     bool periodic;
 
     Ref<WFCConfiguration> config;
+    Ref<WFCConfiguration> macro_config;
+    int macro_block_size;
     bool debug_mode;
+    bool keep_intermediate_outputs;
+    bool record_decisions;
+    Dictionary acceptance;
 
 protected:
     static void _bind_methods();
@@ -208,11 +279,32 @@ public:
     // Configuration (basic settings)
     // ========================================================================
     void set_size(int p_width, int p_height);
-    void set_seed(int p_seed);
+    void set_seed(int64_t p_seed);
     void set_periodic(bool p_periodic);
     void set_configuration(Ref<WFCConfiguration> p_config);
     void enable_debug(bool enabled);
 
+    // When false and stamps are enabled, results keep only the expanded
+    // grid and skip copying the raw WFC tiles (get_wfc_tiles() is empty).
+    void set_keep_intermediate_outputs(bool keep);
+    bool get_keep_intermediate_outputs() const { return keep_intermediate_outputs; }
+
+    // When true, results carry their decision log (get_decision_log()).
+    void set_record_decisions(bool enabled);
+    bool get_record_decisions() const { return record_decisions; }
+
+    // Limits for generate_accepted() (see acceptance.h for the keys);
+    // "floor_value" names the tile (or stamp) value counted as floor.
+    void set_acceptance(const Dictionary& p_acceptance);
+    Dictionary get_acceptance() const { return acceptance; }
+
+    // Coarse tile set for run_hierarchical(), one macro tile per
+    // macro_block_size x macro_block_size block of the output.
+    void set_macro_configuration(Ref<WFCConfiguration> p_config);
+    Ref<WFCConfiguration> get_macro_configuration() const { return macro_config; }
+    void set_macro_block_size(int size);
+    int get_macro_block_size() const { return macro_block_size; }
+
     // ========================================================================
     // Quick setup methods (for simple use cases)
     // ========================================================================
@@ -233,6 +325,39 @@ public:
     // ========================================================================
     Ref<WFCResult> run();
 
+    // Runs one solve per seed on up to `threads` workers (0 = all cores).
+    // The configuration is converted once; results are returned in seed order.
+    Array generate_batch(const PackedInt64Array& seeds, int threads = 0);
+
+    // Solves seeds seed, seed + 1, ... on up to `threads` workers and
+    // returns { result, seed, attempts } for the first successful solve
+    // that meets the acceptance limits, checked on the expanded grid when
+    // stamps are set. result is null if none of `max_attempts` did.
+    Dictionary generate_accepted(int max_attempts = 32, int threads = 0);
+
+    // Converts the configuration once into a native job for
+    // MultiLevelDungeonGenerator. Jobs return the expanded grid when stamps
+    // are set; configuration errors surface as a failed level.
+    LevelJob make_level_job() const;
+
+    // Coarse-to-fine solve for large outputs (see solveTilingHierarchical in
+    // wfc/TilingSolver.h): the macro configuration first, then every block
+    // with this configuration's tiles on up to `threads` workers (0 = all
+    // cores). Always non-periodic; get_wfc_tiles() holds tile ids.
+    Ref<WFCResult> run_hierarchical(int threads = 0);
+
+    // Rebuilds a recorded result from its decision log, applying each
+    // decision with propagation but no entropy search or sampling. Size,
+    // periodicity and configuration must match the recording.
+    Ref<WFCResult> replay(const PackedByteArray& log);
+
+    // Re-solves `rect` (clipped to the output) of a result from this
+    // generator and keeps every other cell: only the rect and a one-cell ring
+    // of its current tiles are solved (see regenerateTilingRegion in
+    // wfc/TilingSolver.h). Needs the result's get_wfc_tiles(), so keep
+    // intermediate outputs when stamps are set. Returns a new result.
+    Ref<WFCResult> regenerate_region(const Ref<WFCResult>& p_result, const Rect2i& rect, int64_t region_seed);
+
     // ========================================================================
     // Utility
     // ========================================================================
@@ -0,0 +1,95 @@
+#include "grid_geometry.h"
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
+#include <vector>
+
+#include "GridGeometry.h"
+#include "region_analysis.h"
+
+namespace {
+
+PackedInt32Array pack_rects(const std::vector<GridRect>& rects, int offset_x, int offset_y) {
+    PackedInt32Array result;
+    result.resize(rects.size() * 4);
+    int32_t* out = result.ptrw();
+    for (const GridRect& r : rects) {
+        *out++ = r.x + offset_x;
+        *out++ = r.y + offset_y;
+        *out++ = r.w;
+        *out++ = r.h;
+    }
+    return result;
+}
+
+Array pack_contours(const std::vector<Contour>& contours, int offset_x, int offset_y) {
+    Array result;
+    result.resize(contours.size());
+    for (size_t i = 0; i < contours.size(); i++) {
+        const Contour& contour = contours[i];
+        PackedVector2Array points;
+        points.resize(contour.size());
+        Vector2* out = points.ptrw();
+        for (const GridPoint& p : contour) {
+            *out++ = Vector2((real_t)(p.x + offset_x), (real_t)(p.y + offset_y));
+        }
+        result[i] = points;
+    }
+    return result;
+}
+
+Array pack_chunks(const std::vector<ContourChunk>& chunks, int offset_x, int offset_y) {
+    Array result;
+    result.resize(chunks.size());
+    for (size_t i = 0; i < chunks.size(); i++) {
+        const GridRect& area = chunks[i].area;
+        Dictionary chunk;
+        chunk["rect"] = Rect2i(area.x + offset_x, area.y + offset_y, area.w, area.h);
+        chunk["contours"] = pack_contours(chunks[i].contours, offset_x, offset_y);
+        result[i] = chunk;
+    }
+    return result;
+}
+
+} // namespace
+
+PackedInt32Array merge_position_rects(const PackedVector2Array& positions) {
+    PositionMask m = rasterize_positions(positions);
+    return pack_rects(mergeRectangles(m.cells.data(), m.width, m.height), m.min_x, m.min_y);
+}
+
+PackedInt32Array merge_grid_rects(const PackedInt32Array& tiles, int width, int height, int value) {
+    std::vector<uint8_t> mask;
+    if (!make_grid_mask(tiles, width, height, value, mask)) {
+        return PackedInt32Array();
+    }
+    return pack_rects(mergeRectangles(mask.data(), width, height), 0, 0);
+}
+
+Array position_contours(const PackedVector2Array& positions, double epsilon) {
+    PositionMask m = rasterize_positions(positions);
+    return pack_contours(traceContours(m.cells.data(), m.width, m.height, epsilon), m.min_x, m.min_y);
+}
+
+Array grid_contours(const PackedInt32Array& tiles, int width, int height, int value, double epsilon) {
+    std::vector<uint8_t> mask;
+    if (!make_grid_mask(tiles, width, height, value, mask)) {
+        return Array();
+    }
+    return pack_contours(traceContours(mask.data(), width, height, epsilon), 0, 0);
+}
+
+Array position_contour_chunks(const PackedVector2Array& positions, int chunk_size, double epsilon, int threads) {
+    PositionMask m = rasterize_positions(positions);
+    return pack_chunks(traceContourChunks(m.cells.data(), m.width, m.height, m.min_x, m.min_y, chunk_size, epsilon,
+                                          threads),
+                       m.min_x, m.min_y);
+}
+
+Array grid_contour_chunks(const PackedInt32Array& tiles, int width, int height, int value, int chunk_size,
+                          double epsilon, int threads) {
+    std::vector<uint8_t> mask;
+    if (!make_grid_mask(tiles, width, height, value, mask)) {
+        return Array();
+    }
+    return pack_chunks(traceContourChunks(mask.data(), width, height, 0, 0, chunk_size, epsilon, threads), 0, 0);
+}
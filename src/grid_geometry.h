@@ -0,0 +1,34 @@
+#ifndef GRID_GEOMETRY_H
+#define GRID_GEOMETRY_H
+
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+
+using namespace godot;
+
+// ============================================================================
+// Shared helpers for the result classes' shape queries (see GridGeometry.h)
+// ============================================================================
+
+// Greedy-meshed rectangles covering every position (or every cell holding
+// `value`), packed as x, y, w, h per rectangle in tile coordinates. Ready
+// for RectangleShape2D bodies or NavigationPolygon outlines.
+PackedInt32Array merge_position_rects(const PackedVector2Array& positions);
+PackedInt32Array merge_grid_rects(const PackedInt32Array& tiles, int width, int height, int value);
+
+// Closed outlines around the positions (or cells holding `value`), one
+// PackedVector2Array of corner points per outline, in tile coordinates.
+// epsilon > 0 simplifies them with Douglas-Peucker.
+Array position_contours(const PackedVector2Array& positions, double epsilon);
+Array grid_contours(const PackedInt32Array& tiles, int width, int height, int value, double epsilon);
+
+// The same, traced per chunk_size x chunk_size chunk on up to `threads`
+// workers: an Array of { "rect": Rect2i (tiles), "contours": Array } for
+// every non-empty chunk, in row-major order. Chunks are aligned to
+// multiples of chunk_size, and each chunk's outlines are closed within it.
+Array position_contour_chunks(const PackedVector2Array& positions, int chunk_size, double epsilon, int threads);
+Array grid_contour_chunks(const PackedInt32Array& tiles, int width, int height, int value, int chunk_size,
+                          double epsilon, int threads);
+
+#endif // GRID_GEOMETRY_H
@@ -1,5 +1,18 @@
 #include "hybrid_godot.h"
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <random>
+
+#include "Parallel.h"
+#include "acceptance.h"
+#include "autotile.h"
+#include "grid_geometry.h"
+#include "placement.h"
+#include "region_analysis.h"
+#include "result_codec.h"
+#include "room_index.h"
+#include "visibility.h"
 
 using namespace godot;
 
@@ -18,30 +31,47 @@ void HybridResult::set_data(const std::vector<RoomObj>& p_rooms,
                            const std::vector<Point>& p_walls,
                            const GenSettings& p_cfg) {
     
-    // Convert Rooms
-    rooms.clear();
-    for (const auto& r : p_rooms) {
-        Dictionary d;
-        d["id"] = r.id;
-        d["x"] = r.x;
-        d["y"] = r.y;
-        d["w"] = r.w;
-        d["h"] = r.h;
-        d["shape"] = (r.shape == Shape::Rect) ? "rect" : "circle";
-        d["is_main"] = r.isMain;
-        rooms.append(d);
-    }
-
-    // Convert Links
-    links.clear();
-    for (const auto& l : p_links) {
-        Dictionary d;
-        d["u"] = l.u;
-        d["v"] = l.v;
-        d["is_mst"] = l.isMST;
-        links.append(d);
+    // Rooms and links go straight into packed arrays; no Dictionaries yet
+    int room_count = (int)p_rooms.size();
+    room_ids.resize(room_count);
+    room_positions.resize(room_count * 2);
+    room_sizes.resize(room_count * 2);
+    room_shapes.resize(room_count);
+    room_flags.resize(room_count);
+    int32_t* ids = room_ids.ptrw();
+    float* positions = room_positions.ptrw();
+    float* sizes = room_sizes.ptrw();
+    int32_t* shapes = room_shapes.ptrw();
+    int32_t* room_flag_bits = room_flags.ptrw();
+    for (int i = 0; i < room_count; ++i) {
+        const RoomObj& r = p_rooms[i];
+        ids[i] = r.id;
+        positions[i * 2] = r.x;
+        positions[i * 2 + 1] = r.y;
+        sizes[i * 2] = r.w;
+        sizes[i * 2 + 1] = r.h;
+        shapes[i] = (r.shape == Shape::Rect) ? SHAPE_RECT : SHAPE_CIRCLE;
+        room_flag_bits[i] = r.isMain ? ROOM_MAIN : 0;
+    }
+
+    int link_count = (int)p_links.size();
+    link_endpoints.resize(link_count * 2);
+    link_flags.resize(link_count);
+    int32_t* endpoints = link_endpoints.ptrw();
+    int32_t* link_flag_bits = link_flags.ptrw();
+    for (int i = 0; i < link_count; ++i) {
+        endpoints[i * 2] = p_links[i].u;
+        endpoints[i * 2 + 1] = p_links[i].v;
+        link_flag_bits[i] = p_links[i].isMST ? LINK_MST : 0;
     }
 
+    rooms = Array();
+    links = Array();
+    rooms_built = false;
+    links_built = false;
+    room_index_built = false;
+    visibility_built = false;
+
     // Convert Floors
     floors.resize(p_floors.size());
     for (size_t i = 0; i < p_floors.size(); ++i) {
@@ -61,8 +91,58 @@ void HybridResult::set_data(const std::vector<RoomObj>& p_rooms,
     tile_h = p_cfg.tileH;
 }
 
-Array HybridResult::get_rooms() const { return rooms; }
-Array HybridResult::get_links() const { return links; }
+Array HybridResult::get_rooms() const {
+    if (!rooms_built) {
+        int count = room_ids.size();
+        const int32_t* ids = room_ids.ptr();
+        const float* positions = room_positions.ptr();
+        const float* sizes = room_sizes.ptr();
+        const int32_t* shapes = room_shapes.ptr();
+        const int32_t* flags = room_flags.ptr();
+        rooms.resize(count);
+        for (int i = 0; i < count; ++i) {
+            Dictionary d;
+            d["id"] = ids[i];
+            d["x"] = positions[i * 2];
+            d["y"] = positions[i * 2 + 1];
+            d["w"] = sizes[i * 2];
+            d["h"] = sizes[i * 2 + 1];
+            d["shape"] = (shapes[i] == SHAPE_CIRCLE) ? "circle" : "rect";
+            d["is_main"] = (flags[i] & ROOM_MAIN) != 0;
+            rooms[i] = d;
+        }
+        rooms_built = true;
+    }
+    return rooms;
+}
+
+Array HybridResult::get_links() const {
+    if (!links_built) {
+        int count = link_flags.size();
+        const int32_t* endpoints = link_endpoints.ptr();
+        const int32_t* flags = link_flags.ptr();
+        links.resize(count);
+        for (int i = 0; i < count; ++i) {
+            Dictionary d;
+            d["u"] = endpoints[i * 2];
+            d["v"] = endpoints[i * 2 + 1];
+            d["is_mst"] = (flags[i] & LINK_MST) != 0;
+            links[i] = d;
+        }
+        links_built = true;
+    }
+    return links;
+}
+
+int HybridResult::get_room_count() const { return room_ids.size(); }
+int HybridResult::get_link_count() const { return link_flags.size(); }
+PackedInt32Array HybridResult::get_room_ids() const { return room_ids; }
+PackedFloat32Array HybridResult::get_room_positions() const { return room_positions; }
+PackedFloat32Array HybridResult::get_room_sizes() const { return room_sizes; }
+PackedInt32Array HybridResult::get_room_shapes() const { return room_shapes; }
+PackedInt32Array HybridResult::get_room_flags() const { return room_flags; }
+PackedInt32Array HybridResult::get_link_endpoints() const { return link_endpoints; }
+PackedInt32Array HybridResult::get_link_flags() const { return link_flags; }
 PackedVector2Array HybridResult::get_floors() const { return floors; }
 PackedVector2Array HybridResult::get_walls() const { return walls; }
 
@@ -75,9 +155,281 @@ int HybridResult::get_grid_height() const { return grid_height; }
 int HybridResult::get_tile_w() const { return tile_w; }
 int HybridResult::get_tile_h() const { return tile_h; }
 
+Dictionary HybridResult::get_floor_regions(int threads) const {
+    return analyze_position_regions(floors, threads);
+}
+
+PackedVector2Array HybridResult::get_dead_end_positions() const {
+    return find_position_dead_ends(floors);
+}
+
+PackedInt32Array HybridResult::get_distance_field(const PackedVector2Array& sources) const {
+    return position_distance_field(floors, sources);
+}
+
+PackedVector2Array HybridResult::get_farthest_pair() const {
+    return position_farthest_pair(floors);
+}
+
+PackedVector2Array HybridResult::get_critical_path() const {
+    return position_critical_path(floors);
+}
+
+PackedVector2Array HybridResult::get_chokepoints() const {
+    return position_chokepoints(floors);
+}
+
+PackedInt32Array HybridResult::get_wall_rects() const {
+    return merge_position_rects(walls);
+}
+
+PackedInt32Array HybridResult::get_floor_rects() const {
+    return merge_position_rects(floors);
+}
+
+Array HybridResult::get_wall_contours(double epsilon) const {
+    return position_contours(walls, epsilon);
+}
+
+Array HybridResult::get_floor_contours(double epsilon) const {
+    return position_contours(floors, epsilon);
+}
+
+Array HybridResult::get_wall_contour_chunks(int chunk_size, double epsilon, int threads) const {
+    return position_contour_chunks(walls, chunk_size, epsilon, threads);
+}
+
+Array HybridResult::get_floor_contour_chunks(int chunk_size, double epsilon, int threads) const {
+    return position_contour_chunks(floors, chunk_size, epsilon, threads);
+}
+
+PackedInt32Array HybridResult::get_wall_bitmasks(int neighbours) const {
+    return position_bitmasks(walls, neighbours);
+}
+
+PackedInt32Array HybridResult::get_floor_bitmasks(int neighbours) const {
+    return position_bitmasks(floors, neighbours);
+}
+
+PackedVector2Array HybridResult::get_wall_autotile(const Dictionary& lut, int neighbours) const {
+    return position_autotile(walls, lut, neighbours);
+}
+
+PackedVector2Array HybridResult::get_floor_autotile(const Dictionary& lut, int neighbours) const {
+    return position_autotile(floors, lut, neighbours);
+}
+
+Array HybridResult::get_floor_placements(const PackedFloat32Array& radii, int64_t seed, const PackedInt32Array& counts,
+                                         const PackedVector2Array& exclude, const PackedVector3Array& keep_out) const {
+    return position_poisson(floors, radii, seed, counts, exclude, keep_out);
+}
+
+static const uint8_t ROOM_FLAG_CIRCLE = 1;
+static const uint8_t ROOM_FLAG_MAIN = 2;
+
+const RoomIndex& HybridResult::room_lookup() const {
+    if (room_index_built) {
+        return room_index;
+    }
+
+    // Main rooms claim the floor cells of their painted shape, using the
+    // same world-to-tile truncation as DungeonBuilder::rasterizeBase()
+    begin_room_index(room_index, floors);
+    int count = room_ids.size();
+    const float* positions = room_positions.ptr();
+    const float* sizes = room_sizes.ptr();
+    const int32_t* shapes = room_shapes.ptr();
+    const int32_t* flags = room_flags.ptr();
+    for (int i = 0; i < count; ++i) {
+        int room = room_index.addRoom();
+        if (!(flags[i] & ROOM_MAIN) || tile_w <= 0 || tile_h <= 0) continue;
+        float x = positions[i * 2], y = positions[i * 2 + 1];
+        float w = sizes[i * 2], h = sizes[i * 2 + 1];
+        if (shapes[i] == SHAPE_RECT) {
+            int sx = (int)((x - w / 2) / tile_w), sy = (int)((y - h / 2) / tile_h);
+            int gw = std::max(1, (int)(w / tile_w)), gh = std::max(1, (int)(h / tile_h));
+            room_index.claimRect(room, GridRect{sx, sy, gw, gh});
+            continue;
+        }
+        int cx = (int)(x / tile_w), cy = (int)(y / tile_h);
+        int rad_x = (int)((w / 2) / tile_w), rad_y = (int)((w / 2) / tile_h);
+        if (rad_x <= 0 || rad_y <= 0) continue;
+        for (int gy = cy - rad_y; gy <= cy + rad_y; ++gy) {
+            for (int gx = cx - rad_x; gx <= cx + rad_x; ++gx) {
+                float dx = (float)(gx - cx), dy = (float)(gy - cy);
+                if ((dx * dx) / (rad_x * rad_x) + (dy * dy) / (rad_y * rad_y) <= 1.0f) {
+                    room_index.claimCell(room, gx, gy);
+                }
+            }
+        }
+    }
+    room_index.finish();
+    room_index_built = true;
+    return room_index;
+}
+
+int HybridResult::room_at(const Vector2i& cell) const {
+    return index_room_at(room_lookup(), cell);
+}
+
+PackedInt32Array HybridResult::rooms_in_rect(const Rect2i& rect) const {
+    return index_rooms_in_rect(room_lookup(), rect);
+}
+
+PackedInt32Array HybridResult::get_room_neighbours(int room) const {
+    return index_room_neighbours(room_lookup(), room);
+}
+
+Rect2i HybridResult::get_room_bounds(int room) const {
+    return index_room_bounds(room_lookup(), room);
+}
+
+VisibilityMap& HybridResult::visibility_map() const {
+    if (!visibility_built) {
+        build_position_visibility(visibility, floors);
+        visibility_built = true;
+    }
+    return visibility;
+}
+
+PackedVector2Array HybridResult::get_fov(const Vector2i& origin, int radius) const {
+    return visibility_fov(visibility_map(), origin, radius);
+}
+
+PackedInt32Array HybridResult::get_visible_rooms(int room, int threads) const {
+    return visibility_rooms(visibility_map(), room_lookup(), room, threads);
+}
+
+bool HybridResult::can_room_see(int from, int to) const {
+    return visibility_room_sees(visibility_map(), room_lookup(), from, to);
+}
+
+PackedByteArray HybridResult::to_bytes(bool compress) const {
+    ByteWriter body;
+    body.putVarU(grid_width);
+    body.putVarU(grid_height);
+    body.putVarU(tile_w);
+    body.putVarU(tile_h);
+
+    int room_count = room_ids.size();
+    const int32_t* ids = room_ids.ptr();
+    const float* positions = room_positions.ptr();
+    const float* sizes = room_sizes.ptr();
+    const int32_t* shapes = room_shapes.ptr();
+    const int32_t* flags = room_flags.ptr();
+    body.putVarU(room_count);
+    for (int i = 0; i < room_count; ++i) {
+        body.putVarI(ids[i]);
+        body.putF32(positions[i * 2]);
+        body.putF32(positions[i * 2 + 1]);
+        body.putF32(sizes[i * 2]);
+        body.putF32(sizes[i * 2 + 1]);
+        uint8_t bits = 0;
+        if (shapes[i] == SHAPE_CIRCLE) bits |= ROOM_FLAG_CIRCLE;
+        if (flags[i] & ROOM_MAIN) bits |= ROOM_FLAG_MAIN;
+        body.putU8(bits);
+    }
+
+    int link_count = link_flags.size();
+    const int32_t* endpoints = link_endpoints.ptr();
+    const int32_t* link_bits = link_flags.ptr();
+    body.putVarU(link_count);
+    for (int i = 0; i < link_count; ++i) {
+        body.putVarI(endpoints[i * 2]);
+        body.putVarI(endpoints[i * 2 + 1]);
+        body.putU8((link_bits[i] & LINK_MST) ? 1 : 0);
+    }
+
+    const PackedVector2Array* layers[] = {&floors, &walls};
+    write_position_layers(body, layers, 2);
+    return make_result_blob(MapAlgorithm::Hybrid, body, compress);
+}
+
+Ref<HybridResult> HybridResult::from_bytes(const PackedByteArray& bytes) {
+    std::vector<uint8_t> scratch;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (!open_result_blob(bytes, MapAlgorithm::Hybrid, "HybridResult", scratch, data, size)) {
+        return Ref<HybridResult>();
+    }
+
+    ByteReader in(data, size);
+    Ref<HybridResult> res;
+    res.instantiate();
+    res->grid_width = (int)in.getVarU();
+    res->grid_height = (int)in.getVarU();
+    res->tile_w = (int)in.getVarU();
+    res->tile_h = (int)in.getVarU();
+
+    // A room takes at least 18 bytes and a link 3, which bounds the counts
+    uint64_t room_count = in.getVarU();
+    if (!in.ok() || room_count > in.remaining() / 18) {
+        UtilityFunctions::push_error("HybridResult.from_bytes: blob is corrupt");
+        return Ref<HybridResult>();
+    }
+    res->room_ids.resize(room_count);
+    res->room_positions.resize(room_count * 2);
+    res->room_sizes.resize(room_count * 2);
+    res->room_shapes.resize(room_count);
+    res->room_flags.resize(room_count);
+    int32_t* ids = res->room_ids.ptrw();
+    float* positions = res->room_positions.ptrw();
+    float* sizes = res->room_sizes.ptrw();
+    int32_t* shapes = res->room_shapes.ptrw();
+    int32_t* flags = res->room_flags.ptrw();
+    for (uint64_t i = 0; i < room_count; ++i) {
+        ids[i] = (int32_t)in.getVarI();
+        positions[i * 2] = in.getF32();
+        positions[i * 2 + 1] = in.getF32();
+        sizes[i * 2] = in.getF32();
+        sizes[i * 2 + 1] = in.getF32();
+        uint8_t bits = in.getU8();
+        shapes[i] = (bits & ROOM_FLAG_CIRCLE) ? SHAPE_CIRCLE : SHAPE_RECT;
+        flags[i] = (bits & ROOM_FLAG_MAIN) ? ROOM_MAIN : 0;
+    }
+
+    uint64_t link_count = in.getVarU();
+    if (!in.ok() || link_count > in.remaining() / 3) {
+        UtilityFunctions::push_error("HybridResult.from_bytes: blob is corrupt");
+        return Ref<HybridResult>();
+    }
+    res->link_endpoints.resize(link_count * 2);
+    res->link_flags.resize(link_count);
+    int32_t* endpoints = res->link_endpoints.ptrw();
+    int32_t* link_bits = res->link_flags.ptrw();
+    for (uint64_t i = 0; i < link_count; ++i) {
+        endpoints[i * 2] = (int32_t)in.getVarI();
+        endpoints[i * 2 + 1] = (int32_t)in.getVarI();
+        link_bits[i] = in.getU8() ? LINK_MST : 0;
+    }
+
+    PackedVector2Array* layers[] = {&res->floors, &res->walls};
+    if (!in.ok() || !read_position_layers(in, layers, 2)) {
+        UtilityFunctions::push_error("HybridResult.from_bytes: blob is corrupt");
+        return Ref<HybridResult>();
+    }
+    return res;
+}
+
 void HybridResult::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_rooms"), &HybridResult::get_rooms);
     ClassDB::bind_method(D_METHOD("get_links"), &HybridResult::get_links);
+    ClassDB::bind_method(D_METHOD("get_room_count"), &HybridResult::get_room_count);
+    ClassDB::bind_method(D_METHOD("room_at", "cell"), &HybridResult::room_at);
+    ClassDB::bind_method(D_METHOD("rooms_in_rect", "rect"), &HybridResult::rooms_in_rect);
+    ClassDB::bind_method(D_METHOD("get_room_neighbours", "room"), &HybridResult::get_room_neighbours);
+    ClassDB::bind_method(D_METHOD("get_room_bounds", "room"), &HybridResult::get_room_bounds);
+    ClassDB::bind_method(D_METHOD("get_fov", "origin", "radius"), &HybridResult::get_fov, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_visible_rooms", "room", "threads"), &HybridResult::get_visible_rooms, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("can_room_see", "from", "to"), &HybridResult::can_room_see);
+    ClassDB::bind_method(D_METHOD("get_link_count"), &HybridResult::get_link_count);
+    ClassDB::bind_method(D_METHOD("get_room_ids"), &HybridResult::get_room_ids);
+    ClassDB::bind_method(D_METHOD("get_room_positions"), &HybridResult::get_room_positions);
+    ClassDB::bind_method(D_METHOD("get_room_sizes"), &HybridResult::get_room_sizes);
+    ClassDB::bind_method(D_METHOD("get_room_shapes"), &HybridResult::get_room_shapes);
+    ClassDB::bind_method(D_METHOD("get_room_flags"), &HybridResult::get_room_flags);
+    ClassDB::bind_method(D_METHOD("get_link_endpoints"), &HybridResult::get_link_endpoints);
+    ClassDB::bind_method(D_METHOD("get_link_flags"), &HybridResult::get_link_flags);
     ClassDB::bind_method(D_METHOD("get_floors"), &HybridResult::get_floors);
     ClassDB::bind_method(D_METHOD("get_walls"), &HybridResult::get_walls);
     ClassDB::bind_method(D_METHOD("get_total_tiles"), &HybridResult::get_total_tiles);
@@ -85,6 +437,35 @@ void HybridResult::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_grid_height"), &HybridResult::get_grid_height);
     ClassDB::bind_method(D_METHOD("get_tile_w"), &HybridResult::get_tile_w);
     ClassDB::bind_method(D_METHOD("get_tile_h"), &HybridResult::get_tile_h);
+    ClassDB::bind_method(D_METHOD("get_floor_regions", "threads"), &HybridResult::get_floor_regions, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_dead_end_positions"), &HybridResult::get_dead_end_positions);
+    ClassDB::bind_method(D_METHOD("get_distance_field", "sources"), &HybridResult::get_distance_field);
+    ClassDB::bind_method(D_METHOD("get_farthest_pair"), &HybridResult::get_farthest_pair);
+    ClassDB::bind_method(D_METHOD("get_critical_path"), &HybridResult::get_critical_path);
+    ClassDB::bind_method(D_METHOD("get_chokepoints"), &HybridResult::get_chokepoints);
+    ClassDB::bind_method(D_METHOD("get_wall_rects"), &HybridResult::get_wall_rects);
+    ClassDB::bind_method(D_METHOD("get_floor_rects"), &HybridResult::get_floor_rects);
+    ClassDB::bind_method(D_METHOD("get_wall_contours", "epsilon"), &HybridResult::get_wall_contours, DEFVAL(0.0));
+    ClassDB::bind_method(D_METHOD("get_floor_contours", "epsilon"), &HybridResult::get_floor_contours, DEFVAL(0.0));
+    ClassDB::bind_method(D_METHOD("get_wall_contour_chunks", "chunk_size", "epsilon", "threads"),
+                         &HybridResult::get_wall_contour_chunks, DEFVAL(0.0), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_floor_contour_chunks", "chunk_size", "epsilon", "threads"),
+                         &HybridResult::get_floor_contour_chunks, DEFVAL(0.0), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_wall_bitmasks", "neighbours"), &HybridResult::get_wall_bitmasks, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_floor_bitmasks", "neighbours"), &HybridResult::get_floor_bitmasks, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_wall_autotile", "lut", "neighbours"), &HybridResult::get_wall_autotile, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_floor_autotile", "lut", "neighbours"), &HybridResult::get_floor_autotile, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_floor_placements", "radii", "seed", "counts", "exclude", "keep_out"),
+                         &HybridResult::get_floor_placements, DEFVAL(PackedInt32Array()), DEFVAL(PackedVector2Array()),
+                         DEFVAL(PackedVector3Array()));
+    ClassDB::bind_method(D_METHOD("to_bytes", "compress"), &HybridResult::to_bytes, DEFVAL(true));
+    ClassDB::bind_static_method("HybridResult", D_METHOD("from_bytes", "bytes"), &HybridResult::from_bytes);
+
+    // Enums
+    BIND_ENUM_CONSTANT(SHAPE_RECT);
+    BIND_ENUM_CONSTANT(SHAPE_CIRCLE);
+    BIND_ENUM_CONSTANT(ROOM_MAIN);
+    BIND_ENUM_CONSTANT(LINK_MST);
 }
 
 // --- HybridDungeonGenerator ---
@@ -130,20 +511,16 @@ void HybridDungeonGenerator::set_tile_h(int h) { settings.tileH = h; }
 int HybridDungeonGenerator::get_tile_w() const { return settings.tileW; }
 int HybridDungeonGenerator::get_tile_h() const { return settings.tileH; }
 
-void HybridDungeonGenerator::set_seed(int seed) { settings.seed = seed; }
-int HybridDungeonGenerator::get_seed() const { return settings.seed; }
+void HybridDungeonGenerator::set_seed(int64_t seed) { settings.seed = (uint64_t)seed; }
+int64_t HybridDungeonGenerator::get_seed() const { return (int64_t)settings.seed; }
 
-Ref<HybridResult> HybridDungeonGenerator::generate() {
-    DungeonBuilder builder;
-    builder.init(settings);
+void HybridDungeonGenerator::set_route_corridors(bool enabled) { settings.routeCorridors = enabled; }
+bool HybridDungeonGenerator::get_route_corridors() const { return settings.routeCorridors; }
 
-    // Run until complete
-    int max_steps = 100000; 
-    while (!builder.isComplete() && max_steps > 0) {
-        builder.step();
-        max_steps--;
-    }
+void HybridDungeonGenerator::set_acceptance(const Dictionary& p_acceptance) { acceptance = p_acceptance; }
+Dictionary HybridDungeonGenerator::get_acceptance() const { return acceptance; }
 
+Ref<HybridResult> HybridDungeonGenerator::make_result(const DungeonBuilder& builder, const GenSettings& p_settings) {
     Ref<HybridResult> res;
     res.instantiate();
     
@@ -152,14 +529,94 @@ Ref<HybridResult> HybridDungeonGenerator::generate() {
         builder.getLinks(),
         builder.getFloors(),
         builder.getWalls(),
-        settings 
+        p_settings 
     );
 
     return res;
 }
 
+Ref<HybridResult> HybridDungeonGenerator::generate() {
+    // A single run may use every core for its labelling passes; batches
+    // already run one builder per worker
+    GenSettings run_settings = settings;
+    run_settings.workerThreads = 0;
+    DungeonBuilder builder;
+    builder.generate(run_settings);
+    return make_result(builder, settings);
+}
+
+Array HybridDungeonGenerator::generate_batch(const PackedInt64Array& seeds, int threads) {
+    int count = seeds.size();
+    std::vector<GenSettings> batch(count, settings);
+    for (int i = 0; i < count; ++i) {
+        batch[i].seed = (uint64_t)seeds[i];
+    }
+
+    std::vector<DungeonBuilder> builders(count);
+    parallelFor(count, threads, [&](int i) {
+        builders[i].generate(batch[i]);
+    });
+
+    Array results;
+    results.resize(count);
+    for (int i = 0; i < count; ++i) {
+        results[i] = make_result(builders[i], batch[i]);
+    }
+    return results;
+}
+
+Dictionary HybridDungeonGenerator::generate_accepted(int max_attempts, int threads) {
+    AcceptanceCriteria criteria;
+    if (!read_acceptance(acceptance, "HybridDungeonGenerator", criteria)) {
+        return Dictionary();
+    }
+    // Candidates need explicit seeds so the winner can be reported
+    uint64_t base_seed = settings.seed;
+    if (base_seed == 0) {
+        std::random_device rd;
+        base_seed = ((uint64_t)rd() << 32) | rd();
+    }
+
+    int slots = acceptanceSlotCount(max_attempts, threads);
+    std::vector<GenSettings> candidates(slots, settings);
+    std::vector<DungeonBuilder> builders(slots);
+    AcceptedCandidate found = firstAccepted(max_attempts, threads, [&](int candidate, int slot) {
+        candidates[slot].seed = base_seed + candidate;
+        DungeonBuilder& builder = builders[slot];
+        builder.generate(candidates[slot]);
+        FloorMask mask;
+        rasterizePoints(builder.getFloors(), mask);
+        return acceptsMap(criteria, mask, (int)builder.getRooms().size());
+    });
+
+    Variant result;
+    if (found.index >= 0) {
+        result = make_result(builders[found.slot], candidates[found.slot]);
+    }
+    return make_acceptance_report(result, found, (int64_t)base_seed);
+}
+
+LevelJob HybridDungeonGenerator::make_level_job() const {
+    GenSettings base = settings;
+    return [base](uint64_t level_seed) {
+        GenSettings level_settings = base;
+        level_settings.seed = level_seed;
+        DungeonBuilder builder;
+        builder.generate(level_settings);
+
+        MapRecord record;
+        record.seed = level_seed;
+        record.algorithm = MapAlgorithm::Hybrid;
+        rasterizeMap(builder.getFloors(), builder.getWalls(), record);
+        return record;
+    };
+}
+
 void HybridDungeonGenerator::_bind_methods() {
     ClassDB::bind_method(D_METHOD("generate"), &HybridDungeonGenerator::generate);
+    ClassDB::bind_method(D_METHOD("generate_batch", "seeds", "threads"), &HybridDungeonGenerator::generate_batch, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("generate_accepted", "max_attempts", "threads"),
+                         &HybridDungeonGenerator::generate_accepted, DEFVAL(32), DEFVAL(0));
     
     ClassDB::bind_method(D_METHOD("set_room_count", "count"), &HybridDungeonGenerator::set_room_count);
     ClassDB::bind_method(D_METHOD("get_room_count"), &HybridDungeonGenerator::get_room_count);
@@ -185,6 +642,12 @@ void HybridDungeonGenerator::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_seed", "seed"), &HybridDungeonGenerator::set_seed);
     ClassDB::bind_method(D_METHOD("get_seed"), &HybridDungeonGenerator::get_seed);
 
+    ClassDB::bind_method(D_METHOD("set_route_corridors", "enabled"), &HybridDungeonGenerator::set_route_corridors);
+    ClassDB::bind_method(D_METHOD("get_route_corridors"), &HybridDungeonGenerator::get_route_corridors);
+
+    ClassDB::bind_method(D_METHOD("set_acceptance", "acceptance"), &HybridDungeonGenerator::set_acceptance);
+    ClassDB::bind_method(D_METHOD("get_acceptance"), &HybridDungeonGenerator::get_acceptance);
+
     // Properties
     ADD_PROPERTY(PropertyInfo(Variant::INT, "room_count"), "set_room_count", "get_room_count");
     ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "spread_radius"), "set_spread_radius", "get_spread_radius");
@@ -200,4 +663,6 @@ void HybridDungeonGenerator::_bind_methods() {
 
     ADD_GROUP("", "");
     ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "route_corridors"), "set_route_corridors", "get_route_corridors");
+    ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "acceptance"), "set_acceptance", "get_acceptance");
 }
\ No newline at end of file
@@ -5,7 +5,17 @@
 #include <godot_cpp/variant/packed_vector2_array.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
 #include "DungeonBuilder.h"
+#include "MultiLevel.h"
+#include "RoomIndex.h"
+#include "Visibility.h"
 
 using namespace godot;
 
@@ -13,9 +23,31 @@ class HybridResult : public RefCounted {
     GDCLASS(HybridResult, RefCounted)
 
 private:
-    // Stored data
-    Array rooms;
-    Array links;
+    // Rooms and links as parallel packed arrays (one entry, or one x/y
+    // pair, per room or link). The Dictionary arrays returned by
+    // get_rooms() / get_links() are only built on first call.
+    PackedInt32Array room_ids;
+    PackedFloat32Array room_positions; // x, y centre pairs (world units)
+    PackedFloat32Array room_sizes;     // w, h pairs (circles: w = h = diameter)
+    PackedInt32Array room_shapes;      // SHAPE_RECT / SHAPE_CIRCLE
+    PackedInt32Array room_flags;       // ROOM_MAIN
+    PackedInt32Array link_endpoints;   // u, v room index pairs
+    PackedInt32Array link_flags;       // LINK_MST
+
+    mutable Array rooms;
+    mutable Array links;
+    mutable bool rooms_built = false;
+    mutable bool links_built = false;
+
+    // Built on the first room query
+    mutable RoomIndex room_index;
+    mutable bool room_index_built = false;
+    const RoomIndex& room_lookup() const;
+
+    mutable VisibilityMap visibility;
+    mutable bool visibility_built = false;
+    VisibilityMap& visibility_map() const;
+
     PackedVector2Array floors;
     PackedVector2Array walls;
     
@@ -28,6 +60,17 @@ protected:
     static void _bind_methods();
 
 public:
+    enum RoomShape {
+        SHAPE_RECT = 0,
+        SHAPE_CIRCLE = 1
+    };
+    enum RoomFlag {
+        ROOM_MAIN = 1
+    };
+    enum LinkFlag {
+        LINK_MST = 1
+    };
+
     HybridResult();
     
     // Setters (used by generator)
@@ -40,6 +83,28 @@ public:
     // Getters (exposed to Godot)
     Array get_rooms() const;
     Array get_links() const;
+
+    int get_room_count() const;
+    int get_link_count() const;
+    PackedInt32Array get_room_ids() const;
+    PackedFloat32Array get_room_positions() const;
+    PackedFloat32Array get_room_sizes() const;
+    PackedInt32Array get_room_shapes() const;
+    PackedInt32Array get_room_flags() const;
+    PackedInt32Array get_link_endpoints() const;
+    PackedInt32Array get_link_flags() const;
+
+    // Room lookup (see room_index.h)
+    int room_at(const Vector2i& cell) const;
+    PackedInt32Array rooms_in_rect(const Rect2i& rect) const;
+    PackedInt32Array get_room_neighbours(int room) const;
+    Rect2i get_room_bounds(int room) const;
+
+    // Visibility (see visibility.h)
+    PackedVector2Array get_fov(const Vector2i& origin, int radius) const;
+    PackedInt32Array get_visible_rooms(int room, int threads) const;
+    bool can_room_see(int from, int to) const;
+
     PackedVector2Array get_floors() const;
     PackedVector2Array get_walls() const;
     
@@ -48,6 +113,36 @@ public:
     int get_grid_height() const;
     int get_tile_w() const;
     int get_tile_h() const;
+
+    // Region analysis (see region_analysis.h)
+    Dictionary get_floor_regions(int threads = 0) const;
+    PackedVector2Array get_dead_end_positions() const;
+    PackedInt32Array get_distance_field(const PackedVector2Array& sources) const;
+    PackedVector2Array get_farthest_pair() const;
+    PackedVector2Array get_critical_path() const;
+    PackedVector2Array get_chokepoints() const;
+
+    // Shapes (see grid_geometry.h)
+    PackedInt32Array get_wall_rects() const;
+    PackedInt32Array get_floor_rects() const;
+    Array get_wall_contours(double epsilon) const;
+    Array get_floor_contours(double epsilon) const;
+    Array get_wall_contour_chunks(int chunk_size, double epsilon, int threads) const;
+    Array get_floor_contour_chunks(int chunk_size, double epsilon, int threads) const;
+
+    // Autotiling (see autotile.h)
+    PackedInt32Array get_wall_bitmasks(int neighbours) const;
+    PackedInt32Array get_floor_bitmasks(int neighbours) const;
+    PackedVector2Array get_wall_autotile(const Dictionary& lut, int neighbours) const;
+    PackedVector2Array get_floor_autotile(const Dictionary& lut, int neighbours) const;
+
+    // Placement (see placement.h)
+    Array get_floor_placements(const PackedFloat32Array& radii, int64_t seed, const PackedInt32Array& counts,
+                               const PackedVector2Array& exclude, const PackedVector3Array& keep_out) const;
+
+    // Compact serialization (see result_codec.h)
+    PackedByteArray to_bytes(bool compress = true) const;
+    static Ref<HybridResult> from_bytes(const PackedByteArray& bytes);
 };
 
 class HybridDungeonGenerator : public RefCounted {
@@ -55,6 +150,9 @@ class HybridDungeonGenerator : public RefCounted {
 
 private:
     GenSettings settings;
+    Dictionary acceptance;
+
+    static Ref<HybridResult> make_result(const DungeonBuilder& builder, const GenSettings& p_settings);
 
 protected:
     static void _bind_methods();
@@ -84,11 +182,36 @@ public:
     int get_tile_w() const;
     int get_tile_h() const;
 
-    void set_seed(int seed);
-    int get_seed() const;
+    void set_seed(int64_t seed);
+    int64_t get_seed() const;
+
+    void set_route_corridors(bool enabled);
+    bool get_route_corridors() const;
+
+    // Limits for generate_accepted() (see acceptance.h for the keys)
+    void set_acceptance(const Dictionary& p_acceptance);
+    Dictionary get_acceptance() const;
 
     // Execution
     Ref<HybridResult> generate();
+
+    // Generates one result per seed on up to `threads` workers (0 = all
+    // cores). Results are returned in seed order.
+    Array generate_batch(const PackedInt64Array& seeds, int threads = 0);
+
+    // Generates seeds seed, seed + 1, ... (from a random base when seed is
+    // 0) on up to `threads` workers and returns { result, seed, attempts }
+    // for the first that meets the acceptance limits; result is null if
+    // none of `max_attempts` did.
+    Dictionary generate_accepted(int max_attempts = 32, int threads = 0);
+
+    // Snapshot of the current settings as a native job for
+    // MultiLevelDungeonGenerator; the level's seed replaces `seed`.
+    LevelJob make_level_job() const;
 };
 
+VARIANT_ENUM_CAST(HybridResult::RoomShape);
+VARIANT_ENUM_CAST(HybridResult::RoomFlag);
+VARIANT_ENUM_CAST(HybridResult::LinkFlag);
+
 #endif // HYBRID_GODOT_H
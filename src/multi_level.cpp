@@ -0,0 +1,213 @@
+#include "multi_level.h"
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <cstring>
+#include <random>
+
+#include "bsp_godot.h"
+#include "gdwfc_v2.h"
+#include "hybrid_godot.h"
+#include "overlapping_wfc_godot.h"
+#include "walker.h"
+
+// --- MultiLevelResult ---
+
+MultiLevelResult::MultiLevelResult()
+    : success(false), level_count(0), width(0), height(0) {
+}
+
+void MultiLevelResult::_set_output(const MultiLevelOutput& output) {
+    success = output.success;
+    failure_reason = String(output.message.c_str());
+    if (!output.success) {
+        return;
+    }
+    level_count = (int)output.seeds.size();
+    width = output.width;
+    height = output.height;
+    origin = Vector2i(output.originX, output.originY);
+
+    cells.resize(output.cells.size());
+    memcpy(cells.ptrw(), output.cells.data(), output.cells.size() * sizeof(int32_t));
+    level_seeds.resize(level_count);
+    for (int i = 0; i < level_count; i++) {
+        level_seeds[i] = (int64_t)output.seeds[i];
+    }
+    stairs = output.stairs;
+}
+
+void MultiLevelResult::_set_failure(const String& reason) {
+    success = false;
+    failure_reason = reason;
+}
+
+PackedInt32Array MultiLevelResult::get_level_cells(int level) const {
+    if (level < 0 || level >= level_count) {
+        return PackedInt32Array();
+    }
+    int64_t area = (int64_t)width * height;
+    return cells.slice(area * level, area * (level + 1));
+}
+
+int MultiLevelResult::get_cell(int level, const Vector2i& cell) const {
+    int x = cell.x - origin.x;
+    int y = cell.y - origin.y;
+    if (level < 0 || level >= level_count || x < 0 || y < 0 || x >= width || y >= height) {
+        return CELL_EMPTY;
+    }
+    return cells[((int64_t)level * height + y) * width + x];
+}
+
+PackedVector2Array MultiLevelResult::positions_of(int level, int value) const {
+    PackedVector2Array out;
+    if (level < 0 || level >= level_count) {
+        return out;
+    }
+    const int32_t* level_cells = cells.ptr() + (int64_t)width * height * level;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            if (level_cells[(int64_t)y * width + x] == value) {
+                out.push_back(Vector2(origin.x + x, origin.y + y));
+            }
+        }
+    }
+    return out;
+}
+
+PackedVector2Array MultiLevelResult::get_floor_positions(int level) const {
+    return positions_of(level, CELL_FLOOR);
+}
+
+PackedVector2Array MultiLevelResult::get_wall_positions(int level) const {
+    return positions_of(level, CELL_WALL);
+}
+
+PackedVector2Array MultiLevelResult::get_stair_positions() const {
+    PackedVector2Array out;
+    out.resize(stairs.size());
+    for (size_t i = 0; i < stairs.size(); i++) {
+        out[i] = Vector2(stairs[i].x, stairs[i].y);
+    }
+    return out;
+}
+
+Array MultiLevelResult::get_stairs() const {
+    Array out;
+    out.resize(stairs.size());
+    for (size_t i = 0; i < stairs.size(); i++) {
+        Dictionary d;
+        d["upper"] = stairs[i].upper;
+        d["lower"] = stairs[i].upper + 1;
+        d["position"] = Vector2i(stairs[i].x, stairs[i].y);
+        d["carved"] = stairs[i].carved;
+        out[i] = d;
+    }
+    return out;
+}
+
+void MultiLevelResult::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("is_success"), &MultiLevelResult::is_success);
+    ClassDB::bind_method(D_METHOD("get_failure_reason"), &MultiLevelResult::get_failure_reason);
+    ClassDB::bind_method(D_METHOD("get_level_count"), &MultiLevelResult::get_level_count);
+    ClassDB::bind_method(D_METHOD("get_width"), &MultiLevelResult::get_width);
+    ClassDB::bind_method(D_METHOD("get_height"), &MultiLevelResult::get_height);
+    ClassDB::bind_method(D_METHOD("get_origin"), &MultiLevelResult::get_origin);
+    ClassDB::bind_method(D_METHOD("get_level_seeds"), &MultiLevelResult::get_level_seeds);
+    ClassDB::bind_method(D_METHOD("get_cells"), &MultiLevelResult::get_cells);
+    ClassDB::bind_method(D_METHOD("get_level_cells", "level"), &MultiLevelResult::get_level_cells);
+    ClassDB::bind_method(D_METHOD("get_cell", "level", "cell"), &MultiLevelResult::get_cell);
+    ClassDB::bind_method(D_METHOD("get_floor_positions", "level"), &MultiLevelResult::get_floor_positions);
+    ClassDB::bind_method(D_METHOD("get_wall_positions", "level"), &MultiLevelResult::get_wall_positions);
+    ClassDB::bind_method(D_METHOD("get_stair_positions"), &MultiLevelResult::get_stair_positions);
+    ClassDB::bind_method(D_METHOD("get_stairs"), &MultiLevelResult::get_stairs);
+
+    BIND_ENUM_CONSTANT(CELL_EMPTY);
+    BIND_ENUM_CONSTANT(CELL_FLOOR);
+    BIND_ENUM_CONSTANT(CELL_WALL);
+}
+
+// --- MultiLevelDungeonGenerator ---
+
+MultiLevelDungeonGenerator::MultiLevelDungeonGenerator()
+    : seed(12345), use_seed(false), wfc_floor_value(0) {
+}
+
+void MultiLevelDungeonGenerator::set_levels(const Array& p_levels) {
+    levels = p_levels;
+}
+
+void MultiLevelDungeonGenerator::add_level(const Ref<RefCounted>& generator) {
+    levels.push_back(generator);
+}
+
+void MultiLevelDungeonGenerator::clear_levels() {
+    levels.clear();
+}
+
+void MultiLevelDungeonGenerator::set_seed(int64_t p_seed) {
+    seed = p_seed;
+}
+
+void MultiLevelDungeonGenerator::set_use_seed(bool p_use_seed) {
+    use_seed = p_use_seed;
+}
+
+void MultiLevelDungeonGenerator::set_wfc_floor_value(int value) {
+    wfc_floor_value = value;
+}
+
+Ref<MultiLevelResult> MultiLevelDungeonGenerator::generate(int threads) {
+    Ref<MultiLevelResult> result;
+    result.instantiate();
+
+    // Settings are copied out of the generators here, on the calling
+    // thread; the workers only see native jobs
+    std::vector<LevelJob> jobs;
+    jobs.reserve(levels.size());
+    for (int i = 0; i < levels.size(); i++) {
+        Object* generator = levels[i];
+        if (WalkerDungeonGenerator* walker = Object::cast_to<WalkerDungeonGenerator>(generator)) {
+            jobs.push_back(walker->make_level_job());
+        } else if (BSPDungeonGenerator* bsp = Object::cast_to<BSPDungeonGenerator>(generator)) {
+            jobs.push_back(bsp->make_level_job());
+        } else if (HybridDungeonGenerator* hybrid = Object::cast_to<HybridDungeonGenerator>(generator)) {
+            jobs.push_back(hybrid->make_level_job());
+        } else if (GDTilingWFCv2* tiling = Object::cast_to<GDTilingWFCv2>(generator)) {
+            jobs.push_back(tiling->make_level_job());
+        } else if (OverlappingWFCGenerator* overlapping = Object::cast_to<OverlappingWFCGenerator>(generator)) {
+            jobs.push_back(overlapping->make_level_job());
+        } else {
+            String reason = "Level " + String::num_int64(i) + " is not a dungeon generator";
+            UtilityFunctions::push_error("MultiLevelDungeonGenerator.generate: ", reason);
+            result->_set_failure(reason);
+            return result;
+        }
+    }
+
+    std::random_device rd;
+    MultiLevelSettings settings;
+    settings.seed = use_seed ? (uint64_t)seed : ((uint64_t)rd() << 32) | rd();
+    settings.wfcFloorValue = wfc_floor_value;
+    settings.threads = threads;
+    result->_set_output(generateLevels(jobs, settings));
+    return result;
+}
+
+void MultiLevelDungeonGenerator::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_levels", "levels"), &MultiLevelDungeonGenerator::set_levels);
+    ClassDB::bind_method(D_METHOD("get_levels"), &MultiLevelDungeonGenerator::get_levels);
+    ClassDB::bind_method(D_METHOD("add_level", "generator"), &MultiLevelDungeonGenerator::add_level);
+    ClassDB::bind_method(D_METHOD("clear_levels"), &MultiLevelDungeonGenerator::clear_levels);
+    ClassDB::bind_method(D_METHOD("set_seed", "seed"), &MultiLevelDungeonGenerator::set_seed);
+    ClassDB::bind_method(D_METHOD("get_seed"), &MultiLevelDungeonGenerator::get_seed);
+    ClassDB::bind_method(D_METHOD("set_use_seed", "use_seed"), &MultiLevelDungeonGenerator::set_use_seed);
+    ClassDB::bind_method(D_METHOD("get_use_seed"), &MultiLevelDungeonGenerator::get_use_seed);
+    ClassDB::bind_method(D_METHOD("set_wfc_floor_value", "value"), &MultiLevelDungeonGenerator::set_wfc_floor_value);
+    ClassDB::bind_method(D_METHOD("get_wfc_floor_value"), &MultiLevelDungeonGenerator::get_wfc_floor_value);
+    ClassDB::bind_method(D_METHOD("generate", "threads"), &MultiLevelDungeonGenerator::generate, DEFVAL(0));
+
+    ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "levels"), "set_levels", "get_levels");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_seed"), "set_use_seed", "get_use_seed");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "wfc_floor_value"), "set_wfc_floor_value", "get_wfc_floor_value");
+}
@@ -0,0 +1,119 @@
+#ifndef MULTI_LEVEL_H
+#define MULTI_LEVEL_H
+
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <vector>
+
+#include "MultiLevel.h"
+
+using namespace godot;
+
+// Every level on one grid: cell (x, y) of level l is
+// get_cells()[l * width * height + (y - origin.y) * width + (x - origin.x)],
+// so the same world position lines up across levels.
+class MultiLevelResult : public RefCounted {
+    GDCLASS(MultiLevelResult, RefCounted)
+
+public:
+    enum CellType {
+        CELL_EMPTY = MAP_CELL_EMPTY,
+        CELL_FLOOR = MAP_CELL_FLOOR,
+        CELL_WALL = MAP_CELL_WALL
+    };
+
+private:
+    bool success;
+    String failure_reason;
+    int level_count;
+    int width;
+    int height;
+    Vector2i origin;
+    PackedInt32Array cells;
+    PackedInt64Array level_seeds;
+    std::vector<StairLink> stairs;
+
+protected:
+    static void _bind_methods();
+
+public:
+    MultiLevelResult();
+
+    // Internal: called by MultiLevelDungeonGenerator
+    void _set_output(const MultiLevelOutput& output);
+    void _set_failure(const String& reason);
+
+    bool is_success() const { return success; }
+    String get_failure_reason() const { return failure_reason; }
+
+    int get_level_count() const { return level_count; }
+    int get_width() const { return width; }
+    int get_height() const { return height; }
+    Vector2i get_origin() const { return origin; }
+    PackedInt64Array get_level_seeds() const { return level_seeds; }
+
+    // CellType values, level after level
+    PackedInt32Array get_cells() const { return cells; }
+    PackedInt32Array get_level_cells(int level) const;
+    // World coordinates; CELL_EMPTY outside the grid
+    int get_cell(int level, const Vector2i& cell) const;
+    PackedVector2Array get_floor_positions(int level) const;
+    PackedVector2Array get_wall_positions(int level) const;
+
+    // stairs[i] joins level i and i + 1 and is floor on both
+    PackedVector2Array get_stair_positions() const;
+    // { "upper", "lower", "position", "carved" } per stair; carved is true
+    // when a corridor was dug on the lower level to reach it
+    Array get_stairs() const;
+
+private:
+    PackedVector2Array positions_of(int level, int value) const;
+};
+
+class MultiLevelDungeonGenerator : public RefCounted {
+    GDCLASS(MultiLevelDungeonGenerator, RefCounted)
+
+private:
+    Array levels;
+    int64_t seed;
+    bool use_seed;
+    int wfc_floor_value;
+
+protected:
+    static void _bind_methods();
+
+public:
+    MultiLevelDungeonGenerator();
+
+    // One generator per level, top first: WalkerDungeonGenerator,
+    // BSPDungeonGenerator, HybridDungeonGenerator, GDTilingWFCv2 or
+    // OverlappingWFCGenerator. The same generator may appear more than once.
+    void set_levels(const Array& p_levels);
+    Array get_levels() const { return levels; }
+    void add_level(const Ref<RefCounted>& generator);
+    void clear_levels();
+
+    // Level i uses seed + i; the generators' own seeds are ignored.
+    void set_seed(int64_t p_seed);
+    int64_t get_seed() const { return seed; }
+    void set_use_seed(bool p_use_seed);
+    bool get_use_seed() const { return use_seed; }
+
+    // WFC tile (or stamp) value treated as floor; other values are walls
+    void set_wfc_floor_value(int value);
+    int get_wfc_floor_value() const { return wfc_floor_value; }
+
+    // Generates every level on up to `threads` workers (0 = all cores),
+    // then places stairs natively (see MultiLevel.h).
+    Ref<MultiLevelResult> generate(int threads = 0);
+};
+
+VARIANT_ENUM_CAST(MultiLevelResult::CellType);
+
+#endif // MULTI_LEVEL_H
@@ -2,9 +2,17 @@
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <chrono>
-
-#include "../fast-wfc/src/include/overlapping_wfc.hpp"
-#include "../fast-wfc/src/include/utils/array2D.hpp"
+#include <memory>
+
+#include "Parallel.h"
+#include "OverlappingSolver.h"
+#include "acceptance.h"
+#include "autotile.h"
+#include "grid_geometry.h"
+#include "packed_arrays.h"
+#include "placement.h"
+#include "region_analysis.h"
+#include "result_codec.h"
 
 using namespace godot;
 
@@ -44,17 +52,45 @@ void OverlappingWFCResult::_bind_methods() {
     // Helper methods
     ClassDB::bind_method(D_METHOD("get_floor_positions", "floor_value"), &OverlappingWFCResult::get_floor_positions, DEFVAL(0));
     ClassDB::bind_method(D_METHOD("get_wall_positions", "wall_value"), &OverlappingWFCResult::get_wall_positions, DEFVAL(1));
+    ClassDB::bind_method(D_METHOD("get_positions_of", "tile_value"), &OverlappingWFCResult::get_positions_of);
+    ClassDB::bind_method(D_METHOD("get_tile_distribution"), &OverlappingWFCResult::get_tile_distribution);
     ClassDB::bind_method(D_METHOD("get_statistics"), &OverlappingWFCResult::get_statistics);
 
+    // Bulk region queries
+    ClassDB::bind_method(D_METHOD("get_region", "rect"), &OverlappingWFCResult::get_region);
+    ClassDB::bind_method(D_METHOD("count_in_rect", "tile_value", "rect"), &OverlappingWFCResult::count_in_rect);
+    ClassDB::bind_method(D_METHOD("find_all", "tile_value", "rect"), &OverlappingWFCResult::find_all);
+
+    // Region analysis
+    ClassDB::bind_method(D_METHOD("get_regions", "tile_value", "threads"), &OverlappingWFCResult::get_regions, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_dead_end_positions", "tile_value"), &OverlappingWFCResult::get_dead_end_positions);
+    ClassDB::bind_method(D_METHOD("get_distance_field", "tile_value", "sources"), &OverlappingWFCResult::get_distance_field);
+    ClassDB::bind_method(D_METHOD("get_farthest_pair", "tile_value"), &OverlappingWFCResult::get_farthest_pair);
+    ClassDB::bind_method(D_METHOD("get_critical_path", "tile_value"), &OverlappingWFCResult::get_critical_path);
+    ClassDB::bind_method(D_METHOD("get_chokepoints", "tile_value"), &OverlappingWFCResult::get_chokepoints);
+    ClassDB::bind_method(D_METHOD("get_rects", "tile_value"), &OverlappingWFCResult::get_rects);
+    ClassDB::bind_method(D_METHOD("get_contours", "tile_value", "epsilon"), &OverlappingWFCResult::get_contours, DEFVAL(0.0));
+    ClassDB::bind_method(D_METHOD("get_contour_chunks", "tile_value", "chunk_size", "epsilon", "threads"),
+                         &OverlappingWFCResult::get_contour_chunks, DEFVAL(0.0), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_bitmasks", "tile_value", "neighbours"), &OverlappingWFCResult::get_bitmasks, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_autotile", "tile_value", "lut", "neighbours"), &OverlappingWFCResult::get_autotile, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_placements", "tile_value", "radii", "seed", "counts", "exclude", "keep_out"),
+                         &OverlappingWFCResult::get_placements, DEFVAL(PackedInt32Array()), DEFVAL(PackedVector2Array()),
+                         DEFVAL(PackedVector3Array()));
+    ClassDB::bind_method(D_METHOD("to_bytes", "compress"), &OverlappingWFCResult::to_bytes, DEFVAL(true));
+    ClassDB::bind_static_method("OverlappingWFCResult", D_METHOD("from_bytes", "bytes"), &OverlappingWFCResult::from_bytes);
+    ClassDB::bind_method(D_METHOD("get_decision_log"), &OverlappingWFCResult::get_decision_log);
+
     // Internal
     ClassDB::bind_method(D_METHOD("_set_pattern_data", "patterns", "width", "height"), &OverlappingWFCResult::_set_pattern_data);
     ClassDB::bind_method(D_METHOD("_set_tile_data", "tiles", "width", "height"), &OverlappingWFCResult::_set_tile_data);
     ClassDB::bind_method(D_METHOD("_set_expanded_data", "tiles", "width", "height", "stamp_size"), &OverlappingWFCResult::_set_expanded_data);
     ClassDB::bind_method(D_METHOD("_set_failure", "reason"), &OverlappingWFCResult::_set_failure);
+    ClassDB::bind_method(D_METHOD("_set_decision_log", "log"), &OverlappingWFCResult::_set_decision_log);
 }
 
 int OverlappingWFCResult::get_pattern_at(int x, int y) const {
-    if (x < 0 || x >= output_width || y < 0 || y >= output_height) {
+    if (x < 0 || x >= output_width || y < 0 || y >= output_height || pattern_output.is_empty()) {
         return -1;
     }
     return pattern_output[y * output_width + x];
@@ -80,50 +116,97 @@ int OverlappingWFCResult::get_expanded_tile_at(int x, int y) const {
     return expanded_output[y * expanded_width + x];
 }
 
-PackedVector2Array OverlappingWFCResult::get_floor_positions(int floor_tile_value) const {
-    PackedVector2Array positions;
-
-    // Use expanded output if available, otherwise tile output
-    const PackedInt32Array& tiles = has_stamps ? expanded_output :
-                                    (!tile_output.is_empty() ? tile_output : pattern_output);
-    int w = has_stamps ? expanded_width : output_width;
-    int h = has_stamps ? expanded_height : output_height;
-
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            int tile = tiles[y * w + x];
-            if (tile == floor_tile_value) {
-                positions.append(Vector2(x, y));
-            }
-        }
+const PackedInt32Array& OverlappingWFCResult::active_output() const {
+    if (has_stamps) {
+        return expanded_output;
     }
-    return positions;
+    return !tile_output.is_empty() ? tile_output : pattern_output;
+}
+
+PackedVector2Array OverlappingWFCResult::get_floor_positions(int floor_tile_value) const {
+    return get_positions_of(floor_tile_value);
 }
 
 PackedVector2Array OverlappingWFCResult::get_wall_positions(int wall_tile_value) const {
-    PackedVector2Array positions;
-
-    const PackedInt32Array& tiles = has_stamps ? expanded_output :
-                                    (!tile_output.is_empty() ? tile_output : pattern_output);
-    int w = has_stamps ? expanded_width : output_width;
-    int h = has_stamps ? expanded_height : output_height;
-
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            int tile = tiles[y * w + x];
-            if (tile == wall_tile_value) {
-                positions.append(Vector2(x, y));
-            }
-        }
-    }
-    return positions;
+    return get_positions_of(wall_tile_value);
+}
+
+PackedVector2Array OverlappingWFCResult::get_positions_of(int tile_value) const {
+    return grid_cache.get_positions(active_output(), active_width(), tile_value);
+}
+
+Dictionary OverlappingWFCResult::get_tile_distribution() const {
+    return grid_cache.get_distribution(active_output());
+}
+
+PackedInt32Array OverlappingWFCResult::get_region(const Rect2i& rect) const {
+    return TileGridCache::get_region(active_output(), active_width(), active_height(), rect);
+}
+
+int64_t OverlappingWFCResult::count_in_rect(int tile_value, const Rect2i& rect) const {
+    return grid_cache.count_in_rect(active_output(), active_width(), active_height(), tile_value, rect);
+}
+
+PackedVector2Array OverlappingWFCResult::find_all(int tile_value, const Rect2i& rect) const {
+    return TileGridCache::find_all(active_output(), active_width(), active_height(), tile_value, rect);
+}
+
+Dictionary OverlappingWFCResult::get_regions(int tile_value, int threads) const {
+    return analyze_grid_regions(active_output(), active_width(), active_height(), tile_value, threads);
+}
+
+PackedVector2Array OverlappingWFCResult::get_dead_end_positions(int tile_value) const {
+    return find_grid_dead_ends(active_output(), active_width(), active_height(), tile_value);
+}
+
+PackedInt32Array OverlappingWFCResult::get_distance_field(int tile_value, const PackedVector2Array& sources) const {
+    return grid_distance_field(active_output(), active_width(), active_height(), tile_value, sources);
+}
+
+PackedVector2Array OverlappingWFCResult::get_farthest_pair(int tile_value) const {
+    return grid_farthest_pair(active_output(), active_width(), active_height(), tile_value);
+}
+
+PackedVector2Array OverlappingWFCResult::get_critical_path(int tile_value) const {
+    return grid_critical_path(active_output(), active_width(), active_height(), tile_value);
+}
+
+PackedVector2Array OverlappingWFCResult::get_chokepoints(int tile_value) const {
+    return grid_chokepoints(active_output(), active_width(), active_height(), tile_value);
+}
+
+PackedInt32Array OverlappingWFCResult::get_rects(int tile_value) const {
+    return merge_grid_rects(active_output(), active_width(), active_height(), tile_value);
+}
+
+Array OverlappingWFCResult::get_contours(int tile_value, double epsilon) const {
+    return grid_contours(active_output(), active_width(), active_height(), tile_value, epsilon);
+}
+
+Array OverlappingWFCResult::get_contour_chunks(int tile_value, int chunk_size, double epsilon, int threads) const {
+    return grid_contour_chunks(active_output(), active_width(), active_height(), tile_value, chunk_size, epsilon, threads);
+}
+
+PackedInt32Array OverlappingWFCResult::get_bitmasks(int tile_value, int neighbours) const {
+    return grid_bitmasks(active_output(), active_width(), active_height(), tile_value, neighbours);
+}
+
+PackedVector2Array OverlappingWFCResult::get_autotile(int tile_value, const Dictionary& lut, int neighbours) const {
+    return grid_autotile(active_output(), active_width(), active_height(), tile_value, lut, neighbours);
+}
+
+Array OverlappingWFCResult::get_placements(int tile_value, const PackedFloat32Array& radii, int64_t seed,
+                                           const PackedInt32Array& counts, const PackedVector2Array& exclude,
+                                           const PackedVector3Array& keep_out) const {
+    return grid_poisson(active_output(), active_width(), active_height(), tile_value, radii, seed, counts, exclude,
+                        keep_out);
 }
 
 Dictionary OverlappingWFCResult::get_statistics() const {
     Dictionary stats;
     stats["output_width"] = output_width;
     stats["output_height"] = output_height;
-    stats["pattern_count"] = pattern_output.size();
+    stats["pattern_count"] = output_width * output_height;
 
     if (has_stamps) {
         stats["expanded_width"] = expanded_width;
@@ -139,12 +222,14 @@ void OverlappingWFCResult::_set_pattern_data(PackedInt32Array patterns, int widt
     output_width = width;
     output_height = height;
     success = true;
+    grid_cache.reset();
 }
 
 void OverlappingWFCResult::_set_tile_data(PackedInt32Array tiles, int width, int height) {
     tile_output = tiles;
     output_width = width;
     output_height = height;
+    grid_cache.reset();
 }
 
 void OverlappingWFCResult::_set_expanded_data(PackedInt32Array tiles, int width, int height, int p_stamp_size) {
@@ -153,6 +238,7 @@ void OverlappingWFCResult::_set_expanded_data(PackedInt32Array tiles, int width,
     expanded_height = height;
     has_stamps = true;
     stamp_size = p_stamp_size;
+    grid_cache.reset();
 }
 
 void OverlappingWFCResult::_set_failure(String reason) {
@@ -160,6 +246,76 @@ void OverlappingWFCResult::_set_failure(String reason) {
     failure_reason = reason;
 }
 
+void OverlappingWFCResult::_set_decision_log(PackedByteArray log) {
+    decision_log = log;
+}
+
+static const uint8_t OVERLAPPING_FLAG_SUCCESS = 1;
+static const uint8_t OVERLAPPING_FLAG_STAMPS = 2;
+// Set when a decision log follows the grids; older blobs have none
+static const uint8_t OVERLAPPING_FLAG_DECISIONS = 4;
+
+PackedByteArray OverlappingWFCResult::to_bytes(bool compress) const {
+    ByteWriter body;
+    body.putU8((success ? OVERLAPPING_FLAG_SUCCESS : 0) | (has_stamps ? OVERLAPPING_FLAG_STAMPS : 0) |
+               (decision_log.is_empty() ? 0 : OVERLAPPING_FLAG_DECISIONS));
+    CharString reason = failure_reason.utf8();
+    body.putString(std::string(reason.get_data(), reason.length()));
+
+    body.putVarU(output_width);
+    body.putVarU(output_height);
+    write_int_grid(body, pattern_output);
+    write_int_grid(body, tile_output);
+
+    body.putVarU(expanded_width);
+    body.putVarU(expanded_height);
+    body.putVarU(stamp_size);
+    write_int_grid(body, expanded_output);
+    if (!decision_log.is_empty()) {
+        write_byte_array(body, decision_log);
+    }
+    return make_result_blob(MapAlgorithm::OverlappingWFC, body, compress);
+}
+
+Ref<OverlappingWFCResult> OverlappingWFCResult::from_bytes(const PackedByteArray& bytes) {
+    std::vector<uint8_t> scratch;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (!open_result_blob(bytes, MapAlgorithm::OverlappingWFC, "OverlappingWFCResult", scratch, data, size)) {
+        return Ref<OverlappingWFCResult>();
+    }
+
+    ByteReader in(data, size);
+    Ref<OverlappingWFCResult> result;
+    result.instantiate();
+    uint8_t flags = in.getU8();
+    result->success = (flags & OVERLAPPING_FLAG_SUCCESS) != 0;
+    result->has_stamps = (flags & OVERLAPPING_FLAG_STAMPS) != 0;
+    std::string reason = in.getString();
+    result->failure_reason = String::utf8(reason.data(), (int)reason.size());
+
+    result->output_width = (int)in.getVarU();
+    result->output_height = (int)in.getVarU();
+    bool ok = in.ok() && read_int_grid(in, result->pattern_output) && read_int_grid(in, result->tile_output) &&
+              int_grid_fits(result->pattern_output, result->output_width, result->output_height) &&
+              int_grid_fits(result->tile_output, result->output_width, result->output_height);
+
+    result->expanded_width = (int)in.getVarU();
+    result->expanded_height = (int)in.getVarU();
+    result->stamp_size = (int)in.getVarU();
+    ok = ok && in.ok() && read_int_grid(in, result->expanded_output) &&
+         int_grid_fits(result->expanded_output, result->expanded_width, result->expanded_height);
+    if (flags & OVERLAPPING_FLAG_DECISIONS) {
+        ok = ok && read_byte_array(in, result->decision_log);
+    }
+
+    if (!ok) {
+        UtilityFunctions::push_error("OverlappingWFCResult.from_bytes: blob is corrupt");
+        return Ref<OverlappingWFCResult>();
+    }
+    return result;
+}
+
 // ============================================================================
 // OverlappingWFCGenerator Implementation
 // ============================================================================
@@ -171,7 +327,7 @@ OverlappingWFCGenerator::OverlappingWFCGenerator() :
     periodic_input(false), periodic_output(false),
     ground_mode(false),
     use_stamps(false), stamp_size(3),
-    debug_mode(false) {
+    debug_mode(false), keep_intermediate_outputs(true), record_decisions(false) {
 }
 
 OverlappingWFCGenerator::~OverlappingWFCGenerator() {
@@ -215,6 +371,12 @@ void OverlappingWFCGenerator::_bind_methods() {
 
     ClassDB::bind_method(D_METHOD("set_stamp_size", "size"), &OverlappingWFCGenerator::set_stamp_size);
     ClassDB::bind_method(D_METHOD("get_stamp_size"), &OverlappingWFCGenerator::get_stamp_size);
+    ClassDB::bind_method(D_METHOD("set_keep_intermediate_outputs", "keep"), &OverlappingWFCGenerator::set_keep_intermediate_outputs);
+    ClassDB::bind_method(D_METHOD("get_keep_intermediate_outputs"), &OverlappingWFCGenerator::get_keep_intermediate_outputs);
+    ClassDB::bind_method(D_METHOD("set_record_decisions", "enabled"), &OverlappingWFCGenerator::set_record_decisions);
+    ClassDB::bind_method(D_METHOD("get_record_decisions"), &OverlappingWFCGenerator::get_record_decisions);
+    ClassDB::bind_method(D_METHOD("set_acceptance", "acceptance"), &OverlappingWFCGenerator::set_acceptance);
+    ClassDB::bind_method(D_METHOD("get_acceptance"), &OverlappingWFCGenerator::get_acceptance);
 
     ClassDB::bind_method(D_METHOD("add_pattern_to_tile_mapping", "color_value", "tile_id"),
                         &OverlappingWFCGenerator::add_pattern_to_tile_mapping);
@@ -230,6 +392,12 @@ void OverlappingWFCGenerator::_bind_methods() {
 
     // Generation
     ClassDB::bind_method(D_METHOD("generate"), &OverlappingWFCGenerator::generate);
+    ClassDB::bind_method(D_METHOD("generate_batch", "seeds", "threads"), &OverlappingWFCGenerator::generate_batch, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("generate_accepted", "max_attempts", "threads"),
+                         &OverlappingWFCGenerator::generate_accepted, DEFVAL(32), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("replay", "log"), &OverlappingWFCGenerator::replay);
+    ClassDB::bind_method(D_METHOD("regenerate_region", "result", "rect", "seed"),
+                         &OverlappingWFCGenerator::regenerate_region);
 
     // Utility
     ClassDB::bind_method(D_METHOD("enable_debug", "enabled"), &OverlappingWFCGenerator::enable_debug);
@@ -255,6 +423,10 @@ void OverlappingWFCGenerator::_bind_methods() {
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_stamps"), "enable_stamps", "get_stamps_enabled");
     ADD_PROPERTY(PropertyInfo(Variant::INT, "stamp_size", PROPERTY_HINT_RANGE, "1,5,1"),
                 "set_stamp_size", "get_stamp_size");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "keep_intermediate_outputs"),
+                "set_keep_intermediate_outputs", "get_keep_intermediate_outputs");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "record_decisions"), "set_record_decisions", "get_record_decisions");
+    ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "acceptance"), "set_acceptance", "get_acceptance");
 }
 
 void OverlappingWFCGenerator::set_seed_image(const Ref<Image>& p_image) {
@@ -282,7 +454,7 @@ void OverlappingWFCGenerator::set_symmetry(int p_symmetry) {
     symmetry = std::max(1, std::min(8, p_symmetry));
 }
 
-void OverlappingWFCGenerator::set_seed(int p_seed) {
+void OverlappingWFCGenerator::set_seed(int64_t p_seed) {
     seed = p_seed;
 }
 
@@ -310,6 +482,18 @@ void OverlappingWFCGenerator::set_stamp_size(int size) {
     stamp_size = std::max(1, std::min(5, size));
 }
 
+void OverlappingWFCGenerator::set_keep_intermediate_outputs(bool keep) {
+    keep_intermediate_outputs = keep;
+}
+
+void OverlappingWFCGenerator::set_record_decisions(bool enabled) {
+    record_decisions = enabled;
+}
+
+void OverlappingWFCGenerator::set_acceptance(const Dictionary& p_acceptance) {
+    acceptance = p_acceptance;
+}
+
 void OverlappingWFCGenerator::add_pattern_to_tile_mapping(int color_value, int tile_id) {
     pattern_to_tile_map[color_value] = tile_id;
 }
@@ -386,185 +570,331 @@ void OverlappingWFCGenerator::enable_debug(bool enabled) {
     debug_mode = enabled;
 }
 
-Ref<OverlappingWFCResult> OverlappingWFCGenerator::generate() {
+// ============================================================================
+// Native problem/output conversion (solving lives in wfc/OverlappingSolver)
+// ============================================================================
+
+namespace {
+
+Ref<OverlappingWFCResult> make_overlapping_result(const OverlappingProblem& problem, const OverlappingOutput& out,
+                                                  bool keep_intermediate) {
     Ref<OverlappingWFCResult> result;
     result.instantiate();
 
+    if (!out.success) {
+        result->_set_failure(String(out.failureReason.c_str()));
+        return result;
+    }
+
+    int output_width = problem.options.out_width;
+    int output_height = problem.options.out_height;
+    // Only the most detailed stage is needed by the helpers; the earlier
+    // ones are copied out only when the caller asked to keep them
+    bool keep_patterns = keep_intermediate || (!problem.hasMapping && !problem.expandStamps);
+    bool keep_tiles = keep_intermediate || !problem.expandStamps;
+    result->_set_pattern_data(keep_patterns ? to_packed_int32(out.patterns) : PackedInt32Array(),
+                              output_width, output_height);
+    if (problem.hasMapping && keep_tiles) {
+        result->_set_tile_data(to_packed_int32(out.tiles), output_width, output_height);
+    }
+    if (problem.expandStamps) {
+        result->_set_expanded_data(to_packed_int32(out.expanded), out.expandedWidth, out.expandedHeight, problem.stampSize);
+    }
+    if (!out.decisions.empty()) {
+        result->_set_decision_log(to_packed_bytes(out.decisions));
+    }
+    return result;
+}
+
+} // namespace
+
+String OverlappingWFCGenerator::prepare_problem(OverlappingProblem& problem) const {
+
     // Validation
     if (!seed_image.is_valid()) {
-        result->_set_failure("No seed image provided");
-        return result;
+        return "No seed image provided";
     }
 
     if (seed_image->is_empty()) {
-        result->_set_failure("Seed image is empty");
-        return result;
+        return "Seed image is empty";
     }
 
-    try {
-        // ====================================================================
-        // STEP 1: Convert Godot Image to Array2D<int>
-        // ====================================================================
-        int img_width = seed_image->get_width();
-        int img_height = seed_image->get_height();
+    // ====================================================================
+    // STEP 1: Convert Godot Image to Array2D<int>
+    // ====================================================================
+    int img_width = seed_image->get_width();
+    int img_height = seed_image->get_height();
 
-        if (debug_mode) {
-            UtilityFunctions::print("OverlappingWFC: Processing ", img_width, "x", img_height, " seed image");
-        }
+    if (debug_mode) {
+        UtilityFunctions::print("OverlappingWFC: Processing ", img_width, "x", img_height, " seed image");
+    }
 
-        Array2D<int> input_array(img_height, img_width);
-
-        // Convert each pixel to an integer color value
-        for (int y = 0; y < img_height; y++) {
-            for (int x = 0; x < img_width; x++) {
-                Color pixel = seed_image->get_pixel(x, y);
-                // Convert to RGB int (ignore alpha for now)
-                int color_value = (int(pixel.r * 255) << 16) |
-                                 (int(pixel.g * 255) << 8) |
-                                 int(pixel.b * 255);
-                input_array.get(y, x) = color_value;
-            }
+    problem.input = Array2D<int>(img_height, img_width);
+
+    // Convert each pixel to an integer color value
+    for (int y = 0; y < img_height; y++) {
+        for (int x = 0; x < img_width; x++) {
+            Color pixel = seed_image->get_pixel(x, y);
+            // Convert to RGB int (ignore alpha for now)
+            int color_value = (int(pixel.r * 255) << 16) |
+                             (int(pixel.g * 255) << 8) |
+                             int(pixel.b * 255);
+            problem.input.get(y, x) = color_value;
         }
+    }
+
+    // ====================================================================
+    // STEP 2: Set up WFC options
+    // ====================================================================
+    problem.options.periodic_input = periodic_input;
+    problem.options.periodic_output = periodic_output;
+    problem.options.out_height = output_height;
+    problem.options.out_width = output_width;
+    problem.options.symmetry = symmetry;
+    problem.options.ground = ground_mode;
+    problem.options.pattern_size = pattern_size;
+
+    // Mappings and stamps are copied out of their Dictionaries once
+    problem.hasMapping = !pattern_to_tile_map.is_empty();
+    Array mapping_keys = pattern_to_tile_map.keys();
+    for (int i = 0; i < mapping_keys.size(); i++) {
+        int key = mapping_keys[i];
+        problem.patternToTile[key] = (int)pattern_to_tile_map[key];
+    }
+
+    problem.expandStamps = use_stamps && !tile_stamps.is_empty();
+    problem.stampSize = stamp_size;
+    Array stamp_keys = tile_stamps.keys();
+    for (int i = 0; i < stamp_keys.size(); i++) {
+        int tile_id = stamp_keys[i];
+        Dictionary stamp_data = tile_stamps[tile_id];
+        PackedInt32Array stamp_pattern = stamp_data["pattern"];
+
+        OverlappingStamp stamp;
+        stamp.width = stamp_data["width"];
+        stamp.height = stamp_data["height"];
+        stamp.pattern.assign(stamp_pattern.ptr(), stamp_pattern.ptr() + stamp_pattern.size());
+        problem.stamps[tile_id] = stamp;
+    }
+
+    return String();
+}
+
+Ref<OverlappingWFCResult> OverlappingWFCGenerator::generate() {
+    OverlappingProblem problem;
+    String error = prepare_problem(problem);
+    if (!error.is_empty()) {
+        Ref<OverlappingWFCResult> result;
+        result.instantiate();
+        result->_set_failure(error);
+        return result;
+    }
 
-        // ====================================================================
-        // STEP 2: Set up WFC options
-        // ====================================================================
-        OverlappingWFCOptions options;
-        options.periodic_input = periodic_input;
-        options.periodic_output = periodic_output;
-        options.out_height = output_height;
-        options.out_width = output_width;
-        options.symmetry = symmetry;
-        options.ground = ground_mode;
-        options.pattern_size = pattern_size;
-
-        // ====================================================================
-        // STEP 3: Run Overlapping WFC
-        // ====================================================================
-        int wfc_seed = use_seed ? seed : (int)std::chrono::system_clock::now().time_since_epoch().count();
-        OverlappingWFC<int> wfc(input_array, options, wfc_seed);
-
-        if (debug_mode) {
-            UtilityFunctions::print("OverlappingWFC: Running with pattern_size=", pattern_size,
-                                  ", symmetry=", symmetry, ", seed=", wfc_seed);
+    int64_t wfc_seed = use_seed ? seed : (int64_t)std::chrono::system_clock::now().time_since_epoch().count();
+
+    if (debug_mode) {
+        UtilityFunctions::print("OverlappingWFC: Running with pattern_size=", pattern_size,
+                              ", symmetry=", symmetry, ", seed=", wfc_seed);
+    }
+
+    OverlappingOutput out = solveOverlapping(problem, wfc_seed, record_decisions);
+
+    if (debug_mode && out.success) {
+        if (problem.hasMapping) {
+            UtilityFunctions::print("OverlappingWFC: Applied pattern-to-tile mappings");
+        }
+        if (problem.expandStamps) {
+            UtilityFunctions::print("OverlappingWFC: Expanded from ", output_width, "x", output_height,
+                                  " to ", out.expandedWidth, "x", out.expandedHeight, " with stamps");
         }
+        UtilityFunctions::print("OverlappingWFC: Generation successful!");
+    }
 
-        std::optional<Array2D<int>> wfc_output = wfc.run();
+    return make_overlapping_result(problem, out, keep_intermediate_outputs);
+}
 
-        if (!wfc_output.has_value()) {
-            result->_set_failure("WFC contradiction - no valid solution found");
-            return result;
+Array OverlappingWFCGenerator::generate_batch(const PackedInt64Array& seeds, int threads) {
+    int count = seeds.size();
+    Array results;
+    results.resize(count);
+
+    // The seed image, mappings and stamps are converted once and shared
+    // read-only by every solve
+    OverlappingProblem problem;
+    String error = prepare_problem(problem);
+    if (!error.is_empty()) {
+        for (int i = 0; i < count; i++) {
+            Ref<OverlappingWFCResult> result;
+            result.instantiate();
+            result->_set_failure(error);
+            results[i] = result;
         }
+        return results;
+    }
+
+    std::vector<OverlappingOutput> outputs(count);
+    parallelFor(count, threads, [&](int i) {
+        outputs[i] = solveOverlapping(problem, (uint64_t)seeds[i], record_decisions);
+    });
+
+    for (int i = 0; i < count; i++) {
+        results[i] = make_overlapping_result(problem, outputs[i], keep_intermediate_outputs);
+    }
+    return results;
+}
 
-        // ====================================================================
-        // STEP 4: Convert WFC output to PackedInt32Array
-        // ====================================================================
-        Array2D<int>& output_array = wfc_output.value();
+Dictionary OverlappingWFCGenerator::generate_accepted(int max_attempts, int threads) {
+    AcceptanceCriteria criteria;
+    int floor_value = 0;
+    if (!read_acceptance(acceptance, "OverlappingWFCGenerator", criteria, &floor_value)) {
+        return Dictionary();
+    }
+    OverlappingProblem problem;
+    String error = prepare_problem(problem);
+    if (!error.is_empty()) {
+        UtilityFunctions::push_error("OverlappingWFCGenerator.generate_accepted: ", error);
+        return Dictionary();
+    }
 
-        PackedInt32Array pattern_result;
-        pattern_result.resize(output_height * output_width);
+    uint64_t base_seed = use_seed ? (uint64_t)seed : (uint64_t)std::chrono::system_clock::now().time_since_epoch().count();
 
-        for (int y = 0; y < output_height; y++) {
-            for (int x = 0; x < output_width; x++) {
-                pattern_result[y * output_width + x] = output_array.get(y, x);
-            }
+    std::vector<OverlappingOutput> outputs(acceptanceSlotCount(max_attempts, threads));
+    AcceptedCandidate found = firstAccepted(max_attempts, threads, [&](int candidate, int slot) {
+        OverlappingOutput& out = outputs[slot];
+        out = solveOverlapping(problem, base_seed + candidate, record_decisions);
+        if (!out.success) {
+            return false;
+        }
+        // Checked on the same stage the result's helpers work on
+        FloorMask mask;
+        if (problem.expandStamps) {
+            gridFloorMask(out.expanded.data(), out.expandedWidth, out.expandedHeight, floor_value, mask);
+        } else {
+            const std::vector<int>& grid = problem.hasMapping ? out.tiles : out.patterns;
+            gridFloorMask(grid.data(), problem.options.out_width, problem.options.out_height, floor_value, mask);
         }
+        return acceptsMap(criteria, mask, 0);
+    });
 
-        result->_set_pattern_data(pattern_result, output_width, output_height);
-
-        // ====================================================================
-        // STEP 5: Apply pattern-to-tile mapping (if configured)
-        // ====================================================================
-        if (!pattern_to_tile_map.is_empty()) {
-            PackedInt32Array tile_result;
-            tile_result.resize(output_height * output_width);
-
-            for (int y = 0; y < output_height; y++) {
-                for (int x = 0; x < output_width; x++) {
-                    int pattern_value = pattern_result[y * output_width + x];
-
-                    // Map pattern to tile ID
-                    if (pattern_to_tile_map.has(pattern_value)) {
-                        tile_result[y * output_width + x] = pattern_to_tile_map[pattern_value];
-                    } else {
-                        // Default to pattern value if no mapping exists
-                        tile_result[y * output_width + x] = pattern_value;
-                    }
-                }
-            }
-
-            result->_set_tile_data(tile_result, output_width, output_height);
-
-            if (debug_mode) {
-                UtilityFunctions::print("OverlappingWFC: Applied pattern-to-tile mappings");
-            }
+    Variant result;
+    if (found.index >= 0) {
+        result = make_overlapping_result(problem, outputs[found.slot], keep_intermediate_outputs);
+    }
+    return make_acceptance_report(result, found, (int64_t)base_seed);
+}
+
+LevelJob OverlappingWFCGenerator::make_level_job() const {
+    auto problem = std::make_shared<OverlappingProblem>();
+    String error = prepare_problem(*problem);
+    std::string message = error.utf8().get_data();
+    return [problem, message](uint64_t level_seed) {
+        MapRecord record;
+        record.seed = level_seed;
+        record.algorithm = MapAlgorithm::OverlappingWFC;
+        if (!message.empty()) {
+            record.success = false;
+            record.message = message;
+            return record;
         }
 
-        // ====================================================================
-        // STEP 6: Expand with stamps (if configured)
-        // ====================================================================
-        if (use_stamps && !tile_stamps.is_empty()) {
-            int expanded_width = output_width * stamp_size;
-            int expanded_height = output_height * stamp_size;
-
-            PackedInt32Array expanded_result;
-            expanded_result.resize(expanded_width * expanded_height);
-            // Initialize to -1 to distinguish unset tiles from actual floor tiles (0)
-            expanded_result.fill(-1);
-
-            // Get the tile array (use mapped tiles if available, otherwise patterns)
-            const PackedInt32Array& tile_array = pattern_to_tile_map.is_empty() ?
-                                                 pattern_result : result->get_tile_output();
-
-            // Expand each tile to its stamp
-            for (int wfc_y = 0; wfc_y < output_height; wfc_y++) {
-                for (int wfc_x = 0; wfc_x < output_width; wfc_x++) {
-                    int tile_id = tile_array[wfc_y * output_width + wfc_x];
-
-                    // Get stamp for this tile
-                    if (tile_stamps.has(tile_id)) {
-                        Dictionary stamp_data = tile_stamps[tile_id];
-                        PackedInt32Array stamp_pattern = stamp_data["pattern"];
-                        int stamp_w = stamp_data["width"];
-                        int stamp_h = stamp_data["height"];
-
-                        // Place stamp
-                        int base_x = wfc_x * stamp_size;
-                        int base_y = wfc_y * stamp_size;
-
-                        for (int local_y = 0; local_y < stamp_h; local_y++) {
-                            for (int local_x = 0; local_x < stamp_w; local_x++) {
-                                int stamp_index = local_y * stamp_w + local_x;
-                                if (stamp_index < stamp_pattern.size()) {
-                                    int world_x = base_x + local_x;
-                                    int world_y = base_y + local_y;
-
-                                    if (world_x < expanded_width && world_y < expanded_height) {
-                                        int tile_value = stamp_pattern[stamp_index];
-                                        expanded_result[world_y * expanded_width + world_x] = tile_value;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-
-            result->_set_expanded_data(expanded_result, expanded_width, expanded_height, stamp_size);
-
-            if (debug_mode) {
-                UtilityFunctions::print("OverlappingWFC: Expanded from ", output_width, "x", output_height,
-                                      " to ", expanded_width, "x", expanded_height, " with stamps");
-            }
+        OverlappingOutput out = solveOverlapping(*problem, level_seed);
+        record.success = out.success;
+        record.message = out.failureReason;
+        if (!out.success) {
+            return record;
+        }
+        if (problem->expandStamps) {
+            record.width = out.expandedWidth;
+            record.height = out.expandedHeight;
+            record.cells = std::move(out.expanded);
+        } else {
+            record.width = problem->options.out_width;
+            record.height = problem->options.out_height;
+            record.cells = problem->hasMapping ? std::move(out.tiles) : std::move(out.patterns);
         }
+        return record;
+    };
+}
+
+Ref<OverlappingWFCResult> OverlappingWFCGenerator::replay(const PackedByteArray& log) {
+    OverlappingProblem problem;
+    String error = prepare_problem(problem);
+    if (!error.is_empty()) {
+        Ref<OverlappingWFCResult> result;
+        result.instantiate();
+        result->_set_failure(error);
+        return result;
+    }
 
-        if (debug_mode) {
-            UtilityFunctions::print("OverlappingWFC: Generation successful!");
+    OverlappingOutput out = replayOverlapping(problem, log.ptr(), log.size());
+    if (out.success) {
+        out.decisions.assign(log.ptr(), log.ptr() + log.size());
+    }
+    return make_overlapping_result(problem, out, keep_intermediate_outputs);
+}
+
+Ref<OverlappingWFCResult> OverlappingWFCGenerator::regenerate_region(const Ref<OverlappingWFCResult>& p_result,
+                                                                    const Rect2i& rect, int64_t region_seed) {
+    Ref<OverlappingWFCResult> result;
+    result.instantiate();
+    OverlappingProblem problem;
+    String error = prepare_problem(problem);
+    if (error.is_empty()) {
+        if (p_result.is_null() || !p_result->is_success()) {
+            error = "regenerate_region needs a successful result";
+        } else if (p_result->get_output_width() != output_width || p_result->get_output_height() != output_height) {
+            error = "Result size does not match this generator's output size";
+        } else if (p_result->get_pattern_output().is_empty()) {
+            error = "Result has no pattern output; enable keep_intermediate_outputs";
+        } else if (p_result->get_pattern_output().size() != (int64_t)output_width * output_height) {
+            error = "Result pattern output does not match its size";
+        } else if (problem.hasMapping && p_result->get_tile_output().size() != (int64_t)output_width * output_height) {
+            error = "Result tile output does not match its size";
+        } else if (problem.expandStamps && (p_result->get_expanded_width() != output_width * stamp_size ||
+                                            p_result->get_expanded_height() != output_height * stamp_size)) {
+            error = "Result stamps do not match this configuration";
+        } else if (problem.expandStamps && p_result->get_expanded_output().size() !=
+                                               (int64_t)output_width * stamp_size * output_height * stamp_size) {
+            error = "Result expanded output does not match its size";
         }
+    }
+    if (!error.is_empty()) {
+        result->_set_failure(error);
+        return result;
+    }
 
-    } catch (const std::exception& e) {
-        result->_set_failure(String("WFC error: ") + e.what());
+    Rect2i region = rect.intersection(Rect2i(0, 0, output_width, output_height));
+    PackedInt32Array patterns = p_result->get_pattern_output();
+    OverlappingOutput out = regenerateOverlappingRegion(problem, patterns.ptr(), region.position.x,
+                                                        region.position.y, region.size.x, region.size.y,
+                                                        (uint64_t)region_seed);
+    if (!out.success) {
+        result->_set_failure(String(out.failureReason.c_str()));
+        return result;
     }
 
+    // The old outputs with the region written over them
+    if (!copy_block(patterns, output_width, out.patterns, region.size.x, region.position.x, region.position.y)) {
+        result->_set_failure("Region does not fit the result");
+        return result;
+    }
+    result->_set_pattern_data(patterns, output_width, output_height);
+    if (problem.hasMapping) {
+        PackedInt32Array tiles = p_result->get_tile_output();
+        if (!copy_block(tiles, output_width, out.tiles, region.size.x, region.position.x, region.position.y)) {
+            result->_set_failure("Region does not fit the result");
+            return result;
+        }
+        result->_set_tile_data(tiles, output_width, output_height);
+    }
+    if (problem.expandStamps) {
+        PackedInt32Array expanded = p_result->get_expanded_output();
+        if (!copy_block(expanded, output_width * stamp_size, out.expanded, out.expandedWidth,
+                        region.position.x * stamp_size, region.position.y * stamp_size)) {
+            result->_set_failure("Region does not fit the result");
+            return result;
+        }
+        result->_set_expanded_data(expanded, output_width * stamp_size, output_height * stamp_size, stamp_size);
+    }
     return result;
 }
@@ -6,15 +6,24 @@
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/classes/image.hpp>
 #include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
 #include <godot_cpp/variant/packed_vector2_array.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/array.hpp>
 #include <godot_cpp/core/class_db.hpp>
 
+#include "MultiLevel.h"
+#include "tile_grid_cache.h"
+
 using namespace godot;
 
 // Forward declarations
 class OverlappingWFCResult;
 class OverlappingWFCGenerator;
+struct OverlappingProblem;
 
 // ============================================================================
 // OverlappingWFCResult - Result object for Overlapping WFC generation
@@ -34,6 +43,14 @@ private:
     int stamp_size;
     bool success;
     String failure_reason;
+    PackedByteArray decision_log;
+
+    // Lazily built views of the most detailed grid (expanded, tile, pattern)
+    mutable TileGridCache grid_cache;
+
+    const PackedInt32Array& active_output() const;
+    int active_width() const { return has_stamps ? expanded_width : output_width; }
+    int active_height() const { return has_stamps ? expanded_height : output_height; }
 
 protected:
     static void _bind_methods();
@@ -60,16 +77,56 @@ public:
     PackedInt32Array get_tile_output() const { return tile_output; }
     PackedInt32Array get_expanded_output() const { return expanded_output; }
 
-    // Helper methods for dungeon generation
+    // Helper methods for dungeon generation. The first call buckets every
+    // tile value in one pass; later calls for any value reuse the buckets.
     PackedVector2Array get_floor_positions(int floor_tile_value = 0) const;
     PackedVector2Array get_wall_positions(int wall_tile_value = 1) const;
+    PackedVector2Array get_positions_of(int tile_value) const;
+    Dictionary get_tile_distribution() const;
     Dictionary get_statistics() const;
 
+    // Bulk queries on the same grid as get_expanded_tile_at(). get_region()
+    // returns rect.size.x * rect.size.y tiles (row-major, -1 outside the grid);
+    // count_in_rect() is O(1) after a per-value summed-area table is built.
+    PackedInt32Array get_region(const Rect2i& rect) const;
+    int64_t count_in_rect(int tile_value, const Rect2i& rect) const;
+    PackedVector2Array find_all(int tile_value, const Rect2i& rect) const;
+
+    // Region analysis on the same grid (see region_analysis.h)
+    Dictionary get_regions(int tile_value, int threads = 0) const;
+    PackedVector2Array get_dead_end_positions(int tile_value) const;
+    PackedInt32Array get_distance_field(int tile_value, const PackedVector2Array& sources) const;
+    PackedVector2Array get_farthest_pair(int tile_value) const;
+    PackedVector2Array get_critical_path(int tile_value) const;
+    PackedVector2Array get_chokepoints(int tile_value) const;
+
+    // Shapes (see grid_geometry.h)
+    PackedInt32Array get_rects(int tile_value) const;
+    Array get_contours(int tile_value, double epsilon) const;
+    Array get_contour_chunks(int tile_value, int chunk_size, double epsilon, int threads) const;
+
+    // Autotiling (see autotile.h)
+    PackedInt32Array get_bitmasks(int tile_value, int neighbours) const;
+    PackedVector2Array get_autotile(int tile_value, const Dictionary& lut, int neighbours) const;
+
+    // Placement (see placement.h)
+    Array get_placements(int tile_value, const PackedFloat32Array& radii, int64_t seed, const PackedInt32Array& counts,
+                         const PackedVector2Array& exclude, const PackedVector3Array& keep_out) const;
+
+    // Compact serialization (see result_codec.h)
+    PackedByteArray to_bytes(bool compress = true) const;
+    static Ref<OverlappingWFCResult> from_bytes(const PackedByteArray& bytes);
+
+    // The solve's decisions (see wfc/DecisionLog.h), for
+    // OverlappingWFCGenerator.replay(). Empty unless record_decisions was on.
+    PackedByteArray get_decision_log() const { return decision_log; }
+
     // Internal setters (used by generator)
     void _set_pattern_data(PackedInt32Array patterns, int width, int height);
     void _set_tile_data(PackedInt32Array tiles, int width, int height);
     void _set_expanded_data(PackedInt32Array tiles, int width, int height, int p_stamp_size);
     void _set_failure(String reason);
+    void _set_decision_log(PackedByteArray log);
 };
 
 // ============================================================================
@@ -85,7 +142,7 @@ private:
     int output_height;
     int pattern_size;
     int symmetry;
-    int seed;
+    int64_t seed;
     bool use_seed;
     bool periodic_input;
     bool periodic_output;
@@ -100,6 +157,19 @@ private:
     // Debug mode
     bool debug_mode;
 
+    // Copy pattern/tile grids into results even when a later stage exists
+    bool keep_intermediate_outputs;
+
+    // Keep each solve's decision log in its result
+    bool record_decisions;
+
+    // Limits checked by generate_accepted()
+    Dictionary acceptance;
+
+    // Converts the seed image, mappings and stamps into native form.
+    // Returns an error message, or an empty string on success.
+    String prepare_problem(OverlappingProblem& problem) const;
+
 protected:
     static void _bind_methods();
 
@@ -125,8 +195,8 @@ public:
     void set_symmetry(int p_symmetry);
     int get_symmetry() const { return symmetry; }
 
-    void set_seed(int p_seed);
-    int get_seed() const { return seed; }
+    void set_seed(int64_t p_seed);
+    int64_t get_seed() const { return seed; }
 
     void set_use_seed(bool p_use);
     bool get_use_seed() const { return use_seed; }
@@ -149,6 +219,21 @@ public:
     void set_stamp_size(int size);
     int get_stamp_size() const { return stamp_size; }
 
+    // When false, results keep only the most detailed output (expanded if
+    // stamps are on, else tile if mapped, else pattern); the others are empty.
+    void set_keep_intermediate_outputs(bool keep);
+    bool get_keep_intermediate_outputs() const { return keep_intermediate_outputs; }
+
+    // When true, results carry their decision log (get_decision_log()).
+    void set_record_decisions(bool enabled);
+    bool get_record_decisions() const { return record_decisions; }
+
+    // Limits for generate_accepted() (see acceptance.h for the keys);
+    // "floor_value" names the value counted as floor in the most detailed
+    // output (expanded, else tile, else pattern colour).
+    void set_acceptance(const Dictionary& p_acceptance);
+    Dictionary get_acceptance() const { return acceptance; }
+
     // Map a pattern color to a tile ID
     // color_value: The color value from the pattern (e.g., 0x000000 for black)
     // tile_id: The tile ID it should map to (e.g., 0 for floor, 1 for wall)
@@ -178,6 +263,36 @@ public:
     // ========================================================================
     Ref<OverlappingWFCResult> generate();
 
+    // Generate one result per seed, solving on up to `threads` worker
+    // threads (0 = all hardware threads). Results are identical to calling
+    // generate() with use_seed enabled for each seed in turn.
+    Array generate_batch(const PackedInt64Array& seeds, int threads = 0);
+
+    // Solves seeds seed, seed + 1, ... (from a time-based base unless
+    // use_seed is set) on up to `threads` workers and returns
+    // { result, seed, attempts } for the first successful solve that meets
+    // the acceptance limits; result is null if none of `max_attempts` did.
+    Dictionary generate_accepted(int max_attempts = 32, int threads = 0);
+
+    // Converts the seed image once into a native job for
+    // MultiLevelDungeonGenerator. Jobs return the most detailed output
+    // stage; configuration errors surface as a failed level.
+    LevelJob make_level_job() const;
+
+    // Rebuilds a recorded result from its decision log, applying each
+    // decision with propagation but no entropy search or sampling. The seed
+    // image and every setting except the seed must match the recording.
+    Ref<OverlappingWFCResult> replay(const PackedByteArray& log);
+
+    // Re-solves `rect` (clipped to the output) of a result from this
+    // generator and keeps every other pixel: only the wave cells whose
+    // patterns cover the rect are solved (see regenerateOverlappingRegion in
+    // wfc/OverlappingSolver.h). Needs the result's pattern output, so keep
+    // intermediate outputs when mapping or stamps are set. Returns a new
+    // result.
+    Ref<OverlappingWFCResult> regenerate_region(const Ref<OverlappingWFCResult>& p_result, const Rect2i& rect,
+                                                int64_t region_seed);
+
     // ========================================================================
     // Utility
     // ========================================================================
@@ -0,0 +1,38 @@
+#include "packed_arrays.h"
+#include <cstring>
+
+PackedByteArray to_packed_bytes(const std::vector<uint8_t>& bytes) {
+    PackedByteArray packed;
+    packed.resize(bytes.size());
+    if (!bytes.empty()) {
+        memcpy(packed.ptrw(), bytes.data(), bytes.size());
+    }
+    return packed;
+}
+
+PackedInt32Array to_packed_int32(const std::vector<int>& values) {
+    PackedInt32Array packed;
+    packed.resize(values.size());
+    if (!values.empty()) {
+        memcpy(packed.ptrw(), values.data(), values.size() * sizeof(int32_t));
+    }
+    return packed;
+}
+
+bool copy_block(PackedInt32Array& grid, int grid_width, const std::vector<int>& block, int block_width,
+                int x, int y) {
+    if (block_width <= 0 || block.empty()) {
+        return block.empty();
+    }
+    int64_t rows = (int64_t)block.size() / block_width;
+    if ((int64_t)block.size() % block_width != 0 || x < 0 || y < 0 ||
+        (int64_t)x + block_width > grid_width || ((int64_t)y + rows) * grid_width > grid.size()) {
+        return false;
+    }
+    int32_t* cells = grid.ptrw();
+    for (int64_t row = 0; row < rows; row++) {
+        memcpy(cells + (int64_t)(y + row) * grid_width + x, block.data() + (size_t)row * block_width,
+               block_width * sizeof(int32_t));
+    }
+    return true;
+}
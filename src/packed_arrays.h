@@ -0,0 +1,23 @@
+#ifndef PACKED_ARRAYS_H
+#define PACKED_ARRAYS_H
+
+#include <cstdint>
+#include <vector>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+
+using namespace godot;
+
+// ============================================================================
+// Shared helpers for moving solver output into Godot packed arrays
+// ============================================================================
+
+PackedByteArray to_packed_bytes(const std::vector<uint8_t>& bytes);
+PackedInt32Array to_packed_int32(const std::vector<int>& values);
+
+// Overwrites the block_width-wide block at (x, y) of a row-major grid.
+// Returns false, and writes nothing, if the block does not fit in the grid.
+bool copy_block(PackedInt32Array& grid, int grid_width, const std::vector<int>& block, int block_width,
+                int x, int y);
+
+#endif // PACKED_ARRAYS_H
@@ -0,0 +1,80 @@
+#include "placement.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "PoissonDisk.h"
+#include "region_analysis.h"
+
+namespace {
+
+std::vector<PoissonLayer> make_layers(const PackedFloat32Array& radii, const PackedInt32Array& counts) {
+    std::vector<PoissonLayer> layers(radii.size());
+    for (int64_t i = 0; i < radii.size(); i++) {
+        layers[i].radius = radii.ptr()[i];
+        layers[i].maxCount = i < counts.size() ? std::max(0, (int)counts.ptr()[i]) : 0;
+    }
+    return layers;
+}
+
+// Clears excluded cells and keep-out discs from a mask whose cell (0, 0)
+// is tile (origin_x, origin_y)
+void apply_exclusions(std::vector<uint8_t>& mask, int width, int height, int origin_x, int origin_y,
+                      const PackedVector2Array& exclude, const PackedVector3Array& keep_out) {
+    const Vector2* e = exclude.ptr();
+    for (int64_t i = 0; i < exclude.size(); i++) {
+        int x = (int)std::floor(e[i].x) - origin_x;
+        int y = (int)std::floor(e[i].y) - origin_y;
+        if (x >= 0 && y >= 0 && x < width && y < height) mask[(size_t)y * width + x] = 0;
+    }
+
+    const Vector3* k = keep_out.ptr();
+    for (int64_t i = 0; i < keep_out.size(); i++) {
+        double cx = k[i].x - origin_x, cy = k[i].y - origin_y, r = k[i].z;
+        if (r <= 0) continue;
+        int x0 = std::max(0, (int)std::floor(cx - r)), x1 = std::min(width - 1, (int)std::ceil(cx + r));
+        int y0 = std::max(0, (int)std::floor(cy - r)), y1 = std::min(height - 1, (int)std::ceil(cy + r));
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) < r * r) mask[(size_t)y * width + x] = 0;
+            }
+        }
+    }
+}
+
+Array pack_layers(const std::vector<std::vector<GridPoint>>& layers, int offset_x, int offset_y) {
+    Array result;
+    result.resize(layers.size());
+    for (size_t l = 0; l < layers.size(); l++) {
+        PackedVector2Array points;
+        points.resize(layers[l].size());
+        Vector2* out = points.ptrw();
+        for (const GridPoint& p : layers[l]) {
+            *out++ = Vector2((real_t)(p.x + offset_x), (real_t)(p.y + offset_y));
+        }
+        result[l] = points;
+    }
+    return result;
+}
+
+} // namespace
+
+Array position_poisson(const PackedVector2Array& positions, const PackedFloat32Array& radii, int64_t seed,
+                       const PackedInt32Array& counts, const PackedVector2Array& exclude,
+                       const PackedVector3Array& keep_out) {
+    PositionMask m = rasterize_positions(positions);
+    apply_exclusions(m.cells, m.width, m.height, m.min_x, m.min_y, exclude, keep_out);
+    return pack_layers(samplePoissonDisk(m.cells.data(), m.width, m.height, make_layers(radii, counts), (uint64_t)seed),
+                       m.min_x, m.min_y);
+}
+
+Array grid_poisson(const PackedInt32Array& tiles, int width, int height, int value, const PackedFloat32Array& radii,
+                   int64_t seed, const PackedInt32Array& counts, const PackedVector2Array& exclude,
+                   const PackedVector3Array& keep_out) {
+    std::vector<uint8_t> mask;
+    if (!make_grid_mask(tiles, width, height, value, mask)) {
+        return pack_layers(std::vector<std::vector<GridPoint>>(radii.size()), 0, 0);
+    }
+    apply_exclusions(mask, width, height, 0, 0, exclude, keep_out);
+    return pack_layers(samplePoissonDisk(mask.data(), width, height, make_layers(radii, counts), (uint64_t)seed), 0, 0);
+}
@@ -0,0 +1,31 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <cstdint>
+
+using namespace godot;
+
+// ============================================================================
+// Shared helpers for the result classes' placement queries (see PoissonDisk.h)
+// ============================================================================
+
+// Poisson-disk samples over the positions (or the cells holding `value`):
+// one PackedVector2Array of tile coordinates per entry of `radii`, no two
+// samples of a layer closer than its radius and no cell used by two layers.
+//   counts    optional cap per layer (0 or missing = as many as fit)
+//   exclude   cells never sampled (e.g. corridors)
+//   keep_out  Vector3(x, y, radius) discs never sampled (e.g. near spawn)
+// The same seed and inputs give the same placements on every platform.
+Array position_poisson(const PackedVector2Array& positions, const PackedFloat32Array& radii, int64_t seed,
+                       const PackedInt32Array& counts, const PackedVector2Array& exclude,
+                       const PackedVector3Array& keep_out);
+Array grid_poisson(const PackedInt32Array& tiles, int width, int height, int value, const PackedFloat32Array& radii,
+                   int64_t seed, const PackedInt32Array& counts, const PackedVector2Array& exclude,
+                   const PackedVector3Array& keep_out);
+
+#endif // PLACEMENT_H
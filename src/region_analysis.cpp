@@ -0,0 +1,217 @@
+#include "region_analysis.h"
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <vector>
+
+#include "GridAnalysis.h"
+
+PositionMask rasterize_positions(const PackedVector2Array& positions) {
+    PositionMask m;
+    const Vector2* p = positions.ptr();
+    int64_t count = positions.size();
+    if (count == 0) {
+        return m;
+    }
+
+    int min_x = INT_MAX, min_y = INT_MAX, max_x = INT_MIN, max_y = INT_MIN;
+    for (int64_t i = 0; i < count; i++) {
+        int x = (int)std::floor(p[i].x);
+        int y = (int)std::floor(p[i].y);
+        min_x = std::min(min_x, x);
+        min_y = std::min(min_y, y);
+        max_x = std::max(max_x, x);
+        max_y = std::max(max_y, y);
+    }
+    m.min_x = min_x;
+    m.min_y = min_y;
+    m.width = max_x - min_x + 1;
+    m.height = max_y - min_y + 1;
+    m.cells.assign((size_t)m.width * m.height, 0);
+    m.index.resize(count);
+    for (int64_t i = 0; i < count; i++) {
+        int32_t cell = ((int)std::floor(p[i].y) - min_y) * m.width + ((int)std::floor(p[i].x) - min_x);
+        m.index[i] = cell;
+        m.cells[cell] = 1;
+    }
+    return m;
+}
+
+bool make_grid_mask(const PackedInt32Array& tiles, int width, int height, int value, std::vector<uint8_t>& mask) {
+    if (width <= 0 || height <= 0 || tiles.size() < (int64_t)width * height) {
+        return false;
+    }
+    mask.resize((size_t)width * height);
+    const int32_t* cells = tiles.ptr();
+    for (size_t i = 0; i < mask.size(); i++) {
+        mask[i] = cells[i] == value;
+    }
+    return true;
+}
+
+namespace {
+
+Dictionary make_region_dictionary(const ComponentLabels& components, PackedInt32Array labels) {
+    PackedInt64Array sizes;
+    sizes.resize(components.count());
+    std::copy(components.sizes.begin(), components.sizes.end(), sizes.ptrw());
+
+    Dictionary histogram;
+    for (const auto& entry : componentSizeHistogram(components)) {
+        histogram[entry.first] = entry.second;
+    }
+
+    Dictionary result;
+    result["count"] = components.count();
+    result["largest"] = components.largest();
+    result["labels"] = labels;
+    result["sizes"] = sizes;
+    result["histogram"] = histogram;
+    return result;
+}
+
+// Source positions as cell indices; positions outside the area are dropped
+std::vector<int32_t> source_cells(const PackedVector2Array& sources, int min_x, int min_y, int width, int height) {
+    std::vector<int32_t> cells;
+    const Vector2* p = sources.ptr();
+    for (int64_t i = 0; i < sources.size(); i++) {
+        int x = (int)std::floor(p[i].x) - min_x;
+        int y = (int)std::floor(p[i].y) - min_y;
+        if (x >= 0 && y >= 0 && x < width && y < height) {
+            cells.push_back(y * width + x);
+        }
+    }
+    return cells;
+}
+
+PackedVector2Array cells_to_positions(const std::vector<int32_t>& cells, int width, int min_x, int min_y) {
+    PackedVector2Array result;
+    result.resize(cells.size());
+    Vector2* out = result.ptrw();
+    for (size_t i = 0; i < cells.size(); i++) {
+        out[i] = Vector2((real_t)(cells[i] % width + min_x), (real_t)(cells[i] / width + min_y));
+    }
+    return result;
+}
+
+std::vector<int32_t> pair_cells(const CellPair& pair) {
+    if (pair.first < 0) {
+        return {};
+    }
+    return {pair.first, pair.second};
+}
+
+std::vector<int32_t> critical_path_cells(const uint8_t* mask, int width, int height) {
+    CellPair pair = farthestPair(mask, width, height);
+    if (pair.first < 0) {
+        return {};
+    }
+    return shortestPath(mask, width, height, pair.first, pair.second);
+}
+
+} // namespace
+
+Dictionary analyze_position_regions(const PackedVector2Array& positions, int threads) {
+    PositionMask m = rasterize_positions(positions);
+    ComponentLabels components = labelComponents(m.cells.data(), m.width, m.height, threads);
+
+    PackedInt32Array labels;
+    labels.resize(m.index.size());
+    int32_t* out = labels.ptrw();
+    for (size_t i = 0; i < m.index.size(); i++) {
+        out[i] = components.labels[m.index[i]];
+    }
+    return make_region_dictionary(components, labels);
+}
+
+Dictionary analyze_grid_regions(const PackedInt32Array& tiles, int width, int height, int value, int threads) {
+    std::vector<uint8_t> mask;
+    if (!make_grid_mask(tiles, width, height, value, mask)) {
+        width = height = 0;
+    }
+    ComponentLabels components = labelComponents(mask.data(), width, height, threads);
+
+    PackedInt32Array labels;
+    labels.resize(components.labels.size());
+    std::copy(components.labels.begin(), components.labels.end(), labels.ptrw());
+    return make_region_dictionary(components, labels);
+}
+
+PackedVector2Array find_position_dead_ends(const PackedVector2Array& positions) {
+    PositionMask m = rasterize_positions(positions);
+    return cells_to_positions(pruneDeadEnds(m.cells.data(), m.width, m.height), m.width, m.min_x, m.min_y);
+}
+
+PackedVector2Array find_grid_dead_ends(const PackedInt32Array& tiles, int width, int height, int value) {
+    std::vector<uint8_t> mask;
+    if (!make_grid_mask(tiles, width, height, value, mask)) {
+        return PackedVector2Array();
+    }
+    return cells_to_positions(pruneDeadEnds(mask.data(), width, height), width, 0, 0);
+}
+
+PackedInt32Array position_distance_field(const PackedVector2Array& positions, const PackedVector2Array& sources) {
+    PositionMask m = rasterize_positions(positions);
+    std::vector<int32_t> distance = distanceField(m.cells.data(), m.width, m.height,
+                                                  source_cells(sources, m.min_x, m.min_y, m.width, m.height));
+    PackedInt32Array result;
+    result.resize(m.index.size());
+    int32_t* out = result.ptrw();
+    for (size_t i = 0; i < m.index.size(); i++) {
+        out[i] = distance[m.index[i]];
+    }
+    return result;
+}
+
+PackedInt32Array grid_distance_field(const PackedInt32Array& tiles, int width, int height, int value,
+                                     const PackedVector2Array& sources) {
+    PackedInt32Array result;
+    std::vector<uint8_t> mask;
+    if (!make_grid_mask(tiles, width, height, value, mask)) {
+        return result;
+    }
+    std::vector<int32_t> distance = distanceField(mask.data(), width, height, source_cells(sources, 0, 0, width, height));
+    result.resize(distance.size());
+    std::copy(distance.begin(), distance.end(), result.ptrw());
+    return result;
+}
+
+PackedVector2Array position_farthest_pair(const PackedVector2Array& positions) {
+    PositionMask m = rasterize_positions(positions);
+    return cells_to_positions(pair_cells(farthestPair(m.cells.data(), m.width, m.height)), m.width, m.min_x, m.min_y);
+}
+
+PackedVector2Array grid_farthest_pair(const PackedInt32Array& tiles, int width, int height, int value) {
+    std::vector<uint8_t> mask;
+    if (!make_grid_mask(tiles, width, height, value, mask)) {
+        return PackedVector2Array();
+    }
+    return cells_to_positions(pair_cells(farthestPair(mask.data(), width, height)), width, 0, 0);
+}
+
+PackedVector2Array position_critical_path(const PackedVector2Array& positions) {
+    PositionMask m = rasterize_positions(positions);
+    return cells_to_positions(critical_path_cells(m.cells.data(), m.width, m.height), m.width, m.min_x, m.min_y);
+}
+
+PackedVector2Array grid_critical_path(const PackedInt32Array& tiles, int width, int height, int value) {
+    std::vector<uint8_t> mask;
+    if (!make_grid_mask(tiles, width, height, value, mask)) {
+        return PackedVector2Array();
+    }
+    return cells_to_positions(critical_path_cells(mask.data(), width, height), width, 0, 0);
+}
+
+PackedVector2Array position_chokepoints(const PackedVector2Array& positions) {
+    PositionMask m = rasterize_positions(positions);
+    return cells_to_positions(articulationPoints(m.cells.data(), m.width, m.height), m.width, m.min_x, m.min_y);
+}
+
+PackedVector2Array grid_chokepoints(const PackedInt32Array& tiles, int width, int height, int value) {
+    std::vector<uint8_t> mask;
+    if (!make_grid_mask(tiles, width, height, value, mask)) {
+        return PackedVector2Array();
+    }
+    return cells_to_positions(articulationPoints(mask.data(), width, height), width, 0, 0);
+}
@@ -0,0 +1,61 @@
+#ifndef REGION_ANALYSIS_H
+#define REGION_ANALYSIS_H
+
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace godot;
+
+// Positions rasterised into a mask over their bounding box
+struct PositionMask {
+    int min_x = 0;
+    int min_y = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> cells;
+    std::vector<int32_t> index; // cell index of each position
+};
+PositionMask rasterize_positions(const PackedVector2Array& positions);
+
+// Cells holding `value`. Returns false (mask untouched) when `tiles` is
+// smaller than width * height.
+bool make_grid_mask(const PackedInt32Array& tiles, int width, int height, int value, std::vector<uint8_t>& mask);
+
+// ============================================================================
+// Shared helpers for the result classes' region queries (see GridAnalysis.h)
+// ============================================================================
+
+// Both return { "count", "largest", "labels", "sizes", "histogram" }:
+//   labels    PackedInt32Array, one per position (or per grid cell, -1 when
+//             the cell does not hold `value`)
+//   sizes     PackedInt64Array, cells per label
+//   histogram Dictionary { region size: number of regions }
+Dictionary analyze_position_regions(const PackedVector2Array& positions, int threads);
+Dictionary analyze_grid_regions(const PackedInt32Array& tiles, int width, int height, int value, int threads);
+
+// Positions a dead-end pruner would remove: cells with at most one
+// 4-neighbour, repeated until none are left. Returned round by round.
+PackedVector2Array find_position_dead_ends(const PackedVector2Array& positions);
+PackedVector2Array find_grid_dead_ends(const PackedInt32Array& tiles, int width, int height, int value);
+
+// Key locations. The position variants work on the positions' bounding box
+// and return distances in position order; the grid variants consider cells
+// holding `value` and return one distance per cell.
+//   distance field  steps to the nearest source, -1 when unreachable
+//   farthest pair   [a, b], two far-apart cells of the largest region
+//   critical path   shortest path from a to b, both included
+//   chokepoints     cells whose removal splits their region
+PackedInt32Array position_distance_field(const PackedVector2Array& positions, const PackedVector2Array& sources);
+PackedInt32Array grid_distance_field(const PackedInt32Array& tiles, int width, int height, int value,
+                                     const PackedVector2Array& sources);
+PackedVector2Array position_farthest_pair(const PackedVector2Array& positions);
+PackedVector2Array grid_farthest_pair(const PackedInt32Array& tiles, int width, int height, int value);
+PackedVector2Array position_critical_path(const PackedVector2Array& positions);
+PackedVector2Array grid_critical_path(const PackedInt32Array& tiles, int width, int height, int value);
+PackedVector2Array position_chokepoints(const PackedVector2Array& positions);
+PackedVector2Array grid_chokepoints(const PackedInt32Array& tiles, int width, int height, int value);
+
+#endif // REGION_ANALYSIS_H
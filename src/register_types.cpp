@@ -6,6 +6,8 @@
 #include "bsp_godot.h"
 #include "hybrid_godot.h"
 #include "overlapping_wfc_godot.h"
+#include "multi_level.h"
+#include "voxel_wfc_godot.h"
 
 #include <gdextension_interface.h>
 #include <godot_cpp/core/class_db.hpp>
@@ -45,6 +47,14 @@ void initialize_gdwfc_module(ModuleInitializationLevel p_level) {
     ClassDB::register_class<OverlappingWFCResult>();
     ClassDB::register_class<OverlappingWFCGenerator>();
 
+    // Register multi-level classes
+    ClassDB::register_class<MultiLevelResult>();
+    ClassDB::register_class<MultiLevelDungeonGenerator>();
+
+    // Register voxel WFC classes
+    ClassDB::register_class<VoxelWFCResult>();
+    ClassDB::register_class<VoxelWFCGenerator>();
+
     UtilityFunctions::print("GDTilingWFC: Registered WalkerDungeonGenerator, BSPDungeonGenerator, Overlapping WFC, and Tiling WFC classes");
 }
 
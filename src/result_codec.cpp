@@ -0,0 +1,254 @@
+#include "result_codec.h"
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include "CompactCodec.h"
+
+namespace {
+
+enum PositionMode : uint8_t {
+    POSITIONS_GRID = 0,         // bitmask grid over the bounding box
+    POSITIONS_INT_LISTS = 1,    // per layer: zigzag varint deltas
+    POSITIONS_FLOAT_LISTS = 2   // per layer: raw f32 pairs
+};
+
+bool is_cell(const Vector2& p) {
+    return p.x == std::floor(p.x) && p.y == std::floor(p.y) &&
+           p.x >= INT_MIN / 2 && p.x <= INT_MAX / 2 && p.y >= INT_MIN / 2 && p.y <= INT_MAX / 2;
+}
+
+} // namespace
+
+void write_position_layers(ByteWriter& out, const PackedVector2Array* const* layers, int layer_count) {
+    bool integral = true;
+    int64_t total = 0;
+    int min_x = INT_MAX, min_y = INT_MAX, max_x = INT_MIN, max_y = INT_MIN;
+    for (int l = 0; l < layer_count; l++) {
+        const PackedVector2Array& layer = *layers[l];
+        const Vector2* p = layer.ptr();
+        for (int64_t i = 0; i < layer.size(); i++) {
+            if (!is_cell(p[i])) {
+                integral = false;
+                break;
+            }
+            int x = (int)p[i].x;
+            int y = (int)p[i].y;
+            min_x = std::min(min_x, x);
+            min_y = std::min(min_y, y);
+            max_x = std::max(max_x, x);
+            max_y = std::max(max_y, y);
+        }
+        total += layer.size();
+    }
+
+    // Grid mode: only when positions are unique per layer and dense enough
+    if (integral && total > 0) {
+        int64_t width = (int64_t)max_x - min_x + 1;
+        int64_t height = (int64_t)max_y - min_y + 1;
+        if (width * height <= total * 64 + 4096) {
+            std::vector<int32_t> cells(width * height, 0);
+            bool unique = true;
+            for (int l = 0; l < layer_count && unique; l++) {
+                const PackedVector2Array& layer = *layers[l];
+                const Vector2* p = layer.ptr();
+                for (int64_t i = 0; i < layer.size(); i++) {
+                    int32_t& cell = cells[((int64_t)p[i].y - min_y) * width + ((int64_t)p[i].x - min_x)];
+                    if (cell & (1 << l)) {
+                        unique = false;
+                        break;
+                    }
+                    cell |= 1 << l;
+                }
+            }
+            if (unique) {
+                out.putU8(POSITIONS_GRID);
+                out.putVarI(min_x);
+                out.putVarI(min_y);
+                out.putVarU(width);
+                out.putVarU(height);
+                encodeGrid(cells.data(), cells.size(), out);
+                return;
+            }
+        }
+    }
+
+    out.putU8(integral ? POSITIONS_INT_LISTS : POSITIONS_FLOAT_LISTS);
+    for (int l = 0; l < layer_count; l++) {
+        const PackedVector2Array& layer = *layers[l];
+        const Vector2* p = layer.ptr();
+        out.putVarU(layer.size());
+        int64_t prev_x = 0, prev_y = 0;
+        for (int64_t i = 0; i < layer.size(); i++) {
+            if (integral) {
+                out.putVarI((int64_t)p[i].x - prev_x);
+                out.putVarI((int64_t)p[i].y - prev_y);
+                prev_x = (int64_t)p[i].x;
+                prev_y = (int64_t)p[i].y;
+            } else {
+                out.putF32((float)p[i].x);
+                out.putF32((float)p[i].y);
+            }
+        }
+    }
+}
+
+bool read_position_layers(ByteReader& in, PackedVector2Array* const* layers, int layer_count) {
+    uint8_t mode = in.getU8();
+
+    if (mode == POSITIONS_GRID) {
+        int64_t min_x = in.getVarI();
+        int64_t min_y = in.getVarI();
+        uint64_t width = in.getVarU();
+        uint64_t height = in.getVarU();
+        if (!in.ok() || width == 0 || height == 0 || width * height > (uint64_t(1) << 31) ||
+            width > (uint64_t(1) << 31) || height > (uint64_t(1) << 31)) {
+            return false;
+        }
+
+        std::vector<int32_t> cells(width * height);
+        if (!decodeGrid(in, cells.data(), cells.size())) {
+            return false;
+        }
+
+        // Count first so every layer is allocated exactly once
+        std::vector<int64_t> counts(layer_count, 0);
+        for (int32_t cell : cells) {
+            for (int l = 0; l < layer_count; l++) {
+                if (cell & (1 << l)) counts[l]++;
+            }
+        }
+        std::vector<Vector2*> write(layer_count);
+        for (int l = 0; l < layer_count; l++) {
+            layers[l]->resize(counts[l]);
+            write[l] = layers[l]->ptrw();
+        }
+        for (uint64_t y = 0; y < height; y++) {
+            for (uint64_t x = 0; x < width; x++) {
+                int32_t cell = cells[y * width + x];
+                if (!cell) continue;
+                Vector2 pos((real_t)(min_x + (int64_t)x), (real_t)(min_y + (int64_t)y));
+                for (int l = 0; l < layer_count; l++) {
+                    if (cell & (1 << l)) *write[l]++ = pos;
+                }
+            }
+        }
+        return true;
+    }
+
+    if (mode != POSITIONS_INT_LISTS && mode != POSITIONS_FLOAT_LISTS) {
+        return false;
+    }
+    for (int l = 0; l < layer_count; l++) {
+        uint64_t count = in.getVarU();
+        // Every position takes at least two bytes
+        if (!in.ok() || count > in.remaining() / 2) {
+            return false;
+        }
+        PackedVector2Array& layer = *layers[l];
+        layer.resize(count);
+        Vector2* p = layer.ptrw();
+        int64_t x = 0, y = 0;
+        for (uint64_t i = 0; i < count; i++) {
+            if (mode == POSITIONS_INT_LISTS) {
+                x += in.getVarI();
+                y += in.getVarI();
+                p[i] = Vector2((real_t)x, (real_t)y);
+            } else {
+                float fx = in.getF32();
+                float fy = in.getF32();
+                p[i] = Vector2(fx, fy);
+            }
+        }
+    }
+    return in.ok();
+}
+
+void write_int_grid(ByteWriter& out, const PackedInt32Array& cells) {
+    out.putVarU(cells.size());
+    encodeGrid(cells.ptr(), cells.size(), out);
+}
+
+bool read_int_grid(ByteReader& in, PackedInt32Array& cells) {
+    uint64_t count = in.getVarU();
+    if (!in.ok() || count > (uint64_t(1) << 31)) {
+        return false;
+    }
+    cells.resize(count);
+    return decodeGrid(in, cells.ptrw(), count);
+}
+
+void write_rect_list(ByteWriter& out, const PackedInt32Array& rects) {
+    int64_t count = rects.size() / 4;
+    const int32_t* r = rects.ptr();
+    out.putVarU(count);
+    for (int64_t i = 0; i < count; i++) {
+        out.putVarI(r[i * 4]);
+        out.putVarI(r[i * 4 + 1]);
+        out.putVarU((uint32_t)r[i * 4 + 2]);
+        out.putVarU((uint32_t)r[i * 4 + 3]);
+    }
+}
+
+bool read_rect_list(ByteReader& in, PackedInt32Array& rects) {
+    uint64_t count = in.getVarU();
+    // Every rectangle takes at least four bytes
+    if (!in.ok() || count > in.remaining() / 4) {
+        return false;
+    }
+    rects.resize(count * 4);
+    int32_t* r = rects.ptrw();
+    for (uint64_t i = 0; i < count; i++) {
+        r[i * 4] = (int32_t)in.getVarI();
+        r[i * 4 + 1] = (int32_t)in.getVarI();
+        r[i * 4 + 2] = (int32_t)in.getVarU();
+        r[i * 4 + 3] = (int32_t)in.getVarU();
+    }
+    return in.ok();
+}
+
+void write_byte_array(ByteWriter& out, const PackedByteArray& bytes) {
+    out.putVarU(bytes.size());
+    if (!bytes.is_empty()) {
+        out.putBytes(bytes.ptr(), bytes.size());
+    }
+}
+
+bool read_byte_array(ByteReader& in, PackedByteArray& bytes) {
+    uint64_t size = in.getVarU();
+    if (!in.ok() || size > in.remaining()) {
+        return false;
+    }
+    bytes.resize(size);
+    return size == 0 || in.getBytes(bytes.ptrw(), size);
+}
+
+bool int_grid_fits(const PackedInt32Array& cells, int width, int height) {
+    if (cells.is_empty()) {
+        return true;
+    }
+    return width >= 0 && height >= 0 && cells.size() == (int64_t)width * height;
+}
+
+PackedByteArray make_result_blob(MapAlgorithm kind, const ByteWriter& body, bool compress) {
+    std::vector<uint8_t> blob = writeBlob((uint8_t)kind, body.data(), compress);
+    PackedByteArray bytes;
+    bytes.resize(blob.size());
+    if (!blob.empty()) {
+        memcpy(bytes.ptrw(), blob.data(), blob.size());
+    }
+    return bytes;
+}
+
+bool open_result_blob(const PackedByteArray& bytes, MapAlgorithm kind, const char* class_name,
+                      std::vector<uint8_t>& scratch, const uint8_t*& body, size_t& body_size) {
+    std::string error;
+    if (!openBlob(bytes.ptr(), bytes.size(), (uint8_t)kind, scratch, body, body_size, error)) {
+        UtilityFunctions::push_error(class_name, ".from_bytes: ", error.c_str());
+        return false;
+    }
+    return true;
+}
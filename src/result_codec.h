@@ -0,0 +1,52 @@
+#ifndef RESULT_CODEC_H
+#define RESULT_CODEC_H
+
+#include <cstdint>
+#include <vector>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+
+#include "ByteStream.h"
+#include "MapContainer.h"
+
+using namespace godot;
+
+// ============================================================================
+// Shared helpers for the result classes' to_bytes() / from_bytes()
+// ============================================================================
+
+// Layered position lists (e.g. floors, walls, corridors) are stored as one
+// grid whose cell value is the bitmask of layers holding that position, so
+// overlapping layers cost nothing extra. Positions come back in row-major
+// order. Lists the grid cannot represent (duplicates, non-integer or very
+// sparse positions) are stored as plain lists instead, preserving order.
+void write_position_layers(ByteWriter& out, const PackedVector2Array* const* layers, int layer_count);
+bool read_position_layers(ByteReader& in, PackedVector2Array* const* layers, int layer_count);
+
+// Cell count followed by the compact grid encoding.
+void write_int_grid(ByteWriter& out, const PackedInt32Array& cells);
+// Decodes directly into the array's buffer.
+bool read_int_grid(ByteReader& in, PackedInt32Array& cells);
+// True if `cells` is empty or holds exactly width * height cells; a decoded
+// grid that fails this does not belong to the sizes stored with it.
+bool int_grid_fits(const PackedInt32Array& cells, int width, int height);
+
+// Rectangles as x, y, w, h quads: count, then zigzag x, y and plain w, h
+// varints per rectangle.
+void write_rect_list(ByteWriter& out, const PackedInt32Array& rects);
+bool read_rect_list(ByteReader& in, PackedInt32Array& rects);
+
+// Raw bytes (e.g. WFC decision logs): size, then the bytes as they are.
+void write_byte_array(ByteWriter& out, const PackedByteArray& bytes);
+bool read_byte_array(ByteReader& in, PackedByteArray& bytes);
+
+PackedByteArray make_result_blob(MapAlgorithm kind, const ByteWriter& body, bool compress);
+
+// Validates the blob header and returns the body. Uncompressed bodies point
+// into `bytes` (no copy); compressed ones are inflated into `scratch`.
+// Reports failures with push_error, prefixed by `class_name`.
+bool open_result_blob(const PackedByteArray& bytes, MapAlgorithm kind, const char* class_name,
+                      std::vector<uint8_t>& scratch, const uint8_t*& body, size_t& body_size);
+
+#endif // RESULT_CODEC_H
@@ -0,0 +1,58 @@
+#include "room_index.h"
+#include <vector>
+
+#include "region_analysis.h"
+
+void begin_room_index(RoomIndex& index, const PackedVector2Array& floors) {
+    PositionMask m = rasterize_positions(floors);
+    index.reset(GridRect{m.min_x, m.min_y, m.width, m.height}, m.cells.data());
+}
+
+void build_rect_room_index(RoomIndex& index, const PackedVector2Array& floors, const PackedInt32Array& rects) {
+    begin_room_index(index, floors);
+    const int32_t* r = rects.ptr();
+    for (int64_t i = 0; i + 3 < rects.size(); i += 4) {
+        int room = index.addRoom();
+        index.claimRect(room, GridRect{r[i], r[i + 1], r[i + 2], r[i + 3]});
+    }
+    index.finish();
+}
+
+int index_room_at(const RoomIndex& index, const Vector2i& cell) {
+    return index.roomAt(cell.x, cell.y);
+}
+
+PackedInt32Array index_rooms_in_rect(const RoomIndex& index, const Rect2i& rect) {
+    std::vector<int> rooms;
+    index.roomsInRect(GridRect{rect.position.x, rect.position.y, rect.size.x, rect.size.y}, rooms);
+    PackedInt32Array result;
+    result.resize(rooms.size());
+    int32_t* out = result.ptrw();
+    for (size_t i = 0; i < rooms.size(); i++) {
+        out[i] = rooms[i];
+    }
+    return result;
+}
+
+PackedInt32Array index_room_neighbours(const RoomIndex& index, int room) {
+    PackedInt32Array result;
+    if (room < 0 || room >= index.roomCount()) {
+        return result;
+    }
+    int count = 0;
+    const int* neighbours = index.neighbours(room, count);
+    result.resize(count);
+    int32_t* out = result.ptrw();
+    for (int i = 0; i < count; i++) {
+        out[i] = neighbours[i];
+    }
+    return result;
+}
+
+Rect2i index_room_bounds(const RoomIndex& index, int room) {
+    if (room < 0 || room >= index.roomCount()) {
+        return Rect2i();
+    }
+    const GridRect& b = index.roomBounds(room);
+    return Rect2i(b.x, b.y, b.w, b.h);
+}
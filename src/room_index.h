@@ -0,0 +1,30 @@
+#ifndef ROOM_INDEX_H
+#define ROOM_INDEX_H
+
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include "RoomIndex.h"
+
+using namespace godot;
+
+// ============================================================================
+// Shared helpers for the result classes' room queries (see RoomIndex.h)
+// ============================================================================
+
+// Starts an index over the floor positions' bounding box; rooms then claim
+// floor cells. Positions off the integer grid are ignored.
+void begin_room_index(RoomIndex& index, const PackedVector2Array& floors);
+
+// Rooms given as x, y, w, h quads; room i claims the floor cells of quad i.
+void build_rect_room_index(RoomIndex& index, const PackedVector2Array& floors, const PackedInt32Array& rects);
+
+int index_room_at(const RoomIndex& index, const Vector2i& cell);
+PackedInt32Array index_rooms_in_rect(const RoomIndex& index, const Rect2i& rect);
+// Empty for unknown rooms
+PackedInt32Array index_room_neighbours(const RoomIndex& index, int room);
+Rect2i index_room_bounds(const RoomIndex& index, int room);
+
+#endif // ROOM_INDEX_H
@@ -0,0 +1,221 @@
+#include "tile_grid_cache.h"
+#include <algorithm>
+
+void TileGridCache::reset() {
+    counted = false;
+    filled = false;
+    values.clear();
+    counts.clear();
+    buckets.clear();
+    distribution = Dictionary();
+    area_tables.clear();
+}
+
+namespace {
+
+// Clips `rect` to a width x height grid; false if nothing is left.
+bool clip_rect(const Rect2i& rect, int width, int height, int& x0, int& y0, int& x1, int& y1) {
+    int64_t left = std::max<int64_t>(rect.position.x, 0);
+    int64_t top = std::max<int64_t>(rect.position.y, 0);
+    int64_t right = std::min<int64_t>((int64_t)rect.position.x + rect.size.x, width);
+    int64_t bottom = std::min<int64_t>((int64_t)rect.position.y + rect.size.y, height);
+    if (left >= right || top >= bottom) {
+        return false;
+    }
+    x0 = (int)left;
+    y0 = (int)top;
+    x1 = (int)right;
+    y1 = (int)bottom;
+    return true;
+}
+
+} // namespace
+
+int TileGridCache::find_slot(int32_t value) const {
+    auto it = std::lower_bound(values.begin(), values.end(), value);
+    if (it == values.end() || *it != value) {
+        return -1;
+    }
+    return (int)(it - values.begin());
+}
+
+void TileGridCache::count_values(const PackedInt32Array& tiles) {
+    if (counted) {
+        return;
+    }
+    counted = true;
+
+    const int32_t* cells = tiles.ptr();
+    int64_t size = tiles.size();
+    if (size == 0) {
+        return;
+    }
+
+    auto range = std::minmax_element(cells, cells + size);
+    int64_t min_value = *range.first;
+    int64_t span = (int64_t)*range.second - min_value + 1;
+
+    if (span <= std::max<int64_t>(size, 1 << 16)) {
+        // Tile ids are usually small and dense: count into a flat table
+        std::vector<int64_t> table(span, 0);
+        for (int64_t i = 0; i < size; i++) {
+            table[cells[i] - min_value]++;
+        }
+        for (int64_t v = 0; v < span; v++) {
+            if (table[v]) {
+                values.push_back((int32_t)(v + min_value));
+                counts.push_back(table[v]);
+            }
+        }
+    } else {
+        std::vector<int32_t> sorted(cells, cells + size);
+        std::sort(sorted.begin(), sorted.end());
+        for (int64_t i = 0; i < size;) {
+            int64_t run = 1;
+            while (i + run < size && sorted[i + run] == sorted[i]) run++;
+            values.push_back(sorted[i]);
+            counts.push_back(run);
+            i += run;
+        }
+    }
+
+    for (size_t i = 0; i < values.size(); i++) {
+        distribution[values[i]] = counts[i];
+    }
+}
+
+void TileGridCache::fill_buckets(const PackedInt32Array& tiles, int width) {
+    count_values(tiles);
+    if (filled) {
+        return;
+    }
+    filled = true;
+    if (width <= 0) {
+        return;
+    }
+
+    buckets.resize(values.size());
+    std::vector<Vector2*> write(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        buckets[i].resize(counts[i]);
+        write[i] = buckets[i].ptrw();
+    }
+
+    const int32_t* cells = tiles.ptr();
+    int64_t size = tiles.size();
+    int slot = 0;
+    for (int64_t i = 0; i < size; i++) {
+        // Runs of equal tiles are common, so try the previous slot first
+        if (values[slot] != cells[i]) {
+            slot = find_slot(cells[i]);
+        }
+        *write[slot]++ = Vector2((real_t)(i % width), (real_t)(i / width));
+    }
+}
+
+PackedVector2Array TileGridCache::get_positions(const PackedInt32Array& tiles, int width, int value) {
+    fill_buckets(tiles, width);
+    int slot = find_slot(value);
+    if (slot < 0 || slot >= (int)buckets.size()) {
+        return PackedVector2Array();
+    }
+    return buckets[slot];
+}
+
+Dictionary TileGridCache::get_distribution(const PackedInt32Array& tiles) {
+    count_values(tiles);
+    // Callers may modify the returned dictionary; keep the cached one intact
+    return distribution.duplicate();
+}
+
+PackedInt32Array TileGridCache::get_region(const PackedInt32Array& tiles, int width, int height, const Rect2i& rect) {
+    PackedInt32Array region;
+    if (rect.size.x <= 0 || rect.size.y <= 0) {
+        return region;
+    }
+    region.resize((int64_t)rect.size.x * rect.size.y);
+    int32_t* out = region.ptrw();
+    std::fill(out, out + region.size(), -1);
+
+    int x0, y0, x1, y1;
+    if (tiles.size() < (int64_t)width * height || !clip_rect(rect, width, height, x0, y0, x1, y1)) {
+        return region;
+    }
+    const int32_t* cells = tiles.ptr();
+    for (int y = y0; y < y1; y++) {
+        std::copy(cells + (int64_t)y * width + x0, cells + (int64_t)y * width + x1,
+                  out + (int64_t)(y - rect.position.y) * rect.size.x + (x0 - rect.position.x));
+    }
+    return region;
+}
+
+PackedVector2Array TileGridCache::find_all(const PackedInt32Array& tiles, int width, int height, int value, const Rect2i& rect) {
+    PackedVector2Array positions;
+    int x0, y0, x1, y1;
+    if (tiles.size() < (int64_t)width * height || !clip_rect(rect, width, height, x0, y0, x1, y1)) {
+        return positions;
+    }
+
+    // Count first so the array is allocated once
+    const int32_t* cells = tiles.ptr();
+    int64_t count = 0;
+    for (int y = y0; y < y1; y++) {
+        const int32_t* row = cells + (int64_t)y * width;
+        count += std::count(row + x0, row + x1, value);
+    }
+    positions.resize(count);
+    Vector2* out = positions.ptrw();
+    for (int y = y0; y < y1 && count > 0; y++) {
+        const int32_t* row = cells + (int64_t)y * width;
+        for (int x = x0; x < x1; x++) {
+            if (row[x] == value) {
+                *out++ = Vector2((real_t)x, (real_t)y);
+            }
+        }
+    }
+    return positions;
+}
+
+int64_t TileGridCache::count_in_rect(const PackedInt32Array& tiles, int width, int height, int value, const Rect2i& rect) {
+    int x0, y0, x1, y1;
+    if (tiles.size() < (int64_t)width * height || !clip_rect(rect, width, height, x0, y0, x1, y1)) {
+        return 0;
+    }
+
+    // No table for values the grid does not hold, or for a grid of one value
+    count_values(tiles);
+    int slot = find_slot(value);
+    if (slot < 0) {
+        return 0;
+    }
+    if (values.size() == 1) {
+        return (int64_t)(x1 - x0) * (y1 - y0);
+    }
+
+    int64_t stride = (int64_t)width + 1;
+    auto found = std::find_if(area_tables.begin(), area_tables.end(),
+                              [value](const AreaTable& t) { return t.value == value; });
+    if (found == area_tables.end()) {
+        if ((int)area_tables.size() == MAX_AREA_TABLES) {
+            area_tables.pop_back();
+        }
+        std::vector<int32_t> sums(stride * (height + 1), 0);
+        const int32_t* cells = tiles.ptr();
+        for (int y = 0; y < height; y++) {
+            int32_t row_sum = 0;
+            const int32_t* row = cells + (int64_t)y * width;
+            int32_t* above = sums.data() + (int64_t)y * stride;
+            int32_t* current = above + stride;
+            for (int x = 0; x < width; x++) {
+                row_sum += row[x] == value;
+                current[x + 1] = above[x + 1] + row_sum;
+            }
+        }
+        area_tables.insert(area_tables.begin(), AreaTable{ value, std::move(sums) });
+    } else if (found != area_tables.begin()) {
+        std::rotate(area_tables.begin(), found, found + 1);
+    }
+
+    const int32_t* table = area_tables.front().sums.data();
+    return (int64_t)table[y1 * stride + x1] - table[y0 * stride + x1] - table[y1 * stride + x0] + table[y0 * stride + x0];
+}
@@ -0,0 +1,60 @@
+#ifndef TILE_GRID_CACHE_H
+#define TILE_GRID_CACHE_H
+
+#include <cstdint>
+#include <vector>
+#include <godot_cpp/variant/dictionary.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+
+using namespace godot;
+
+// ============================================================================
+// TileGridCache - Memoised per-value views of a row-major tile grid
+// ============================================================================
+// Backs the position and distribution helpers on the WFC result classes.
+// Nothing is computed until the first query; then one counting pass sizes
+// every value's bucket and one fill pass writes the positions of all values
+// at once, so later queries for any value are a lookup. Rectangle counts
+// use a summed-area table per value, built on first use; only the most
+// recently used few are kept. Call reset() whenever the grid changes.
+class TileGridCache {
+public:
+    void reset();
+
+    // Positions (x, y) of every cell equal to `value`, in row-major order.
+    PackedVector2Array get_positions(const PackedInt32Array& tiles, int width, int value);
+    // { value: count } for every value present, keys in ascending order.
+    Dictionary get_distribution(const PackedInt32Array& tiles);
+
+    // Region queries. `rect` is clipped to the grid, except by get_region,
+    // which returns rect.size.x * rect.size.y cells with -1 outside the grid.
+    static PackedInt32Array get_region(const PackedInt32Array& tiles, int width, int height, const Rect2i& rect);
+    static PackedVector2Array find_all(const PackedInt32Array& tiles, int width, int height, int value, const Rect2i& rect);
+    // O(1) after a summed-area table for `value` is built on first use.
+    // Values absent from the grid return 0 without building a table.
+    int64_t count_in_rect(const PackedInt32Array& tiles, int width, int height, int value, const Rect2i& rect);
+
+private:
+    bool counted = false;
+    bool filled = false;
+    std::vector<int32_t> values;            // distinct values, ascending
+    std::vector<int64_t> counts;            // parallel to values
+    std::vector<PackedVector2Array> buckets; // parallel to values, once filled
+    Dictionary distribution;
+    struct AreaTable {
+        int32_t value;
+        // (width + 1) * (height + 1) prefix counts, row 0 / column 0 zero
+        std::vector<int32_t> sums;
+    };
+    // Most recently used first, at most MAX_AREA_TABLES
+    static const int MAX_AREA_TABLES = 4;
+    std::vector<AreaTable> area_tables;
+
+    void count_values(const PackedInt32Array& tiles);
+    void fill_buckets(const PackedInt32Array& tiles, int width);
+    int find_slot(int32_t value) const;
+};
+
+#endif // TILE_GRID_CACHE_H
@@ -0,0 +1,60 @@
+#include "visibility.h"
+#include <vector>
+
+#include "region_analysis.h"
+
+namespace {
+
+void ensure_room_visibility(VisibilityMap& map, const RoomIndex& rooms, int threads) {
+    if (!map.hasRoomVisibility()) {
+        map.buildRoomVisibility(rooms, threads);
+    }
+}
+
+} // namespace
+
+void build_position_visibility(VisibilityMap& map, const PackedVector2Array& floors) {
+    PositionMask m = rasterize_positions(floors);
+    if (m.width == 0) {
+        map.reset(GridRect{0, 0, 0, 0}, nullptr);
+        return;
+    }
+    int width = m.width + 2, height = m.height + 2;
+    std::vector<uint8_t> opaque((size_t)width * height, 1);
+    for (int y = 0; y < m.height; y++) {
+        for (int x = 0; x < m.width; x++) {
+            opaque[(size_t)(y + 1) * width + (x + 1)] = !m.cells[(size_t)y * m.width + x];
+        }
+    }
+    map.reset(GridRect{m.min_x - 1, m.min_y - 1, width, height}, opaque.data());
+}
+
+PackedVector2Array visibility_fov(VisibilityMap& map, const Vector2i& origin, int radius) {
+    std::vector<GridPoint> cells;
+    map.computeFov(origin.x, origin.y, radius, cells);
+    PackedVector2Array result;
+    result.resize(cells.size());
+    Vector2* out = result.ptrw();
+    for (const GridPoint& p : cells) {
+        *out++ = Vector2((real_t)p.x, (real_t)p.y);
+    }
+    return result;
+}
+
+PackedInt32Array visibility_rooms(VisibilityMap& map, const RoomIndex& rooms, int room, int threads) {
+    ensure_room_visibility(map, rooms, threads);
+    std::vector<int> seen;
+    map.visibleRooms(room, seen);
+    PackedInt32Array result;
+    result.resize(seen.size());
+    int32_t* out = result.ptrw();
+    for (size_t i = 0; i < seen.size(); i++) {
+        out[i] = seen[i];
+    }
+    return result;
+}
+
+bool visibility_room_sees(VisibilityMap& map, const RoomIndex& rooms, int from, int to) {
+    ensure_room_visibility(map, rooms, 0);
+    return map.roomSees(from, to);
+}
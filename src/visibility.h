@@ -0,0 +1,29 @@
+#ifndef VISIBILITY_H
+#define VISIBILITY_H
+
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_vector2_array.hpp>
+#include <godot_cpp/variant/vector2i.hpp>
+
+#include "Visibility.h"
+
+using namespace godot;
+
+// ============================================================================
+// Shared helpers for the result classes' visibility queries (see Visibility.h)
+// ============================================================================
+
+// Opacity from the floor positions: every other cell blocks sight. The
+// area is the floors' bounding box grown by one, so the walls around the
+// edge can be lit.
+void build_position_visibility(VisibilityMap& map, const PackedVector2Array& floors);
+
+// Cells visible from `origin` (see VisibilityMap::computeFov()).
+PackedVector2Array visibility_fov(VisibilityMap& map, const Vector2i& origin, int radius);
+
+// Room table queries; the table is built on first use. Empty / false for
+// unknown rooms.
+PackedInt32Array visibility_rooms(VisibilityMap& map, const RoomIndex& rooms, int room, int threads);
+bool visibility_room_sees(VisibilityMap& map, const RoomIndex& rooms, int from, int to);
+
+#endif // VISIBILITY_H
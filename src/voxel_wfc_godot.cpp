@@ -0,0 +1,177 @@
+#include "voxel_wfc_godot.h"
+#include <godot_cpp/variant/utility_functions.hpp>
+#include <cstring>
+#include <random>
+
+#include "Parallel.h"
+
+// --- VoxelWFCResult ---
+
+VoxelWFCResult::VoxelWFCResult()
+    : success(false) {
+}
+
+void VoxelWFCResult::_set_output(const AdjacencyOutput& output) {
+    success = output.success;
+    failure_reason = String(output.failureReason.c_str());
+    if (!output.success) {
+        return;
+    }
+    size = Vector3i(output.width, output.height, output.depth);
+    cells.resize(output.cells.size());
+    memcpy(cells.ptrw(), output.cells.data(), output.cells.size() * sizeof(int32_t));
+}
+
+void VoxelWFCResult::_set_failure(const String& reason) {
+    success = false;
+    failure_reason = reason;
+}
+
+int VoxelWFCResult::get_cell(const Vector3i& cell) const {
+    if (cell.x < 0 || cell.y < 0 || cell.z < 0 || cell.x >= size.x || cell.y >= size.y || cell.z >= size.z) {
+        return -1;
+    }
+    return cells[cell.x + (int64_t)size.x * (cell.y + (int64_t)size.y * cell.z)];
+}
+
+PackedVector3Array VoxelWFCResult::get_positions_of(int tile) const {
+    PackedVector3Array out;
+    const int32_t* data = cells.ptr();
+    int64_t index = 0;
+    for (int z = 0; z < size.z; z++) {
+        for (int y = 0; y < size.y; y++) {
+            for (int x = 0; x < size.x; x++, index++) {
+                if (data[index] == tile) {
+                    out.push_back(Vector3(x, y, z));
+                }
+            }
+        }
+    }
+    return out;
+}
+
+void VoxelWFCResult::apply_to_grid_map(GridMap* grid_map, const Vector3i& offset) const {
+    if (grid_map == nullptr) {
+        UtilityFunctions::push_error("VoxelWFCResult.apply_to_grid_map: grid_map is null");
+        return;
+    }
+    const int32_t* data = cells.ptr();
+    int64_t index = 0;
+    for (int z = 0; z < size.z; z++) {
+        for (int y = 0; y < size.y; y++) {
+            for (int x = 0; x < size.x; x++, index++) {
+                grid_map->set_cell_item(offset + Vector3i(x, y, z), data[index]);
+            }
+        }
+    }
+}
+
+void VoxelWFCResult::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("is_success"), &VoxelWFCResult::is_success);
+    ClassDB::bind_method(D_METHOD("get_failure_reason"), &VoxelWFCResult::get_failure_reason);
+    ClassDB::bind_method(D_METHOD("get_size"), &VoxelWFCResult::get_size);
+    ClassDB::bind_method(D_METHOD("get_cells"), &VoxelWFCResult::get_cells);
+    ClassDB::bind_method(D_METHOD("get_cell", "cell"), &VoxelWFCResult::get_cell);
+    ClassDB::bind_method(D_METHOD("get_positions_of", "tile"), &VoxelWFCResult::get_positions_of);
+    ClassDB::bind_method(D_METHOD("apply_to_grid_map", "grid_map", "offset"),
+                         &VoxelWFCResult::apply_to_grid_map, DEFVAL(Vector3i()));
+}
+
+// --- VoxelWFCGenerator ---
+
+VoxelWFCGenerator::VoxelWFCGenerator()
+    : size(16, 8, 16), periodic(false), seed(12345), use_seed(false) {
+    problem.topology = GridTopology::Cube;
+}
+
+void VoxelWFCGenerator::set_size(const Vector3i& p_size) {
+    size = p_size;
+}
+
+void VoxelWFCGenerator::set_periodic(bool p_periodic) {
+    periodic = p_periodic;
+}
+
+void VoxelWFCGenerator::set_seed(int64_t p_seed) {
+    seed = p_seed;
+}
+
+void VoxelWFCGenerator::set_use_seed(bool p_use_seed) {
+    use_seed = p_use_seed;
+}
+
+void VoxelWFCGenerator::add_tile(int tile_id, double weight) {
+    if (!problem.addTile(tile_id, weight)) {
+        UtilityFunctions::push_error("VoxelWFCGenerator.add_tile: tile ", tile_id,
+                                     " already exists or has a weight that is not positive");
+    }
+}
+
+void VoxelWFCGenerator::add_adjacency(int tile_a, int tile_b, const Vector3i& direction) {
+    int index = cubeDirection(direction.x, direction.y, direction.z);
+    if (index < 0) {
+        UtilityFunctions::push_error("VoxelWFCGenerator.add_adjacency: direction must be a unit step, got ",
+                                     direction);
+        return;
+    }
+    if (!problem.allow(tile_a, tile_b, index)) {
+        UtilityFunctions::push_error("VoxelWFCGenerator.add_adjacency: unknown tile ", tile_a, " or ", tile_b);
+    }
+}
+
+void VoxelWFCGenerator::clear() {
+    problem = AdjacencyProblem();
+    problem.topology = GridTopology::Cube;
+}
+
+Ref<VoxelWFCResult> VoxelWFCGenerator::generate() {
+    std::random_device rd;
+    uint64_t run_seed = use_seed ? (uint64_t)seed : ((uint64_t)rd() << 32) | rd();
+
+    Ref<VoxelWFCResult> result;
+    result.instantiate();
+    result->_set_output(solveAdjacency(problem, size.x, size.y, size.z, periodic, run_seed));
+    return result;
+}
+
+Array VoxelWFCGenerator::generate_batch(const PackedInt64Array& seeds, int threads) {
+    int count = seeds.size();
+    std::vector<AdjacencyOutput> outputs(count);
+    parallelFor(count, threads, [&](int i) {
+        outputs[i] = solveAdjacency(problem, size.x, size.y, size.z, periodic, (uint64_t)seeds[i]);
+    });
+
+    Array results;
+    results.resize(count);
+    for (int i = 0; i < count; i++) {
+        Ref<VoxelWFCResult> result;
+        result.instantiate();
+        result->_set_output(outputs[i]);
+        results[i] = result;
+    }
+    return results;
+}
+
+void VoxelWFCGenerator::_bind_methods() {
+    ClassDB::bind_method(D_METHOD("set_size", "size"), &VoxelWFCGenerator::set_size);
+    ClassDB::bind_method(D_METHOD("get_size"), &VoxelWFCGenerator::get_size);
+    ClassDB::bind_method(D_METHOD("set_periodic", "periodic"), &VoxelWFCGenerator::set_periodic);
+    ClassDB::bind_method(D_METHOD("get_periodic"), &VoxelWFCGenerator::get_periodic);
+    ClassDB::bind_method(D_METHOD("set_seed", "seed"), &VoxelWFCGenerator::set_seed);
+    ClassDB::bind_method(D_METHOD("get_seed"), &VoxelWFCGenerator::get_seed);
+    ClassDB::bind_method(D_METHOD("set_use_seed", "use_seed"), &VoxelWFCGenerator::set_use_seed);
+    ClassDB::bind_method(D_METHOD("get_use_seed"), &VoxelWFCGenerator::get_use_seed);
+    ClassDB::bind_method(D_METHOD("add_tile", "tile_id", "weight"), &VoxelWFCGenerator::add_tile, DEFVAL(1.0));
+    ClassDB::bind_method(D_METHOD("add_adjacency", "tile_a", "tile_b", "direction"),
+                         &VoxelWFCGenerator::add_adjacency);
+    ClassDB::bind_method(D_METHOD("clear"), &VoxelWFCGenerator::clear);
+    ClassDB::bind_method(D_METHOD("get_tile_count"), &VoxelWFCGenerator::get_tile_count);
+    ClassDB::bind_method(D_METHOD("generate"), &VoxelWFCGenerator::generate);
+    ClassDB::bind_method(D_METHOD("generate_batch", "seeds", "threads"), &VoxelWFCGenerator::generate_batch,
+                         DEFVAL(0));
+
+    ADD_PROPERTY(PropertyInfo(Variant::VECTOR3I, "size"), "set_size", "get_size");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "periodic"), "set_periodic", "get_periodic");
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_seed"), "set_use_seed", "get_use_seed");
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
+}
@@ -0,0 +1,94 @@
+#ifndef VOXEL_WFC_GODOT_H
+#define VOXEL_WFC_GODOT_H
+
+#include <godot_cpp/classes/grid_map.hpp>
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+#include <godot_cpp/variant/vector3i.hpp>
+#include <godot_cpp/core/class_db.hpp>
+
+#include "AdjacencySolver.h"
+
+using namespace godot;
+
+// A solved voxel grid. Cell (x, y, z) is
+// get_cells()[x + size.x * (y + size.y * z)], y pointing up as in GridMap.
+class VoxelWFCResult : public RefCounted {
+    GDCLASS(VoxelWFCResult, RefCounted)
+
+private:
+    bool success;
+    String failure_reason;
+    Vector3i size;
+    PackedInt32Array cells;
+
+protected:
+    static void _bind_methods();
+
+public:
+    VoxelWFCResult();
+
+    // Internal: called by VoxelWFCGenerator
+    void _set_output(const AdjacencyOutput& output);
+    void _set_failure(const String& reason);
+
+    bool is_success() const { return success; }
+    String get_failure_reason() const { return failure_reason; }
+    Vector3i get_size() const { return size; }
+
+    // Tile ids, x fastest, then y, then z
+    PackedInt32Array get_cells() const { return cells; }
+    // -1 outside the grid
+    int get_cell(const Vector3i& cell) const;
+    PackedVector3Array get_positions_of(int tile) const;
+
+    // Writes every cell as a GridMap item (-1 clears the cell)
+    void apply_to_grid_map(GridMap* grid_map, const Vector3i& offset) const;
+};
+
+// WFC on a 3D grid with plain adjacency rules: each tile is one GridMap item
+// and fills one cell. Uses the same solver as the 2D generators, over a
+// 6-direction cube topology.
+class VoxelWFCGenerator : public RefCounted {
+    GDCLASS(VoxelWFCGenerator, RefCounted)
+
+private:
+    AdjacencyProblem problem;
+    Vector3i size;
+    bool periodic;
+    int64_t seed;
+    bool use_seed;
+
+protected:
+    static void _bind_methods();
+
+public:
+    VoxelWFCGenerator();
+
+    void set_size(const Vector3i& p_size);
+    Vector3i get_size() const { return size; }
+    void set_periodic(bool p_periodic);
+    bool get_periodic() const { return periodic; }
+    void set_seed(int64_t p_seed);
+    int64_t get_seed() const { return seed; }
+    void set_use_seed(bool p_use_seed);
+    bool get_use_seed() const { return use_seed; }
+
+    // tile_id is the GridMap item written for the tile; -1 is an empty cell.
+    void add_tile(int tile_id, double weight = 1.0);
+    // tile_b may sit at tile_a + direction, where direction is one unit step
+    // such as Vector3i(0, 1, 0) for "above". The reverse rule is implied.
+    void add_adjacency(int tile_a, int tile_b, const Vector3i& direction);
+    void clear();
+    int get_tile_count() const { return (int)problem.tileValues.size(); }
+
+    Ref<VoxelWFCResult> generate();
+    // One result per seed, solved on up to `threads` workers (0 = all cores)
+    Array generate_batch(const PackedInt64Array& seeds, int threads = 0);
+};
+
+#endif // VOXEL_WFC_GODOT_H
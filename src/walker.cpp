@@ -4,7 +4,17 @@
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 #include <algorithm>
-#include <cmath>
+#include <random>
+
+#include "Parallel.h"
+#include "acceptance.h"
+#include "autotile.h"
+#include "grid_geometry.h"
+#include "placement.h"
+#include "region_analysis.h"
+#include "result_codec.h"
+#include "room_index.h"
+#include "visibility.h"
 
 using namespace godot;
 
@@ -21,9 +31,41 @@ void WalkerResult::_bind_methods() {
     ClassDB::bind_method(D_METHOD("get_wall_positions"), &WalkerResult::get_wall_positions);
     ClassDB::bind_method(D_METHOD("get_map_width"), &WalkerResult::get_map_width);
     ClassDB::bind_method(D_METHOD("get_map_height"), &WalkerResult::get_map_height);
+    ClassDB::bind_method(D_METHOD("get_room_rects"), &WalkerResult::get_room_rects);
+    ClassDB::bind_method(D_METHOD("get_room_count"), &WalkerResult::get_room_count);
+    ClassDB::bind_method(D_METHOD("room_at", "cell"), &WalkerResult::room_at);
+    ClassDB::bind_method(D_METHOD("rooms_in_rect", "rect"), &WalkerResult::rooms_in_rect);
+    ClassDB::bind_method(D_METHOD("get_room_neighbours", "room"), &WalkerResult::get_room_neighbours);
+    ClassDB::bind_method(D_METHOD("get_room_bounds", "room"), &WalkerResult::get_room_bounds);
+    ClassDB::bind_method(D_METHOD("get_fov", "origin", "radius"), &WalkerResult::get_fov, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_visible_rooms", "room", "threads"), &WalkerResult::get_visible_rooms, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("can_room_see", "from", "to"), &WalkerResult::can_room_see);
     ClassDB::bind_method(D_METHOD("get_tilemap_positions_with_atlas", "tilemap_layer", "atlas_coords", "source_id"),
                         &WalkerResult::get_tilemap_positions_with_atlas, DEFVAL(0));
     ClassDB::bind_method(D_METHOD("get_statistics"), &WalkerResult::get_statistics);
+    ClassDB::bind_method(D_METHOD("get_floor_regions", "threads"), &WalkerResult::get_floor_regions, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_dead_end_positions"), &WalkerResult::get_dead_end_positions);
+    ClassDB::bind_method(D_METHOD("get_distance_field", "sources"), &WalkerResult::get_distance_field);
+    ClassDB::bind_method(D_METHOD("get_farthest_pair"), &WalkerResult::get_farthest_pair);
+    ClassDB::bind_method(D_METHOD("get_critical_path"), &WalkerResult::get_critical_path);
+    ClassDB::bind_method(D_METHOD("get_chokepoints"), &WalkerResult::get_chokepoints);
+    ClassDB::bind_method(D_METHOD("get_wall_rects"), &WalkerResult::get_wall_rects);
+    ClassDB::bind_method(D_METHOD("get_floor_rects"), &WalkerResult::get_floor_rects);
+    ClassDB::bind_method(D_METHOD("get_wall_contours", "epsilon"), &WalkerResult::get_wall_contours, DEFVAL(0.0));
+    ClassDB::bind_method(D_METHOD("get_floor_contours", "epsilon"), &WalkerResult::get_floor_contours, DEFVAL(0.0));
+    ClassDB::bind_method(D_METHOD("get_wall_contour_chunks", "chunk_size", "epsilon", "threads"),
+                         &WalkerResult::get_wall_contour_chunks, DEFVAL(0.0), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_floor_contour_chunks", "chunk_size", "epsilon", "threads"),
+                         &WalkerResult::get_floor_contour_chunks, DEFVAL(0.0), DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("get_wall_bitmasks", "neighbours"), &WalkerResult::get_wall_bitmasks, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_floor_bitmasks", "neighbours"), &WalkerResult::get_floor_bitmasks, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_wall_autotile", "lut", "neighbours"), &WalkerResult::get_wall_autotile, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_floor_autotile", "lut", "neighbours"), &WalkerResult::get_floor_autotile, DEFVAL(8));
+    ClassDB::bind_method(D_METHOD("get_floor_placements", "radii", "seed", "counts", "exclude", "keep_out"),
+                         &WalkerResult::get_floor_placements, DEFVAL(PackedInt32Array()), DEFVAL(PackedVector2Array()),
+                         DEFVAL(PackedVector3Array()));
+    ClassDB::bind_method(D_METHOD("to_bytes", "compress"), &WalkerResult::to_bytes, DEFVAL(true));
+    ClassDB::bind_static_method("WalkerResult", D_METHOD("from_bytes", "bytes"), &WalkerResult::from_bytes);
 }
 
 PackedVector2Array WalkerResult::get_tilemap_positions_with_atlas(Object* tilemap_layer, Vector2i atlas_coords, int source_id) const {
@@ -66,6 +108,165 @@ void WalkerResult::_set_result_data(PackedVector2Array floors, PackedVector2Arra
     wall_positions = walls;
     map_width = width;
     map_height = height;
+    room_index_built = false;
+    visibility_built = false;
+}
+
+void WalkerResult::_set_room_rects(PackedInt32Array rects) {
+    room_rects = rects;
+    room_index_built = false;
+    visibility_built = false;
+}
+
+const RoomIndex& WalkerResult::room_lookup() const {
+    if (!room_index_built) {
+        build_rect_room_index(room_index, floor_positions, room_rects);
+        room_index_built = true;
+    }
+    return room_index;
+}
+
+int WalkerResult::room_at(const Vector2i& cell) const {
+    return index_room_at(room_lookup(), cell);
+}
+
+PackedInt32Array WalkerResult::rooms_in_rect(const Rect2i& rect) const {
+    return index_rooms_in_rect(room_lookup(), rect);
+}
+
+PackedInt32Array WalkerResult::get_room_neighbours(int room) const {
+    return index_room_neighbours(room_lookup(), room);
+}
+
+Rect2i WalkerResult::get_room_bounds(int room) const {
+    return index_room_bounds(room_lookup(), room);
+}
+
+VisibilityMap& WalkerResult::visibility_map() const {
+    if (!visibility_built) {
+        build_position_visibility(visibility, floor_positions);
+        visibility_built = true;
+    }
+    return visibility;
+}
+
+PackedVector2Array WalkerResult::get_fov(const Vector2i& origin, int radius) const {
+    return visibility_fov(visibility_map(), origin, radius);
+}
+
+PackedInt32Array WalkerResult::get_visible_rooms(int room, int threads) const {
+    return visibility_rooms(visibility_map(), room_lookup(), room, threads);
+}
+
+bool WalkerResult::can_room_see(int from, int to) const {
+    return visibility_room_sees(visibility_map(), room_lookup(), from, to);
+}
+
+Dictionary WalkerResult::get_floor_regions(int threads) const {
+    return analyze_position_regions(floor_positions, threads);
+}
+
+PackedVector2Array WalkerResult::get_dead_end_positions() const {
+    return find_position_dead_ends(floor_positions);
+}
+
+PackedInt32Array WalkerResult::get_distance_field(const PackedVector2Array& sources) const {
+    return position_distance_field(floor_positions, sources);
+}
+
+PackedVector2Array WalkerResult::get_farthest_pair() const {
+    return position_farthest_pair(floor_positions);
+}
+
+PackedVector2Array WalkerResult::get_critical_path() const {
+    return position_critical_path(floor_positions);
+}
+
+PackedVector2Array WalkerResult::get_chokepoints() const {
+    return position_chokepoints(floor_positions);
+}
+
+PackedInt32Array WalkerResult::get_wall_rects() const {
+    return merge_position_rects(wall_positions);
+}
+
+PackedInt32Array WalkerResult::get_floor_rects() const {
+    return merge_position_rects(floor_positions);
+}
+
+Array WalkerResult::get_wall_contours(double epsilon) const {
+    return position_contours(wall_positions, epsilon);
+}
+
+Array WalkerResult::get_floor_contours(double epsilon) const {
+    return position_contours(floor_positions, epsilon);
+}
+
+Array WalkerResult::get_wall_contour_chunks(int chunk_size, double epsilon, int threads) const {
+    return position_contour_chunks(wall_positions, chunk_size, epsilon, threads);
+}
+
+Array WalkerResult::get_floor_contour_chunks(int chunk_size, double epsilon, int threads) const {
+    return position_contour_chunks(floor_positions, chunk_size, epsilon, threads);
+}
+
+PackedInt32Array WalkerResult::get_wall_bitmasks(int neighbours) const {
+    return position_bitmasks(wall_positions, neighbours);
+}
+
+PackedInt32Array WalkerResult::get_floor_bitmasks(int neighbours) const {
+    return position_bitmasks(floor_positions, neighbours);
+}
+
+PackedVector2Array WalkerResult::get_wall_autotile(const Dictionary& lut, int neighbours) const {
+    return position_autotile(wall_positions, lut, neighbours);
+}
+
+PackedVector2Array WalkerResult::get_floor_autotile(const Dictionary& lut, int neighbours) const {
+    return position_autotile(floor_positions, lut, neighbours);
+}
+
+Array WalkerResult::get_floor_placements(const PackedFloat32Array& radii, int64_t seed, const PackedInt32Array& counts,
+                                         const PackedVector2Array& exclude, const PackedVector3Array& keep_out) const {
+    return position_poisson(floor_positions, radii, seed, counts, exclude, keep_out);
+}
+
+PackedByteArray WalkerResult::to_bytes(bool compress) const {
+    ByteWriter body;
+    body.putVarU(map_width);
+    body.putVarU(map_height);
+    const PackedVector2Array* layers[] = {&floor_positions, &wall_positions};
+    write_position_layers(body, layers, 2);
+    write_rect_list(body, room_rects);
+    return make_result_blob(MapAlgorithm::Walker, body, compress);
+}
+
+Ref<WalkerResult> WalkerResult::from_bytes(const PackedByteArray& bytes) {
+    std::vector<uint8_t> scratch;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    if (!open_result_blob(bytes, MapAlgorithm::Walker, "WalkerResult", scratch, data, size)) {
+        return Ref<WalkerResult>();
+    }
+
+    ByteReader in(data, size);
+    int width = (int)in.getVarU();
+    int height = (int)in.getVarU();
+    PackedVector2Array floors, walls;
+    PackedInt32Array room_rects;
+    PackedVector2Array* layers[] = {&floors, &walls};
+    // Blobs written before rooms were stored end after the positions
+    if (!read_position_layers(in, layers, 2) || !in.ok() ||
+        (in.remaining() > 0 && !read_rect_list(in, room_rects))) {
+        UtilityFunctions::push_error("WalkerResult.from_bytes: blob is corrupt");
+        return Ref<WalkerResult>();
+    }
+
+    Ref<WalkerResult> result;
+    result.instantiate();
+    result->_set_result_data(floors, walls, width, height);
+    result->_set_room_rects(room_rects);
+    return result;
 }
 
 // ============================================================================
@@ -74,8 +275,7 @@ void WalkerResult::_set_result_data(PackedVector2Array floors, PackedVector2Arra
 
 WalkerDungeonGenerator::WalkerDungeonGenerator()
     : allow_overlap(false), min_hall(3), max_hall(6), room_dim(5),
-      total_floor_count(200), seed(0), use_seed(false), map_size(0, 0) {
-    rng.seed(std::random_device{}());
+      total_floor_count(200), seed(0), use_seed(false) {
 }
 
 WalkerDungeonGenerator::~WalkerDungeonGenerator() {}
@@ -103,8 +303,14 @@ void WalkerDungeonGenerator::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_use_seed", "use_seed"), &WalkerDungeonGenerator::set_use_seed);
     ClassDB::bind_method(D_METHOD("get_use_seed"), &WalkerDungeonGenerator::get_use_seed);
 
+    ClassDB::bind_method(D_METHOD("set_acceptance", "acceptance"), &WalkerDungeonGenerator::set_acceptance);
+    ClassDB::bind_method(D_METHOD("get_acceptance"), &WalkerDungeonGenerator::get_acceptance);
+
     // Generation method
     ClassDB::bind_method(D_METHOD("generate"), &WalkerDungeonGenerator::generate);
+    ClassDB::bind_method(D_METHOD("generate_batch", "seeds", "threads"), &WalkerDungeonGenerator::generate_batch, DEFVAL(0));
+    ClassDB::bind_method(D_METHOD("generate_accepted", "max_attempts", "threads"),
+                         &WalkerDungeonGenerator::generate_accepted, DEFVAL(32), DEFVAL(0));
 
     // Properties for inspector
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "allow_overlap"), "set_allow_overlap", "get_allow_overlap");
@@ -114,6 +320,7 @@ void WalkerDungeonGenerator::_bind_methods() {
     ADD_PROPERTY(PropertyInfo(Variant::INT, "total_floor_count", PROPERTY_HINT_RANGE, "50,5000,10"), "set_total_floor_count", "get_total_floor_count");
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_seed"), "set_use_seed", "get_use_seed");
     ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
+    ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "acceptance"), "set_acceptance", "get_acceptance");
 }
 
 void WalkerDungeonGenerator::set_allow_overlap(bool p_allow_overlap) {
@@ -136,7 +343,7 @@ void WalkerDungeonGenerator::set_total_floor_count(int p_total_floor_count) {
     total_floor_count = std::max(50, p_total_floor_count);
 }
 
-void WalkerDungeonGenerator::set_seed(int p_seed) {
+void WalkerDungeonGenerator::set_seed(int64_t p_seed) {
     seed = p_seed;
 }
 
@@ -144,276 +351,122 @@ void WalkerDungeonGenerator::set_use_seed(bool p_use_seed) {
     use_seed = p_use_seed;
 }
 
-void WalkerDungeonGenerator::calculate_map_size() {
-    float fill_ratio = allow_overlap ? 0.50f : 0.65f;
-    int total_tiles_needed = (int)(total_floor_count / fill_ratio);
-    int side_length = (int)std::sqrt(total_tiles_needed) + (allow_overlap ? 15 : 10);
-    side_length = std::max(side_length, (allow_overlap ? 30 : 20));
-    map_size = Vector2i(side_length, side_length);
+void WalkerDungeonGenerator::set_acceptance(const Dictionary& p_acceptance) {
+    acceptance = p_acceptance;
 }
 
-Vector2i WalkerDungeonGenerator::random_direction(Vector2i current) {
-    static const std::vector<Vector2i> directions = {
-        Vector2i(0, -1), Vector2i(0, 1), Vector2i(-1, 0), Vector2i(1, 0)
-    };
-
-    Vector2i dir;
-    int tries = 0;
-    do {
-        dir = directions[randi_range(0, directions.size() - 1)];
-        tries++;
-    } while (allow_overlap && current.x != 0 && current.y != 0 &&
-             dir.x == -current.x && dir.y == -current.y && tries < 10);
-
-    return dir;
+WalkerSettings WalkerDungeonGenerator::make_settings(uint64_t p_seed) const {
+    WalkerSettings settings;
+    settings.allowOverlap = allow_overlap;
+    settings.minHall = min_hall;
+    settings.maxHall = max_hall;
+    settings.roomDim = room_dim;
+    settings.totalFloorCount = total_floor_count;
+    settings.seed = p_seed;
+    return settings;
 }
 
-int WalkerDungeonGenerator::randi_range(int from, int to) {
-    if (from > to) {
-        std::swap(from, to);
-    }
-    return std::uniform_int_distribution<>(from, to)(rng);
-}
+Ref<WalkerResult> WalkerDungeonGenerator::make_result(const WalkerBuilder& builder) {
+    // Convert to Godot arrays
+    const std::vector<WalkerVec2i>& floors = builder.getFloors();
+    const std::vector<WalkerVec2i>& walls = builder.getWalls();
 
-bool WalkerDungeonGenerator::room_overlaps_existing(Vector2i center, int width, int height) {
-    if (allow_overlap) {
-        return false;
+    PackedVector2Array floor_array;
+    floor_array.resize(floors.size());
+    for (size_t i = 0; i < floors.size(); i++) {
+        floor_array[i] = Vector2(floors[i].x, floors[i].y);
     }
 
-    int margin = 1;
-    for (const auto& existing : rooms) {
-        if (center.x - width / 2 - margin < existing.center.x + existing.width / 2 &&
-            center.x + width / 2 + margin > existing.center.x - existing.width / 2 &&
-            center.y - height / 2 - margin < existing.center.y + existing.height / 2 &&
-            center.y + height / 2 + margin > existing.center.y - existing.height / 2) {
-            return true;
-        }
-    }
-    return false;
-}
-
-void WalkerDungeonGenerator::spawn_walker() {
-    Vector2i start;
-    if (floor_tiles.empty()) {
-        start = Vector2i(map_size.x / 2, map_size.y / 2);
-        floor_tiles.insert(start);
-    } else {
-        auto it = floor_tiles.begin();
-        std::advance(it, randi_range(0, floor_tiles.size() - 1));
-        start = *it;
+    PackedVector2Array wall_array;
+    wall_array.resize(walls.size());
+    for (size_t i = 0; i < walls.size(); i++) {
+        wall_array[i] = Vector2(walls[i].x, walls[i].y);
     }
 
-    walkers.push_back({start, random_direction(), Vector2i(0, 0)});
-}
-
-void WalkerDungeonGenerator::place_organic_room(Vector2i center, int w, int h) {
-    float rx = std::max(1.f, w / 2.f);
-    float ry = std::max(1.f, h / 2.f);
-
-    for (int y = -(int)std::ceil(ry); y <= (int)std::ceil(ry); ++y) {
-        for (int x = -(int)std::ceil(rx); x <= (int)std::ceil(rx); ++x) {
-            float nx = x / rx;
-            float ny = y / ry;
-            if (nx * nx + ny * ny <= 1.0f &&
-                randi_range(0, 100) > (int)((1.0f - std::sqrt(nx * nx + ny * ny)) * 20)) {
-                Vector2i pos = center + Vector2i(x, y);
-                if (pos.x > 0 && pos.x < map_size.x - 1 &&
-                    pos.y > 0 && pos.y < map_size.y - 1) {
-                    floor_tiles.insert(pos);
-                }
-            }
-        }
+    Ref<WalkerResult> result;
+    result.instantiate();
+    result->_set_result_data(floor_array, wall_array, builder.getMapWidth(), builder.getMapHeight());
+
+    // Rooms are stored as centre and half extents
+    const std::vector<WalkerRoom>& rooms = builder.getRooms();
+    PackedInt32Array rects;
+    rects.resize(rooms.size() * 4);
+    int32_t* r = rects.ptrw();
+    for (const WalkerRoom& room : rooms) {
+        *r++ = room.center.x - room.width;
+        *r++ = room.center.y - room.height;
+        *r++ = room.width * 2 + 1;
+        *r++ = room.height * 2 + 1;
     }
+    result->_set_room_rects(rects);
+    return result;
 }
 
-bool WalkerDungeonGenerator::try_place_room(Vector2i center) {
-    for (int i = 0; i < 3; ++i) {
-        int d = std::max(3, room_dim - i * 2);
-        int rx = randi_range(1, d / 2 + 1);
-        int ry = randi_range(1, d / 2 + 1);
-
-        if (allow_overlap && randi_range(0, 100) < 70) {
-            place_organic_room(center, rx * 2, ry * 2);
-            return true;
-        }
-
-        if (center.x - rx <= 0 || center.x + rx >= map_size.x - 1 ||
-            center.y - ry <= 0 || center.y + ry >= map_size.y - 1) {
-            continue;
-        }
-
-        if (!allow_overlap && room_overlaps_existing(center, rx, ry)) {
-            continue;
-        }
-
-        for (int x = -rx; x <= rx; ++x) {
-            for (int y = -ry; y <= ry; ++y) {
-                floor_tiles.insert(center + Vector2i(x, y));
-            }
-        }
+Ref<WalkerResult> WalkerDungeonGenerator::generate() {
+    std::random_device rd;
+    uint64_t run_seed = use_seed ? (uint64_t)seed : ((uint64_t)rd() << 32) | rd();
 
-        if (!allow_overlap) {
-            rooms.push_back({center, rx, ry});
-        }
-        return true;
-    }
-    return false;
+    WalkerBuilder builder;
+    builder.generate(make_settings(run_seed));
+    return make_result(builder);
 }
 
-void WalkerDungeonGenerator::simulate_walkers() {
-    Vector2i start(map_size.x / 2, map_size.y / 2);
-    floor_tiles.insert(start);
-
-    if (!allow_overlap) {
-        try_place_room(start);
-    } else {
-        for (int i = 0; i < 3; i++) {
-            spawn_walker();
-        }
+Array WalkerDungeonGenerator::generate_batch(const PackedInt64Array& seeds, int threads) {
+    int count = seeds.size();
+    std::vector<WalkerSettings> settings(count);
+    for (int i = 0; i < count; i++) {
+        settings[i] = make_settings((uint64_t)seeds[i]);
     }
 
-    int attempts = 0;
-    const int max_attempts = allow_overlap ? 150000 : 50000;
-
-    while (floor_tiles.size() < (size_t)total_floor_count && attempts++ < max_attempts) {
-        if (allow_overlap) {
-            std::vector<Walker> next_gen;
-            if (walkers.empty()) {
-                spawn_walker();
-            }
-
-            for (auto& w : walkers) {
-                Vector2i new_pos = w.position + w.direction;
-                if (new_pos.x > 0 && new_pos.x < map_size.x - 1 &&
-                    new_pos.y > 0 && new_pos.y < map_size.y - 1) {
-                    floor_tiles.insert(new_pos);
-                    w.position = new_pos;
-                    w.last_direction = w.direction;
-
-                    // Widen corridors occasionally
-                    if (randi_range(0, 100) < 10) {
-                        Vector2i perp(w.direction.y, w.direction.x);
-                        floor_tiles.insert(new_pos + perp);
-                        floor_tiles.insert(new_pos - perp);
-                    }
-
-                    // Change direction
-                    if (randi_range(0, 100) < 15) {
-                        w.direction = random_direction(w.last_direction);
-                    }
-
-                    // Spawn new walker
-                    if (randi_range(0, 100) < 10 && walkers.size() < 50) {
-                        next_gen.push_back({w.position, random_direction(w.last_direction), w.last_direction});
-                    }
-
-                    // Place organic room
-                    if (randi_range(0, 100) < 7) {
-                        place_organic_room(w.position,
-                                         randi_range(room_dim / 2, room_dim),
-                                         randi_range(room_dim / 2, room_dim));
-                    }
-
-                    next_gen.push_back(w);
-                }
-            }
-            walkers = next_gen;
-        } else {
-            // Non-overlap mode: single walker with rooms
-            Vector2i cur_pos = start;
-            if (!rooms.empty() && randi_range(0, 100) < 70) {
-                cur_pos = rooms[randi_range(0, rooms.size() - 1)].center;
-            } else if (!floor_tiles.empty()) {
-                auto it = floor_tiles.begin();
-                std::advance(it, randi_range(0, floor_tiles.size() - 1));
-                cur_pos = *it;
-            }
-
-            Vector2i dir = random_direction();
-            int len = randi_range(min_hall, max_hall);
-            for (int i = 0; i < len; ++i) {
-                Vector2i next = cur_pos + dir;
-                if (next.x > 1 && next.x < map_size.x - 2 &&
-                    next.y > 1 && next.y < map_size.y - 2) {
-                    floor_tiles.insert(next);
-                    cur_pos = next;
-                } else {
-                    dir = random_direction(dir);
-                    next = cur_pos + dir;
-                    if (next.x > 1 && next.x < map_size.x - 2 &&
-                        next.y > 1 && next.y < map_size.y - 2) {
-                        floor_tiles.insert(next);
-                        cur_pos = next;
-                    } else {
-                        break;
-                    }
-                }
-            }
-            try_place_room(cur_pos);
-        }
+    // Builders are independent; only the Godot objects are created afterwards
+    // on the calling thread.
+    std::vector<WalkerBuilder> builders(count);
+    parallelFor(count, threads, [&](int i) {
+        builders[i].generate(settings[i]);
+    });
+
+    Array results;
+    results.resize(count);
+    for (int i = 0; i < count; i++) {
+        results[i] = make_result(builders[i]);
     }
+    return results;
 }
 
-void WalkerDungeonGenerator::generate_walls() {
-    walls.clear();
-
-    // Check 4 directions (N/S/E/W) around each floor tile
-    std::vector<Vector2i> neighbors = {
-        Vector2i(1, 0), Vector2i(-1, 0),
-        Vector2i(0, 1), Vector2i(0, -1)
-    };
-
-    for (const Vector2i& tile : floor_tiles) {
-        for (const Vector2i& offset : neighbors) {
-            Vector2i n = tile + offset;
-            if (floor_tiles.find(n) == floor_tiles.end()) {
-                walls.insert(n);
-            }
-        }
+Dictionary WalkerDungeonGenerator::generate_accepted(int max_attempts, int threads) {
+    AcceptanceCriteria criteria;
+    if (!read_acceptance(acceptance, "WalkerDungeonGenerator", criteria)) {
+        return Dictionary();
     }
+    std::random_device rd;
+    uint64_t base_seed = use_seed ? (uint64_t)seed : ((uint64_t)rd() << 32) | rd();
+
+    // One builder per slot; only the accepted one becomes a Godot object
+    std::vector<WalkerBuilder> builders(acceptanceSlotCount(max_attempts, threads));
+    AcceptedCandidate found = firstAccepted(max_attempts, threads, [&](int candidate, int slot) {
+        WalkerBuilder& builder = builders[slot];
+        builder.generate(make_settings(base_seed + candidate));
+        FloorMask mask;
+        rasterizePoints(builder.getFloors(), mask);
+        return acceptsMap(criteria, mask, (int)builder.getRooms().size());
+    });
+
+    Variant result = found.index >= 0 ? Variant(make_result(builders[found.slot])) : Variant();
+    return make_acceptance_report(result, found, (int64_t)base_seed);
 }
 
-Ref<WalkerResult> WalkerDungeonGenerator::generate() {
-    // Initialize RNG
-    if (use_seed) {
-        rng.seed(seed);
-    } else {
-        rng.seed(std::random_device{}());
-    }
-
-    // Clear previous state
-    walkers.clear();
-    floor_tiles.clear();
-    rooms.clear();
-    walls.clear();
-
-    // Calculate map size based on parameters
-    calculate_map_size();
-
-    // Generate dungeon
-    simulate_walkers();
-    generate_walls();
-
-    // Convert to Godot arrays
-    PackedVector2Array floor_array;
-    PackedVector2Array wall_array;
-
-    floor_array.resize(floor_tiles.size());
-    int idx = 0;
-    for (const Vector2i& pos : floor_tiles) {
-        floor_array[idx++] = Vector2(pos.x, pos.y);
-    }
-
-    wall_array.resize(walls.size());
-    idx = 0;
-    for (const Vector2i& pos : walls) {
-        wall_array[idx++] = Vector2(pos.x, pos.y);
-    }
-
-    // Create result
-    Ref<WalkerResult> result;
-    result.instantiate();
-    result->_set_result_data(floor_array, wall_array, map_size.x, map_size.y);
-
-    return result;
+LevelJob WalkerDungeonGenerator::make_level_job() const {
+    WalkerSettings base = make_settings(0);
+    return [base](uint64_t level_seed) {
+        WalkerSettings settings = base;
+        settings.seed = level_seed;
+        WalkerBuilder builder;
+        builder.generate(settings);
+
+        MapRecord record;
+        record.seed = level_seed;
+        record.algorithm = MapAlgorithm::Walker;
+        rasterizeMap(builder.getFloors(), builder.getWalls(), record);
+        return record;
+    };
 }
@@ -8,10 +8,18 @@
 #include <godot_cpp/variant/vector2i.hpp>
 #include <godot_cpp/variant/dictionary.hpp>
 #include <godot_cpp/variant/string.hpp>
-
-#include <vector>
-#include <unordered_set>
-#include <random>
+#include <godot_cpp/variant/packed_int32_array.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <godot_cpp/variant/packed_int64_array.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/rect2i.hpp>
+
+#include "MultiLevel.h"
+#include "RoomIndex.h"
+#include "Visibility.h"
+#include "WalkerBuilder.h"
 
 using namespace godot;
 
@@ -24,9 +32,19 @@ class WalkerResult : public RefCounted {
 private:
     PackedVector2Array floor_positions;
     PackedVector2Array wall_positions;
+    PackedInt32Array room_rects; // x, y, w, h per room
     int map_width;
     int map_height;
 
+    // Built on the first room query
+    mutable RoomIndex room_index;
+    mutable bool room_index_built = false;
+    const RoomIndex& room_lookup() const;
+
+    mutable VisibilityMap visibility;
+    mutable bool visibility_built = false;
+    VisibilityMap& visibility_map() const;
+
 protected:
     static void _bind_methods();
 
@@ -39,6 +57,19 @@ public:
     PackedVector2Array get_wall_positions() const { return wall_positions; }
     int get_map_width() const { return map_width; }
     int get_map_height() const { return map_height; }
+    PackedInt32Array get_room_rects() const { return room_rects; }
+    int get_room_count() const { return room_rects.size() / 4; }
+
+    // Room lookup (see room_index.h)
+    int room_at(const Vector2i& cell) const;
+    PackedInt32Array rooms_in_rect(const Rect2i& rect) const;
+    PackedInt32Array get_room_neighbours(int room) const;
+    Rect2i get_room_bounds(int room) const;
+
+    // Visibility (see visibility.h)
+    PackedVector2Array get_fov(const Vector2i& origin, int radius) const;
+    PackedInt32Array get_visible_rooms(int room, int threads) const;
+    bool can_room_see(int from, int to) const;
 
     // Query TileMapLayer for positions matching specific atlas coords
     PackedVector2Array get_tilemap_positions_with_atlas(Object* tilemap_layer, Vector2i atlas_coords, int source_id = 0) const;
@@ -46,8 +77,39 @@ public:
     // Statistics
     Dictionary get_statistics() const;
 
+    // Region analysis (see region_analysis.h)
+    Dictionary get_floor_regions(int threads = 0) const;
+    PackedVector2Array get_dead_end_positions() const;
+    PackedInt32Array get_distance_field(const PackedVector2Array& sources) const;
+    PackedVector2Array get_farthest_pair() const;
+    PackedVector2Array get_critical_path() const;
+    PackedVector2Array get_chokepoints() const;
+
+    // Shapes (see grid_geometry.h)
+    PackedInt32Array get_wall_rects() const;
+    PackedInt32Array get_floor_rects() const;
+    Array get_wall_contours(double epsilon) const;
+    Array get_floor_contours(double epsilon) const;
+    Array get_wall_contour_chunks(int chunk_size, double epsilon, int threads) const;
+    Array get_floor_contour_chunks(int chunk_size, double epsilon, int threads) const;
+
+    // Autotiling (see autotile.h)
+    PackedInt32Array get_wall_bitmasks(int neighbours) const;
+    PackedInt32Array get_floor_bitmasks(int neighbours) const;
+    PackedVector2Array get_wall_autotile(const Dictionary& lut, int neighbours) const;
+    PackedVector2Array get_floor_autotile(const Dictionary& lut, int neighbours) const;
+
+    // Placement (see placement.h)
+    Array get_floor_placements(const PackedFloat32Array& radii, int64_t seed, const PackedInt32Array& counts,
+                               const PackedVector2Array& exclude, const PackedVector3Array& keep_out) const;
+
+    // Compact serialization (see result_codec.h)
+    PackedByteArray to_bytes(bool compress = true) const;
+    static Ref<WalkerResult> from_bytes(const PackedByteArray& bytes);
+
     // Internal setters (used by generator)
     void _set_result_data(PackedVector2Array floors, PackedVector2Array walls, int width, int height);
+    void _set_room_rects(PackedInt32Array rects);
 };
 
 // ============================================================================
@@ -63,46 +125,12 @@ private:
     int max_hall;
     int room_dim;
     int total_floor_count;
-    int seed;
+    int64_t seed;
     bool use_seed;
+    Dictionary acceptance;
 
-    // Generation state
-    Vector2i map_size;
-    std::mt19937 rng;
-
-    // Internal data structures
-    struct Room {
-        Vector2i center;
-        int width, height;
-    };
-
-    struct Walker {
-        Vector2i position;
-        Vector2i direction;
-        Vector2i last_direction;
-    };
-
-    struct Vector2iHash {
-        size_t operator()(const Vector2i& v) const {
-            return std::hash<int>()(v.x) ^ (std::hash<int>()(v.y) << 1);
-        }
-    };
-
-    std::unordered_set<Vector2i, Vector2iHash> floor_tiles;
-    std::unordered_set<Vector2i, Vector2iHash> walls;
-    std::vector<Room> rooms;
-    std::vector<Walker> walkers;
-
-    // Internal methods
-    void calculate_map_size();
-    Vector2i random_direction(Vector2i current = Vector2i(0, 0));
-    int randi_range(int from, int to);
-    bool room_overlaps_existing(Vector2i center, int width, int height);
-    void simulate_walkers();
-    void place_organic_room(Vector2i center, int base_width, int base_height);
-    bool try_place_room(Vector2i center);
-    void spawn_walker();
-    void generate_walls();
+    WalkerSettings make_settings(uint64_t p_seed) const;
+    static Ref<WalkerResult> make_result(const WalkerBuilder& builder);
 
 protected:
     static void _bind_methods();
@@ -127,14 +155,34 @@ public:
     void set_total_floor_count(int p_total_floor_count);
     int get_total_floor_count() const { return total_floor_count; }
 
-    void set_seed(int p_seed);
-    int get_seed() const { return seed; }
+    void set_seed(int64_t p_seed);
+    int64_t get_seed() const { return seed; }
 
     void set_use_seed(bool p_use_seed);
     bool get_use_seed() const { return use_seed; }
 
+    // Limits for generate_accepted(), e.g. { "min_floor_ratio": 0.3,
+    // "max_regions": 1 } (see acceptance.h for the keys)
+    void set_acceptance(const Dictionary& p_acceptance);
+    Dictionary get_acceptance() const { return acceptance; }
+
     // Generation
     Ref<WalkerResult> generate();
+
+    // Generates one result per seed (as if use_seed were set) on up to
+    // `threads` workers (0 = all cores). Results are returned in seed order.
+    Array generate_batch(const PackedInt64Array& seeds, int threads = 0);
+
+    // Generates seeds seed, seed + 1, ... (from a random base unless
+    // use_seed is set) on up to `threads` workers and checks each natively
+    // against the acceptance limits. Returns { result, seed, attempts } for
+    // the first seed that passes; result is null if none of `max_attempts`
+    // did. The floor ratio is taken over the floors' bounding box.
+    Dictionary generate_accepted(int max_attempts = 32, int threads = 0);
+
+    // Snapshot of the current settings as a native job for
+    // MultiLevelDungeonGenerator; the level's seed replaces `seed`.
+    LevelJob make_level_job() const;
 };
 
 #endif // WALKER_H
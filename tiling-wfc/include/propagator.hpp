@@ -1,9 +1,10 @@
 #ifndef FAST_WFC_PROPAGATOR_HPP_
 #define FAST_WFC_PROPAGATOR_HPP_
 
-#include "direction.hpp"
-#include "utils/array3D.hpp"
+#include "topology.hpp"
+#include "utils/array2D.hpp"
 #include <tuple>
+#include <utility>
 #include <vector>
 #include <array>
 
@@ -11,10 +12,13 @@ class Wave;
 
 /**
  * Propagate information about patterns in the wave.
+ * Instantiated for SquareTopology, CubeTopology and HexTopology.
  */
-class Propagator {
+template <typename Topology> class BasicPropagator {
 public:
-  using PropagatorState = std::vector<std::array<std::vector<unsigned>, 4>>;
+  static constexpr unsigned nb_directions = Topology::directions;
+  using PropagatorState =
+      std::vector<std::array<std::vector<unsigned>, nb_directions>>;
 
 private:
   /**
@@ -29,31 +33,26 @@ private:
   PropagatorState propagator_state;
 
   /**
-   * The wave width and height.
+   * neighbours[cell * nb_directions + direction] is the cell next to cell
+   * in that direction, or -1 past the edge of a non-periodic wave.
    */
-  const unsigned wave_width;
-  const unsigned wave_height;
+  std::vector<int> neighbours;
 
   /**
-   * True if the wave and the output is toric.
-   */
-  const bool periodic_output;
-
-  /**
-   * All the tuples (y, x, pattern) that should be propagated.
-   * The tuple should be propagated when wave.get(y, x, pattern) is set to
+   * All the pairs (cell, pattern) that should be propagated.
+   * The pair should be propagated when wave.get(cell, pattern) is set to
    * false.
    */
-  std::vector<std::tuple<unsigned, unsigned, unsigned>> propagating;
+  std::vector<std::pair<unsigned, unsigned>> propagating;
 
   /**
-   * compatible.get(y, x, pattern)[direction] contains the number of patterns
-   * present in the wave that can be placed in the cell next to (y,x) in the
-   * opposite direction of direction without being in contradiction with pattern
-   * placed in (y,x). If wave.get(y, x, pattern) is set to false, then
-   * compatible.get(y, x, pattern) has every element negative or null
+   * compatible.get(cell, pattern)[direction] contains the number of patterns
+   * present in the wave that can be placed in the cell next to cell in the
+   * opposite direction of direction without being in contradiction with
+   * pattern placed in cell. If wave.get(cell, pattern) is set to false, then
+   * compatible.get(cell, pattern) has every element negative or null
    */
-  Array3D<std::array<int, 4>> compatible;
+  Array2D<std::array<int, nb_directions>> compatible;
 
   /**
    * Initialize compatible.
@@ -62,26 +61,33 @@ private:
 
 public:
   /**
-   * Constructor building the propagator and initializing compatible.
+   * Constructor building the propagator, its neighbour table and
+   * initializing compatible.
    */
-  Propagator(unsigned wave_height, unsigned wave_width, bool periodic_output,
-             PropagatorState propagator_state) noexcept
+  BasicPropagator(const Topology &topology,
+                  PropagatorState propagator_state) noexcept
       : patterns_size(propagator_state.size()),
-        propagator_state(propagator_state), wave_width(wave_width),
-        wave_height(wave_height), periodic_output(periodic_output),
-        compatible(wave_height, wave_width, patterns_size) {
+        propagator_state(propagator_state),
+        neighbours(topology.size() * nb_directions),
+        compatible(topology.size(), patterns_size) {
+    for (unsigned cell = 0; cell < topology.size(); cell++) {
+      for (unsigned direction = 0; direction < nb_directions; direction++) {
+        neighbours[cell * nb_directions + direction] =
+            topology.neighbour(cell, direction);
+      }
+    }
     init_compatible();
   }
 
   /**
    * Add an element to the propagator.
-   * This function is called when wave.get(y, x, pattern) is set to false.
+   * This function is called when wave.get(cell, pattern) is set to false.
    */
-  void add_to_propagator(unsigned y, unsigned x, unsigned pattern) noexcept {
-    // All the direction are set to 0, since the pattern cannot be set in (y,x).
-    std::array<int, 4> temp = {};
-    compatible.get(y, x, pattern) = temp;
-    propagating.emplace_back(y, x, pattern);
+  void add_to_propagator(unsigned cell, unsigned pattern) noexcept {
+    // All the direction are set to 0, since the pattern cannot be set in cell.
+    std::array<int, nb_directions> temp = {};
+    compatible.get(cell, pattern) = temp;
+    propagating.emplace_back(cell, pattern);
   }
 
   /**
@@ -90,4 +96,6 @@ public:
   void propagate(Wave &wave) noexcept;
 };
 
+using Propagator = BasicPropagator<SquareTopology>;
+
 #endif // FAST_WFC_PROPAGATOR_HPP_
@@ -219,10 +219,10 @@ public:
    */
   unsigned width;
 
-private:
-
   /**
    * Generate mapping from id to oriented tiles and vice versa.
+   * This and the two helpers below are public so that callers running many
+   * solves over one tile set can build the generic WFC input only once.
    */
   static std::pair<std::vector<std::pair<unsigned, unsigned>>,
                    std::vector<std::vector<unsigned>>>
@@ -322,6 +322,8 @@ private:
     return frequencies;
   }
 
+private:
+
   /**
    * Translate the generic WFC result into the image result
    */
@@ -360,15 +362,15 @@ public:
       const std::vector<std::tuple<unsigned, unsigned, unsigned, unsigned>>
           &neighbors,
       const unsigned height, const unsigned width,
-      const TilingWFCOptions &options, int seed)
+      const TilingWFCOptions &options, uint64_t seed)
       : tiles(tiles),
         id_to_oriented_tile(generate_oriented_tile_ids(tiles).first),
         oriented_tile_ids(generate_oriented_tile_ids(tiles).second),
         options(options),
-        wfc(options.periodic_output, seed, get_tiles_weights(tiles),
+        wfc(SquareTopology{width, height, options.periodic_output}, seed,
+            get_tiles_weights(tiles),
             generate_propagator(neighbors, tiles, id_to_oriented_tile,
-                                oriented_tile_ids),
-            height, width),
+                                oriented_tile_ids)),
         height(height), width(width) {}
 
   /**
@@ -396,6 +398,24 @@ public:
     }
     return id_to_tiling(*a);
   }
+
+  /**
+   * Record the decisions of run() into log (see WFC::set_decision_log).
+   */
+  void record_decisions(std::vector<WFCDecision> *log) noexcept {
+    wfc.set_decision_log(log);
+  }
+
+  /**
+   * Rebuild the result of a recorded run (see WFC::replay).
+   */
+  std::optional<Array2D<T>> replay(const std::vector<WFCDecision> &log) {
+    auto a = wfc.replay(log);
+    if (a == std::nullopt) {
+      return std::nullopt;
+    }
+    return id_to_tiling(*a);
+  }
 };
 
 #endif // FAST_WFC_TILING_WFC_HPP_
@@ -0,0 +1,109 @@
+#ifndef FAST_WFC_TOPOLOGY_HPP_
+#define FAST_WFC_TOPOLOGY_HPP_
+
+#include "direction.hpp"
+#include "utils/array2D.hpp"
+#include "utils/array3D.hpp"
+
+/**
+ * A topology describes the cells of the wave and how they touch.
+ *
+ * Cells are numbered with x varying fastest, then y, then z. Every topology
+ * has a fixed number of directions, ordered so that the opposite of
+ * direction d is always (directions - 1 - d). neighbour() is only called
+ * while the propagator builds its neighbour table, so it may be slow;
+ * propagation itself never wraps coordinates.
+ */
+
+/**
+ * Wrap or clip one coordinate. Return -1 when c leaves a non-periodic grid.
+ */
+constexpr int wrap_coordinate(int c, int extent, bool periodic) noexcept {
+  if (c >= 0 && c < extent) {
+    return c;
+  }
+  if (!periodic) {
+    return -1;
+  }
+  return (c % extent + extent) % extent;
+}
+
+/**
+ * The 2D grid: 4 directions, as in direction.hpp.
+ */
+struct SquareTopology {
+  static constexpr unsigned directions = 4;
+  using Output = Array2D<unsigned>;
+
+  unsigned width;
+  unsigned height;
+  bool periodic;
+
+  unsigned size() const noexcept { return width * height; }
+  Output make_output() const noexcept { return Output(height, width); }
+
+  int neighbour(unsigned cell, unsigned direction) const noexcept {
+    int x = wrap_coordinate((int)(cell % width) + directions_x[direction], width, periodic);
+    int y = wrap_coordinate((int)(cell / width) + directions_y[direction], height, periodic);
+    return x < 0 || y < 0 ? -1 : y * (int)width + x;
+  }
+};
+
+/**
+ * The 3D voxel grid: 6 directions, -z, -y, -x, +x, +y, +z.
+ */
+constexpr int cube_directions_x[6] = {0, 0, -1, 1, 0, 0};
+constexpr int cube_directions_y[6] = {0, -1, 0, 0, 1, 0};
+constexpr int cube_directions_z[6] = {-1, 0, 0, 0, 0, 1};
+
+struct CubeTopology {
+  static constexpr unsigned directions = 6;
+  using Output = Array3D<unsigned>;
+
+  unsigned width;
+  unsigned height;
+  unsigned depth;
+  bool periodic;
+
+  unsigned size() const noexcept { return width * height * depth; }
+  Output make_output() const noexcept { return Output(depth, height, width); }
+
+  int neighbour(unsigned cell, unsigned direction) const noexcept {
+    int x = wrap_coordinate((int)(cell % width) + cube_directions_x[direction], width, periodic);
+    int y = wrap_coordinate((int)(cell / width % height) + cube_directions_y[direction], height, periodic);
+    int z = wrap_coordinate((int)(cell / (width * height)) + cube_directions_z[direction], depth, periodic);
+    return x < 0 || y < 0 || z < 0 ? -1 : (z * (int)height + y) * (int)width + x;
+  }
+};
+
+/**
+ * The hexagonal grid in "odd-r" offset coordinates (odd rows shifted half a
+ * cell right): 6 directions, up-left, up-right, left, right, down-left,
+ * down-right. A periodic hex grid needs an even height, or the row parity
+ * would not survive the vertical wrap.
+ */
+struct HexTopology {
+  static constexpr unsigned directions = 6;
+  using Output = Array2D<unsigned>;
+
+  unsigned width;
+  unsigned height;
+  bool periodic;
+
+  unsigned size() const noexcept { return width * height; }
+  Output make_output() const noexcept { return Output(height, width); }
+
+  int neighbour(unsigned cell, unsigned direction) const noexcept {
+    static constexpr int dy[6] = {-1, -1, 0, 0, 1, 1};
+    static constexpr int even_dx[6] = {-1, 0, -1, 1, -1, 0};
+    static constexpr int odd_dx[6] = {0, 1, -1, 1, 0, 1};
+    int x0 = (int)(cell % width);
+    int y0 = (int)(cell / width);
+    int dx = (y0 & 1) ? odd_dx[direction] : even_dx[direction];
+    int x = wrap_coordinate(x0 + dx, width, periodic);
+    int y = wrap_coordinate(y0 + dy[direction], height, periodic);
+    return x < 0 || y < 0 ? -1 : y * (int)width + x;
+  }
+};
+
+#endif // FAST_WFC_TOPOLOGY_HPP_
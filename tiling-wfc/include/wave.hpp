@@ -2,21 +2,25 @@
 #define FAST_WFC_WAVE_HPP_
 
 #include "utils/array2D.hpp"
-#include <random>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+#include "CounterRng.h"
+
 /**
  * Struct containing the values needed to compute the entropy of all the cells.
  * This struct is updated every time the wave is changed.
- * p'(pattern) is equal to patterns_frequencies[pattern] if wave.get(cell,
- * pattern) is set to true, otherwise 0.
+ * q'(pattern) is equal to the fixed-point frequency of pattern if
+ * wave.get(cell, pattern) is set to true, otherwise 0.
+ * Entropies are integers (log2 with 20 fraction bits, see wave.cpp) so that
+ * the cell picked for a seed does not depend on the platform's libm.
  */
 struct EntropyMemoisation {
-  std::vector<double> plogp_sum; // The sum of p'(pattern) * log(p'(pattern)).
-  std::vector<double> sum;       // The sum of p'(pattern).
-  std::vector<double> log_sum;   // The log of sum.
+  std::vector<uint64_t> plogp_sum; // The sum of q'(pattern) * log2(q'(pattern)).
+  std::vector<uint64_t> sum;       // The sum of q'(pattern).
   std::vector<unsigned> nb_patterns; // The number of patterns present
-  std::vector<double> entropy;       // The entropy of the cell.
+  std::vector<int64_t> entropy;      // The entropy of the cell.
 };
 
 /**
@@ -26,20 +30,15 @@ struct EntropyMemoisation {
 class Wave {
 private:
   /**
-   * The patterns frequencies p given to wfc.
-   */
-  const std::vector<double> patterns_frequencies;
-
-  /**
-   * The precomputation of p * log(p).
+   * The patterns frequencies p given to wfc, in fixed point (q = p * 2^20,
+   * at least 1).
    */
-  const std::vector<double> plogp_patterns_frequencies;
+  const std::vector<uint64_t> patterns_frequencies;
 
   /**
-   * The precomputation of min (p * log(p)) / 2.
-   * This is used to define the maximum value of the noise.
+   * The precomputation of q * log2(q).
    */
-  const double min_abs_half_plogp;
+  const std::vector<uint64_t> plogp_patterns_frequencies;
 
   /**
    * The memoisation of important values for the computation of entropy.
@@ -65,17 +64,14 @@ private:
 
 public:
   /**
-   * The size of the wave.
+   * The number of cells in the wave.
    */
-  const unsigned width;
-  const unsigned height;
   const unsigned size;
 
   /**
    * Initialize the wave with every cell being able to have every pattern.
    */
-  Wave(unsigned height, unsigned width,
-       const std::vector<double> &patterns_frequencies) noexcept;
+  Wave(unsigned size, const std::vector<double> &patterns_frequencies) noexcept;
 
   /**
    * Return true if pattern can be placed in cell index.
@@ -84,23 +80,16 @@ public:
     return data.get(index, pattern);
   }
 
-  /**
-   * Return true if pattern can be placed in cell (i,j)
-   */
-  bool get(unsigned i, unsigned j, unsigned pattern) const noexcept {
-    return get(i * width + j, pattern);
-  }
-
   /**
    * Set the value of pattern in cell index.
    */
   void set(unsigned index, unsigned pattern, bool value) noexcept;
 
   /**
-   * Set the value of pattern in cell (i,j).
+   * Return the number of patterns that can still be placed in cell index.
    */
-  void set(unsigned i, unsigned j, unsigned pattern, bool value) noexcept {
-    set(i * width + j, pattern, value);
+  unsigned get_nb_patterns(unsigned index) const noexcept {
+    return memoisation.nb_patterns[index];
   }
 
   /**
@@ -108,7 +97,7 @@ public:
    * If there is a contradiction in the wave, return -2.
    * If every cell is decided, return -1.
    */
-  int get_min_entropy(std::minstd_rand &gen) const noexcept;
+  int get_min_entropy(CounterStream &gen) const noexcept;
 
 };
 
@@ -1,22 +1,46 @@
 #ifndef FAST_WFC_WFC_HPP_
 #define FAST_WFC_WFC_HPP_
 
+#include <cstdint>
 #include <optional>
-#include <random>
+#include <vector>
 
-#include "utils/array2D.hpp"
 #include "propagator.hpp"
+#include "topology.hpp"
 #include "wave.hpp"
+#include "CounterRng.h"
 
 /**
- * Class containing the generic WFC algorithm.
+ * One observation: cell (wave index, see topology.hpp) was set to its option-th
+ * still possible pattern. Options are small numbers even with many
+ * patterns, which keeps encoded logs short.
  */
-class WFC {
+struct WFCDecision {
+  unsigned cell;
+  unsigned option;
+};
+
+/**
+ * Class containing the generic WFC algorithm, over the cells of a topology
+ * (see topology.hpp).
+ */
+template <typename Topology> class BasicWFC {
+public:
+  using Output = typename Topology::Output;
+  using PropagatorState =
+      typename BasicPropagator<Topology>::PropagatorState;
+
 private:
   /**
-   * The random number generator.
+   * The cells of the wave and how they touch.
    */
-  std::minstd_rand gen;
+  const Topology topology;
+
+  /**
+   * The random number generator (portable: the same seed gives the same
+   * output with every compiler and standard library).
+   */
+  CounterStream gen;
 
   /**
    * The distribution of the patterns as given in input.
@@ -36,28 +60,53 @@ private:
   /**
    * The propagator, used to propagate the information in the wave.
    */
-  Propagator propagator;
+  BasicPropagator<Topology> propagator;
+
+  /**
+   * Where observe() appends its decisions, or nullptr when not recording.
+   */
+  std::vector<WFCDecision> *decision_log = nullptr;
+
+  /**
+   * Set cell to pattern, removing every other pattern from it.
+   */
+  void collapse(unsigned cell, unsigned pattern) noexcept;
 
   /**
-   * Transform the wave to a valid output (a 2d array of patterns that aren't in
-   * contradiction). This function should be used only when all cell of the wave
-   * are defined.
+   * Transform the wave to a valid output (an array of patterns that aren't in
+   * contradiction, shaped by the topology). This function should be used only
+   * when all cell of the wave are defined.
    */
-  Array2D<unsigned> wave_to_output() const noexcept;
+  Output wave_to_output() const noexcept;
 
 public:
   /**
    * Basic constructor initializing the algorithm.
    */
-  WFC(bool periodic_output, int seed, std::vector<double> patterns_frequencies,
-      Propagator::PropagatorState propagator, unsigned wave_height,
-      unsigned wave_width)
-    noexcept;
+  BasicWFC(const Topology &topology, uint64_t seed,
+           std::vector<double> patterns_frequencies,
+           PropagatorState propagator) noexcept;
 
   /**
    * Run the algorithm, and return a result if it succeeded.
    */
-  std::optional<Array2D<unsigned>> run() noexcept;
+  std::optional<Output> run() noexcept;
+
+  /**
+   * Record every decision of observe() into log (nullptr to stop).
+   */
+  void set_decision_log(std::vector<WFCDecision> *log) noexcept {
+    decision_log = log;
+  }
+
+  /**
+   * Rebuild the output of a recorded run: each decision is applied and
+   * propagated in order, without entropy search or random sampling. The
+   * wave must start in the same state (same patterns and constraints).
+   * Fails if a decision is not possible or the log leaves a cell undecided.
+   */
+  std::optional<Output> replay(
+      const std::vector<WFCDecision> &log) noexcept;
 
   /**
    * Return value of observe.
@@ -79,14 +128,23 @@ public:
   void propagate() noexcept { propagator.propagate(wave); }
 
   /**
-   * Remove pattern from cell (i,j).
+   * Remove pattern from cell.
    */
-  void remove_wave_pattern(unsigned i, unsigned j, unsigned pattern) noexcept {
-    if (wave.get(i, j, pattern)) {
-      wave.set(i, j, pattern, false);
-      propagator.add_to_propagator(i, j, pattern);
+  void remove_wave_pattern(unsigned cell, unsigned pattern) noexcept {
+    if (wave.get(cell, pattern)) {
+      wave.set(cell, pattern, false);
+      propagator.add_to_propagator(cell, pattern);
     }
   }
+
+  /**
+   * Remove pattern from cell (i,j) of a 2D topology.
+   */
+  void remove_wave_pattern(unsigned i, unsigned j, unsigned pattern) noexcept {
+    remove_wave_pattern(i * topology.width + j, pattern);
+  }
 };
 
+using WFC = BasicWFC<SquareTopology>;
+
 #endif // FAST_WFC_WFC_HPP_
@@ -0,0 +1,258 @@
+#include "WalkerBuilder.h"
+#include <algorithm>
+#include <cmath>
+
+void WalkerBuilder::generate(const WalkerSettings& settings) {
+    cfg = settings;
+    // The same limits the Godot setters apply, so every front end gets the
+    // same map for the same settings and seed
+    cfg.minHall = std::max(1, cfg.minHall);
+    cfg.maxHall = std::max(cfg.minHall, cfg.maxHall);
+    cfg.roomDim = std::max(2, cfg.roomDim);
+    cfg.totalFloorCount = std::max(50, cfg.totalFloorCount);
+    rng = CounterStream(cfg.seed);
+
+    walkers.clear();
+    floorTiles.clear();
+    rooms.clear();
+    wallTiles.clear();
+    floors.clear();
+    walls.clear();
+
+    calculateMapSize();
+
+    simulateWalkers();
+    generateWalls();
+}
+
+void WalkerBuilder::addFloor(WalkerVec2i pos) {
+    if (floorTiles.insert(pos).second) {
+        floors.push_back(pos);
+    }
+}
+
+void WalkerBuilder::calculateMapSize() {
+    float fill_ratio = cfg.allowOverlap ? 0.50f : 0.65f;
+    int total_tiles_needed = (int)(cfg.totalFloorCount / fill_ratio);
+    int side_length = (int)std::sqrt(total_tiles_needed) + (cfg.allowOverlap ? 15 : 10);
+    side_length = std::max(side_length, (cfg.allowOverlap ? 30 : 20));
+    mapSize = WalkerVec2i(side_length, side_length);
+}
+
+WalkerVec2i WalkerBuilder::randomDirection(WalkerVec2i current) {
+    static const WalkerVec2i directions[4] = {
+        WalkerVec2i(0, -1), WalkerVec2i(0, 1), WalkerVec2i(-1, 0), WalkerVec2i(1, 0)
+    };
+
+    WalkerVec2i dir;
+    int tries = 0;
+    do {
+        dir = directions[randiRange(0, 3)];
+        tries++;
+    } while (cfg.allowOverlap && current.x != 0 && current.y != 0 &&
+             dir.x == -current.x && dir.y == -current.y && tries < 10);
+
+    return dir;
+}
+
+int WalkerBuilder::randiRange(int from, int to) {
+    if (from > to) {
+        std::swap(from, to);
+    }
+    return rng.range(from, to);
+}
+
+bool WalkerBuilder::roomOverlapsExisting(WalkerVec2i center, int width, int height) const {
+    if (cfg.allowOverlap) {
+        return false;
+    }
+
+    int margin = 1;
+    for (const auto& existing : rooms) {
+        if (center.x - width / 2 - margin < existing.center.x + existing.width / 2 &&
+            center.x + width / 2 + margin > existing.center.x - existing.width / 2 &&
+            center.y - height / 2 - margin < existing.center.y + existing.height / 2 &&
+            center.y + height / 2 + margin > existing.center.y - existing.height / 2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WalkerBuilder::spawnWalker() {
+    WalkerVec2i start;
+    if (floorTiles.empty()) {
+        start = WalkerVec2i(mapSize.x / 2, mapSize.y / 2);
+        addFloor(start);
+    } else {
+        start = floors[randiRange(0, floors.size() - 1)];
+    }
+
+    walkers.push_back({start, randomDirection(), WalkerVec2i(0, 0)});
+}
+
+void WalkerBuilder::placeOrganicRoom(WalkerVec2i center, int w, int h) {
+    float rx = std::max(1.f, w / 2.f);
+    float ry = std::max(1.f, h / 2.f);
+
+    for (int y = -(int)std::ceil(ry); y <= (int)std::ceil(ry); ++y) {
+        for (int x = -(int)std::ceil(rx); x <= (int)std::ceil(rx); ++x) {
+            float nx = x / rx;
+            float ny = y / ry;
+            if (nx * nx + ny * ny <= 1.0f &&
+                randiRange(0, 100) > (int)((1.0f - std::sqrt(nx * nx + ny * ny)) * 20)) {
+                WalkerVec2i pos = center + WalkerVec2i(x, y);
+                if (pos.x > 0 && pos.x < mapSize.x - 1 &&
+                    pos.y > 0 && pos.y < mapSize.y - 1) {
+                    addFloor(pos);
+                }
+            }
+        }
+    }
+}
+
+bool WalkerBuilder::tryPlaceRoom(WalkerVec2i center) {
+    for (int i = 0; i < 3; ++i) {
+        int d = std::max(3, cfg.roomDim - i * 2);
+        int rx = randiRange(1, d / 2 + 1);
+        int ry = randiRange(1, d / 2 + 1);
+
+        if (cfg.allowOverlap && randiRange(0, 100) < 70) {
+            placeOrganicRoom(center, rx * 2, ry * 2);
+            return true;
+        }
+
+        if (center.x - rx <= 0 || center.x + rx >= mapSize.x - 1 ||
+            center.y - ry <= 0 || center.y + ry >= mapSize.y - 1) {
+            continue;
+        }
+
+        if (!cfg.allowOverlap && roomOverlapsExisting(center, rx, ry)) {
+            continue;
+        }
+
+        for (int x = -rx; x <= rx; ++x) {
+            for (int y = -ry; y <= ry; ++y) {
+                addFloor(center + WalkerVec2i(x, y));
+            }
+        }
+
+        if (!cfg.allowOverlap) {
+            rooms.push_back({center, rx, ry});
+        }
+        return true;
+    }
+    return false;
+}
+
+void WalkerBuilder::simulateWalkers() {
+    WalkerVec2i start(mapSize.x / 2, mapSize.y / 2);
+    addFloor(start);
+
+    if (!cfg.allowOverlap) {
+        tryPlaceRoom(start);
+    } else {
+        for (int i = 0; i < 3; i++) {
+            spawnWalker();
+        }
+    }
+
+    int attempts = 0;
+    const int max_attempts = cfg.allowOverlap ? 150000 : 50000;
+
+    while (floorTiles.size() < (size_t)cfg.totalFloorCount && attempts++ < max_attempts) {
+        if (cfg.allowOverlap) {
+            std::vector<Walker> next_gen;
+            if (walkers.empty()) {
+                spawnWalker();
+            }
+
+            for (auto& w : walkers) {
+                WalkerVec2i new_pos = w.position + w.direction;
+                if (new_pos.x > 0 && new_pos.x < mapSize.x - 1 &&
+                    new_pos.y > 0 && new_pos.y < mapSize.y - 1) {
+                    addFloor(new_pos);
+                    w.position = new_pos;
+                    w.lastDirection = w.direction;
+
+                    // Widen corridors occasionally
+                    if (randiRange(0, 100) < 10) {
+                        WalkerVec2i perp(w.direction.y, w.direction.x);
+                        addFloor(new_pos + perp);
+                        addFloor(new_pos - perp);
+                    }
+
+                    // Change direction
+                    if (randiRange(0, 100) < 15) {
+                        w.direction = randomDirection(w.lastDirection);
+                    }
+
+                    // Spawn new walker
+                    if (randiRange(0, 100) < 10 && walkers.size() < 50) {
+                        next_gen.push_back({w.position, randomDirection(w.lastDirection), w.lastDirection});
+                    }
+
+                    // Place organic room
+                    if (randiRange(0, 100) < 7) {
+                        placeOrganicRoom(w.position,
+                                         randiRange(cfg.roomDim / 2, cfg.roomDim),
+                                         randiRange(cfg.roomDim / 2, cfg.roomDim));
+                    }
+
+                    next_gen.push_back(w);
+                }
+            }
+            walkers = next_gen;
+        } else {
+            // Non-overlap mode: single walker with rooms
+            WalkerVec2i cur_pos = start;
+            if (!rooms.empty() && randiRange(0, 100) < 70) {
+                cur_pos = rooms[randiRange(0, rooms.size() - 1)].center;
+            } else if (!floors.empty()) {
+                cur_pos = floors[randiRange(0, floors.size() - 1)];
+            }
+
+            WalkerVec2i dir = randomDirection();
+            int len = randiRange(cfg.minHall, cfg.maxHall);
+            for (int i = 0; i < len; ++i) {
+                WalkerVec2i next = cur_pos + dir;
+                if (next.x > 1 && next.x < mapSize.x - 2 &&
+                    next.y > 1 && next.y < mapSize.y - 2) {
+                    addFloor(next);
+                    cur_pos = next;
+                } else {
+                    dir = randomDirection(dir);
+                    next = cur_pos + dir;
+                    if (next.x > 1 && next.x < mapSize.x - 2 &&
+                        next.y > 1 && next.y < mapSize.y - 2) {
+                        addFloor(next);
+                        cur_pos = next;
+                    } else {
+                        break;
+                    }
+                }
+            }
+            tryPlaceRoom(cur_pos);
+        }
+    }
+}
+
+void WalkerBuilder::generateWalls() {
+    wallTiles.clear();
+    walls.clear();
+
+    // Check 4 directions (N/S/E/W) around each floor tile
+    static const WalkerVec2i neighbors[4] = {
+        WalkerVec2i(1, 0), WalkerVec2i(-1, 0),
+        WalkerVec2i(0, 1), WalkerVec2i(0, -1)
+    };
+
+    for (const WalkerVec2i& tile : floors) {
+        for (const WalkerVec2i& offset : neighbors) {
+            WalkerVec2i n = tile + offset;
+            if (floorTiles.find(n) == floorTiles.end() && wallTiles.insert(n).second) {
+                walls.push_back(n);
+            }
+        }
+    }
+}
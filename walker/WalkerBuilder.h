@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <unordered_set>
+
+#include "CounterRng.h"
+
+// --- Data Structures (Pure C++) ---
+
+struct WalkerVec2i {
+    int x, y;
+    WalkerVec2i() : x(0), y(0) {}
+    WalkerVec2i(int x, int y) : x(x), y(y) {}
+    WalkerVec2i operator+(const WalkerVec2i& o) const { return {x + o.x, y + o.y}; }
+    WalkerVec2i operator-(const WalkerVec2i& o) const { return {x - o.x, y - o.y}; }
+    bool operator==(const WalkerVec2i& o) const { return x == o.x && y == o.y; }
+    bool operator!=(const WalkerVec2i& o) const { return !(*this == o); }
+};
+
+struct WalkerVec2iHash {
+    size_t operator()(const WalkerVec2i& v) const {
+        return std::hash<int>()(v.x) ^ (std::hash<int>()(v.y) << 1);
+    }
+};
+
+struct WalkerRoom {
+    WalkerVec2i center;
+    int width, height;
+};
+
+// generate() raises out-of-range values: minHall to 1, maxHall to minHall,
+// roomDim to 2 and totalFloorCount to 50.
+struct WalkerSettings {
+    bool allowOverlap = false;
+    int minHall = 3;
+    int maxHall = 6;
+    int roomDim = 5;
+    int totalFloorCount = 200;
+    uint64_t seed = 0;
+};
+
+// --- The API Class ---
+//
+// One builder owns all state for a single run, so independent builders can
+// generate concurrently.
+
+class WalkerBuilder {
+public:
+    void generate(const WalkerSettings& settings);
+
+    // Floors in the order they were first reached, walls in the order the
+    // floor scan found them; both are the same for a given seed on every
+    // platform (they are not copied out of the hash sets).
+    const std::vector<WalkerVec2i>& getFloors() const { return floors; }
+    const std::vector<WalkerVec2i>& getWalls() const { return walls; }
+    const std::vector<WalkerRoom>& getRooms() const { return rooms; }
+
+    int getMapWidth() const { return mapSize.x; }
+    int getMapHeight() const { return mapSize.y; }
+
+private:
+    struct Walker {
+        WalkerVec2i position;
+        WalkerVec2i direction;
+        WalkerVec2i lastDirection;
+    };
+
+    WalkerSettings cfg;
+    CounterStream rng{0};
+    WalkerVec2i mapSize;
+
+    // Membership sets; the vectors below keep the tiles in generation
+    // order, so random picks never depend on hash-set iteration order
+    std::unordered_set<WalkerVec2i, WalkerVec2iHash> floorTiles;
+    std::unordered_set<WalkerVec2i, WalkerVec2iHash> wallTiles;
+    std::vector<WalkerRoom> rooms;
+    std::vector<Walker> walkers;
+
+    std::vector<WalkerVec2i> floors;
+    std::vector<WalkerVec2i> walls;
+
+    void addFloor(WalkerVec2i pos);
+
+    void calculateMapSize();
+    WalkerVec2i randomDirection(WalkerVec2i current = WalkerVec2i(0, 0));
+    int randiRange(int from, int to);
+    bool roomOverlapsExisting(WalkerVec2i center, int width, int height) const;
+    void simulateWalkers();
+    void placeOrganicRoom(WalkerVec2i center, int baseWidth, int baseHeight);
+    bool tryPlaceRoom(WalkerVec2i center);
+    void spawnWalker();
+    void generateWalls();
+};
@@ -0,0 +1,117 @@
+#include "AdjacencySolver.h"
+#include <algorithm>
+#include <optional>
+
+#include "topology.hpp"
+#include "wfc.hpp"
+
+int topologyDirectionCount(GridTopology topology) {
+    switch (topology) {
+        case GridTopology::Cube:
+            return CubeTopology::directions;
+        case GridTopology::Hex:
+            return HexTopology::directions;
+        default:
+            return SquareTopology::directions;
+    }
+}
+
+int cubeDirection(int dx, int dy, int dz) {
+    for (unsigned d = 0; d < CubeTopology::directions; d++) {
+        if (cube_directions_x[d] == dx && cube_directions_y[d] == dy && cube_directions_z[d] == dz) {
+            return (int)d;
+        }
+    }
+    return -1;
+}
+
+bool AdjacencyProblem::addTile(int value, double weight) {
+    if (weight <= 0.0 || valueToIndex.count(value)) {
+        return false;
+    }
+    valueToIndex[value] = (int)tileValues.size();
+    tileValues.push_back(value);
+    weights.push_back(weight);
+    return true;
+}
+
+bool AdjacencyProblem::allow(int fromValue, int toValue, int direction) {
+    auto from = valueToIndex.find(fromValue);
+    auto to = valueToIndex.find(toValue);
+    if (from == valueToIndex.end() || to == valueToIndex.end()) {
+        return false;
+    }
+    if (direction < 0 || direction >= topologyDirectionCount(topology)) {
+        return false;
+    }
+    rules.push_back({from->second, to->second, direction});
+    return true;
+}
+
+template <typename Topology>
+static void runAdjacency(const AdjacencyProblem& problem, const Topology& topology,
+                         uint64_t seed, AdjacencyOutput& out) {
+    constexpr unsigned directions = Topology::directions;
+    typename BasicWFC<Topology>::PropagatorState state(problem.tileValues.size());
+    for (const AdjacencyRule& rule : problem.rules) {
+        state[rule.from][rule.direction].push_back(rule.to);
+        state[rule.to][directions - 1 - rule.direction].push_back(rule.from);
+    }
+    // A rule given both ways would otherwise be counted twice
+    for (auto& tile : state) {
+        for (auto& allowed : tile) {
+            std::sort(allowed.begin(), allowed.end());
+            allowed.erase(std::unique(allowed.begin(), allowed.end()), allowed.end());
+        }
+    }
+
+    BasicWFC<Topology> wfc(topology, seed, problem.weights, state);
+    std::optional<typename Topology::Output> output = wfc.run();
+    if (!output.has_value()) {
+        out.failureReason = "WFC contradiction - no valid solution";
+        return;
+    }
+
+    out.cells.resize(output->data.size());
+    for (size_t i = 0; i < out.cells.size(); i++) {
+        out.cells[i] = problem.tileValues[output->data[i]];
+    }
+    out.success = true;
+}
+
+AdjacencyOutput solveAdjacency(const AdjacencyProblem& problem, int width, int height,
+                               int depth, bool periodic, uint64_t seed) {
+    AdjacencyOutput out;
+    if (problem.topology != GridTopology::Cube) {
+        depth = 1;
+    }
+    if (problem.tileValues.empty()) {
+        out.failureReason = "No tiles defined";
+        return out;
+    }
+    if (width <= 0 || height <= 0 || depth <= 0) {
+        out.failureReason = "Grid size must be positive";
+        return out;
+    }
+    if (problem.topology == GridTopology::Hex && periodic && height % 2 != 0) {
+        out.failureReason = "A periodic hex grid needs an even height";
+        return out;
+    }
+    out.width = width;
+    out.height = height;
+    out.depth = depth;
+
+    switch (problem.topology) {
+        case GridTopology::Cube:
+            runAdjacency(problem, CubeTopology{(unsigned)width, (unsigned)height, (unsigned)depth, periodic},
+                         seed, out);
+            break;
+        case GridTopology::Hex:
+            runAdjacency(problem, HexTopology{(unsigned)width, (unsigned)height, periodic}, seed, out);
+            break;
+        default:
+            runAdjacency(problem, SquareTopology{(unsigned)width, (unsigned)height, periodic}, seed, out);
+            break;
+    }
+    return out;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// --- Data Structures (Pure C++) ---
+
+// The grid a solve runs on (see topology.hpp for the direction order of
+// each). The opposite of direction d is always directionCount - 1 - d.
+//   Square: 4 directions, up, left, right, down
+//   Cube:   6 directions, -z, -y, -x, +x, +y, +z
+//   Hex:    6 directions (odd-r rows), up-left, up-right, left, right,
+//           down-left, down-right
+enum class GridTopology {
+    Square,
+    Cube,
+    Hex
+};
+
+int topologyDirectionCount(GridTopology topology);
+// Index of the unit step (dx, dy, dz) in the Cube direction order, or -1.
+int cubeDirection(int dx, int dy, int dz);
+
+struct AdjacencyRule {
+    int from;        // wfc tile index
+    int to;          // wfc tile index, allowed next to `from` in `direction`
+    int direction;
+};
+
+// Plain adjacency rules over single-cell tiles: no orientations, no stamps.
+// Built once, then shared read-only by any number of concurrent solves.
+struct AdjacencyProblem {
+    GridTopology topology = GridTopology::Square;
+    std::vector<int> tileValues;        // wfc tile index -> tile value
+    std::vector<double> weights;        // per wfc tile index
+    std::map<int, int> valueToIndex;    // tile value -> wfc tile index
+    std::vector<AdjacencyRule> rules;
+
+    // Returns false if the value is already a tile or the weight is not
+    // positive.
+    bool addTile(int value, double weight);
+    // Allows `to` next to `from` in `direction`, and `from` next to `to` in
+    // the opposite direction. Returns false if a tile is unknown or the
+    // direction is out of range for the topology.
+    bool allow(int fromValue, int toValue, int direction);
+};
+
+struct AdjacencyOutput {
+    bool success = false;
+    std::string failureReason;
+    std::vector<int> cells;             // tile values, x fastest, then y, then z
+    int width = 0;
+    int height = 0;
+    int depth = 0;
+};
+
+// --- The API ---
+
+// `depth` is only used by the Cube topology (Square and Hex solve one
+// layer). A periodic Hex grid needs an even height.
+AdjacencyOutput solveAdjacency(const AdjacencyProblem& problem, int width, int height,
+                               int depth, bool periodic, uint64_t seed);
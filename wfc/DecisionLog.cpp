@@ -0,0 +1,37 @@
+#include "DecisionLog.h"
+#include "ByteStream.h"
+
+static const uint8_t DECISION_LOG_VERSION = 1;
+
+std::vector<uint8_t> encodeDecisions(const std::vector<WFCDecision>& decisions) {
+    ByteWriter out;
+    out.putU8(DECISION_LOG_VERSION);
+    out.putVarU(decisions.size());
+    for (const WFCDecision& decision : decisions) {
+        out.putVarU(decision.cell);
+        out.putVarU(decision.option);
+    }
+    return std::move(out.data());
+}
+
+bool decodeDecisions(const uint8_t* data, size_t size, std::vector<WFCDecision>& decisions) {
+    ByteReader in(data, size);
+    uint8_t version = in.getU8();
+    uint64_t count = in.getVarU();
+    // Every decision takes at least two bytes
+    if (!in.ok() || version != DECISION_LOG_VERSION || count > in.remaining() / 2) {
+        return false;
+    }
+
+    decisions.resize(count);
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t cell = in.getVarU();
+        uint64_t option = in.getVarU();
+        if (cell > UINT32_MAX || option > UINT32_MAX) {
+            return false;
+        }
+        decisions[i].cell = static_cast<unsigned>(cell);
+        decisions[i].option = static_cast<unsigned>(option);
+    }
+    return in.ok() && in.remaining() == 0;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "wfc.hpp"
+
+// --- Compact WFC decision logs (Pure C++) ---
+//
+// The observe() decisions of a run, enough to rebuild its output with
+// WFC::replay() given the same problem:
+//   u8 version, varint count, { varint cell, varint option }*
+// Options index the patterns still possible in the cell and are almost
+// always below 128, so a decision takes two or three bytes.
+std::vector<uint8_t> encodeDecisions(const std::vector<WFCDecision>& decisions);
+// Returns false on a truncated or unknown log.
+bool decodeDecisions(const uint8_t* data, size_t size, std::vector<WFCDecision>& decisions);
@@ -0,0 +1,218 @@
+#include "OverlappingSolver.h"
+#include <algorithm>
+
+#include "DecisionLog.h"
+
+// Applies the mapping and stamps to `out.patterns`, an outputWidth x
+// outputHeight block of colours.
+static void mapPatterns(const OverlappingProblem& problem, int outputWidth, int outputHeight,
+                        OverlappingOutput& out) {
+    // Apply pattern-to-tile mapping (if configured)
+    if (problem.hasMapping) {
+        out.tiles.resize(out.patterns.size());
+        for (size_t i = 0; i < out.patterns.size(); i++) {
+            auto it = problem.patternToTile.find(out.patterns[i]);
+            // Default to pattern value if no mapping exists
+            out.tiles[i] = it != problem.patternToTile.end() ? it->second : out.patterns[i];
+        }
+    }
+
+    // Expand with stamps (if configured)
+    if (problem.expandStamps) {
+        int stampSize = problem.stampSize;
+        out.expandedWidth = outputWidth * stampSize;
+        out.expandedHeight = outputHeight * stampSize;
+
+        // Initialize to -1 to distinguish unset tiles from actual floor tiles (0)
+        out.expanded.assign(out.expandedWidth * out.expandedHeight, -1);
+
+        // Use mapped tiles if available, otherwise patterns
+        const std::vector<int>& tileArray = problem.hasMapping ? out.tiles : out.patterns;
+
+        for (int wfcY = 0; wfcY < outputHeight; wfcY++) {
+            for (int wfcX = 0; wfcX < outputWidth; wfcX++) {
+                int tileId = tileArray[wfcY * outputWidth + wfcX];
+
+                auto it = problem.stamps.find(tileId);
+                if (it == problem.stamps.end()) {
+                    continue;
+                }
+                const OverlappingStamp& stamp = it->second;
+
+                // Place stamp
+                int baseX = wfcX * stampSize;
+                int baseY = wfcY * stampSize;
+
+                for (int localY = 0; localY < stamp.height; localY++) {
+                    for (int localX = 0; localX < stamp.width; localX++) {
+                        int stampIndex = localY * stamp.width + localX;
+                        if (stampIndex < (int)stamp.pattern.size()) {
+                            int worldX = baseX + localX;
+                            int worldY = baseY + localY;
+
+                            if (worldX < out.expandedWidth && worldY < out.expandedHeight) {
+                                out.expanded[worldY * out.expandedWidth + worldX] = stamp.pattern[stampIndex];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Copies a finished run (or replay) and applies the mapping and stamps.
+static void finishOverlapping(const OverlappingProblem& problem, std::optional<Array2D<int>>& wfcOutput,
+                              OverlappingOutput& out) {
+    int outputWidth = problem.options.out_width;
+    int outputHeight = problem.options.out_height;
+
+    if (!wfcOutput.has_value()) {
+        out.failureReason = "WFC contradiction - no valid solution found";
+        return;
+    }
+
+    // Copy WFC output
+    Array2D<int>& outputArray = wfcOutput.value();
+    out.patterns.resize(outputHeight * outputWidth);
+
+    for (int y = 0; y < outputHeight; y++) {
+        for (int x = 0; x < outputWidth; x++) {
+            out.patterns[y * outputWidth + x] = outputArray.get(y, x);
+        }
+    }
+    out.success = true;
+    mapPatterns(problem, outputWidth, outputHeight, out);
+}
+
+OverlappingOutput solveOverlapping(const OverlappingProblem& problem, uint64_t seed, bool recordDecisions) {
+    OverlappingOutput out;
+    try {
+        // Run Overlapping WFC
+        OverlappingWFC<int> wfc(problem.input, problem.options, seed);
+        std::vector<WFCDecision> decisions;
+        if (recordDecisions) {
+            wfc.record_decisions(&decisions);
+        }
+        std::optional<Array2D<int>> wfcOutput = wfc.run();
+        finishOverlapping(problem, wfcOutput, out);
+        if (recordDecisions && out.success) {
+            out.decisions = encodeDecisions(decisions);
+        }
+    } catch (const std::exception& e) {
+        out = OverlappingOutput();
+        out.failureReason = std::string("WFC error: ") + e.what();
+    }
+    return out;
+}
+
+OverlappingOutput replayOverlapping(const OverlappingProblem& problem, const uint8_t* log, size_t logSize) {
+    OverlappingOutput out;
+    std::vector<WFCDecision> decisions;
+    if (!decodeDecisions(log, logSize, decisions)) {
+        out.failureReason = "Invalid decision log";
+        return out;
+    }
+    try {
+        // The seed is never used: replay makes no random draws
+        OverlappingWFC<int> wfc(problem.input, problem.options, 0);
+        std::optional<Array2D<int>> wfcOutput = wfc.replay(decisions);
+        finishOverlapping(problem, wfcOutput, out);
+    } catch (const std::exception& e) {
+        out = OverlappingOutput();
+        out.failureReason = std::string("WFC error: ") + e.what();
+    }
+    return out;
+}
+
+OverlappingOutput regenerateOverlappingRegion(const OverlappingProblem& problem, const int* patterns,
+                                              int rectX, int rectY, int rectWidth, int rectHeight, uint64_t seed) {
+    OverlappingOutput out;
+    const OverlappingWFCOptions& options = problem.options;
+    int width = (int)options.out_width;
+    int height = (int)options.out_height;
+    int n = (int)options.pattern_size;
+    bool periodic = options.periodic_output;
+    int waveWidth = (int)options.get_wave_width();
+    int waveHeight = (int)options.get_wave_height();
+
+    if (rectWidth < 1 || rectHeight < 1 || rectX < 0 || rectY < 0 ||
+        rectX + rectWidth > width || rectY + rectHeight > height) {
+        out.failureReason = "Region must be a non-empty rect inside the output";
+        return out;
+    }
+    if (periodic && (rectWidth + n > width || rectHeight + n > height)) {
+        out.failureReason = "Region plus pattern_size spans a whole periodic axis; use run() instead";
+        return out;
+    }
+
+    auto inRect = [&](int x, int y) {
+        return (x - rectX + width) % width < rectWidth && (y - rectY + height) % height < rectHeight;
+    };
+
+    try {
+        auto extracted = OverlappingWFC<int>::get_patterns(problem.input, options);
+        const std::vector<Array2D<int>>& list = extracted.first;
+        unsigned count = (unsigned)list.size();
+
+        // Every wave cell whose pattern covers a pixel of the rect
+        int subX = periodic ? rectX - n + 1 : std::max(rectX - n + 1, 0);
+        int subY = periodic ? rectY - n + 1 : std::max(rectY - n + 1, 0);
+        int subWidth = (periodic ? rectX + rectWidth : std::min(rectX + rectWidth, waveWidth)) - subX;
+        int subHeight = (periodic ? rectY + rectHeight : std::min(rectY + rectHeight, waveHeight)) - subY;
+
+        WFC wfc(SquareTopology{(unsigned)subWidth, (unsigned)subHeight, false}, seed, extracted.second,
+                OverlappingWFC<int>::generate_compatible(list));
+        unsigned ground = options.ground ? OverlappingWFC<int>::get_ground_pattern_id(problem.input, list, options)
+                                         : count;
+
+        // A pattern may only stay if it matches the kept pixels it covers
+        for (int y = 0; y < subHeight; y++) {
+            int cy = (subY + y + height) % height;
+            for (int x = 0; x < subWidth; x++) {
+                int cx = (subX + x + width) % width;
+                unsigned cell = (unsigned)(y * subWidth + x);
+                for (unsigned p = 0; p < count; p++) {
+                    bool keep = ground == count || (p == ground) == (cy == waveHeight - 1);
+                    for (int dy = 0; keep && dy < n; dy++) {
+                        for (int dx = 0; keep && dx < n; dx++) {
+                            int px = (cx + dx) % width;
+                            int py = (cy + dy) % height;
+                            keep = inRect(px, py) || list[p].get(dy, dx) == patterns[(size_t)py * width + px];
+                        }
+                    }
+                    if (!keep) {
+                        wfc.remove_wave_pattern(cell, p);
+                    }
+                }
+            }
+        }
+        wfc.propagate();
+
+        std::optional<Array2D<unsigned>> ids = wfc.run();
+        if (!ids.has_value()) {
+            out.failureReason = "WFC contradiction - no valid solution found for the region";
+            return out;
+        }
+
+        // Pixel (x, y) comes from the pattern at wave cell (x, y), or from the
+        // last row and column of patterns on a non-periodic edge
+        out.patterns.resize((size_t)rectWidth * rectHeight);
+        for (int y = 0; y < rectHeight; y++) {
+            int py = rectY + y;
+            int cy = periodic ? py : std::min(py, waveHeight - 1);
+            for (int x = 0; x < rectWidth; x++) {
+                int px = rectX + x;
+                int cx = periodic ? px : std::min(px, waveWidth - 1);
+                unsigned id = ids->get((cy - subY + height) % height, (cx - subX + width) % width);
+                out.patterns[(size_t)y * rectWidth + x] = list[id].get(py - cy, px - cx);
+            }
+        }
+        out.success = true;
+        mapPatterns(problem, rectWidth, rectHeight, out);
+    } catch (const std::exception& e) {
+        out = OverlappingOutput();
+        out.failureReason = std::string("WFC error: ") + e.what();
+    }
+    return out;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "overlapping_wfc.hpp"
+#include "utils/array2D.hpp"
+
+// --- Data Structures (Pure C++) ---
+
+struct OverlappingStamp {
+    std::vector<int> pattern;
+    int width = 0;
+    int height = 0;
+};
+
+// Everything an overlapping solve needs. Built once, then shared read-only by
+// any number of concurrent solves.
+struct OverlappingProblem {
+    Array2D<int> input = Array2D<int>(0, 0);   // seed colours as 0xRRGGBB
+    OverlappingWFCOptions options = {};
+    bool hasMapping = false;
+    std::unordered_map<int, int> patternToTile;
+    bool expandStamps = false;
+    int stampSize = 0;
+    std::unordered_map<int, OverlappingStamp> stamps;
+};
+
+struct OverlappingOutput {
+    bool success = false;
+    std::string failureReason;
+    std::vector<int> patterns;          // raw colours, row-major
+    std::vector<int> tiles;             // mapped tile ids (only with a mapping)
+    std::vector<int> expanded;          // stamp values, -1 where unset
+    int expandedWidth = 0;
+    int expandedHeight = 0;
+    std::vector<uint8_t> decisions;     // encoded decision log, if recorded
+};
+
+// --- The API ---
+
+// With `recordDecisions`, the output carries the run's decision log (see
+// DecisionLog.h), which replayOverlapping() turns back into the same output.
+OverlappingOutput solveOverlapping(const OverlappingProblem& problem, uint64_t seed,
+                                   bool recordDecisions = false);
+// Rebuilds a recorded run without entropy search or sampling. The problem
+// must match the recording; a log that does not fit it fails like a
+// contradiction.
+OverlappingOutput replayOverlapping(const OverlappingProblem& problem, const uint8_t* log, size_t logSize);
+// Re-solves rect (rectX, rectY, rectWidth, rectHeight) of a finished output
+// and keeps every other pixel. `patterns` is the output's raw colours
+// (out_width x out_height, row-major). Only the wave cells whose patterns cover the rect
+// are solved, each limited to patterns that match the kept pixels around it,
+// so the cost depends on the rect, not the output. On success `patterns`,
+// `tiles` and `expanded` cover only the rect. A periodic rect must be at
+// least pattern_size narrower than the output on both axes.
+OverlappingOutput regenerateOverlappingRegion(const OverlappingProblem& problem, const int* patterns,
+                                              int rectX, int rectY, int rectWidth, int rectHeight, uint64_t seed);
@@ -0,0 +1,556 @@
+#include "TilingSolver.h"
+#include <algorithm>
+
+#include "CounterRng.h"
+#include "DecisionLog.h"
+#include "Parallel.h"
+#include "utils/array2D.hpp"
+#include "wfc.hpp"
+
+void TilingProblem::addTile(int tileId, const std::vector<int>& data, int size,
+                            Symmetry symmetry, double weight) {
+    // Create Array2D from tile data
+    Array2D<int> tileArray(size, size);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            int index = y * size + x;
+            if (index < (int)data.size()) {
+                tileArray.get(y, x) = data[index];
+            }
+        }
+    }
+
+    idToIndex[tileId] = (int)tiles.size();
+    tiles.push_back(Tile<int>(tileArray, symmetry, weight));
+    tileIds.push_back(tileId);
+    stamps.push_back(TilingStamp());
+}
+
+bool TilingProblem::setStamp(int tileId, const std::vector<int>& pattern, int width, int height) {
+    auto it = idToIndex.find(tileId);
+    if (it == idToIndex.end()) {
+        return false;
+    }
+    TilingStamp& stamp = stamps[it->second];
+    stamp.hasStamp = true;
+    stamp.pattern = pattern;
+    stamp.width = width;
+    stamp.height = height;
+    return true;
+}
+
+void TilingProblem::addNeighbor(int tile1Id, int orientation1, int tile2Id, int orientation2) {
+    auto it1 = idToIndex.find(tile1Id);
+    auto it2 = idToIndex.find(tile2Id);
+    if (it1 == idToIndex.end() || it2 == idToIndex.end()) {
+        return;
+    }
+    neighbors.push_back(std::make_tuple(it1->second, orientation1, it2->second, orientation2));
+}
+
+bool TilingProblem::enableStamps(int size) {
+    stampSize = 0;
+    if (size <= 0) {
+        return true;
+    }
+    for (const auto& stamp : stamps) {
+        if (!stamp.hasStamp) {
+            return false;
+        }
+    }
+    stampSize = size;
+    return true;
+}
+
+static void expandStamps(const TilingProblem& problem, TilingOutput& out) {
+    int stampSize = problem.stampSize;
+    out.expandedWidth = out.width * stampSize;
+    out.expandedHeight = out.height * stampSize;
+
+    // Initialize to -1 to distinguish unset tiles from actual floor tiles (0)
+    out.expanded.assign(out.expandedWidth * out.expandedHeight, -1);
+
+    // Expand each WFC tile to its stamp
+    for (int wfcY = 0; wfcY < out.height; wfcY++) {
+        for (int wfcX = 0; wfcX < out.width; wfcX++) {
+            int tileId = out.tiles[wfcY * out.width + wfcX];
+
+            auto it = problem.idToIndex.find(tileId);
+            if (it == problem.idToIndex.end()) {
+                continue;
+            }
+            const TilingStamp& stamp = problem.stamps[it->second];
+            if (!stamp.hasStamp) {
+                continue;
+            }
+
+            // Place stamp
+            int baseX = wfcX * stampSize;
+            int baseY = wfcY * stampSize;
+
+            for (int localY = 0; localY < stamp.height; localY++) {
+                for (int localX = 0; localX < stamp.width; localX++) {
+                    int stampIndex = localY * stamp.width + localX;
+                    if (stampIndex < (int)stamp.pattern.size()) {
+                        int worldX = baseX + localX;
+                        int worldY = baseY + localY;
+
+                        if (worldX < out.expandedWidth && worldY < out.expandedHeight) {
+                            out.expanded[worldY * out.expandedWidth + worldX] = stamp.pattern[stampIndex];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Converts a finished run (or replay) into tile ids and stamps.
+static void finishTiling(const TilingProblem& problem, std::optional<Array2D<int>>& output,
+                         TilingOutput& out) {
+    if (!output.has_value()) {
+        out.failureReason = "WFC contradiction - no valid solution";
+        out.failureX = -1;
+        out.failureY = -1;
+        return;
+    }
+
+    // Convert WFC output back to tile IDs
+    Array2D<int>& outputArray = output.value();
+    out.height = outputArray.height;
+    out.width = outputArray.width;
+    out.tiles.resize(out.height * out.width);
+
+    for (int y = 0; y < out.height; y++) {
+        for (int x = 0; x < out.width; x++) {
+            int tileIndex = outputArray.get(y, x);
+            out.tiles[y * out.width + x] = problem.tileIds[tileIndex];
+        }
+    }
+    out.success = true;
+
+    // Expand stamps if configured
+    if (problem.stampSize > 0) {
+        expandStamps(problem, out);
+    }
+}
+
+TilingOutput solveTiling(const TilingProblem& problem, int width, int height,
+                         bool periodic, uint64_t seed, bool recordDecisions) {
+    TilingOutput out;
+    try {
+        // Run WFC algorithm
+        TilingWFCOptions options;
+        options.periodic_output = periodic;
+
+        TilingWFC<int> wfc(problem.tiles, problem.neighbors, height, width, options, seed);
+        std::vector<WFCDecision> decisions;
+        if (recordDecisions) {
+            wfc.record_decisions(&decisions);
+        }
+        std::optional<Array2D<int>> output = wfc.run();
+        finishTiling(problem, output, out);
+        if (recordDecisions && out.success) {
+            out.decisions = encodeDecisions(decisions);
+        }
+    } catch (const std::exception& e) {
+        out = TilingOutput();
+        out.failureReason = std::string("WFC error: ") + e.what();
+    }
+    return out;
+}
+
+TilingOutput replayTiling(const TilingProblem& problem, int width, int height,
+                          bool periodic, const uint8_t* log, size_t logSize) {
+    TilingOutput out;
+    std::vector<WFCDecision> decisions;
+    if (!decodeDecisions(log, logSize, decisions)) {
+        out.failureReason = "Invalid decision log";
+        return out;
+    }
+    try {
+        TilingWFCOptions options;
+        options.periodic_output = periodic;
+
+        // The seed is never used: replay makes no random draws
+        TilingWFC<int> wfc(problem.tiles, problem.neighbors, height, width, options, 0);
+        std::optional<Array2D<int>> output = wfc.replay(decisions);
+        finishTiling(problem, output, out);
+    } catch (const std::exception& e) {
+        out = TilingOutput();
+        out.failureReason = std::string("WFC error: ") + e.what();
+    }
+    return out;
+}
+
+// --- Hierarchical solving ---
+
+// A tile set as the generic WFC sees it. Built once per tile set, then
+// copied into every block solve.
+struct OrientedTiles {
+    std::vector<std::pair<unsigned, unsigned>> idToOriented;   // oriented id -> (tile index, orientation)
+    std::vector<std::vector<unsigned>> orientedIds;            // tile index -> oriented ids
+    WFC::PropagatorState propagator;
+    std::vector<double> weights;
+};
+
+static OrientedTiles orientTiles(const TilingProblem& problem) {
+    OrientedTiles out;
+    auto ids = TilingWFC<int>::generate_oriented_tile_ids(problem.tiles);
+    out.idToOriented = ids.first;
+    out.orientedIds = ids.second;
+    out.propagator = TilingWFC<int>::generate_propagator(problem.neighbors, problem.tiles,
+                                                         out.idToOriented, out.orientedIds);
+    out.weights = TilingWFC<int>::get_tiles_weights(problem.tiles);
+    return out;
+}
+
+struct BlockGrid {
+    int width;                              // fine cells
+    int height;
+    int blockSize;
+    int macroWidth;                         // blocks
+    int macroHeight;
+    std::vector<int> labels;                // per block: macro tile index
+    std::vector<std::vector<char>> allowed; // per macro tile index: fine oriented id -> allowed
+    std::vector<int> solved;                // per fine cell: oriented id, -1 until its pass is done
+};
+
+// Solves the fine cells in [x0, x1) x [y0, y1) with a one-cell ring taken
+// from `grid` (clipped to the map): ring cells already solved are fixed, the
+// others are restricted to their macro interior. Returns the area's oriented
+// ids, row-major, or nothing if every attempt hit a contradiction.
+static std::optional<std::vector<int>> solveArea(const OrientedTiles& fine, const BlockGrid& grid,
+                                                 int x0, int y0, int x1, int y1, int attempts,
+                                                 CounterStream seeds) {
+    int subX = std::max(x0 - 1, 0);
+    int subY = std::max(y0 - 1, 0);
+    int subWidth = std::min(x1 + 1, grid.width) - subX;
+    int subHeight = std::min(y1 + 1, grid.height) - subY;
+    unsigned patterns = (unsigned)fine.idToOriented.size();
+
+    for (int attempt = 0; attempt < attempts; attempt++) {
+        WFC wfc(SquareTopology{(unsigned)subWidth, (unsigned)subHeight, false}, seeds.next(),
+                fine.weights, fine.propagator);
+        for (int y = 0; y < subHeight; y++) {
+            for (int x = 0; x < subWidth; x++) {
+                int gx = subX + x;
+                int gy = subY + y;
+                bool inside = gx >= x0 && gx < x1 && gy >= y0 && gy < y1;
+                int fixed = inside ? -1 : grid.solved[gy * grid.width + gx];
+                int label = grid.labels[(gy / grid.blockSize) * grid.macroWidth + gx / grid.blockSize];
+                const std::vector<char>& allowed = grid.allowed[label];
+                unsigned cell = (unsigned)(y * subWidth + x);
+                for (unsigned p = 0; p < patterns; p++) {
+                    if (fixed >= 0 ? p != (unsigned)fixed : !allowed[p]) {
+                        wfc.remove_wave_pattern(cell, p);
+                    }
+                }
+            }
+        }
+        wfc.propagate();
+
+        std::optional<Array2D<unsigned>> ids = wfc.run();
+        if (!ids.has_value()) {
+            continue;
+        }
+        std::vector<int> cells;
+        cells.reserve((x1 - x0) * (y1 - y0));
+        for (int y = y0; y < y1; y++) {
+            for (int x = x0; x < x1; x++) {
+                cells.push_back((int)ids->get(y - subY, x - subX));
+            }
+        }
+        return cells;
+    }
+    return std::nullopt;
+}
+
+// Fine cell bounds of block `block`, clipped to the map.
+static void blockBounds(const BlockGrid& grid, int block, int& x0, int& y0, int& x1, int& y1) {
+    x0 = (block % grid.macroWidth) * grid.blockSize;
+    y0 = (block / grid.macroWidth) * grid.blockSize;
+    x1 = std::min(x0 + grid.blockSize, grid.width);
+    y1 = std::min(y0 + grid.blockSize, grid.height);
+}
+
+static std::optional<std::vector<int>> solveBlock(const OrientedTiles& fine, const BlockGrid& grid,
+                                                  int block, int attempts, uint64_t seed) {
+    int x0, y0, x1, y1;
+    blockBounds(grid, block, x0, y0, x1, y1);
+    return solveArea(fine, grid, x0, y0, x1, y1, attempts, CounterStream(seed).substream((uint64_t)block));
+}
+
+// Fallback for a block whose own attempts all failed, usually because the
+// fixed ring from first-pass neighbours admits no interior. Re-solves the
+// block together with its eight neighbours against the ring around all
+// nine. In the second pass every cell of that window belongs to a finished
+// block, so the whole window is written back and the neighbours' seams stay
+// consistent; in the first pass only the block itself is kept.
+static bool repairBlock(const OrientedTiles& fine, BlockGrid& grid, int block, bool keepWindow,
+                        int attempts, uint64_t seed) {
+    int x0, y0, x1, y1;
+    blockBounds(grid, block, x0, y0, x1, y1);
+    int wx0 = std::max(x0 - grid.blockSize, 0);
+    int wy0 = std::max(y0 - grid.blockSize, 0);
+    int wx1 = std::min(x1 + grid.blockSize, grid.width);
+    int wy1 = std::min(y1 + grid.blockSize, grid.height);
+    std::optional<std::vector<int>> cells = solveArea(fine, grid, wx0, wy0, wx1, wy1, attempts,
+                                                      CounterStream(seed).substream((uint64_t)block));
+    if (!cells.has_value()) {
+        return false;
+    }
+    for (int y = wy0; y < wy1; y++) {
+        for (int x = wx0; x < wx1; x++) {
+            if (keepWindow || (x >= x0 && x < x1 && y >= y0 && y < y1)) {
+                grid.solved[(size_t)y * grid.width + x] = (*cells)[(size_t)(y - wy0) * (wx1 - wx0) + (x - wx0)];
+            }
+        }
+    }
+    return true;
+}
+
+TilingOutput solveTilingHierarchical(const TilingProblem& problem, const HierarchicalTiling& hierarchy,
+                                     int width, int height, uint64_t seed) {
+    TilingOutput out;
+    if (hierarchy.macro.tiles.empty()) {
+        out.failureReason = "No macro tiles defined";
+        return out;
+    }
+    if (hierarchy.blockSize < 1 || width < 1 || height < 1) {
+        out.failureReason = "Output and block sizes must be positive";
+        return out;
+    }
+
+    try {
+        OrientedTiles macro = orientTiles(hierarchy.macro);
+        OrientedTiles fine = orientTiles(problem);
+
+        BlockGrid grid;
+        grid.width = width;
+        grid.height = height;
+        grid.blockSize = hierarchy.blockSize;
+        grid.macroWidth = (width + grid.blockSize - 1) / grid.blockSize;
+        grid.macroHeight = (height + grid.blockSize - 1) / grid.blockSize;
+
+        // Interiors as per-macro-tile masks over the fine oriented ids
+        grid.allowed.assign(hierarchy.macro.tiles.size(), std::vector<char>(fine.idToOriented.size(), 1));
+        for (const auto& entry : hierarchy.interiors) {
+            auto macroIt = hierarchy.macro.idToIndex.find(entry.first);
+            if (macroIt == hierarchy.macro.idToIndex.end()) {
+                continue;
+            }
+            std::vector<char>& allowed = grid.allowed[macroIt->second];
+            std::fill(allowed.begin(), allowed.end(), 0);
+            bool any = false;
+            for (int fineId : entry.second) {
+                auto fineIt = problem.idToIndex.find(fineId);
+                if (fineIt == problem.idToIndex.end()) {
+                    continue;
+                }
+                for (unsigned id : fine.orientedIds[fineIt->second]) {
+                    allowed[id] = 1;
+                    any = true;
+                }
+            }
+            if (!any) {
+                out.failureReason = "Macro tile " + std::to_string(entry.first) + " allows no known fine tiles";
+                return out;
+            }
+        }
+
+        // Coarse pass: one macro tile per block
+        WFC macroWfc(SquareTopology{(unsigned)grid.macroWidth, (unsigned)grid.macroHeight, false}, seed,
+                     macro.weights, macro.propagator);
+        std::optional<Array2D<unsigned>> macroIds = macroWfc.run();
+        if (!macroIds.has_value()) {
+            out.failureReason = "Macro WFC contradiction - no valid solution";
+            out.failureX = -1;
+            out.failureY = -1;
+            return out;
+        }
+        grid.labels.resize(macroIds->data.size());
+        for (size_t i = 0; i < grid.labels.size(); i++) {
+            grid.labels[i] = (int)macro.idToOriented[macroIds->data[i]].first;
+        }
+
+        // Fine passes: blocks of one checkerboard colour never touch, so a
+        // pass reads only the previous pass and is written back once done
+        grid.solved.assign((size_t)width * height, -1);
+        uint64_t fineSeed = counterRandom(seed, 1);
+        uint64_t repairSeed = counterRandom(seed, 2);
+        for (int pass = 0; pass < 2; pass++) {
+            std::vector<int> blocks;
+            for (int by = 0; by < grid.macroHeight; by++) {
+                for (int bx = 0; bx < grid.macroWidth; bx++) {
+                    if ((bx + by) % 2 == pass) {
+                        blocks.push_back(by * grid.macroWidth + bx);
+                    }
+                }
+            }
+
+            std::vector<std::optional<std::vector<int>>> results(blocks.size());
+            parallelFor((int)blocks.size(), hierarchy.threads, [&](int i) {
+                results[i] = solveBlock(fine, grid, blocks[i], hierarchy.blockAttempts, fineSeed);
+            });
+
+            std::vector<int> failed;
+            for (size_t i = 0; i < blocks.size(); i++) {
+                if (!results[i].has_value()) {
+                    failed.push_back(blocks[i]);
+                    continue;
+                }
+                int x0, y0, x1, y1;
+                blockBounds(grid, blocks[i], x0, y0, x1, y1);
+                const std::vector<int>& cells = *results[i];
+                for (size_t c = 0; c < cells.size(); c++) {
+                    int x = x0 + (int)c % (x1 - x0);
+                    int y = y0 + (int)c / (x1 - x0);
+                    grid.solved[(size_t)y * width + x] = cells[c];
+                }
+            }
+
+            // Repairs run one at a time, in block order, so a later one sees
+            // the cells an earlier one rewrote; a block already covered by an
+            // earlier repair's window is left as it is
+            for (int block : failed) {
+                int x0, y0, x1, y1;
+                blockBounds(grid, block, x0, y0, x1, y1);
+                if (grid.solved[(size_t)y0 * width + x0] >= 0) {
+                    continue;
+                }
+                if (!repairBlock(fine, grid, block, pass == 1, hierarchy.blockAttempts, repairSeed)) {
+                    out.failureReason = "WFC contradiction in block at (" + std::to_string(x0) + ", " +
+                                        std::to_string(y0) + ")";
+                    out.failureX = x0;
+                    out.failureY = y0;
+                    return out;
+                }
+            }
+        }
+
+        out.width = width;
+        out.height = height;
+        out.tiles.resize(grid.solved.size());
+        for (size_t i = 0; i < grid.solved.size(); i++) {
+            out.tiles[i] = problem.tileIds[fine.idToOriented[grid.solved[i]].first];
+        }
+        out.success = true;
+        if (problem.stampSize > 0) {
+            expandStamps(problem, out);
+        }
+    } catch (const std::exception& e) {
+        out = TilingOutput();
+        out.failureReason = std::string("WFC error: ") + e.what();
+    }
+    return out;
+}
+
+// --- Region regeneration ---
+
+TilingOutput regenerateTilingRegion(const TilingProblem& problem, const int* tiles,
+                                    int width, int height, bool periodic, int rectX, int rectY,
+                                    int rectWidth, int rectHeight, uint64_t seed) {
+    TilingOutput out;
+    if (problem.tiles.empty()) {
+        out.failureReason = "No tiles defined";
+        return out;
+    }
+    // Ring cells are matched by the value of a tile's single cell, so every
+    // orientation of every tile must be 1x1
+    for (const Tile<int>& tile : problem.tiles) {
+        for (const Array2D<int>& orientation : tile.data) {
+            if (orientation.width != 1 || orientation.height != 1) {
+                out.failureReason = "Region regeneration needs 1x1 tiles";
+                return out;
+            }
+        }
+    }
+    if (rectWidth < 1 || rectHeight < 1 || rectX < 0 || rectY < 0 ||
+        rectX + rectWidth > width || rectY + rectHeight > height) {
+        out.failureReason = "Region must be a non-empty rect inside the output";
+        return out;
+    }
+    if (periodic && (rectWidth == width || rectHeight == height)) {
+        out.failureReason = "Region spans a whole periodic axis; use run() instead";
+        return out;
+    }
+
+    try {
+        OrientedTiles oriented = orientTiles(problem);
+        unsigned patterns = (unsigned)oriented.idToOriented.size();
+
+        // The tile id run() reports for each oriented tile: its data value
+        // read as a tile index (see finishTiling)
+        std::vector<int> labels(patterns, -1);
+        for (unsigned p = 0; p < patterns; p++) {
+            const auto& id = oriented.idToOriented[p];
+            int value = problem.tiles[id.first].data[id.second].get(0, 0);
+            if (value >= 0 && value < (int)problem.tileIds.size()) {
+                labels[p] = problem.tileIds[value];
+            }
+        }
+
+        // The rect plus a one-cell ring, wrapped when periodic, clipped otherwise
+        int subX = periodic ? rectX - 1 : std::max(rectX - 1, 0);
+        int subY = periodic ? rectY - 1 : std::max(rectY - 1, 0);
+        int subWidth = (periodic ? rectX + rectWidth + 1 : std::min(rectX + rectWidth + 1, width)) - subX;
+        int subHeight = (periodic ? rectY + rectHeight + 1 : std::min(rectY + rectHeight + 1, height)) - subY;
+
+        WFC wfc(SquareTopology{(unsigned)subWidth, (unsigned)subHeight, false}, seed,
+                oriented.weights, oriented.propagator);
+        for (int y = 0; y < subHeight; y++) {
+            for (int x = 0; x < subWidth; x++) {
+                int gx = subX + x;
+                int gy = subY + y;
+                if (gx >= rectX && gx < rectX + rectWidth && gy >= rectY && gy < rectY + rectHeight) {
+                    continue;
+                }
+                gx = (gx + width) % width;
+                gy = (gy + height) % height;
+                // Ring cells keep their tile, in any orientation
+                int tileId = tiles[(size_t)gy * width + gx];
+                unsigned cell = (unsigned)(y * subWidth + x);
+                bool known = false;
+                for (unsigned p = 0; p < patterns; p++) {
+                    if (labels[p] == tileId) {
+                        known = true;
+                    } else {
+                        wfc.remove_wave_pattern(cell, p);
+                    }
+                }
+                if (!known) {
+                    out.failureReason = "Result does not match the configuration: unknown tile " +
+                                        std::to_string(tileId);
+                    return out;
+                }
+            }
+        }
+        wfc.propagate();
+
+        std::optional<Array2D<unsigned>> ids = wfc.run();
+        if (!ids.has_value()) {
+            out.failureReason = "WFC contradiction - no valid solution for the region";
+            out.failureX = rectX;
+            out.failureY = rectY;
+            return out;
+        }
+
+        out.width = rectWidth;
+        out.height = rectHeight;
+        out.tiles.resize((size_t)rectWidth * rectHeight);
+        for (int y = 0; y < rectHeight; y++) {
+            for (int x = 0; x < rectWidth; x++) {
+                out.tiles[(size_t)y * rectWidth + x] = labels[ids->get(rectY + y - subY, rectX + x - subX)];
+            }
+        }
+        out.success = true;
+        if (problem.stampSize > 0) {
+            expandStamps(problem, out);
+        }
+    } catch (const std::exception& e) {
+        out = TilingOutput();
+        out.failureReason = std::string("WFC error: ") + e.what();
+    }
+    return out;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "tiling_wfc.hpp"
+
+// --- Data Structures (Pure C++) ---
+
+struct TilingStamp {
+    bool hasStamp = false;
+    std::vector<int> pattern;
+    int width = 0;
+    int height = 0;
+};
+
+// Everything a tiling solve needs. Built once, then shared read-only by any
+// number of concurrent solves.
+struct TilingProblem {
+    std::vector<Tile<int>> tiles;
+    std::vector<std::tuple<unsigned, unsigned, unsigned, unsigned>> neighbors;
+    std::vector<int> tileIds;           // wfc tile index -> tile id
+    std::map<int, int> idToIndex;       // tile id -> wfc tile index
+    std::vector<TilingStamp> stamps;    // per wfc tile index
+    int stampSize = 0;                  // > 0 only if every tile has a stamp
+
+    // `data` is a row-major size x size block; missing values stay 0.
+    void addTile(int tileId, const std::vector<int>& data, int size, Symmetry symmetry, double weight);
+    // Returns false if the tile id is unknown.
+    bool setStamp(int tileId, const std::vector<int>& pattern, int width, int height);
+    // Rules naming an unknown tile are dropped.
+    void addNeighbor(int tile1Id, int orientation1, int tile2Id, int orientation2);
+    // Stamps are only expanded when every tile has one. Returns false if
+    // `size` > 0 but some tile has no stamp.
+    bool enableStamps(int size);
+};
+
+// Coarse-to-fine settings for solveTilingHierarchical(). The macro tile set
+// (e.g. room / corridor / void metatiles) is solved first, one macro cell
+// per blockSize x blockSize block of fine cells.
+struct HierarchicalTiling {
+    TilingProblem macro;
+    // macro tile id -> fine tile ids allowed in its blocks; macro tiles
+    // without an entry allow every fine tile
+    std::map<int, std::vector<int>> interiors;
+    int blockSize = 16;
+    int blockAttempts = 8;              // seeds tried per block, and per repair
+    int threads = 0;                    // workers for the block solves, 0 = all cores
+};
+
+struct TilingOutput {
+    bool success = false;
+    std::string failureReason;
+    int failureX = 0;
+    int failureY = 0;
+    std::vector<int> tiles;             // tile ids, row-major
+    int width = 0;
+    int height = 0;
+    std::vector<int> expanded;          // stamp values, -1 where unset
+    int expandedWidth = 0;
+    int expandedHeight = 0;
+    std::vector<uint8_t> decisions;     // encoded decision log, if recorded
+};
+
+// --- The API ---
+
+// With `recordDecisions`, the output carries the run's decision log (see
+// DecisionLog.h), which replayTiling() turns back into the same output.
+TilingOutput solveTiling(const TilingProblem& problem, int width, int height,
+                         bool periodic, uint64_t seed, bool recordDecisions = false);
+// Solves `hierarchy.macro` on a ceil(width / blockSize) x
+// ceil(height / blockSize) grid, then fills every block with `problem`'s
+// tiles, restricted to the block's macro interior. Blocks are solved in two
+// checkerboard passes, all blocks of a pass in parallel. Each block sees a
+// one-cell ring around it: cells of blocks solved in the first pass are fixed,
+// the others are restricted to their own macro interior. The fixed ring can
+// leave a second-pass block with no solution, which new seeds do not fix, so
+// a block that fails every attempt is repaired afterwards: it is re-solved
+// with its eight neighbouring blocks inside the ring around all nine, and
+// the run fails only if that fails too. Blocks that solve on their own are
+// no larger than (blockSize + 2)^2 cells, and the output does not depend on
+// the thread count. Always non-periodic; `tiles` holds fine tile ids.
+TilingOutput solveTilingHierarchical(const TilingProblem& problem, const HierarchicalTiling& hierarchy,
+                                     int width, int height, uint64_t seed);
+// Re-solves rect (rectX, rectY, rectWidth, rectHeight) of a finished map
+// and keeps every other cell. `tiles` is the map as run() reports it
+// (width x height tile ids, row-major). Only the rect and a one-cell ring around it are
+// solved, the ring fixed to its current tiles (in any orientation) and
+// wrapped when `periodic`, so the cost depends on the rect, not the map. On
+// success `tiles` and `expanded` cover only the rect. Needs 1x1 tiles; a
+// periodic rect must be narrower than the map on both axes.
+TilingOutput regenerateTilingRegion(const TilingProblem& problem, const int* tiles,
+                                    int width, int height, bool periodic, int rectX, int rectY,
+                                    int rectWidth, int rectHeight, uint64_t seed);
+// Rebuilds a recorded run without entropy search or sampling. The problem,
+// size and periodicity must match the recording; a log that does not fit
+// them fails like a contradiction.
+TilingOutput replayTiling(const TilingProblem& problem, int width, int height,
+                          bool periodic, const uint8_t* log, size_t logSize);